@@ -0,0 +1,122 @@
+/*
+ * In this benchmark we compare Contraction Hierarchy
+ * queries with Dijkstra on the same road like Graph
+ * (grid with random weights and a few long edges).
+ *
+ * Dijkstra is timed through Graph_dijkstra_query, the
+ * search behind Graph_dijkstra, and through early
+ * terminating Graph_shortest_path.
+ *
+ * Compile:
+ *    gcc -O2 -Isrc bench/ch_bench.c src/graph*.c -lpthread -o ch_bench
+ * Run:
+ *    ./ch_bench [grid side] [no of queries]
+ *
+ * Author: Kaushik, Koneru
+ * Email:  konerukaushik@gmail.com
+ */
+
+#include <time.h>
+#include <graph.h>
+
+static double
+elapsed(const struct timespec *start) {
+
+  struct timespec       now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+int main(int argc, char **argv) {
+
+  Graph_t              *G;
+  Graph_ch_t           *H;
+  Graph_workspace_t    *W;
+  Graph_workspace_t    *Wr;
+  vertex_number_t      *sources;
+  vertex_number_t      *targets;
+  struct timespec       start;
+  int                   side    = (argc > 1) ? atoi(argv[1]) : 300;
+  int                   queries = (argc > 2) ? atoi(argv[2]) : 1000;
+  int                   vertices;
+  int                   x, y, query;
+  long                  checksum_ch = 0;
+  long                  checksum_dijkstra = 0;
+  long                  distance;
+  double                seconds;
+
+  vertices = side * side;
+  srand(1);
+
+  G = Graph_init(vertices, FALSE);
+  for (y = 0; y < side; y++) {
+    for (x = 0; x < side; x++) {
+      if (x + 1 < side) {
+        Graph_add_edge(G, y * side + x, y * side + x + 1, 10 + rand() % 90, FALSE);
+      }
+      if (y + 1 < side) {
+        Graph_add_edge(G, y * side + x, (y + 1) * side + x, 10 + rand() % 90, FALSE);
+      }
+      if (rand() % 100 == 0) {
+        Graph_add_edge(G, y * side + x, rand() % vertices, 500 + rand() % 5000, FALSE);
+      }
+    }
+  }
+
+  sources = (vertex_number_t *)malloc(queries * sizeof(vertex_number_t));
+  targets = (vertex_number_t *)malloc(queries * sizeof(vertex_number_t));
+  for (query = 0; query < queries; query++) {
+    sources[query] = rand() % vertices;
+    targets[query] = rand() % vertices;
+  }
+
+  printf("Graph: %d vertices, %ld edges\n", vertices, G->total_edges);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  H = Graph_ch_build(G);
+  printf("CH build: %.2f s, %ld shortcuts\n", elapsed(&start), H->shortcuts);
+
+  W  = Graph_workspace_create(vertices);
+  Wr = Graph_workspace_create(vertices);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (query = 0; query < queries; query++) {
+    checksum_ch += Graph_ch_query(H, W, Wr, sources[query], targets[query]);
+  }
+  seconds = elapsed(&start);
+  printf("CH query: %.2f us/query\n", seconds * 1e6 / queries);
+
+  /* Full Dijkstra is slow, a tenth of the queries is enough */
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (query = 0; query < queries / 10; query++) {
+    Graph_dijkstra_query(G, W, sources[query]);
+    checksum_dijkstra += Graph_workspace_get_distance(G, W, targets[query]);
+  }
+  seconds = elapsed(&start);
+  printf("Dijkstra (all vertices): %.2f us/query\n", seconds * 1e6 / (queries / 10));
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (query = 0; query < queries / 10; query++) {
+    Graph_shortest_path(G, sources[query], targets[query], &distance, NULL);
+  }
+  seconds = elapsed(&start);
+  printf("Dijkstra (early exit): %.2f us/query\n", seconds * 1e6 / (queries / 10));
+
+  /* Both must agree on the queries they share */
+  checksum_ch = 0;
+  for (query = 0; query < queries / 10; query++) {
+    checksum_ch += Graph_ch_query(H, W, Wr, sources[query], targets[query]);
+  }
+  printf("Distances %s\n", (checksum_ch == checksum_dijkstra) ? "match" : "DIFFER");
+
+  Graph_workspace_destroy(W);
+  Graph_workspace_destroy(Wr);
+  Graph_ch_destroy(H);
+  Graph_destroy(G);
+  free(sources);
+  free(targets);
+
+  return 0;
+}
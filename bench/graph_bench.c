@@ -0,0 +1,733 @@
+/*
+ * In this benchmark we measure core API's of the library
+ * on synthetic Graphs of growing size, so regressions show
+ * up as changes of its numbers over time.
+ *
+ * Generators are deterministic for a given seed (own
+ * random number generator, independent of libc):
+ *      - er:       Erdos-Renyi G(n, m), uniform random edges
+ *      - rmat:     R-MAT / Kronecker (Graph500 parameters
+ *                  a=0.57 b=0.19 c=0.19), vertex IDs shuffled
+ *      - grid:     road like 2D grid with random weights
+ *                  and a few long undirected edges
+ *      - powerlaw: preferential attachment, targets picked
+ *                  in proportion to their degree
+ *
+ * For every generator and size (10^min .. 10^max edges) a
+ * child process builds the Graph and runs every API, so peak
+ * RSS is per case. One JSON object is printed per API:
+ *      {"generator":..,"seed":..,"vertices":..,"edges":..,
+ *       "threads":..,"api":..,"seconds":..,"ops":..,
+ *       "ops_per_second":..,["p50_us","p90_us","p99_us","max_us"
+ *       per query latency],["teps" traversed edges per second],
+ *       "peak_rss_kb":..,"timestamp":..}
+ * peak_rss_kb is high water mark of the case process when
+ * the API finished, so it is cumulative: it covers
+ * generated edges and every API run before in the case.
+ *
+ * Point queries (has_edge, csr_has_edge) take less time
+ * than reading the clock, so throughput is timed over the
+ * whole batch and latency over blocks of
+ * BENCH_LATENCY_BLOCK queries (mean per query in a block).
+ * Query pairs are drawn before timing starts.
+ *
+ * Dijkstra is timed through Graph_dijkstra_query with a
+ * reused workspace, the search behind Graph_dijkstra.
+ *
+ * Compile:
+ *    gcc -O2 -Isrc bench/graph_bench.c src/graph*.c -lpthread -o graph_bench
+ * Run:
+ *    ./graph_bench [-g er,rmat,grid,powerlaw] [-m min exponent] [-M max exponent]
+ *                  [-q queries] [-p paths] [-s searches] [-t threads] [-r seed]
+ *                  [-a api,...]
+ *
+ * Author: Kaushik, Koneru
+ * Email:  konerukaushik@gmail.com
+ */
+
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <graph.h>
+
+#define BENCH_LATENCY_BLOCK 64
+
+/*
+ * Edges of a generated Graph
+ */
+typedef struct bench_edges_ {
+  const char           *generator;
+  vertex_number_t       vertices;
+  edge_index_t          count;
+  vertex_number_t      *src;
+  vertex_number_t      *dst;
+  edge_weight_t        *weight;
+  bool                  directed;
+} bench_edges_t;
+
+/*
+ * Options of the run
+ */
+typedef struct bench_options_ {
+  const char           *generators;
+  const char           *apis;
+  int                   min_exponent;
+  int                   max_exponent;
+  int                   queries;       /* Point queries per API */
+  int                   paths;         /* Shortest path queries */
+  int                   searches;      /* Whole Graph searches per API */
+  int                   threads;
+  uint64_t              seed;
+} bench_options_t;
+
+static uint64_t         bench_state;
+
+/*
+ * splitmix64, same stream on every platform
+ */
+static uint64_t
+bench_random(void) {
+
+  uint64_t              z;
+
+  z = (bench_state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+  return z ^ (z >> 31);
+}
+
+static uint64_t
+bench_below(uint64_t bound) {
+
+  return bound ? bench_random() % bound : 0;
+}
+
+static double
+bench_unit(void) {
+
+  return (bench_random() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double
+elapsed(const struct timespec *start) {
+
+  struct timespec       now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static bool
+bench_alloc(bench_edges_t *E, vertex_number_t vertices, edge_index_t count) {
+
+  E->vertices = vertices;
+  E->count    = 0;
+  E->src      = (vertex_number_t *)malloc((count + 1) * sizeof(vertex_number_t));
+  E->dst      = (vertex_number_t *)malloc((count + 1) * sizeof(vertex_number_t));
+  E->weight   = (edge_weight_t *)malloc((count + 1) * sizeof(edge_weight_t));
+
+  return E->src != NULL && E->dst != NULL && E->weight != NULL;
+}
+
+static void
+bench_add(bench_edges_t *E, vertex_number_t src, vertex_number_t dst, edge_weight_t weight) {
+
+  E->src[E->count]    = src;
+  E->dst[E->count]    = dst;
+  E->weight[E->count] = weight;
+  E->count++;
+}
+
+/*
+ * Erdos-Renyi: m uniform random edges over m/8 vertices
+ */
+static bool
+bench_generate_er(bench_edges_t *E, edge_index_t edges) {
+
+  vertex_number_t       vertices = (vertex_number_t)(edges / 8 > 1 ? edges / 8 : 2);
+  edge_index_t          iterator;
+
+  if (!bench_alloc(E, vertices, edges)) {
+    return FALSE;
+  }
+  E->directed = TRUE;
+
+  for (iterator = 0; iterator < edges; iterator++) {
+    bench_add(E, (vertex_number_t)bench_below(vertices), (vertex_number_t)bench_below(vertices),
+              1 + (edge_weight_t)bench_below(100));
+  }
+
+  return TRUE;
+}
+
+/*
+ * R-MAT: every edge descends into one quadrant of the
+ * adjacency matrix per bit, 16 edges per vertex
+ */
+static bool
+bench_generate_rmat(bench_edges_t *E, edge_index_t edges) {
+
+  vertex_number_t      *permutation;
+  vertex_number_t       vertices;
+  vertex_number_t       src, dst, swap;
+  edge_index_t          iterator;
+  double                pick;
+  int                   scale = 1;
+  int                   bit;
+
+  while (((edge_index_t)1 << scale) * 16 < edges) {
+    scale++;
+  }
+  vertices = (vertex_number_t)1 << scale;
+
+  permutation = (vertex_number_t *)malloc(vertices * sizeof(vertex_number_t));
+  if (permutation == NULL || !bench_alloc(E, vertices, edges)) {
+    free(permutation);
+    return FALSE;
+  }
+  E->directed = TRUE;
+
+  for (src = 0; src < vertices; src++) {
+    permutation[src] = src;
+  }
+  for (src = vertices - 1; src > 0; src--) {
+    dst = (vertex_number_t)bench_below(src + 1);
+    swap = permutation[src];
+    permutation[src] = permutation[dst];
+    permutation[dst] = swap;
+  }
+
+  for (iterator = 0; iterator < edges; iterator++) {
+    src = dst = 0;
+    for (bit = 0; bit < scale; bit++) {
+      pick = bench_unit();
+      if (pick >= 0.57) {
+        if (pick < 0.76) {
+          dst |= 1 << bit;
+        } else if (pick < 0.95) {
+          src |= 1 << bit;
+        } else {
+          src |= 1 << bit;
+          dst |= 1 << bit;
+        }
+      }
+    }
+    bench_add(E, permutation[src], permutation[dst], 1 + (edge_weight_t)bench_below(100));
+  }
+
+  free(permutation);
+
+  return TRUE;
+}
+
+/*
+ * Road like grid: side x side vertices, edges to right
+ * and lower neighbor, one long edge per 64 vertices
+ */
+static bool
+bench_generate_grid(bench_edges_t *E, edge_index_t edges) {
+
+  vertex_number_t       side = 2;
+  vertex_number_t       x, y, vertex;
+
+  while ((edge_index_t)(side + 1) * (side + 1) * 2 <= edges) {
+    side++;
+  }
+
+  if (!bench_alloc(E, side * side, (edge_index_t)side * side * 2 + side * side / 64 + 1)) {
+    return FALSE;
+  }
+  E->directed = FALSE;
+
+  for (y = 0; y < side; y++) {
+    for (x = 0; x < side; x++) {
+      vertex = y * side + x;
+      if (x + 1 < side) {
+        bench_add(E, vertex, vertex + 1, 10 + (edge_weight_t)bench_below(90));
+      }
+      if (y + 1 < side) {
+        bench_add(E, vertex, vertex + side, 10 + (edge_weight_t)bench_below(90));
+      }
+    }
+  }
+
+  for (vertex = 0; vertex < side * side / 64; vertex++) {
+    bench_add(E, (vertex_number_t)bench_below(side * side), (vertex_number_t)bench_below(side * side),
+              500 + (edge_weight_t)bench_below(1000));
+  }
+
+  return TRUE;
+}
+
+/*
+ * Preferential attachment (undirected): every new vertex
+ * links to 8 endpoints of earlier edges, so targets are
+ * picked in proportion to their degree
+ */
+static bool
+bench_generate_powerlaw(bench_edges_t *E, edge_index_t edges) {
+
+  vertex_number_t       vertices = (vertex_number_t)(edges / 8 > 9 ? edges / 8 : 9);
+  vertex_number_t       vertex;
+  vertex_number_t       target;
+  edge_index_t          pick;
+  int                   link;
+
+  if (!bench_alloc(E, vertices, (edge_index_t)vertices * 8)) {
+    return FALSE;
+  }
+  E->directed = FALSE;
+
+  /* Seed cycle of 9 vertices, every vertex starts with degree 2 */
+  for (vertex = 0; vertex < 9; vertex++) {
+    bench_add(E, vertex, (vertex + 1) % 9, 1 + (edge_weight_t)bench_below(100));
+  }
+
+  for (vertex = 9; vertex < vertices && E->count + 8 <= (edge_index_t)vertices * 8; vertex++) {
+    for (link = 0; link < 8; link++) {
+      pick   = (edge_index_t)bench_below(E->count * 2);
+      target = (pick & 1) ? E->dst[pick >> 1] : E->src[pick >> 1];
+      bench_add(E, vertex, target, 1 + (edge_weight_t)bench_below(100));
+    }
+  }
+
+  return TRUE;
+}
+
+/*
+ * Edges leaving vertices reached by a search, what
+ * TEPS is counted on
+ */
+static double
+bench_traversed(const Graph_csr_t *C, const long *distance) {
+
+  vertex_number_t       row;
+  double                traversed = 0;
+
+  for (row = 0; row < C->total_vertices; row++) {
+    if (distance[row] != GRAPH_INFINITE_DISTANCE) {
+      traversed += C->offsets[row + 1] - C->offsets[row];
+    }
+  }
+
+  return traversed;
+}
+
+/*
+ * Endpoint of a random edge, so searches do not
+ * start at isolated vertices (as in Graph500)
+ */
+static vertex_number_t
+bench_source(const bench_edges_t *E) {
+
+  edge_index_t          pick = (edge_index_t)bench_below(E->count);
+
+  return (E->directed || (pick & 1)) ? E->src[pick] : E->dst[pick];
+}
+
+static void
+bench_free(bench_edges_t *E) {
+
+  free(E->src);
+  free(E->dst);
+  free(E->weight);
+}
+
+static int
+bench_compare(const void *first, const void *second) {
+
+  double                a = *(const double *)first;
+  double                b = *(const double *)second;
+
+  return (a > b) - (a < b);
+}
+
+static bool
+bench_wanted(const char *list, const char *name) {
+
+  size_t                length = strlen(name);
+  const char           *cursor;
+
+  if (list == NULL) {
+    return TRUE;
+  }
+
+  for (cursor = list; (cursor = strstr(cursor, name)) != NULL; cursor += length) {
+    if ((cursor == list || cursor[-1] == ',') &&
+        (cursor[length] == ',' || cursor[length] == '\0')) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+static long
+bench_peak_rss(void) {
+
+  struct rusage         usage;
+
+  getrusage(RUSAGE_SELF, &usage);
+
+  return usage.ru_maxrss;
+}
+
+/*
+ * Prints one JSON line. latency (samples entries,
+ * seconds) is sorted for percentiles when given,
+ * traversed edges give TEPS when positive
+ */
+static void
+bench_report(const bench_options_t *O, const bench_edges_t *E, const char *api,
+             double seconds, long ops, double *latency, long samples,
+             double traversed) {
+
+  printf("{\"generator\":\"%s\",\"seed\":%llu,\"vertices\":%d,\"edges\":%ld,"
+         "\"threads\":%d,\"api\":\"%s\",\"seconds\":%.6f,\"ops\":%ld,"
+         "\"ops_per_second\":%.1f",
+         E->generator, (unsigned long long)O->seed, E->vertices, E->count,
+         Graph_resolve_threads(O->threads), api, seconds, ops,
+         seconds > 0 ? ops / seconds : 0.0);
+
+  if (latency != NULL && samples > 0) {
+    qsort(latency, samples, sizeof(double), bench_compare);
+    printf(",\"p50_us\":%.3f,\"p90_us\":%.3f,\"p99_us\":%.3f,\"max_us\":%.3f",
+           latency[(samples - 1) * 50 / 100] * 1e6, latency[(samples - 1) * 90 / 100] * 1e6,
+           latency[(samples - 1) * 99 / 100] * 1e6, latency[samples - 1] * 1e6);
+  }
+
+  if (traversed > 0 && seconds > 0) {
+    printf(",\"teps\":%.1f", traversed / seconds);
+  }
+
+  printf(",\"peak_rss_kb\":%ld,\"timestamp\":%ld}\n", bench_peak_rss(), (long)time(NULL));
+  fflush(stdout);
+}
+
+/*
+ * Point queries over drawn pairs, on Graph G or (if G
+ * is NULL) on snapshot C: whole batch for throughput,
+ * then same pairs again in timed blocks for latency
+ */
+static long
+bench_has_edge(const bench_options_t *O, const bench_edges_t *E, const char *api,
+               Graph_t *G, const Graph_csr_t *C, const vertex_number_t *src,
+               const vertex_number_t *dst, long queries, double *latency) {
+
+  struct timespec       start;
+  double                seconds;
+  long                  checksum = 0;
+  long                  blocks = 0;
+  long                  query;
+  long                  end;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (query = 0; query < queries; query++) {
+    checksum += G ? Graph_has_edge(G, src[query], dst[query]) :
+                    Graph_csr_has_edge(C, src[query], dst[query]);
+  }
+  seconds = elapsed(&start);
+
+  for (query = 0; query + BENCH_LATENCY_BLOCK <= queries; query = end) {
+    end = query + BENCH_LATENCY_BLOCK;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (; query < end; query++) {
+      checksum += G ? Graph_has_edge(G, src[query], dst[query]) :
+                      Graph_csr_has_edge(C, src[query], dst[query]);
+    }
+    latency[blocks++] = elapsed(&start) / BENCH_LATENCY_BLOCK;
+  }
+
+  bench_report(O, E, api, seconds, queries, latency, blocks, 0);
+
+  return checksum;
+}
+
+/*
+ * Runs every selected API on one generated Graph
+ */
+static int
+bench_case(const bench_options_t *O, const char *generator, edge_index_t edges) {
+
+  bench_edges_t         E;
+  Graph_t              *G = NULL;
+  Graph_t              *B;
+  Graph_csr_t          *C = NULL;
+  Graph_csr_t          *R = NULL;
+  Graph_workspace_t    *W = NULL;
+  Graph_workspace_t    *Wr = NULL;
+  struct timespec       start;
+  struct timespec       one;
+  vertex_number_t      *component = NULL;
+  vertex_number_t      *parent = NULL;
+  vertex_number_t      *query_src = NULL;
+  vertex_number_t      *query_dst = NULL;
+  long                 *distance = NULL;
+  double               *latency;
+  double                seconds;
+  double                traversed;
+  long                  distance_found;
+  long                  checksum = 0;
+  long                  query;
+  edge_index_t          pick;
+  int                   queries  = O->queries;
+  int                   paths    = O->paths;
+  int                   searches = O->searches;
+  bool                  ok = TRUE;
+
+  memset(&E, 0, sizeof(E));
+  E.generator = generator;
+  bench_state = O->seed;
+
+  if (!strcmp(generator, "er")) {
+    ok = bench_generate_er(&E, edges);
+  } else if (!strcmp(generator, "rmat")) {
+    ok = bench_generate_rmat(&E, edges);
+  } else if (!strcmp(generator, "grid")) {
+    ok = bench_generate_grid(&E, edges);
+  } else if (!strcmp(generator, "powerlaw")) {
+    ok = bench_generate_powerlaw(&E, edges);
+  } else {
+    fprintf(stderr, "Unknown generator %s\n", generator);
+    return 1;
+  }
+
+  query   = (queries > searches) ? queries : searches;
+  query   = (query > paths) ? query : paths;
+  latency = (double *)malloc(query * sizeof(double));
+  if (!ok || latency == NULL) {
+    fprintf(stderr, "Unable to generate %s with %ld edges\n", generator, edges);
+    bench_free(&E);
+    free(latency);
+    return 1;
+  }
+
+  /* Building */
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  G = Graph_init(E.vertices, E.directed);
+  for (pick = 0; pick < E.count; pick++) {
+    Graph_add_edge(G, E.src[pick], E.dst[pick], E.weight[pick], E.directed);
+  }
+  seconds = elapsed(&start);
+  Graph_set_num_threads(G, O->threads);
+  if (bench_wanted(O->apis, "add_edge")) {
+    bench_report(O, &E, "add_edge", seconds, E.count, NULL, 0, 0);
+  }
+
+  if (bench_wanted(O->apis, "add_edges_bulk")) {
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    B = Graph_init(E.vertices, E.directed);
+    Graph_add_edges_bulk(B, E.src, E.dst, E.weight, E.count, E.directed);
+    seconds = elapsed(&start);
+    Graph_destroy(B);
+    bench_report(O, &E, "add_edges_bulk", seconds, E.count, NULL, 0, 0);
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  C = Graph_freeze(G);
+  seconds = elapsed(&start);
+  if (bench_wanted(O->apis, "freeze")) {
+    bench_report(O, &E, "freeze", seconds, E.count, NULL, 0, 0);
+  }
+
+  W         = Graph_workspace_create(E.vertices);
+  Wr        = Graph_workspace_create(E.vertices);
+  distance  = (long *)malloc(E.vertices * sizeof(long));
+  parent    = (vertex_number_t *)malloc(E.vertices * sizeof(vertex_number_t));
+  component = (vertex_number_t *)malloc(E.vertices * sizeof(vertex_number_t));
+  query_src = (vertex_number_t *)malloc(queries * sizeof(vertex_number_t));
+  query_dst = (vertex_number_t *)malloc(queries * sizeof(vertex_number_t));
+  if (C == NULL || W == NULL || Wr == NULL || distance == NULL ||
+      parent == NULL || component == NULL || query_src == NULL || query_dst == NULL) {
+    fprintf(stderr, "Unable to allocate query state for %d vertices\n", E.vertices);
+    ok = FALSE;
+    goto destroy;
+  }
+
+  /* Point queries, half of them hit an existing edge */
+  for (query = 0; query < queries; query++) {
+    pick             = (edge_index_t)bench_below(E.count);
+    query_src[query] = E.src[pick];
+    query_dst[query] = (query & 1) ? E.dst[pick] : (vertex_number_t)bench_below(E.vertices);
+  }
+
+  if (bench_wanted(O->apis, "has_edge")) {
+    checksum += bench_has_edge(O, &E, "has_edge", G, NULL, query_src, query_dst,
+                               queries, latency);
+  }
+
+  if (bench_wanted(O->apis, "csr_has_edge")) {
+    checksum += bench_has_edge(O, &E, "csr_has_edge", NULL, C, query_src, query_dst,
+                               queries, latency);
+  }
+
+  if (bench_wanted(O->apis, "shortest_path")) {
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (query = 0; query < paths; query++) {
+      clock_gettime(CLOCK_MONOTONIC, &one);
+      Graph_shortest_path_query(G, W, Wr, bench_source(&E), bench_source(&E),
+                                &distance_found, NULL);
+      latency[query] = elapsed(&one);
+      checksum += distance_found;
+    }
+    bench_report(O, &E, "shortest_path", elapsed(&start), paths, latency, paths, 0);
+  }
+
+  /* Whole Graph searches */
+  if (bench_wanted(O->apis, "dijkstra")) {
+    for (seconds = 0, traversed = 0, query = 0; query < searches; query++) {
+      clock_gettime(CLOCK_MONOTONIC, &one);
+      Graph_dijkstra_query(G, W, bench_source(&E));
+      latency[query] = elapsed(&one);
+      seconds       += latency[query];
+      traversed     += bench_traversed(C, W->min_distance);
+    }
+    bench_report(O, &E, "dijkstra", seconds, searches, latency, searches, traversed);
+  }
+
+  if (bench_wanted(O->apis, "csr_dijkstra")) {
+    for (seconds = 0, traversed = 0, query = 0; query < searches; query++) {
+      clock_gettime(CLOCK_MONOTONIC, &one);
+      Graph_csr_dijkstra_query(C, W, bench_source(&E));
+      latency[query] = elapsed(&one);
+      seconds       += latency[query];
+      traversed     += bench_traversed(C, W->min_distance);
+    }
+    bench_report(O, &E, "csr_dijkstra", seconds, searches, latency, searches, traversed);
+  }
+
+  if (bench_wanted(O->apis, "delta_stepping")) {
+    for (seconds = 0, traversed = 0, query = 0; query < searches; query++) {
+      clock_gettime(CLOCK_MONOTONIC, &one);
+      Graph_csr_delta_stepping(C, bench_source(&E), 0, distance);
+      latency[query] = elapsed(&one);
+      seconds       += latency[query];
+      traversed     += bench_traversed(C, distance);
+    }
+    bench_report(O, &E, "delta_stepping", seconds, searches, latency, searches, traversed);
+  }
+
+  if (bench_wanted(O->apis, "bfs")) {
+    R = E.directed ? Graph_csr_transpose(C) : NULL;
+    for (seconds = 0, traversed = 0, query = 0; query < searches; query++) {
+      clock_gettime(CLOCK_MONOTONIC, &one);
+      Graph_csr_bfs(C, R, bench_source(&E), distance, parent);
+      latency[query] = elapsed(&one);
+      seconds       += latency[query];
+      traversed     += bench_traversed(C, distance);
+    }
+    bench_report(O, &E, "bfs", seconds, searches, latency, searches, traversed);
+  }
+
+  /* Whole Graph analytics */
+  if (bench_wanted(O->apis, "connected_components")) {
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    checksum += Graph_csr_connected_components(C, component);
+    bench_report(O, &E, "connected_components", elapsed(&start), 1, NULL, 0,
+                 (double)C->total_edges);
+  }
+
+  if (bench_wanted(O->apis, "strongly_connected_components")) {
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    checksum += Graph_csr_strongly_connected_components(C, R, GRAPH_SCC_FORWARD_BACKWARD, component);
+    bench_report(O, &E, "strongly_connected_components", elapsed(&start), 1, NULL, 0,
+                 (double)C->total_edges);
+  }
+
+  /* Keeps calls above from being optimized away */
+  if (checksum == 42) {
+    fprintf(stderr, "checksum %ld\n", checksum);
+  }
+
+destroy:
+  Graph_workspace_destroy(W);
+  Graph_workspace_destroy(Wr);
+  Graph_csr_destroy(C);
+  Graph_csr_destroy(R);
+  Graph_destroy(G);
+  bench_free(&E);
+  free(distance);
+  free(parent);
+  free(component);
+  free(query_src);
+  free(query_dst);
+  free(latency);
+
+  return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+
+  bench_options_t       O;
+  char                 *generators;
+  char                 *generator;
+  char                 *save = NULL;
+  edge_index_t          edges;
+  pid_t                 child;
+  int                   status;
+  int                   exponent;
+  int                   option;
+  int                   result = 0;
+
+  O.generators   = "er,rmat,grid,powerlaw";
+  O.apis         = NULL;
+  O.min_exponent = 3;
+  O.max_exponent = 6;
+  O.queries      = 10000;
+  O.paths        = 100;
+  O.searches     = 10;
+  O.threads      = 0;
+  O.seed         = 1;
+
+  while ((option = getopt(argc, argv, "g:a:m:M:q:p:s:t:r:")) != -1) {
+    switch (option) {
+      case 'g': O.generators   = optarg; break;
+      case 'a': O.apis         = optarg; break;
+      case 'm': O.min_exponent = atoi(optarg); break;
+      case 'M': O.max_exponent = atoi(optarg); break;
+      case 'q': O.queries      = atoi(optarg); break;
+      case 'p': O.paths        = atoi(optarg); break;
+      case 's': O.searches     = atoi(optarg); break;
+      case 't': O.threads      = atoi(optarg); break;
+      case 'r': O.seed         = strtoull(optarg, NULL, 10); break;
+      default:
+        fprintf(stderr, "Usage: %s [-g er,rmat,grid,powerlaw] [-m min exponent] [-M max exponent]\n"
+                        "          [-q queries] [-p paths] [-s searches] [-t threads] [-r seed]\n"
+                        "          [-a api,...]\n",
+                argv[0]);
+        return 1;
+    }
+  }
+
+  if (O.queries < 1 || O.paths < 1 || O.searches < 1 ||
+      O.min_exponent < 1 || O.max_exponent > 9) {
+    fprintf(stderr, "Queries, paths and searches must be positive, exponents within 1 .. 9\n");
+    return 1;
+  }
+
+  generators = strdup(O.generators);
+  for (generator = strtok_r(generators, ",", &save); generator != NULL;
+       generator = strtok_r(NULL, ",", &save)) {
+    for (edges = 1, exponent = 0; exponent < O.min_exponent; exponent++) {
+      edges *= 10;
+    }
+    for (exponent = O.min_exponent; exponent <= O.max_exponent; exponent++, edges *= 10) {
+      /* Own process per case, so peak RSS is not carried over */
+      child = fork();
+      if (child == 0) {
+        exit(bench_case(&O, generator, edges));
+      }
+      if (child < 0 || waitpid(child, &status, 0) < 0 ||
+          !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "Case %s with %ld edges failed\n", generator, edges);
+        result = 1;
+      }
+    }
+  }
+  free(generators);
+
+  return result;
+}
@@ -54,6 +54,7 @@ int main() {
   printf("----- Dijkstra ----\n");
 
   Graph_get_dijsktra(G,0);
+  Graph_display_graph(G);
 
   return 0;
 }
@@ -12,6 +12,9 @@
 int main() {
   
   Graph_t              *G;
+  long                  distance[10];
+  vertex_number_t       predecessor[10];
+  int                   vertex;
   unsigned int          destination;
   unsigned int          source;
   unsigned int          weight = 10;
@@ -47,7 +50,19 @@ int main() {
 
   printf("----- Dijkstra ----\n");
 
-  Graph_get_dijsktra(G,0);
+  /* Vertices 0 .. 9 of Graph_init keep their order as dense index */
+  if (Graph_dijkstra(G, 0, distance, predecessor)) {
+    for (vertex = 0; vertex < 10; vertex++) {
+      if (distance[vertex] == GRAPH_INFINITE_DISTANCE) {
+        printf("Vertex %d : unreachable\n", vertex);
+      } else {
+        printf("Vertex %d : distance %ld through %d\n", vertex,
+               distance[vertex], predecessor[vertex]);
+      }
+    }
+  }
+
+  Graph_destroy(G);
 
   return 0;
 }
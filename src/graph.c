@@ -67,111 +67,351 @@ bool
 Graph_has_edge(Graph_t *G, vertex_number_t S, vertex_number_t D) {
 
   Graph_vertices_t    *vertex;
+  int                  indexed;
+
+  if (G->edge_index != NULL) {
+    indexed = Graph_edge_index_lookup(G->edge_index, S, D);
+    if (indexed >= 0) {
+      return indexed;
+    }
+  }
 
   vertex  = Graph_get_vertex(G,S);
   if (vertex == NULL) {
-    LOG_DEBUG("Vertex :%d has no edges",S);
     return FALSE;
   }
 
+  if (G->sorted_adjacency) {
+    return Graph_sorted_contains(vertex->neighbors, vertex->neighbors_count, D);
+  }
+
   return Graph_node_in_adjacency(vertex->adjacency_list,D);
 
 }
 
 /*
  * Function:
- *  Graph_node_in_priority_list
+ * Graph_vertex_hash_slot
  *
- *  In this function we verify
- *  whether node is already present in 
- *  priority_list before appending to
- *  priority_list
+ * In this function we compute home slot of
+ * a vertex ID in the hash index
+ * (Fibonacci hashing, size is power of 2)
  *
- * Input
- *    Graph_priority_t
- *    vertex_number_t
+ * Input:
+ *      vertex_number_t  - Vertex ID
+ *      vertex_number_t  - Hash index size
+ * Output:
+ *      vertex_number_t  - Slot
+ */
+static vertex_number_t
+Graph_vertex_hash_slot(vertex_number_t node, vertex_number_t size) {
+
+    return (vertex_number_t)(((unsigned int)node * 2654435761u) &
+                             (unsigned int)(size - 1));
+}
+
+/*
+ * Function:
+ * Graph_get_vertex
+ *
+ * In this function we vertex pointer
+ * from graph. IDs in range of the direct
+ * index are resolved with single load, 
+ * sparse IDs through the hash index
+ *
+ * Input:
+ *      Graph_t   
+ *      vertex_number_t
  *
- * output
- *    True (If already present)
- *    False (If not present)
+ * Output:
+ *      Graph_vertices_t
  */
-bool
-Graph_node_in_priority_list(Graph_priority_t *prio,
-                              vertex_number_t node) {
-    Graph_priority_t    *S;
+Graph_vertices_t *
+Graph_get_vertex(const Graph_t *G, vertex_number_t node) {
+  
+    Graph_vertices_t    *runner;
+    vertex_number_t      slot;
 
-    S = prio;
+    if (node >= 0 && node < G->vertex_table_size) {
+      runner = G->vertex_table[node];
+      if (runner != NULL) {
+        return runner;
+      }
+    }
+
+    if (G->vertex_hash_count == 0) {
+      return NULL;
+    }
 
-    while(S != NULL) {
-      if (S->vertex == node) {
-        return TRUE;
+    /* Linear probing till we hit the ID or an empty slot */
+    slot = Graph_vertex_hash_slot(node, G->vertex_hash_size);
+    while ((runner = G->vertex_hash[slot]) != NULL) {
+      if (runner->interface_number == node) {
+        return runner;
       }
-      S = S->next;
+      slot = (slot + 1) & (G->vertex_hash_size - 1);
     }
 
-    return FALSE;
+    return NULL;
 }
 
-/* Function:
- * Graph_dump_prio_list
+/*
+ * Function:
+ * Graph_vertex_hash_insert
  *
- * In this function we dump complete Priority 
- * List
+ * In this function we add vertex to the hash
+ * index, doubling it when it is half full
  *
  * Input:
- *    Graph_priority_t *S
+ *      Graph_t
+ *      Graph_vertices_t  - Vertex to index
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- On Failure
+ */
+static bool
+Graph_vertex_hash_insert(Graph_t *G, Graph_vertices_t *V) {
+
+    Graph_vertices_t   **new_hash;
+    vertex_number_t      new_size;
+    vertex_number_t      iterator;
+    vertex_number_t      slot;
+
+    if (2 * (G->vertex_hash_count + 1) > G->vertex_hash_size) {
+      new_size = G->vertex_hash_size ? 2 * G->vertex_hash_size
+                                     : GRAPH_VERTEX_TABLE_MIN;
+      new_hash = (Graph_vertices_t **)calloc(new_size, sizeof(Graph_vertices_t *));
+      if (new_hash == NULL) {
+        LOG_ERR("Unable to grow vertex hash index to %d",new_size);
+        return FALSE;
+      }
+      GRAPH_STATS_ALLOC(G->stats, new_size * sizeof(Graph_vertices_t *));
+
+      for (iterator = 0; iterator < G->vertex_hash_size; iterator++) {
+        if (G->vertex_hash[iterator] == NULL) {
+          continue;
+        }
+        slot = Graph_vertex_hash_slot(G->vertex_hash[iterator]->interface_number,
+                                      new_size);
+        while (new_hash[slot] != NULL) {
+          slot = (slot + 1) & (new_size - 1);
+        }
+        new_hash[slot] = G->vertex_hash[iterator];
+      }
+
+      free(G->vertex_hash);
+      G->vertex_hash      = new_hash;
+      G->vertex_hash_size = new_size;
+    }
+
+    slot = Graph_vertex_hash_slot(V->interface_number, G->vertex_hash_size);
+    while (G->vertex_hash[slot] != NULL) {
+      slot = (slot + 1) & (G->vertex_hash_size - 1);
+    }
+    G->vertex_hash[slot] = V;
+    G->vertex_hash_count++;
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_index_vertex
  *
+ * In this function we make vertex resolvable
+ * by Graph_get_vertex. Dense IDs go to the direct
+ * index which is grown geometrically, IDs far
+ * beyond its capacity go to the hash index
+ *
+ * Input:
+ *      Graph_t
+ *      Graph_vertices_t  - Vertex to index
  * Output:
- *    none
+ *      bool True  <-- On Success
+ *           False <-- On Failure
  */
-void
-Graph_dump_prio_list(Graph_priority_t *S) {
+static bool
+Graph_index_vertex(Graph_t *G, Graph_vertices_t *V) {
 
-  Graph_priority_t      *runner = S;
+    Graph_vertices_t   **new_table;
+    long                 limit;
+    long                 new_size;
+    vertex_number_t      node = V->interface_number;
 
+    limit = 2L * (G->vertex_table_size > G->total_vertices ?
+                  G->vertex_table_size : G->total_vertices) +
+            GRAPH_VERTEX_TABLE_MIN;
 
-  if (S == NULL) {
-    LOG_DEBUG("Priority List is NULL");
-    return;
-  }
+    if (node < 0 || node >= limit) {
+      return Graph_vertex_hash_insert(G, V);
+    }
 
-  printf("<-----Prio List ----->\n");
-  while(S != NULL) {
-    printf(" Node -> %d\n",S->vertex);
-    S = S->next;
-  }
-  printf("<-------------------->\n");
+    if (node >= G->vertex_table_size) {
+      new_size = G->vertex_table_size ? G->vertex_table_size
+                                      : GRAPH_VERTEX_TABLE_MIN;
+      while (new_size <= node) {
+        new_size = 2 * new_size;
+      }
+      if (new_size > INT_MAX) {
+        new_size = INT_MAX;
+      }
+
+      new_table = (Graph_vertices_t **)realloc(G->vertex_table,
+                                   new_size * sizeof(Graph_vertices_t *));
+      if (new_table == NULL) {
+        LOG_ERR("Unable to grow vertex index to %ld",new_size);
+        return FALSE;
+      }
+      GRAPH_STATS_ALLOC(G->stats, new_size * sizeof(Graph_vertices_t *));
+      memset(new_table + G->vertex_table_size, 0,
+             (new_size - G->vertex_table_size) * sizeof(Graph_vertices_t *));
+
+      G->vertex_table      = new_table;
+      G->vertex_table_size = (vertex_number_t)new_size;
+    }
 
+    G->vertex_table[node] = V;
 
-  return;
+    return TRUE;
 }
 
 /*
  * Function:
- * Graph_get_vertex
+ * Graph_link_vertex
  *
- * In this function we vertex pointer
- * from graph
+ * In this function we append vertex to
+ * vertices list, assign its dense index
+ * (recorded in index_table) and add it to
+ * the vertex index
  *
  * Input:
- *      Graph_t   
- *      vertex_number_t
+ *      Graph_t
+ *      Graph_vertices_t  - Vertex with interface_number set
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- On Failure
+ */
+static bool
+Graph_link_vertex(Graph_t *G, Graph_vertices_t *V) {
+
+    Graph_vertices_t   **new_table;
+    long                 new_size;
+
+    if (G->total_vertices >= G->index_table_size) {
+      new_size  = G->index_table_size ? 2L * G->index_table_size
+                                      : GRAPH_VERTEX_TABLE_MIN;
+      if (new_size > INT_MAX) {
+        new_size = INT_MAX;
+      }
+      new_table = (Graph_vertices_t **)realloc(G->index_table,
+                                   new_size * sizeof(Graph_vertices_t *));
+      if (new_table == NULL) {
+        LOG_ERR("Unable to grow index table to %ld",new_size);
+        return FALSE;
+      }
+      GRAPH_STATS_ALLOC(G->stats, new_size * sizeof(Graph_vertices_t *));
+      G->index_table      = new_table;
+      G->index_table_size = (vertex_number_t)new_size;
+    }
+
+    if (!Graph_index_vertex(G, V)) {
+      return FALSE;
+    }
+
+    V->index = G->total_vertices;
+    G->index_table[V->index] = V;
+
+    V->prev = G->vertices_tail;
+    if (G->vertices_tail == NULL) {
+      G->vertices_list = V;
+    } else {
+      G->vertices_tail->next = V;
+    }
+    G->vertices_tail = V;
+
+    G->total_vertices++;
+
+    if (G->sssp_trees != NULL) {
+      Graph_sssp_vertex_added(G, V);
+    }
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_unlink_vertex
  *
+ * In this function we undo Graph_link_vertex:
+ * vertex is taken out of vertices list and vertex
+ * index, last vertex takes over its dense index so
+ * that indexes stay 0 .. total_vertices-1
+ *
+ * Input:
+ *      Graph_t
+ *      Graph_vertices_t  - Vertex to unlink
  * Output:
- *      Graph_vertices_t
+ *      none
  */
-Graph_vertices_t *
-Graph_get_vertex(Graph_t *G, vertex_number_t node) {
-  
-    Graph_vertices_t    *runner;
+static void
+Graph_unlink_vertex(Graph_t *G, Graph_vertices_t *V) {
+
+    Graph_vertices_t    *last;
+    vertex_number_t      node = V->interface_number;
+    vertex_number_t      slot;
+    vertex_number_t      hole;
+    vertex_number_t      home;
+    vertex_number_t      mask;
+
+    if (node >= 0 && node < G->vertex_table_size && G->vertex_table[node] == V) {
+      G->vertex_table[node] = NULL;
+    } else if (G->vertex_hash_count > 0) {
+      mask = G->vertex_hash_size - 1;
+      slot = Graph_vertex_hash_slot(node, G->vertex_hash_size);
+      while (G->vertex_hash[slot] != V) {
+        slot = (slot + 1) & mask;
+      }
 
-    runner  = G->vertices_list;
+      /*
+       * Backward shift deletion: later entries of the
+       * probe run whose home is not between the hole and
+       * their slot move into the hole, so no tombstones
+       */
+      hole = slot;
+      for (slot = (slot + 1) & mask; G->vertex_hash[slot] != NULL;
+           slot = (slot + 1) & mask) {
+        home = Graph_vertex_hash_slot(G->vertex_hash[slot]->interface_number,
+                                      G->vertex_hash_size);
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+          G->vertex_hash[hole] = G->vertex_hash[slot];
+          hole = slot;
+        }
+      }
+      G->vertex_hash[hole] = NULL;
+      G->vertex_hash_count--;
+    }
+
+    last = G->index_table[G->total_vertices - 1];
+    last->index = V->index;
+    G->index_table[V->index] = last;
+    G->total_vertices--;
 
-    while(runner != NULL && runner->interface_number != node) {
-      runner = runner->next;
+    if (G->sssp_trees != NULL) {
+      Graph_sssp_vertex_moved(G, last, G->total_vertices);
     }
 
-    return runner;
+    if (V->prev == NULL) {
+      G->vertices_list = V->next;
+    } else {
+      V->prev->next = V->next;
+    }
+    if (V->next == NULL) {
+      G->vertices_tail = V->prev;
+    } else {
+      V->next->prev = V->prev;
+    }
+
+    return;
 }
 
 /*
@@ -179,35 +419,31 @@ Graph_get_vertex(Graph_t *G, vertex_number_t node) {
  * Graph_add_edge_to_vertex
  *
  * In this function we append new_edge to
- * the adjacency list of vertices list
+ * the adjacency list of vertex. Vertex keeps
+ * tail of its list so append is O(1)
  *
- * Input: Graph_edges_t     adjacency_list
+ * Input: Graph_vertices_t  vertex
  *        Graph_edges_t     new_edge
  * output:
  *        Graph_edges_t* (Graph Vertex adjacencyList)
  */
 Graph_edges_t *
-Graph_add_edge_to_vertex(Graph_edges_t  *adjacency_list,
-                         Graph_edges_t  *new_edge) {
-
-  Graph_edges_t      *runner; /* To Parse through to vertices_list */
-  
-  if (adjacency_list == NULL) {
-    free(runner);
-    return new_edge;
-  }
+Graph_add_edge_to_vertex(Graph_vertices_t *vertex,
+                         Graph_edges_t    *new_edge) {
 
-  runner = adjacency_list;
+  new_edge->next = NULL;
 
-  /* Parse till we reach end of Adjacency List */
-  while(runner->next != NULL) {
-    runner = runner->next;
+  if (vertex->adjacency_list == NULL) {
+    vertex->adjacency_list = new_edge;
+  } else {
+    /* Append the New edge to List */
+    vertex->adjacency_tail->next = new_edge;
   }
 
-  /* Append the New edge to List */
-  runner->next = new_edge;
+  vertex->adjacency_tail = new_edge;
+  vertex->degree++;
 
-  return adjacency_list;
+  return vertex->adjacency_list;
 }
 
 /* 
@@ -219,18 +455,20 @@ Graph_add_edge_to_vertex(Graph_edges_t  *adjacency_list,
  * So, We consider destination and weight only
  *
  * Input:
+ *      Graph_t         G (Graph owning edge slab)
  *      vertex_number_t destination (Destination Vertex)
  *      edge_weight_t   weight  (Weight of edge)
  * Output:
  *      Graph_edges_t  (new edge Object)
  */
 Graph_edges_t *
-Graph_add_edge_template(vertex_number_t Destination,
+Graph_add_edge_template(Graph_t        *G,
+                        vertex_number_t Destination,
                         edge_weight_t   weight) {
 
     Graph_edges_t      *temp;
 
-    temp = (Graph_edges_t *)malloc(sizeof(Graph_edges_t));
+    temp = (Graph_edges_t *)Graph_slab_alloc(&G->edge_slab);
 
     if (temp == NULL) {
       LOG_ERR("Unable to allocate memory for Edge with Dest:%d",Destination);
@@ -244,10 +482,322 @@ Graph_add_edge_template(vertex_number_t Destination,
     return temp;
     
 destroy:
-    free(temp);
     return NULL;
 }
 
+/*
+ * Function: Graph_note_weight
+ *
+ * In this function we keep max edge weight of
+ * Graph up to date, it picks frontier used by
+ * Dijkstra (see Graph_set_heap_type). Bound is
+ * not lowered when edges go away
+ *
+ * Input:
+ *      G <-- Graph
+ *      weight <-- Weight of added edge
+ * Output:
+ *      none
+ */
+static void
+Graph_note_weight(Graph_t *G, edge_weight_t weight) {
+
+    if (weight < 0) {
+      G->max_weight = -1;
+    } else if (G->max_weight >= 0 && weight > G->max_weight) {
+      G->max_weight = weight;
+    }
+
+    return;
+}
+
+/*
+ * Function: Graph_link_reverse_edge
+ *
+ * In this function we record incoming edge
+ * in reverse adjacency of vertex. Order of
+ * incoming edges does not matter, so it is
+ * pushed in front
+ *
+ * Input:
+ *      vertex <-- Destination of the edge
+ *      reverse <-- Edge whose target is Source
+ * Output:
+ *      none
+ */
+static void
+Graph_link_reverse_edge(Graph_vertices_t *vertex, Graph_edges_t *reverse) {
+
+  reverse->next        = vertex->reverse_list;
+  vertex->reverse_list = reverse;
+
+  return;
+}
+
+/*
+ * Function: Graph_pending_slot
+ *
+ * In this function we find slot of vertex ID
+ * in index of pending incoming edges
+ *
+ * Input:
+ *      G <-- Graph
+ *      node <-- Vertex ID
+ * Output:
+ *      vertex_number_t <-- Slot, -1 if ID has no pending edges
+ */
+static vertex_number_t
+Graph_pending_slot(const Graph_t *G, vertex_number_t node) {
+
+  vertex_number_t      slot;
+
+  if (G->pending_count == 0) {
+    return -1;
+  }
+
+  slot = Graph_vertex_hash_slot(node, G->pending_size);
+  while (G->pending[slot].edges != NULL) {
+    if (G->pending[slot].node == node) {
+      return slot;
+    }
+    slot = (slot + 1) & (G->pending_size - 1);
+  }
+
+  return -1;
+}
+
+/*
+ * Function: Graph_pending_reserve
+ *
+ * In this function we make room for one more
+ * vertex ID in index of pending incoming edges,
+ * doubling it when it is half full. Done before
+ * Graph is changed so Graph_pending_add can not fail
+ *
+ * Input:
+ *      G <-- Graph
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- On Failure
+ */
+static bool
+Graph_pending_reserve(Graph_t *G) {
+
+  Graph_pending_t     *new_pending;
+  vertex_number_t      new_size;
+  vertex_number_t      iterator;
+  vertex_number_t      slot;
+
+  if (2 * (G->pending_count + 1) <= G->pending_size) {
+    return TRUE;
+  }
+
+  new_size    = G->pending_size ? 2 * G->pending_size : GRAPH_VERTEX_TABLE_MIN;
+  new_pending = (Graph_pending_t *)calloc(new_size, sizeof(Graph_pending_t));
+  if (new_pending == NULL) {
+    LOG_ERR("Unable to grow pending edge index to %d",new_size);
+    return FALSE;
+  }
+  GRAPH_STATS_ALLOC(G->stats, new_size * sizeof(Graph_pending_t));
+
+  for (iterator = 0; iterator < G->pending_size; iterator++) {
+    if (G->pending[iterator].edges == NULL) {
+      continue;
+    }
+    slot = Graph_vertex_hash_slot(G->pending[iterator].node, new_size);
+    while (new_pending[slot].edges != NULL) {
+      slot = (slot + 1) & (new_size - 1);
+    }
+    new_pending[slot] = G->pending[iterator];
+  }
+
+  free(G->pending);
+  G->pending      = new_pending;
+  G->pending_size = new_size;
+
+  return TRUE;
+}
+
+/*
+ * Function: Graph_pending_add
+ *
+ * In this function we keep incoming edge of
+ * vertex ID which is not in the Graph yet.
+ * Graph_pending_reserve must be called before
+ *
+ * Input:
+ *      G <-- Graph
+ *      node <-- Destination of the edge
+ *      reverse <-- Edge whose target is Source
+ * Output:
+ *      none
+ */
+static void
+Graph_pending_add(Graph_t *G, vertex_number_t node, Graph_edges_t *reverse) {
+
+  vertex_number_t      slot;
+
+  slot = Graph_vertex_hash_slot(node, G->pending_size);
+  while (G->pending[slot].edges != NULL && G->pending[slot].node != node) {
+    slot = (slot + 1) & (G->pending_size - 1);
+  }
+
+  if (G->pending[slot].edges == NULL) {
+    G->pending[slot].node = node;
+    G->pending_count++;
+  }
+  reverse->next          = G->pending[slot].edges;
+  G->pending[slot].edges = reverse;
+
+  return;
+}
+
+/*
+ * Function: Graph_pending_delete
+ *
+ * In this function we empty slot of index of
+ * pending incoming edges, with backward shift
+ * deletion as in Graph_unlink_vertex
+ *
+ * Input:
+ *      G <-- Graph
+ *      slot <-- Slot whose edges are gone
+ * Output:
+ *      none
+ */
+static void
+Graph_pending_delete(Graph_t *G, vertex_number_t slot) {
+
+  vertex_number_t      mask = G->pending_size - 1;
+  vertex_number_t      hole = slot;
+  vertex_number_t      home;
+
+  for (slot = (slot + 1) & mask; G->pending[slot].edges != NULL;
+       slot = (slot + 1) & mask) {
+    home = Graph_vertex_hash_slot(G->pending[slot].node, G->pending_size);
+    if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+      G->pending[hole] = G->pending[slot];
+      hole = slot;
+    }
+  }
+  G->pending[hole].edges = NULL;
+  G->pending_count--;
+
+  return;
+}
+
+/*
+ * Function: Graph_pending_clear
+ *
+ * In this function we drop every pending
+ * incoming edge (reverse adjacency switched off),
+ * index keeps its memory
+ *
+ * Input:
+ *      G <-- Graph
+ * Output:
+ *      none
+ */
+static void
+Graph_pending_clear(Graph_t *G) {
+
+  Graph_edges_t       *edge;
+  Graph_edges_t       *next;
+  vertex_number_t      slot;
+
+  for (slot = 0; slot < G->pending_size && G->pending_count > 0; slot++) {
+    for (edge = G->pending[slot].edges; edge != NULL; edge = next) {
+      next = edge->next;
+      Graph_slab_free(&G->edge_slab, edge);
+    }
+    if (G->pending[slot].edges != NULL) {
+      G->pending[slot].edges = NULL;
+      G->pending_count--;
+    }
+  }
+
+  return;
+}
+
+/*
+ * Function: Graph_resolve_pending_edges
+ *
+ * In this function we give vertex just added
+ * incoming edges of edges which were added towards
+ * its ID before it existed. Only its own pending
+ * edges are looked at, so cost is their number.
+ * Registered shortest path trees are repaired as
+ * if the edges were added now
+ *
+ * Input:
+ *      G <-- Graph with reverse adjacency
+ *      vertex <-- Vertex just added
+ * Output:
+ *      none
+ */
+static void
+Graph_resolve_pending_edges(Graph_t *G, Graph_vertices_t *vertex) {
+
+  Graph_vertices_t    *source;
+  Graph_edges_t       *edge;
+  Graph_edges_t       *next;
+  vertex_number_t      slot;
+
+  slot = Graph_pending_slot(G, vertex->interface_number);
+  if (slot < 0) {
+    return;
+  }
+
+  edge = G->pending[slot].edges;
+  Graph_pending_delete(G, slot);
+
+  for (; edge != NULL; edge = next) {
+    next = edge->next;
+    Graph_link_reverse_edge(vertex, edge);
+
+    if (G->sssp_trees != NULL &&
+        (source = Graph_get_vertex(G, edge->target)) != NULL) {
+      Graph_sssp_edge_changed(G, source, vertex, GRAPH_INFINITE_DISTANCE,
+                              edge->weight);
+    }
+  }
+
+  return;
+}
+
+/*
+ * Function: Graph_incoming_edges
+ *
+ * In this function we find list holding incoming
+ * edges of Destination: its reverse_list, or its
+ * pending edges if it is not in the Graph yet
+ *
+ * Input:
+ *      G <-- Graph with reverse adjacency
+ *      D <-- Destination
+ *      slot <-- Pending slot, -1 if Destination exists (Output)
+ * Output:
+ *      Graph_edges_t ** (head of list) or NULL
+ */
+static Graph_edges_t **
+Graph_incoming_edges(Graph_t *G, vertex_number_t D, vertex_number_t *slot) {
+
+  Graph_vertices_t    *target;
+
+  target = Graph_get_vertex(G, D);
+  if (target != NULL) {
+    *slot = -1;
+    return &target->reverse_list;
+  }
+
+  *slot = Graph_pending_slot(G, D);
+  if (*slot < 0) {
+    return NULL;
+  }
+
+  return &G->pending[*slot].edges;
+}
+
 /* Function: Graph_append_edge
  * In this function we add edges
  * to a Specifc Graph
@@ -264,32 +814,68 @@ Graph_t *
 Graph_append_edge(Graph_t *G, vertex_number_t S, vertex_number_t D,
                   edge_weight_t weight) {
 
-  Graph_edges_t       *new_edge;
+  Graph_edges_t       *new_edge = NULL;
+  Graph_edges_t       *reverse  = NULL;
   Graph_vertices_t    *vertex;
-  int                  found = 0;
+  Graph_vertices_t    *target   = NULL;
+
+  vertex  = Graph_get_vertex(G, S);
+  if (vertex == NULL) {
+    LOG_ERR("Unable to find vertex: %d",S);
+    goto destroy;
+  }
 
-  new_edge   =  Graph_add_edge_template(D, weight);
+  new_edge   =  Graph_add_edge_template(G, D, weight);
   if (new_edge == NULL) {
     LOG_ERR("Unable to Create edge Template for Source %d - Destination %d\n",S,D);
     goto destroy;
   }
 
-  vertex  = Graph_get_vertex(G, S);
-  if (vertex == NULL) {
-    LOG_ERR("Unable to find vertex: %d",S);
+  /* Edges towards unknown vertices keep reverse edge till vertex is added */
+  target = Graph_get_vertex(G, D);
+  if (G->reverse_adjacency) {
+    reverse = Graph_add_edge_template(G, S, weight);
+    if (reverse == NULL) {
+      LOG_ERR("Unable to add reverse edge for Source %d - Destination %d",S,D);
+      goto destroy;
+    }
+    if (target == NULL && !Graph_pending_reserve(G)) {
+      goto destroy;
+    }
+  }
+
+  if (G->sorted_adjacency && !Graph_sorted_insert(vertex, D)) {
     goto destroy;
   }
 
   /* If we are unable to add certain edge, Notify User
    * and Proceed to execute further
    */
-  vertex->adjacency_list = Graph_add_edge_to_vertex(vertex->adjacency_list, new_edge);
+  Graph_add_edge_to_vertex(vertex, new_edge);
+  G->total_edges++;
+  Graph_note_weight(G, weight);
+
+  if (reverse != NULL && target != NULL) {
+    Graph_link_reverse_edge(target, reverse);
+  } else if (reverse != NULL) {
+    Graph_pending_add(G, D, reverse);
+  }
+
+  if (G->edge_index != NULL) {
+    Graph_edge_index_insert(G, S, D);
+  }
+
+  if (G->sssp_trees != NULL && target != NULL) {
+    Graph_sssp_edge_changed(G, vertex, target, GRAPH_INFINITE_DISTANCE, weight);
+  }
 
   return G;
 
 destroy:
-  free(vertex);
-  free(new_edge);
+  /* Vertex stays with the Graph, only unlinked edges are released */
+  Graph_slab_free(&G->edge_slab, new_edge);
+  Graph_slab_free(&G->edge_slab, reverse);
+  return G;
 }
       
 /*
@@ -304,20 +890,539 @@ destroy:
  *      Destination <-- 
  *      is_directed <-- if then add to specific one vertices
  *                      else add to both vertices
- *                     
+ *                     
+ */
+Graph_t *
+Graph_add_edge(Graph_t *G, vertex_number_t S, vertex_number_t D,  
+                edge_weight_t weight, bool is_directed) {
+
+  
+  G = Graph_append_edge(G,S,D,weight);
+
+  if (!is_directed) {
+    G = Graph_append_edge(G,D,S,weight);
+  }
+
+  return G;
+}
+
+/*
+ * Function: Graph_find_reverse_edge
+ *
+ * In this function we find incoming edge
+ * coming from Source, preferring one with
+ * given weight since parallel edges may differ in it
+ *
+ * Input:
+ *      list <-- Incoming edges of Destination
+ *      S <-- Source of the edge
+ *      weight <-- Weight of the edge
+ *      previous <-- Edge before it in list (Output)
+ * Output:
+ *      Graph_edges_t (incoming edge) or NULL
+ */
+static Graph_edges_t *
+Graph_find_reverse_edge(Graph_edges_t *list, vertex_number_t S,
+                        edge_weight_t weight, Graph_edges_t **previous) {
+
+  Graph_edges_t       *edge;
+  Graph_edges_t       *before = NULL;
+  Graph_edges_t       *found  = NULL;
+
+  *previous = NULL;
+  for (edge = list; edge != NULL; before = edge, edge = edge->next) {
+    if (edge->target != S) {
+      continue;
+    }
+    if (found == NULL || edge->weight == weight) {
+      found     = edge;
+      *previous = before;
+    }
+    if (edge->weight == weight) {
+      break;
+    }
+  }
+
+  return found;
+}
+
+/*
+ * Function: Graph_unlink_reverse_edge
+ *
+ * In this function we remove incoming edge of
+ * Source to Destination edge which is going away,
+ * from reverse_list of Destination or from its
+ * pending edges
+ *
+ * Input:
+ *      G <-- Graph with reverse adjacency
+ *      S <-- Source of the edge
+ *      D <-- Destination of the edge
+ *      weight <-- Weight of the edge
+ * Output:
+ *      none
+ */
+static void
+Graph_unlink_reverse_edge(Graph_t *G, vertex_number_t S, vertex_number_t D,
+                          edge_weight_t weight) {
+
+  Graph_edges_t      **list;
+  Graph_edges_t       *reverse;
+  Graph_edges_t       *previous;
+  vertex_number_t      slot;
+
+  list = Graph_incoming_edges(G, D, &slot);
+  if (list == NULL) {
+    return;
+  }
+
+  reverse = Graph_find_reverse_edge(*list, S, weight, &previous);
+  if (reverse == NULL) {
+    return;
+  }
+
+  if (previous == NULL) {
+    *list = reverse->next;
+  } else {
+    previous->next = reverse->next;
+  }
+  Graph_slab_free(&G->edge_slab, reverse);
+
+  if (slot >= 0 && G->pending[slot].edges == NULL) {
+    Graph_pending_delete(G, slot);
+  }
+
+  return;
+}
+
+/*
+ * Function: Graph_detach_edge
+ *
+ * In this function we remove first edge from
+ * vertex towards Destination with everything kept
+ * about it: incoming edge of Destination, sorted
+ * neighbors and edge index (if no parallel edge is
+ * left). Edge memory goes back to the slab
+ *
+ * Input:
+ *      G <-- Graph
+ *      vertex <-- Source vertex
+ *      D <-- Destination
+ * Output:
+ *      bool True  <-- If edge was removed
+ *           False <-- If there is no such edge
+ */
+static bool
+Graph_detach_edge(Graph_t *G, Graph_vertices_t *vertex, vertex_number_t D) {
+
+  Graph_edges_t       *edge;
+  Graph_edges_t       *previous = NULL;
+  Graph_edges_t       *runner;
+  Graph_vertices_t    *target;
+  bool                 parallel = FALSE;
+
+  for (edge = vertex->adjacency_list; edge != NULL; edge = edge->next) {
+    if (edge->target == D) {
+      break;
+    }
+    previous = edge;
+  }
+
+  if (edge == NULL) {
+    return FALSE;
+  }
+
+  if (previous == NULL) {
+    vertex->adjacency_list = edge->next;
+  } else {
+    previous->next = edge->next;
+  }
+  if (vertex->adjacency_tail == edge) {
+    vertex->adjacency_tail = previous;
+  }
+  vertex->degree--;
+  G->total_edges--;
+
+  if (G->reverse_adjacency) {
+    Graph_unlink_reverse_edge(G, vertex->interface_number, D, edge->weight);
+  }
+
+  if (G->sorted_adjacency) {
+    Graph_sorted_remove(vertex, D);
+  }
+
+  if (G->edge_index != NULL) {
+    for (runner = edge->next; runner != NULL && !parallel; runner = runner->next) {
+      parallel = (runner->target == D);
+    }
+    if (!parallel) {
+      Graph_edge_index_remove(G, vertex->interface_number, D);
+    }
+  }
+
+  if (G->sssp_trees != NULL && (target = Graph_get_vertex(G, D)) != NULL) {
+    Graph_sssp_edge_changed(G, vertex, target, edge->weight,
+                            GRAPH_INFINITE_DISTANCE);
+  }
+
+  Graph_slab_free(&G->edge_slab, edge);
+
+  return TRUE;
+}
+
+/*
+ * Function: Graph_remove_edge
+ *
+ * This function is the API for removing
+ * Edge. One edge is removed per direction,
+ * parallel edges added more than once stay.
+ * Adjacency list of Source is scanned, so cost
+ * is O(degree), sorted neighbors are searched in
+ * O(log degree) and edge index is updated in
+ * amortized O(1)
+ *
+ * Input:
+ *      G <-- Graph
+ *      S <-- Source
+ *      D <-- Destination
+ *      is_directed <-- if then remove only Source to Destination
+ *                      else both directions
+ * Output:
+ *      bool True  <-- If Source to Destination edge was removed
+ *           False <-- If there is no such edge
+ */
+bool
+Graph_remove_edge(Graph_t *G, vertex_number_t S, vertex_number_t D,
+                  bool is_directed) {
+
+  Graph_vertices_t    *source;
+  Graph_vertices_t    *destination;
+
+  if (G == NULL) {
+    LOG_ERR("Provided Graph is NULL");
+    return FALSE;
+  }
+
+  source = Graph_get_vertex(G, S);
+  if (source == NULL || !Graph_detach_edge(G, source, D)) {
+    return FALSE;
+  }
+
+  if (!is_directed && (destination = Graph_get_vertex(G, D)) != NULL) {
+    Graph_detach_edge(G, destination, S);
+  }
+
+  return TRUE;
+}
+
+/*
+ * Function: Graph_reweight_edge
+ *
+ * In this function we change weight of first
+ * edge from vertex towards Destination, along with
+ * its incoming edge
+ */
+static bool
+Graph_reweight_edge(Graph_t *G, Graph_vertices_t *vertex, vertex_number_t D,
+                    edge_weight_t weight) {
+
+  Graph_edges_t       *edge;
+  Graph_edges_t      **list;
+  Graph_edges_t       *reverse;
+  Graph_edges_t       *previous;
+  Graph_vertices_t    *target;
+  edge_weight_t        old_weight;
+  vertex_number_t      slot;
+
+  for (edge = vertex->adjacency_list; edge != NULL; edge = edge->next) {
+    if (edge->target == D) {
+      break;
+    }
+  }
+
+  if (edge == NULL) {
+    return FALSE;
+  }
+
+  if (G->reverse_adjacency &&
+      (list = Graph_incoming_edges(G, D, &slot)) != NULL) {
+    reverse = Graph_find_reverse_edge(*list, vertex->interface_number,
+                                      edge->weight, &previous);
+    if (reverse != NULL) {
+      reverse->weight = weight;
+    }
+  }
+
+  old_weight   = edge->weight;
+  edge->weight = weight;
+  Graph_note_weight(G, weight);
+
+  if (G->sssp_trees != NULL && (target = Graph_get_vertex(G, D)) != NULL) {
+    Graph_sssp_edge_changed(G, vertex, target, old_weight, weight);
+  }
+
+  return TRUE;
+}
+
+/*
+ * Function: Graph_update_weight
+ *
+ * This function is the API for changing
+ * weight of an Edge in place, O(degree) of
+ * Source. First edge is changed if there are
+ * parallel ones
+ *
+ * Input:
+ *      G <-- Graph
+ *      S <-- Source
+ *      D <-- Destination
+ *      weight <-- New weight
+ *      is_directed <-- if then change only Source to Destination
+ *                      else both directions
+ * Output:
+ *      bool True  <-- If Source to Destination edge was changed
+ *           False <-- If there is no such edge
+ */
+bool
+Graph_update_weight(Graph_t *G, vertex_number_t S, vertex_number_t D,
+                    edge_weight_t weight, bool is_directed) {
+
+  Graph_vertices_t    *source;
+  Graph_vertices_t    *destination;
+
+  if (G == NULL) {
+    LOG_ERR("Provided Graph is NULL");
+    return FALSE;
+  }
+
+  source = Graph_get_vertex(G, S);
+  if (source == NULL || !Graph_reweight_edge(G, source, D, weight)) {
+    return FALSE;
+  }
+
+  if (!is_directed && (destination = Graph_get_vertex(G, D)) != NULL) {
+    Graph_reweight_edge(G, destination, S, weight);
+  }
+
+  return TRUE;
+}
+
+/*
+ * Function: Graph_enable_reverse_adjacency
+ *
+ * In this function we switch reverse adjacency
+ * of Graph on or off. With it every vertex keeps
+ * its incoming edges too, which backward searches
+ * (bidirectional Dijkstra) walk. Switching it on
+ * builds incoming edges of existing edges, later
+ * edges keep them up to date. Incoming edges of a
+ * vertex ID which does not exist yet are kept in an
+ * index by the ID and move to the vertex once it is
+ * added, in time proportional to their number. It
+ * stays on while shortest path trees are registered
+ * (Graph_sssp_register)
+ *
+ * Input : G <- Graph
+ *         enable <- TRUE / FALSE
+ * Output: bool True  <-- On Success
+ *              False <-- On Failure (Graph is left without it)
+ */
+bool
+Graph_enable_reverse_adjacency(Graph_t *G, bool enable) {
+
+  Graph_vertices_t    *vertex;
+  Graph_vertices_t    *target;
+  Graph_edges_t       *edge;
+  Graph_edges_t       *next;
+  Graph_edges_t       *reverse;
+
+  if (G == NULL) {
+    LOG_ERR("Provided Graph is NULL");
+    return FALSE;
+  }
+
+  /* Registered shortest path trees are repaired through incoming edges */
+  if (G->sssp_trees != NULL) {
+    if (!enable) {
+      LOG_ERR("Reverse adjacency is needed by registered shortest path trees");
+      return FALSE;
+    }
+    return TRUE;
+  }
+
+  if (G->reverse_adjacency) {
+    for (vertex = G->vertices_list; vertex != NULL; vertex = vertex->next) {
+      for (edge = vertex->reverse_list; edge != NULL; edge = next) {
+        next = edge->next;
+        Graph_slab_free(&G->edge_slab, edge);
+      }
+      vertex->reverse_list = NULL;
+    }
+    Graph_pending_clear(G);
+    G->reverse_adjacency = FALSE;
+  }
+
+  if (!enable) {
+    return TRUE;
+  }
+
+  G->reverse_adjacency = TRUE;
+  for (vertex = G->vertices_list; vertex != NULL; vertex = vertex->next) {
+    for (edge = vertex->adjacency_list; edge != NULL; edge = edge->next) {
+      target  = Graph_get_vertex(G, edge->target);
+      reverse = Graph_add_edge_template(G, vertex->interface_number,
+                                        edge->weight);
+      if (reverse == NULL || (target == NULL && !Graph_pending_reserve(G))) {
+        LOG_ERR("Unable to build reverse adjacency");
+        Graph_slab_free(&G->edge_slab, reverse);
+        Graph_enable_reverse_adjacency(G, FALSE);
+        return FALSE;
+      }
+
+      if (target == NULL) {
+        Graph_pending_add(G, edge->target, reverse);
+      } else {
+        Graph_link_reverse_edge(target, reverse);
+      }
+    }
+  }
+
+  return TRUE;
+}
+
+/*
+ * Function: Graph_add_edges_bulk
+ *
+ * This function is the API for adding many
+ * edges at once. Vertices are resolved through
+ * the vertex index and every edge is appended
+ * in O(1), so loading E edges costs O(E)
+ * irrespective of vertex degrees. Every edge is
+ * taken as Graph_add_edge takes it: Destination
+ * not in the Graph yet gets a pending incoming
+ * edge and the edge back (undirected) is left out
+ *
+ * Input:
+ *      G <-- Graph In which we Need to Append the Edges
+ *      src <-- Source of every edge
+ *      dst <-- Destination of every edge
+ *      weight <-- Weight of every edge (NULL for weight 1)
+ *      no_of_edges <-- Entries in src/dst/weight
+ *      is_directed <-- if then add to specific one vertices
+ *                      else add to both vertices
+ * Output:
+ *      edge_index_t <-- No of edges (pairs) added, edges whose
+ *                       Source is unknown are skipped, adding
+ *                       stops at first allocation failure
  */
-Graph_t *
-Graph_add_edge(Graph_t *G, vertex_number_t S, vertex_number_t D,  
-                edge_weight_t weight, bool is_directed) {
+edge_index_t
+Graph_add_edges_bulk(Graph_t *G, const vertex_number_t *src,
+                     const vertex_number_t *dst, const edge_weight_t *weight,
+                     edge_index_t no_of_edges, bool is_directed) {
+
+  Graph_vertices_t    *source;
+  Graph_vertices_t    *destination;
+  Graph_edges_t       *forward;
+  Graph_edges_t       *backward;
+  Graph_edges_t       *reverse_forward;
+  Graph_edges_t       *reverse_backward;
+  edge_weight_t        edge_weight;
+  edge_index_t         iterator;
+  edge_index_t         added = 0;
+  bool                 failed;
+
+  for (iterator = 0; iterator < no_of_edges; iterator++) {
+    source      = Graph_get_vertex(G, src[iterator]);
+    destination = Graph_get_vertex(G, dst[iterator]);
+    if (source == NULL) {
+      LOG_ERR("Unable to find vertex: %d",src[iterator]);
+      continue;
+    }
 
-  
-  G = Graph_append_edge(G,S,D,weight);
+    edge_weight = (weight != NULL) ? weight[iterator] : 1;
 
-  if (!is_directed) {
-    G = Graph_append_edge(G,D,S,weight);
+    forward          = Graph_add_edge_template(G, dst[iterator], edge_weight);
+    backward         = NULL;
+    reverse_forward  = NULL;
+    reverse_backward = NULL;
+    if (!is_directed && destination != NULL) {
+      backward = Graph_add_edge_template(G, src[iterator], edge_weight);
+    }
+    if (G->reverse_adjacency) {
+      reverse_forward = Graph_add_edge_template(G, src[iterator], edge_weight);
+      if (!is_directed && destination != NULL) {
+        reverse_backward = Graph_add_edge_template(G, dst[iterator], edge_weight);
+      }
+    }
+
+    failed = forward == NULL ||
+             (!is_directed && destination != NULL && backward == NULL) ||
+             (G->reverse_adjacency && (reverse_forward == NULL ||
+                                       (backward != NULL && reverse_backward == NULL)));
+    if (failed) {
+      LOG_ERR("Unable to Create edge Template for Source %d - Destination %d",
+              src[iterator],dst[iterator]);
+    } else if (reverse_forward != NULL && destination == NULL) {
+      failed = !Graph_pending_reserve(G);
+    }
+
+    /* Sorted neighbors are appended as is and sorted once at the end */
+    if (!failed && G->sorted_adjacency) {
+      failed = !Graph_sorted_append(source, dst[iterator]);
+      if (!failed && backward != NULL &&
+          !Graph_sorted_append(destination, src[iterator])) {
+        source->neighbors_count--;
+        failed = TRUE;
+      }
+    }
+
+    if (failed) {
+      Graph_slab_free(&G->edge_slab, forward);
+      Graph_slab_free(&G->edge_slab, backward);
+      Graph_slab_free(&G->edge_slab, reverse_forward);
+      Graph_slab_free(&G->edge_slab, reverse_backward);
+      break;
+    }
+
+    Graph_add_edge_to_vertex(source, forward);
+    G->total_edges++;
+    Graph_note_weight(G, forward->weight);
+    if (reverse_forward != NULL && destination != NULL) {
+      Graph_link_reverse_edge(destination, reverse_forward);
+    } else if (reverse_forward != NULL) {
+      Graph_pending_add(G, dst[iterator], reverse_forward);
+    }
+    if (G->edge_index != NULL) {
+      Graph_edge_index_insert(G, src[iterator], dst[iterator]);
+    }
+    if (G->sssp_trees != NULL && destination != NULL) {
+      Graph_sssp_edge_changed(G, source, destination, GRAPH_INFINITE_DISTANCE,
+                              forward->weight);
+    }
+    if (backward != NULL) {
+      Graph_add_edge_to_vertex(destination, backward);
+      G->total_edges++;
+      Graph_note_weight(G, backward->weight);
+      if (reverse_backward != NULL) {
+        Graph_link_reverse_edge(source, reverse_backward);
+      }
+      if (G->edge_index != NULL) {
+        Graph_edge_index_insert(G, dst[iterator], src[iterator]);
+      }
+      if (G->sssp_trees != NULL) {
+        Graph_sssp_edge_changed(G, destination, source, GRAPH_INFINITE_DISTANCE,
+                                backward->weight);
+      }
+    }
+
+    added++;
   }
 
-  return G;
+  if (G->sorted_adjacency) {
+    Graph_sorted_finish(G);
+  }
+
+  return added;
 }
   
 
@@ -327,15 +1432,15 @@ Graph_add_edge(Graph_t *G, vertex_number_t S, vertex_number_t D,
  * In this function we create 
  * single vertex and return it
  *
- * Input : none
+ * Input : G <- Graph owning vertex slab
  * output: Graph_vertices_t object or NULL
  */
 Graph_vertices_t *
-Graph_add_vertices_template() {
+Graph_add_vertices_template(Graph_t *G) {
   
     Graph_vertices_t     *V;
 
-    V = (Graph_vertices_t *)malloc(sizeof(Graph_vertices_t));
+    V = (Graph_vertices_t *)Graph_slab_alloc(&G->vertex_slab);
     if (V == NULL) {
       LOG_ERR("Unable to assign Memory for Vertices");
       goto destroy;
@@ -343,16 +1448,24 @@ Graph_add_vertices_template() {
 
     /* Initialize V with template */
     V->interface_number   = NaN;
+    V->index              = NaN;
     V->is_visited         = FALSE;
     V->adjacency_list     = NULL;
+    V->adjacency_tail     = NULL;
+    V->degree             = 0;
+    V->neighbors          = NULL;
+    V->neighbors_count    = 0;
+    V->neighbors_capacity = 0;
+    V->neighbors_sorted   = TRUE;
+    V->reverse_list       = NULL;
     V->min_distance       = NaN;
     V->next               = NULL;
+    V->prev               = NULL;
 
 
     return V;
 
 destroy:
-    free(V);
     return NULL;
 }
 
@@ -369,50 +1482,181 @@ destroy:
 Graph_vertices_t *
 Graph_add_vertices(Graph_t *G, int no_of_vertices) {
   
-    Graph_vertices_t     *V        = NULL;
     Graph_vertices_t     *runner   = NULL;
     int                   iterator = G->total_vertices;
+    int                   created  = 0;
 
-    V = G->vertices_list;
-
-    while(V != NULL && V->next != NULL) {
-      V = V->next;
-    }
-
-    while(iterator < no_of_vertices + G->total_vertices) {
-      LOG_DEBUG("Memory Appending for vertices %d",iterator);
-      LOG_DEBUG("Total required vertices %d, Present vertices %d",no_of_vertices, G->total_vertices);
+    while(created < no_of_vertices) {
+      /* ID might already be taken by Graph_add_vertex */
+      if (Graph_get_vertex(G, iterator) != NULL) {
+        iterator = iterator + 1;
+        continue;
+      }
 
-      runner  = Graph_add_vertices_template();
+      runner  = Graph_add_vertices_template(G);
       if (runner == NULL) {
         LOG_ERR("Runner is NULL for iterator %d",iterator);
         goto destroy;
       }
 
-      LOG_DEBUG("Appending Vertex with ID:%d",iterator);
       runner->interface_number = iterator;
 
-      if (V == NULL) {
-          V                = runner;
-          G->vertices_list = V;
-      } else {
-          V->next = runner;
-          V       = V->next;
+      if (!Graph_link_vertex(G, runner)) {
+        LOG_ERR("Unable to index vertex %d",iterator);
+        goto destroy;
+      }
+
+      if (G->pending_count > 0) {
+        Graph_resolve_pending_edges(G, runner);
       }
-    
-      runner = runner->next;
 
       iterator = iterator + 1;
+      created  = created + 1;
     }
 
-    G->total_vertices += iterator;
-
     return G->vertices_list;
 
 destroy:
-    free(V);
-    free(runner);
-    return G->vertices_list;;
+    /* Vertices created so far are linked and stay with the Graph */
+    Graph_slab_free(&G->vertex_slab, runner);
+    return G->vertices_list;
+}
+
+/*
+ * Function: Graph_add_vertex
+ *
+ * In this function we create single vertex
+ * with caller chosen ID. IDs need not be
+ * contiguous, sparse IDs are resolved 
+ * through the hash index
+ *
+ * Input : G <- To Which we need to append vertex
+ *         node <- ID of the new vertex
+ * output: Graph_vertices_t object (existing one if
+ *         ID is already present) or NULL
+ */
+Graph_vertices_t *
+Graph_add_vertex(Graph_t *G, vertex_number_t node) {
+
+    Graph_vertices_t     *V;
+
+    V = Graph_get_vertex(G, node);
+    if (V != NULL) {
+      return V;
+    }
+
+    V = Graph_add_vertices_template(G);
+    if (V == NULL) {
+      LOG_ERR("Unable to create vertex %d",node);
+      return NULL;
+    }
+
+    V->interface_number = node;
+
+    if (!Graph_link_vertex(G, V)) {
+      LOG_ERR("Unable to index vertex %d",node);
+      Graph_slab_free(&G->vertex_slab, V);
+      return NULL;
+    }
+
+    if (G->pending_count > 0) {
+      Graph_resolve_pending_edges(G, V);
+    }
+
+    return V;
+}
+
+/*
+ * Function: Graph_remove_vertex
+ *
+ * In this function we remove vertex along with
+ * its outgoing and incoming edges. Last vertex of
+ * the Graph takes over its dense index. With reverse
+ * adjacency incoming edges are found from the vertex,
+ * O(degree) overall, otherwise every adjacency list
+ * is scanned for them, O(V+E)
+ *
+ * Input : G <- Graph
+ *         node <- ID of the vertex
+ * output: bool True  <-- On Success
+ *              False <-- If there is no such vertex
+ */
+bool
+Graph_remove_vertex(Graph_t *G, vertex_number_t node) {
+
+    Graph_vertices_t     *V;
+    Graph_vertices_t     *source;
+    Graph_edges_t        *edge;
+    Graph_edges_t        *next;
+
+    if (G == NULL) {
+      LOG_ERR("Provided Graph is NULL");
+      return FALSE;
+    }
+
+    V = Graph_get_vertex(G, node);
+    if (V == NULL) {
+      return FALSE;
+    }
+
+    if (G->sssp_trees != NULL) {
+      Graph_sssp_vertex_removing(G, V);
+    }
+
+    /* Incoming edges, self loops go with outgoing ones */
+    if (G->reverse_adjacency) {
+      edge = V->reverse_list;
+      while (edge != NULL) {
+        source = (edge->target != node) ? Graph_get_vertex(G, edge->target) : NULL;
+        if (source == NULL || !Graph_detach_edge(G, source, node)) {
+          edge = edge->next;
+          continue;
+        }
+        /* Detach unlinked one incoming edge, maybe this one */
+        edge = V->reverse_list;
+      }
+    } else {
+      for (source = G->vertices_list; source != NULL; source = source->next) {
+        if (source == V) {
+          continue;
+        }
+        while (Graph_detach_edge(G, source, node)) {
+          /* Parallel edges */
+        }
+      }
+    }
+
+    /* Outgoing edges, unlinked first as index may be rebuilt meanwhile */
+    edge = V->adjacency_list;
+    V->adjacency_list = NULL;
+    V->adjacency_tail = NULL;
+    V->degree         = 0;
+    for (; edge != NULL; edge = next) {
+      next = edge->next;
+      if (G->reverse_adjacency && edge->target != node) {
+        Graph_unlink_reverse_edge(G, node, edge->target, edge->weight);
+      }
+      if (G->edge_index != NULL) {
+        Graph_edge_index_remove(G, node, edge->target);
+      }
+      Graph_slab_free(&G->edge_slab, edge);
+      G->total_edges--;
+    }
+
+    for (edge = V->reverse_list; edge != NULL; edge = next) {
+      next = edge->next;
+      Graph_slab_free(&G->edge_slab, edge);
+    }
+
+    free(V->neighbors);
+    Graph_unlink_vertex(G, V);
+    Graph_slab_free(&G->vertex_slab, V);
+
+    if (G->sssp_trees != NULL) {
+      Graph_sssp_vertex_removed(G);
+    }
+
+    return TRUE;
 }
 
 /* 
@@ -442,9 +1686,36 @@ Graph_init_template() {
     G->total_vertices   =   0;
     G->total_edges      =   0;
     G->vertices_list    =   NULL;
+    G->vertices_tail    =   NULL;
     G->source           =   NaN;
     G->is_directed      =   FALSE;
 
+    G->vertex_table      = NULL;
+    G->vertex_table_size = 0;
+    G->vertex_hash       = NULL;
+    G->vertex_hash_size  = 0;
+    G->vertex_hash_count = 0;
+    G->index_table       = NULL;
+    G->index_table_size  = 0;
+    G->heap_type         = GRAPH_HEAP_AUTO;
+    G->max_weight        = 0;
+    G->num_threads       = 0;
+    G->sorted_adjacency  = FALSE;
+    G->edge_index        = NULL;
+    G->reverse_adjacency = FALSE;
+    G->sssp_trees        = NULL;
+    G->pending           = NULL;
+    G->pending_size      = 0;
+    G->pending_count     = 0;
+
+    Graph_slab_init(&G->vertex_slab, sizeof(Graph_vertices_t));
+    Graph_slab_init(&G->edge_slab, sizeof(Graph_edges_t));
+
+    G->stats             = Graph_stats_create();
+    G->vertex_slab.stats = G->stats;
+    G->edge_slab.stats   = G->stats;
+    GRAPH_STATS_ALLOC(G->stats, sizeof(Graph_t));
+
     return G;
 
 destroy:
@@ -475,7 +1746,7 @@ Graph_init(int no_of_vertices, bool is_directed) {
     }
 
     Graph_add_vertices(G, no_of_vertices);
-    if (G->vertices_list  == NULL) {
+    if (G->total_vertices != no_of_vertices) {
       LOG_ERR("Unable to create %d vertices",no_of_vertices);
       goto destroy;
     }
@@ -485,10 +1756,197 @@ Graph_init(int no_of_vertices, bool is_directed) {
     return G;
 
 destroy:
-    free(G);
+    Graph_destroy(G);
     return NULL;
 }
 
+/*
+ * Function: Graph_clear
+ *
+ * In this function we remove all vertices and
+ * edges of Graph but keep its memory (slab blocks,
+ * vertex index) for the next rebuild, so a Graph
+ * reloaded periodically stays at the same footprint.
+ * Settings (directed, heap type, threads) are kept,
+ * registered shortest path trees are recomputed once
+ * read again
+ *
+ * Input : G <- Graph
+ * Output: none
+ */
+void
+Graph_clear(Graph_t *G) {
+
+    if (G == NULL) {
+      return;
+    }
+
+    if (G->sorted_adjacency) {
+      Graph_sorted_release(G);
+    }
+
+    if (G->edge_index != NULL) {
+      Graph_edge_index_clear(G->edge_index);
+    }
+
+    Graph_slab_reset(&G->vertex_slab);
+    Graph_slab_reset(&G->edge_slab);
+
+    if (G->vertex_table != NULL) {
+      memset(G->vertex_table, 0,
+             G->vertex_table_size * sizeof(Graph_vertices_t *));
+    }
+    if (G->vertex_hash != NULL) {
+      memset(G->vertex_hash, 0,
+             G->vertex_hash_size * sizeof(Graph_vertices_t *));
+    }
+    G->vertex_hash_count = 0;
+    if (G->pending != NULL) {
+      memset(G->pending, 0, G->pending_size * sizeof(Graph_pending_t));
+    }
+    G->pending_count     = 0;
+
+    G->vertices_list     = NULL;
+    G->vertices_tail     = NULL;
+    G->total_vertices    = 0;
+    G->total_edges       = 0;
+    G->max_weight        = 0;
+    G->source            = NaN;
+
+    Graph_sssp_invalidate(G);
+
+    return;
+}
+
+/*
+ * Function: Graph_compact
+ *
+ * In this function we tidy Graph after many
+ * removals: edge index is rebuilt without
+ * tombstones and stale Bloom filter bits, sorted
+ * neighbors give back unused memory and max edge
+ * weight (kept as an upper bound while edges go
+ * away) is computed again, so Dijkstra can pick
+ * Dial buckets again. Removals already compact
+ * edge index on their own in amortized O(1), this
+ * is for the rest, O(V+E)
+ *
+ * Input : G <- Graph
+ * Output: bool True  <-- On Success
+ *              False <-- On Failure (edge index is dropped)
+ */
+bool
+Graph_compact(Graph_t *G) {
+
+    Graph_vertices_t    *V;
+    Graph_edges_t       *E;
+    long                 max_weight = 0;
+
+    if (G == NULL) {
+      LOG_ERR("Provided Graph is NULL");
+      return FALSE;
+    }
+
+    for (V = G->vertices_list; V != NULL; V = V->next) {
+      for (E = V->adjacency_list; E != NULL; E = E->next) {
+        if (E->weight < 0) {
+          max_weight = -1;
+        } else if (max_weight >= 0 && E->weight > max_weight) {
+          max_weight = E->weight;
+        }
+      }
+      if (G->sorted_adjacency) {
+        Graph_sorted_shrink(V);
+      }
+    }
+    G->max_weight = max_weight;
+
+    if (G->edge_index != NULL && G->edge_index->removed > 0) {
+      return Graph_edge_index_rebuild(G);
+    }
+
+    return TRUE;
+}
+
+/*
+ * Function: Graph_destroy
+ *
+ * In this function we release Graph along with
+ * all its vertices, edges and registered shortest
+ * path trees. Nodes live in slabs
+ * so cost is proportional to no of slab blocks,
+ * not to no of vertices or edges
+ *
+ * Input : G <- Graph (can be NULL)
+ * Output: none
+ */
+void
+Graph_destroy(Graph_t *G) {
+
+    if (G == NULL) {
+      return;
+    }
+
+    Graph_sssp_release(G);
+
+    if (G->sorted_adjacency) {
+      Graph_sorted_release(G);
+    }
+
+    Graph_disable_edge_index(G);
+
+    Graph_slab_release(&G->vertex_slab);
+    Graph_slab_release(&G->edge_slab);
+
+    free(G->vertex_table);
+    free(G->vertex_hash);
+    free(G->index_table);
+    free(G->pending);
+    free(G->stats);
+    free(G);
+
+    return;
+}
+
+/*
+ * Function: Graph_set_heap_type
+ *
+ * In this function we select priority queue
+ * variant used as frontier by Dijkstra.
+ * GRAPH_HEAP_AUTO (default) uses Dial bucket ring
+ * when max edge weight is at most
+ * GRAPH_HEAP_DIAL_MAX_WEIGHT, else 4-ary heap
+ *
+ * Input : G <- Graph
+ *         type <- GRAPH_HEAP_BINARY / GRAPH_HEAP_QUATERNARY /
+ *                 GRAPH_HEAP_PAIRING / GRAPH_HEAP_RADIX /
+ *                 GRAPH_HEAP_DIAL / GRAPH_HEAP_AUTO
+ * Output: none
+ */
+void
+Graph_set_heap_type(Graph_t *G, Graph_heap_type_t type) {
+
+    G->heap_type = type;
+    return;
+}
+
+/*
+ * Function: Graph_set_num_threads
+ *
+ * In this function we select no of threads
+ * used by parallel API's of the Graph
+ *
+ * Input : G <- Graph
+ *         no_of_threads <- 0 for no of online processors
+ * Output: none
+ */
+void
+Graph_set_num_threads(Graph_t *G, int no_of_threads) {
+
+    G->num_threads = (no_of_threads > 0) ? no_of_threads : 0;
+    return;
+}
+
 
 /*
  * Function
@@ -583,123 +2041,145 @@ Graph_dump_vertices(const Graph_vertices_t *V, bool print_adjacency) {
  
 destroy:
 
-   free(V_parse);
    return;
  }
 
 
-Graph_vertices_t *
-Graph_Dj_get_next_vertex(Graph_t *G, Graph_priority_t *priority_list) {
+/*
+ * Function
+ * Graph_dijkstra_query
+ *
+ * In this function we find shortest distance 
+ * from Source to all the vertices. Graph is only
+ * read, distances, predecessors and frontier live in
+ * the caller owned workspace, so queries on the same
+ * Graph can run concurrently with one workspace each.
+ * Frontier is an indexed min heap (see Graph_set_heap_type)
+ * so every vertex is settled once, O((V+E) log V)
+ *
+ * Input:
+ *       Graph_t * G (Graph)
+ *       Graph_workspace_t * W (capacity >= total_vertices)
+ *       vertex_number_t S (Source)
+ * Output:
+ *       bool True  <-- On Success
+ *            False <-- On Failure
+ */
+bool
+Graph_dijkstra_query(const Graph_t *G, Graph_workspace_t *W,
+                     vertex_number_t S) {
 
-  if (priority_list == NULL) {
-    return NULL;
+  Graph_vertices_t      *vertex;
+  Graph_vertices_t      *target;
+  Graph_edges_t         *adjacency_list;
+  vertex_number_t        index;
+
+  vertex = Graph_get_vertex(G,S);
+  if (vertex == NULL) {
+    LOG_ERR("Unable to find vertex %d",S);
+    return FALSE;
   }
 
-  return Graph_get_vertex(G,priority_list->vertex); 
-}
+  if (W == NULL || W->capacity < G->total_vertices) {
+    LOG_ERR("Workspace can not hold %d vertices",G->total_vertices);
+    return FALSE;
+  }
 
-Graph_priority_t *
-Graph_get_priority_list_template() {
+  Graph_workspace_reset(W);
+  Graph_heap_set_type(W->heap, G->heap_type, G->max_weight);
+  W->source     = vertex->index;
+  GRAPH_STATS_ADD(&W->stats, queries, 1);
 
-  Graph_priority_t      *temp;
+  Graph_workspace_relax(W, vertex->index, -1, 0);
 
-  temp  = (Graph_priority_t *) malloc(sizeof(Graph_priority_t));
-  if (temp == NULL) {
-      LOG_ERR("Unable to allocate memory for new Prio List");
-      goto destroy;
-  }
+  while(!Graph_heap_is_empty(W->heap)) {
+    /* Closest vertex which is not yet settled */
+    GRAPH_STATS_TIMED(&W->stats, heap_pops, frontier_ticks,
+                      index = Graph_heap_pop(W->heap));
+    GRAPH_STATS_ADD(&W->stats, vertices_settled, 1);
+    vertex = G->index_table[index];
 
-  temp->vertex = 0;
-  temp->next   = NULL;
+    /* Relax all edges of the vertex, decreasing key
+     * of targets already in the priority list
+     */
+    GRAPH_STATS_BEGIN(W);
+    adjacency_list = vertex->adjacency_list;
+    while(adjacency_list != NULL) {
+      GRAPH_STATS_TIMED(&W->stats, vertex_lookups, lookup_ticks,
+                        target = Graph_get_vertex(G, adjacency_list->target));
+      if (target == NULL) {
+        LOG_ERR("Unable to find vertex with ID :%d ",adjacency_list->target);
+      } else {
+        Graph_workspace_relax(W, target->index, index,
+                              W->min_distance[index] + adjacency_list->weight);
+      }
+      adjacency_list = adjacency_list->next;
+    }
+    GRAPH_STATS_END(W, relax_ticks);
+  }
 
-  return temp;
+  GRAPH_STATS_MERGE(G, W);
 
-destroy:
-  free(temp);
-  return NULL;
+  return TRUE;
 }
 
+/*
+ * Function
+ * Graph_dijkstra
+ *
+ * In this function we find shortest distance
+ * from Source to all the vertices. Graph is not
+ * modified and nothing is printed, results are written
+ * to caller provided arrays of total_vertices entries
+ * indexed by dense vertex index. Workspace is created
+ * for the call, use Graph_dijkstra_query to reuse one
+ *
+ * Input:
+ *       Graph_t * G (Graph)
+ *       vertex_number_t S (Source)
+ *       long * distance (Output, GRAPH_INFINITE_DISTANCE
+ *                        for unreachable vertices)
+ *       vertex_number_t * predecessor (Output, Vertex ID of
+ *                        previous vertex on shortest path,
+ *                        -1 for Source and unreachable
+ *                        vertices, can be NULL)
+ * Output:
+ *       bool True  <-- On Success
+ *            False <-- On Failure
+ */
 bool
-Graph_Dj_set_min_distance(Graph_t *G,
-                          edge_weight_t weight, 
-                          vertex_number_t vertex_ID) {
+Graph_dijkstra(const Graph_t *G, vertex_number_t S, long *distance,
+               vertex_number_t *predecessor) {
 
-  Graph_vertices_t            *vertex;
+  Graph_workspace_t     *W;
+  vertex_number_t        index;
+  bool                   result;
 
-  vertex  = Graph_get_vertex(G,vertex_ID);
-  if (vertex == NULL) {
-    LOG_ERR("Unable to find vertex with ID :%d ",vertex_ID);
+  if (G == NULL || distance == NULL) {
+    LOG_ERR("Provided Graph or distance array is NULL");
     return FALSE;
   }
 
-
-  if (vertex->min_distance > weight) {
-      vertex->min_distance = weight;
-      return TRUE;
-  }
-
-  return FALSE;
-}
-
-Graph_priority_t *
-Graph_get_priority_list(Graph_t *G,
-                         Graph_priority_t  *priority_list, 
-                          Graph_vertices_t *vertex) {
-
-  Graph_edges_t             *adjacency_list;
-  Graph_priority_t          *prio_runner;
-  Graph_priority_t          *temp;
-
-  /* Need to make sure that vertex sent is proper */
-  assert(vertex);
-
-  adjacency_list  = vertex->adjacency_list;
-  prio_runner     = priority_list;
-
-  while(prio_runner != NULL && prio_runner->next != NULL ) {
-    prio_runner = prio_runner->next;
+  W = Graph_workspace_create(G->total_vertices);
+  if (W == NULL) {
+    LOG_ERR("Unable to create workspace for %d vertices",G->total_vertices);
+    return FALSE;
   }
 
-  while(adjacency_list != NULL) {
-    /* Add to Priority List only if 
-     * vertex distance + weight is less than existing 
-     * new vertex min distance
-     */
-    if (Graph_Dj_set_min_distance(G, 
-                        (vertex->min_distance+adjacency_list->weight),
-                          adjacency_list->target)) {
-      if (!Graph_node_in_priority_list(priority_list, adjacency_list->target)) { 
-        temp  =  Graph_get_priority_list_template(); 
-        temp->vertex = adjacency_list->target;
-        if (priority_list == NULL || prio_runner == NULL) {
-          priority_list = temp;
-          prio_runner   = temp;
-        } else {
-          prio_runner->next = temp;
-          prio_runner   = prio_runner->next;
-        }
-        temp = temp->next;
-      } 
+  result = Graph_dijkstra_query(G, W, S);
+  if (result) {
+    memcpy(distance, W->min_distance, G->total_vertices * sizeof(long));
+    if (predecessor != NULL) {
+      for (index = 0; index < G->total_vertices; index++) {
+        predecessor[index] = W->predecessor[index] < 0 ? -1 :
+                             G->index_table[W->predecessor[index]]->interface_number;
+      }
     }
-    adjacency_list = adjacency_list->next;
   }
 
-  return priority_list;
-}
-
-Graph_priority_t *
-Graph_Dj_pop_priority_list(Graph_priority_t *priority_list) {
-
-  Graph_priority_t      *runner;
-
-  assert(priority_list);
-  runner = priority_list;
-  priority_list = priority_list->next;
-
-  /* Destroy Unnecessary Node */
-  free(runner);
+  Graph_workspace_destroy(W);
 
-  return priority_list;
+  return result;
 }
 
 /*
@@ -708,7 +2188,9 @@ Graph_Dj_pop_priority_list(Graph_priority_t *priority_list) {
  *
  * In this function we find shortest distance 
  * from Source (argument) to all the vertices
- * and distance
+ * and distance. Result of every vertex (including
+ * the ones left from previous call) is stored in
+ * Graph_vertices_t, Graph_display_graph shows it
  *
  * Input:
  *       Graph_t * G (Graph)
@@ -718,38 +2200,31 @@ Graph_Dj_pop_priority_list(Graph_priority_t *priority_list) {
 void
 Graph_get_dijsktra(Graph_t  *G, vertex_number_t S) {
  
+  Graph_workspace_t     *W;
   Graph_vertices_t      *vertex;
-  Graph_edges_t         *adjacency_list;
-  Graph_priority_t      *priority_list;
 
-  vertex = Graph_get_vertex(G,S);
+  W = Graph_workspace_create(G->total_vertices);
+  if (W == NULL) {
+    LOG_ERR("Unable to create workspace for %d vertices",G->total_vertices);
+    return;
+  }
 
-  if (vertex == NULL) {
-    LOG_ERR("Unable to find vertex %d",S);
+  if (!Graph_dijkstra_query(G, W, S)) {
+    Graph_workspace_destroy(W);
     return;
   }
-  
-  vertex->min_distance = 0;
-  adjacency_list = vertex->adjacency_list;
-  priority_list = Graph_get_priority_list(G, priority_list, vertex);
-
-#ifdef DEBUG
-  Graph_dump_prio_list(priority_list);
-#endif
-
-  while(priority_list != NULL) {
-    /* Return Last vertex from Priority List */
-    vertex = Graph_Dj_get_next_vertex(G, priority_list);
-    /* Pop PriorityList */
-    priority_list = Graph_Dj_pop_priority_list(priority_list);
-    /* Populate min distance for new vertices */
-    priority_list = Graph_get_priority_list(G, priority_list,vertex); 
-#ifdef DEBUG
-    Graph_dump_prio_list(priority_list);
-#endif
-  }
-
-  Graph_display_graph(G);
+
+  for (vertex = G->vertices_list; vertex != NULL; vertex = vertex->next) {
+    if (W->min_distance[vertex->index] == GRAPH_INFINITE_DISTANCE) {
+      vertex->min_distance = NaN;
+      vertex->is_visited   = FALSE;
+    } else {
+      vertex->min_distance = W->min_distance[vertex->index];
+      vertex->is_visited   = TRUE;
+    }
+  }
+
+  Graph_workspace_destroy(W);
 
   return;
 }
@@ -29,6 +29,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <limits.h>
+#include <stdint.h>
+#include <pthread.h>
+#if defined(GRAPH_STATS) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
 
 /*
  * List of typedef
@@ -36,22 +42,169 @@
 typedef struct graph_ Graph_t;
 typedef struct graph_vertices_ Graph_vertices_t;
 typedef struct graph_edges_ Graph_edges_t;
-typedef struct graph_priority_ Graph_priority_t;
+typedef struct graph_heap_ Graph_heap_t;
+typedef struct graph_slab_ Graph_slab_t;
+typedef struct graph_csr_ Graph_csr_t;
+typedef struct graph_workspace_ Graph_workspace_t;
+typedef struct graph_workspace_pool_ Graph_workspace_pool_t;
+typedef struct graph_thread_ Graph_thread_t;
+typedef struct graph_work_queue_ Graph_work_queue_t;
+typedef struct graph_barrier_ Graph_barrier_t;
+typedef struct graph_edge_file_header_ Graph_edge_file_header_t;
+typedef struct graph_snapshot_header_ Graph_snapshot_header_t;
+typedef struct graph_edge_index_ Graph_edge_index_t;
+typedef struct graph_ch_ Graph_ch_t;
+typedef struct graph_ch_header_ Graph_ch_header_t;
+typedef struct graph_mst_ Graph_mst_t;
+typedef struct graph_stats_ Graph_stats_t;
+typedef struct graph_sssp_ Graph_sssp_t;
+typedef struct graph_pending_ Graph_pending_t;
 typedef int vertex_number_t;
 typedef int edge_weight_t;
+typedef long edge_index_t;
 typedef int bool;
 
+/*
+ * Heuristic of A* search, returns estimate of
+ * distance from Vertex (first) to Target (second),
+ * third argument is context given by caller
+ */
+typedef long (*Graph_heuristic_t)(vertex_number_t, vertex_number_t, void *);
+
+/*
+ * Priority queue variants used as
+ * frontier of shortest path algorithms
+ */
+typedef enum graph_heap_type_ {
+    GRAPH_HEAP_BINARY = 0,   /* Binary heap */
+    GRAPH_HEAP_QUATERNARY,   /* 4-ary heap */
+    GRAPH_HEAP_PAIRING,      /* Pairing heap */
+    GRAPH_HEAP_RADIX,        /* Radix heap (monotone keys) */
+    GRAPH_HEAP_DIAL,         /* Dial bucket ring (monotone keys, small weights) */
+    GRAPH_HEAP_AUTO          /* Dial or 4-ary by max edge weight */
+} Graph_heap_type_t;
+
+/*
+ * Edge list file formats
+ */
+typedef enum graph_file_format_ {
+    GRAPH_FORMAT_AUTO = 0,   /* Binary if file starts with magic, else Text */
+    GRAPH_FORMAT_TEXT,       /* "source destination [weight]" per line */
+    GRAPH_FORMAT_BINARY      /* Header followed by int32 records */
+} Graph_file_format_t;
+
+/*
+ * Minimum spanning tree algorithms
+ */
+typedef enum graph_mst_algorithm_ {
+    GRAPH_MST_PRIM = 0,      /* Prim with indexed heap */
+    GRAPH_MST_KRUSKAL,       /* Radix sorted edges and union-find */
+    GRAPH_MST_BORUVKA        /* Parallel Boruvka rounds */
+} Graph_mst_algorithm_t;
+
+/*
+ * Strongly Connected Components algorithms
+ */
+typedef enum graph_scc_algorithm_ {
+    GRAPH_SCC_TARJAN = 0,            /* Iterative Tarjan, one thread */
+    GRAPH_SCC_FORWARD_BACKWARD       /* Parallel trim, forward-backward, coloring */
+} Graph_scc_algorithm_t;
+
+/*
+ * Levels of library messages, a message is
+ * reported if its level is at most the level set
+ * by Graph_set_log_level
+ */
+typedef enum graph_log_level_ {
+    GRAPH_LOG_NONE = 0,      /* Report nothing */
+    GRAPH_LOG_ERR,           /* Failures */
+    GRAPH_LOG_INFO           /* Notes, e.g. empty Graph displayed */
+} Graph_log_level_t;
+
+/*
+ * Receiver of library messages, called with level,
+ * source file, line, formatted message (no newline)
+ * and context given to Graph_set_log_handler
+ */
+typedef void (*Graph_log_handler_t)(Graph_log_level_t, const char *, int,
+                                    const char *, void *);
+
+/*
+ * Graph_slab Structure
+ * Allocator for fixed size Graph nodes.
+ * Objects are carved from blocks growing geometrically,
+ * freed objects are kept for reuse
+ */
+struct graph_slab_ {
+    size_t               object_size;   /* Size of every object */
+    void                *blocks;        /* Most recent block, linked to older ones */
+    char                *cursor;        /* Next unused object of recent block */
+    char                *limit;         /* End of recent block */
+    void                *free_list;     /* Objects returned to slab */
+    void                *spare;         /* Blocks kept by Graph_slab_reset */
+    size_t               block_count;   /* No of blocks */
+    size_t               bytes;         /* Bytes held by blocks */
+    Graph_stats_t       *stats;         /* Counters of owning Graph, or NULL */
+};
+
 /* 
  * This Structure maintains
  * all information regarding Graph
  */
 struct graph_ {
     vertex_number_t      total_vertices; /* To Store total number of vertices */
-    edge_weight_t        total_edges;    /* To Store total number of edges */
+    edge_index_t         total_edges;    /* To Store total number of edges */
     Graph_vertices_t    *vertices_list;  /* To store vertices */
+    Graph_vertices_t    *vertices_tail;  /* Last vertex, to append in O(1) */
     vertex_number_t      source;         /* To Maintain Source Node */
     bool                 is_directed;    /* Set True If Graph is Directed, Else False */
 
+    Graph_vertices_t   **vertex_table;      /* Direct index, vertex_table[ID] */
+    vertex_number_t      vertex_table_size; /* Capacity of vertex_table */
+    Graph_vertices_t   **vertex_hash;       /* Open addressing index for IDs
+                                               which do not fit vertex_table */
+    vertex_number_t      vertex_hash_size;  /* Capacity of vertex_hash (power of 2) */
+    vertex_number_t      vertex_hash_count; /* Vertices stored in vertex_hash */
+    Graph_vertices_t   **index_table;       /* Vertex of every dense index */
+    vertex_number_t      index_table_size;  /* Capacity of index_table */
+
+    Graph_heap_type_t    heap_type;      /* Frontier used by Dijkstra */
+    long                 max_weight;     /* Largest edge weight, -1 once a
+                                            negative weight is added */
+    int                  num_threads;    /* Threads used by parallel API's,
+                                            0 for no of online processors */
+
+    bool                 sorted_adjacency; /* Vertices keep sorted neighbors,
+                                              see Graph_set_sorted_adjacency */
+    Graph_edge_index_t  *edge_index;     /* Edge existence index, NULL if
+                                            not enabled (Graph_enable_edge_index) */
+    bool                 reverse_adjacency; /* Vertices keep incoming edges,
+                                               see Graph_enable_reverse_adjacency */
+
+    Graph_slab_t         vertex_slab;    /* Memory of Graph_vertices_t */
+    Graph_slab_t         edge_slab;      /* Memory of Graph_edges_t */
+
+    Graph_stats_t       *stats;          /* Counters, NULL unless library is
+                                            built with GRAPH_STATS */
+    Graph_sssp_t        *sssp_trees;     /* Shortest path trees repaired on
+                                            every change (Graph_sssp_register) */
+    Graph_pending_t     *pending;        /* Open addressing index of incoming
+                                            edges towards vertex IDs not in the
+                                            Graph yet (with reverse adjacency) */
+    vertex_number_t      pending_size;   /* Capacity of pending (power of 2) */
+    vertex_number_t      pending_count;  /* Vertex IDs stored in pending */
+};
+
+/*
+ * Graph_pending Structure
+ * Incoming edges of a vertex ID which is not
+ * in the Graph yet. They move to reverse_list of
+ * the vertex once it is added
+ */
+struct graph_pending_ {
+    vertex_number_t      node;           /* Vertex ID edges point to */
+    Graph_edges_t       *edges;          /* Incoming edges, target is the source
+                                            vertex. NULL if slot is empty */
 };
 
 /*
@@ -61,6 +214,11 @@ struct graph_ {
  */
 struct graph_vertices_ {
     vertex_number_t         interface_number;     /* To Store Vertex Index(Number) */
+    vertex_number_t         index;          /* Dense position of the vertex in
+                                               the Graph (0 .. total_vertices-1),
+                                               same as interface_number unless
+                                               sparse IDs are used or vertices
+                                               were removed */
 
     bool                    is_visited;     /* To Check whether This 
                                               interface is parsed 
@@ -69,11 +227,24 @@ struct graph_vertices_ {
 
     Graph_edges_t          *adjacency_list; /* To Maintain List of adjacent to 
                                                present vertex */
+    Graph_edges_t          *adjacency_tail; /* Last edge of adjacency_list,
+                                               to append in O(1) */
+    edge_index_t            degree;         /* No of edges in adjacency_list */
+    vertex_number_t        *neighbors;      /* Sorted IDs of adjacency_list targets,
+                                               NULL unless Graph has sorted adjacency */
+    edge_index_t            neighbors_count;    /* Entries in neighbors */
+    edge_index_t            neighbors_capacity; /* Capacity of neighbors */
+    bool                    neighbors_sorted;   /* False while bulk load appends */
+    Graph_edges_t          *reverse_list;   /* Incoming edges, target is the source
+                                               vertex. NULL unless Graph has
+                                               reverse adjacency */
     long                    min_distance;   /* This is used to calculate 
                                                min distance from source to
                                                this vertex
                                             */
     Graph_vertices_t       *next;           /* Pointer to Next Vertex */
+    Graph_vertices_t       *prev;           /* Pointer to Previous Vertex,
+                                               to unlink in O(1) */
 };
 
 /*
@@ -91,25 +262,362 @@ struct graph_edges_ {
     Graph_edges_t         *next;   /* Pointer to next edge */
 };
 
+/*
+ * Radix heap has a bucket for keys equal to last
+ * popped key and one per bit they may differ in
+ */
+#define GRAPH_HEAP_RADIX_BUCKETS  (sizeof(long) * CHAR_BIT + 1)
+
 /* 
- * Graph_priority Structure
- * to maintain Priority List
+ * Graph_heap Structure
+ * to maintain Priority List.
+ * Indexed min heap over elements 0 .. capacity-1
+ * with decrease-key, all arrays are allocated once
+ * (except ring of Dial, sized by Graph_heap_set_type)
+ */
+struct graph_heap_ {
+    Graph_heap_type_t    type;      /* Variant */
+    vertex_number_t      capacity;  /* No of elements heap can hold */
+    vertex_number_t      size;      /* No of elements presently in heap */
+    vertex_number_t      root;      /* Root element (Pairing heap) */
+    long                *key;       /* Key of every element */
+    vertex_number_t     *heap;      /* Heap ordered elements (d-ary),
+                                       scratch while popping (Pairing) */
+    vertex_number_t     *position;  /* Slot of element in heap (bucket for
+                                       Radix / Dial), -1 if absent */
+    vertex_number_t     *child;     /* Leftmost child (Pairing) */
+    vertex_number_t     *sibling;   /* Right sibling (Pairing), next
+                                       in bucket (Radix / Dial) */
+    vertex_number_t     *prev;      /* Left sibling or parent (Pairing),
+                                       previous in bucket (Radix / Dial) */
+    long                 last;      /* Last key popped (Radix / Dial) */
+    long                 span;      /* Buckets in ring (Dial) */
+    vertex_number_t     *ring;      /* Bucket of key % span (Dial) */
+    vertex_number_t      radix[GRAPH_HEAP_RADIX_BUCKETS]; /* Bucket by highest
+                                       bit differing from last (Radix) */
+};
+
+/*
+ * Graph_csr Structure
+ * Immutable Compressed Sparse Row snapshot
+ * of a Graph, built by Graph_freeze.
+ * Row R holds the vertex with dense index R, its neighbors
+ * are stored contiguously in targets[offsets[R] .. offsets[R+1])
+ * along with weights
+ */
+struct graph_csr_ {
+    vertex_number_t      total_vertices; /* Number of rows */
+    edge_index_t         total_edges;    /* Number of stored (directed) edges */
+    bool                 is_directed;    /* Copied from Graph */
+    bool                 is_identity;    /* True if row == vertex ID for all rows */
+    bool                 is_sorted;      /* True if every row is sorted by target */
+    Graph_heap_type_t    heap_type;      /* Frontier used by Dijkstra */
+    long                 max_weight;     /* Largest edge weight, -1 if any
+                                            is negative or not known */
+    int                  num_threads;    /* Threads used by parallel API's */
+    edge_index_t        *offsets;        /* total_vertices + 1 row offsets */
+    vertex_number_t     *targets;        /* Target row of every edge, row by row */
+    edge_weight_t       *weights;        /* Weight of every edge, row by row */
+    vertex_number_t     *vertex_ids;     /* Vertex ID of every row */
+    vertex_number_t     *sorted_rows;    /* Rows sorted by vertex ID, used to
+                                            resolve sparse IDs (NULL if identity) */
+    void                *mapping;        /* Snapshot file the arrays point into,
+                                            NULL if arrays are allocated */
+    size_t               mapping_size;   /* Bytes mapped */
+};
+
+/*
+ * Graph_edge_index Structure
+ * Blocked Bloom filter and hash set over
+ * (source, destination) pairs of a Graph
+ */
+struct graph_edge_index_ {
+    size_t               budget;         /* Max bytes, 0 for no limit */
+    uint64_t            *bloom;          /* bloom_blocks blocks of 8 words */
+    size_t               bloom_blocks;   /* Power of 2 */
+    uint64_t            *set;            /* Packed pairs, NULL if over budget */
+    size_t               set_size;       /* Slots in set (power of 2) */
+    size_t               set_count;      /* Pairs in set */
+    size_t               set_tombstones; /* Slots of removed pairs in set */
+    size_t               removed;        /* Pairs removed since index was
+                                            built, still set in Bloom filter */
+    size_t               planned_edges;  /* Edges index is sized for */
+};
+
+/*
+ * Graph_stats Structure
+ * Counters kept when library is built with GRAPH_STATS,
+ * per Graph (Graph_get_stats) and for last query of a
+ * workspace (Graph_workspace_get_stats). Ticks are TSC
+ * cycles on x86, nanoseconds elsewhere, estimated from
+ * sampled operations
  */
-struct graph_priority_{
-  vertex_number_t      vertex; /* To store vertex information */
-  Graph_priority_t     *next;
+struct graph_stats_ {
+    uint64_t             queries;          /* Searches run */
+    uint64_t             vertices_settled; /* Vertices taken off frontier */
+    uint64_t             edges_relaxed;    /* Distances offered to vertices */
+    uint64_t             distance_updates; /* Offers which lowered a distance */
+    uint64_t             heap_pushes;      /* Inserts and decrease keys */
+    uint64_t             heap_pops;
+    uint64_t             vertex_lookups;   /* Graph_get_vertex calls of searches */
+    uint64_t             allocations;      /* Blocks allocated for Graph */
+    uint64_t             allocated_bytes;
+    uint64_t             frontier_ticks;   /* In heap pushes and pops */
+    uint64_t             lookup_ticks;     /* In vertex lookups */
+    uint64_t             relax_ticks;      /* Scanning edges of settled vertices,
+                                              lookups and pushes included */
+    uint64_t             ticks_per_second; /* Filled in by Graph_get_stats */
 };
 
+/*
+ * Graph_workspace Structure
+ * Per query state of shortest path algorithms.
+ * Graph is only read by queries, so every thread
+ * querying the same Graph needs its own workspace.
+ * Arrays are indexed by dense vertex index (row of CSR)
+ */
+struct graph_workspace_ {
+    vertex_number_t      capacity;      /* No of vertices workspace can serve */
+    vertex_number_t      source;        /* Dense index of source of last query */
+    long                *min_distance;  /* Distance from source,
+                                           GRAPH_INFINITE_DISTANCE if unreachable */
+    vertex_number_t     *predecessor;   /* Previous vertex on shortest path, -1 if none */
+    vertex_number_t     *touched;       /* Vertices reached by last query, so
+                                           that reset is proportional to its work */
+    vertex_number_t      touched_count; /* Entries in touched */
+    Graph_heap_t        *heap;          /* Frontier */
+    Graph_stats_t        stats;         /* Counters of last query */
+    uint64_t             stats_mark;    /* Start of phase being timed */
+};
+
+/*
+ * Graph_workspace_pool Structure
+ * Thread safe pool of reusable workspaces
+ */
+struct graph_workspace_pool_ {
+    pthread_mutex_t      lock;          /* Protects idle list */
+    vertex_number_t      capacity;      /* Capacity of every workspace */
+    int                  max_idle;      /* Max workspaces kept for reuse */
+    int                  idle_count;    /* Workspaces presently idle */
+    Graph_workspace_t  **idle;          /* Idle workspaces */
+};
+
+/*
+ * Graph_sssp Structure
+ * Shortest path tree of a source registered with
+ * Graph_sssp_register, repaired by the Graph on every
+ * edge and vertex change. Arrays are indexed by dense
+ * vertex index
+ */
+struct graph_sssp_ {
+    Graph_t             *graph;         /* Graph the tree follows */
+    vertex_number_t      source;        /* Vertex ID of source */
+    vertex_number_t      capacity;      /* Entries in arrays */
+    long                *distance;      /* Distance from source,
+                                           GRAPH_INFINITE_DISTANCE if unreachable */
+    vertex_number_t     *parent;        /* Previous vertex on shortest path, -1 if none */
+    char                *affected;      /* Set for vertices in queue */
+    vertex_number_t     *queue;         /* Vertices cut off, being repaired */
+    vertex_number_t      queue_count;   /* Entries in queue */
+    Graph_heap_t        *heap;          /* Frontier of repairs */
+    bool                 stale;         /* Tree is recomputed on next read */
+    Graph_sssp_t        *next;          /* Next tree of the Graph */
+};
+
+/*
+ * Graph_thread Structure
+ * Handed to every thread started by Graph_parallel_run
+ */
+struct graph_thread_ {
+    int                  id;            /* 0 .. count-1 */
+    int                  count;         /* No of threads */
+    int                  running;       /* Threads actually started, only
+                                         * valid in thread 0 */
+    void                *shared;        /* Argument shared by all threads */
+};
+
+/*
+ * Cache line size, per thread state is aligned to it
+ * and allocated with Graph_aligned_calloc (released
+ * with Graph_aligned_free)
+ */
+#define GRAPH_CACHE_LINE 64
+
+/*
+ * Graph_work_queue Structure
+ * Range of items owned by a thread, other
+ * threads steal from it once theirs is drained.
+ * Aligned so that queues do not share cache lines
+ */
+struct graph_work_queue_ {
+    long                 next;          /* Next item to hand out */
+    long                 end;           /* End of range */
+} __attribute__((aligned(GRAPH_CACHE_LINE)));
+
+/*
+ * Graph_barrier Structure
+ * Reusable barrier for threads of Graph_parallel_run.
+ * Thread 0 shrinks it to threads actually running
+ * (see Graph_barrier_resize) before its first wait
+ */
+struct graph_barrier_ {
+    pthread_mutex_t      lock;
+    pthread_cond_t       cond;
+    int                  participants;  /* Threads to wait for */
+    int                  arrived;       /* Threads waiting now */
+    unsigned long        generation;    /* Bumped on every release */
+};
+
+/*
+ * Graph_edge_file_header Structure
+ * Start of binary edge list file, followed by
+ * no_of_edges records of int32 source, destination
+ * and (if GRAPH_EDGE_FILE_WEIGHTED) weight
+ */
+struct graph_edge_file_header_ {
+    char                 magic[4];      /* GRAPH_EDGE_FILE_MAGIC */
+    uint32_t             version;       /* GRAPH_EDGE_FILE_VERSION */
+    uint32_t             flags;         /* GRAPH_EDGE_FILE_WEIGHTED */
+    uint32_t             reserved;      /* Zero */
+    uint64_t             no_of_edges;   /* No of records */
+};
+
+#define GRAPH_EDGE_FILE_MAGIC     "GLEL"
+#define GRAPH_EDGE_FILE_VERSION   1
+#define GRAPH_EDGE_FILE_WEIGHTED  0x1
+
+/*
+ * Smallest chunk of input handed to a loader thread
+ */
+#define GRAPH_IO_MIN_CHUNK        (1 << 20)
+
+/*
+ * Graph_snapshot_header Structure
+ * Start of snapshot file written by Graph_csr_save.
+ * CSR arrays follow at section offsets, each aligned
+ * to GRAPH_SNAPSHOT_ALIGN so they can be used in place
+ */
+struct graph_snapshot_header_ {
+    char                 magic[4];          /* GRAPH_SNAPSHOT_MAGIC */
+    uint32_t             version;           /* GRAPH_SNAPSHOT_VERSION */
+    uint32_t             flags;             /* GRAPH_SNAPSHOT_DIRECTED, IDENTITY */
+    uint32_t             endian;            /* 0x01020304 as written by saving machine */
+    uint8_t              vertex_size;       /* sizeof(vertex_number_t) */
+    uint8_t              weight_size;       /* sizeof(edge_weight_t) */
+    uint8_t              index_size;        /* sizeof(edge_index_t) */
+    uint8_t              reserved[5];       /* Zero */
+    uint64_t             total_vertices;    /* Rows */
+    uint64_t             total_edges;       /* Stored (directed) edges */
+    uint64_t             section[5];        /* Offsets of offsets, targets, weights,
+                                               vertex_ids and sorted_rows */
+    uint64_t             file_size;         /* Bytes in file */
+    uint64_t             payload_checksum;  /* Checksum of everything after header */
+    uint64_t             header_checksum;   /* Checksum of header, this field as zero */
+};
+
+#define GRAPH_SNAPSHOT_MAGIC      "GLSN"
+#define GRAPH_SNAPSHOT_VERSION    1
+#define GRAPH_SNAPSHOT_DIRECTED   0x1
+#define GRAPH_SNAPSHOT_IDENTITY   0x2
+#define GRAPH_SNAPSHOT_SORTED     0x4
+#define GRAPH_SNAPSHOT_ALIGN      64
+
+/*
+ * Seed of checksums kept in snapshot files
+ */
+#define GRAPH_CHECKSUM_SEED       14695981039346656037ULL
+
+/*
+ * Graph_ch Structure
+ * Contraction Hierarchy of a Graph, built by
+ * Graph_ch_build. Every vertex has a rank (order of
+ * contraction), shortcut edges stand for paths
+ * through lower ranked vertices. Queries search
+ * upwards from both ends, so they only need edges
+ * towards higher ranked vertices
+ */
+struct graph_ch_ {
+    vertex_number_t      total_vertices; /* Rows of up and down */
+    edge_index_t         shortcuts;      /* Shortcut edges added by contraction */
+    Graph_heap_type_t    heap_type;      /* Frontier used by queries */
+    Graph_csr_t         *up;             /* Row v: edges v -> x with x ranked higher,
+                                            rows carry Vertex IDs of the Graph */
+    Graph_csr_t         *down;           /* Row v: u for every edge u -> v with u
+                                            ranked higher (walked by backward search) */
+};
+
+/*
+ * Graph_mst Structure
+ * Minimum spanning forest returned by Graph_mst,
+ * one tree per connected component of the Graph.
+ * Edges are given by Vertex IDs
+ */
+struct graph_mst_ {
+    long                 total_weight;   /* Sum of weights of edges */
+    edge_index_t         no_of_edges;    /* Edges in forest */
+    vertex_number_t     *source;         /* Source of every edge */
+    vertex_number_t     *destination;    /* Destination of every edge */
+    edge_weight_t       *weight;         /* Weight of every edge */
+};
+
+/*
+ * Graph_ch_header Structure
+ * Start of file written by Graph_ch_save, followed by
+ * vertex IDs and offsets, targets, weights of up and down
+ */
+struct graph_ch_header_ {
+    char                 magic[4];          /* GRAPH_CH_MAGIC */
+    uint32_t             version;           /* GRAPH_CH_VERSION */
+    uint32_t             endian;            /* 0x01020304 as written by saving machine */
+    uint8_t              vertex_size;       /* sizeof(vertex_number_t) */
+    uint8_t              weight_size;       /* sizeof(edge_weight_t) */
+    uint8_t              index_size;        /* sizeof(edge_index_t) */
+    uint8_t              reserved;          /* Zero */
+    uint64_t             total_vertices;    /* Rows */
+    uint64_t             up_edges;          /* Edges of up */
+    uint64_t             down_edges;        /* Edges of down */
+    uint64_t             shortcuts;         /* Shortcut edges */
+    uint64_t             payload_checksum;  /* Checksum of arrays in file order */
+    uint64_t             header_checksum;   /* Checksum of header, this field as zero */
+};
+
+#define GRAPH_CH_MAGIC            "GLCH"
+#define GRAPH_CH_VERSION          1
+
+/*
+ * Witness searches of contraction give up after
+ * settling this many vertices, and do not expand
+ * vertices this many edges away (shortcut is then
+ * added, which is always safe)
+ */
+#define GRAPH_CH_WITNESS_SETTLED  500
+#define GRAPH_CH_WITNESS_HOPS     16
+
+/*
+ * Same limits for witness searches which only
+ * estimate importance of a vertex
+ */
+#define GRAPH_CH_ESTIMATE_SETTLED 128
+#define GRAPH_CH_ESTIMATE_HOPS    5
+
+/*
+ * Messages reported per second by default (see
+ * Graph_set_log_rate_limit), rest are counted and
+ * summarized once next second starts
+ */
+#define GRAPH_LOG_RATE_LIMIT 100
+
+/*
+ * Longest message given to log handler,
+ * longer ones are truncated
+ */
+#define GRAPH_LOG_MESSAGE_MAX 512
+
 /*
  * Following Defines are to Make life easy
  */
-#define LOG_ERR(f_, ...)   printf("%s:%d ERROR: "f_"\n",__FILE__, __LINE__, ## __VA_ARGS__)
-#define LOG_INFO(f_, ...)  printf("%s:%d INFO:  "f_"\n",__FILE__, __LINE__, ## __VA_ARGS__)
-#ifdef DEBUG
-#define LOG_DEBUG(f_, ...) printf("%s:%d DEBUG: "f_"\n",__FILE__, __LINE__, ## __VA_ARGS__)
-#else
-#define LOG_DEBUG(f_, ...)
-#endif /* DEBUG */
+#define LOG_ERR(f_, ...)   Graph_log(GRAPH_LOG_ERR, __FILE__, __LINE__, f_, ## __VA_ARGS__)
+#define LOG_INFO(f_, ...)  Graph_log(GRAPH_LOG_INFO, __FILE__, __LINE__, f_, ## __VA_ARGS__)
 #define FALSE 0
 #define TRUE  1
 
@@ -119,6 +627,98 @@ struct graph_priority_{
  */
 #define NaN     32767
 
+/*
+ * Hot path counters, see Graph_stats_t. Without
+ * GRAPH_STATS all of them compile to nothing (timed
+ * statements are left as they are). Reading the clock
+ * costs as much as a heap operation, so only one in
+ * GRAPH_STATS_SAMPLE operations (and edge scans) is timed
+ * and its ticks are scaled up
+ */
+#define GRAPH_STATS_SAMPLE               64
+#ifdef GRAPH_STATS
+#if defined(__x86_64__) || defined(__i386__)
+#define GRAPH_STATS_CLOCK()              ((uint64_t)__rdtsc())
+#else
+#define GRAPH_STATS_CLOCK()              Graph_stats_clock()
+#endif
+#define GRAPH_STATS_ADD(S_, field_, n_)  ((S_)->field_ += (n_))
+#define GRAPH_STATS_TIMED(S_, counter_, ticks_, ...)                          \
+    do {                                                                      \
+      if ((S_)->counter_++ % GRAPH_STATS_SAMPLE == 0) {                       \
+        uint64_t graph_stats_start_ = GRAPH_STATS_CLOCK();                    \
+        __VA_ARGS__;                                                          \
+        (S_)->ticks_ += (GRAPH_STATS_CLOCK() - graph_stats_start_) *          \
+                        GRAPH_STATS_SAMPLE;                                   \
+      } else {                                                                \
+        __VA_ARGS__;                                                          \
+      }                                                                       \
+    } while (0)
+/* Edge scans are sampled by vertices settled, 1st one included */
+#define GRAPH_STATS_BEGIN(W_)                                                 \
+    ((W_)->stats_mark = (W_)->stats.vertices_settled % GRAPH_STATS_SAMPLE == 1 \
+                        ? GRAPH_STATS_CLOCK() : 0)
+#define GRAPH_STATS_END(W_, ticks_)                                           \
+    do {                                                                      \
+      if ((W_)->stats_mark != 0) {                                            \
+        (W_)->stats.ticks_ += (GRAPH_STATS_CLOCK() - (W_)->stats_mark) *      \
+                              GRAPH_STATS_SAMPLE;                             \
+      }                                                                       \
+    } while (0)
+#define GRAPH_STATS_ALLOC(S_, bytes_)                                         \
+    do {                                                                      \
+      if ((S_) != NULL) {                                                     \
+        (S_)->allocations     += 1;                                           \
+        (S_)->allocated_bytes += (bytes_);                                    \
+      }                                                                       \
+    } while (0)
+#define GRAPH_STATS_MERGE(G_, W_)                                             \
+    do {                                                                      \
+      if ((G_)->stats != NULL) {                                              \
+        Graph_stats_merge((G_)->stats, &(W_)->stats);                         \
+      }                                                                       \
+    } while (0)
+#else
+#define GRAPH_STATS_ADD(S_, field_, n_)              ((void)0)
+#define GRAPH_STATS_TIMED(S_, counter_, ticks_, ...) do { __VA_ARGS__; } while (0)
+#define GRAPH_STATS_BEGIN(W_)                        ((void)0)
+#define GRAPH_STATS_END(W_, ticks_)                  ((void)0)
+#define GRAPH_STATS_ALLOC(S_, bytes_)                ((void)0)
+#define GRAPH_STATS_MERGE(G_, W_)                    ((void)0)
+#endif /* GRAPH_STATS */
+
+/*
+ * Distance reported for vertices which are
+ * not reachable from the source
+ */
+#define GRAPH_INFINITE_DISTANCE LONG_MAX
+
+/*
+ * Minimum capacity of the direct vertex index.
+ * Vertex IDs beyond twice the capacity (plus this slack)
+ * are considered sparse and are kept in the hash index
+ */
+#define GRAPH_VERTEX_TABLE_MIN  64
+
+/*
+ * No of objects in first and largest slab block
+ */
+#define GRAPH_SLAB_MIN_OBJECTS  64
+#define GRAPH_SLAB_MAX_OBJECTS  65536
+
+/*
+ * Sorted neighbor lists up to this length are
+ * scanned (with SIMD compares) instead of bisected
+ */
+#define GRAPH_SORTED_SCAN_MAX   32
+
+/*
+ * Largest edge weight for which Dial bucket ring
+ * is used, scanning its empty buckets costs more
+ * than heap operations above it
+ */
+#define GRAPH_HEAP_DIAL_MAX_WEIGHT 4096
+
 /*
  * API Declaration
  */
@@ -126,21 +726,327 @@ struct graph_priority_{
 Graph_t*  
 Graph_init(int, bool);
 
+void
+Graph_destroy(Graph_t *);
+
+void
+Graph_clear(Graph_t *);
+
 Graph_vertices_t* 
 Graph_add_vertices(Graph_t*, int);
 
+Graph_vertices_t *
+Graph_add_vertex(Graph_t *, vertex_number_t);
+
 void      
 Graph_display_graph(const Graph_t *);
 
 Graph_t *
 Graph_add_edge(Graph_t *, vertex_number_t, vertex_number_t, edge_weight_t , bool);
 
+edge_index_t
+Graph_add_edges_bulk(Graph_t *, const vertex_number_t *, const vertex_number_t *,
+                     const edge_weight_t *, edge_index_t, bool);
+
+bool
+Graph_remove_edge(Graph_t *, vertex_number_t, vertex_number_t, bool);
+
+bool
+Graph_update_weight(Graph_t *, vertex_number_t, vertex_number_t, edge_weight_t, bool);
+
+bool
+Graph_remove_vertex(Graph_t *, vertex_number_t);
+
+bool
+Graph_compact(Graph_t *);
+
 void
 Graph_get_dijsktra(Graph_t *, vertex_number_t );
 
+bool
+Graph_dijkstra(const Graph_t *, vertex_number_t, long *, vertex_number_t *);
+
 bool
 Graph_has_edge(Graph_t *, vertex_number_t , vertex_number_t);
 
+void
+Graph_set_heap_type(Graph_t *, Graph_heap_type_t);
+
+void
+Graph_set_num_threads(Graph_t *, int);
+
+bool
+Graph_set_sorted_adjacency(Graph_t *, bool);
+
+bool
+Graph_enable_edge_index(Graph_t *, size_t);
+
+void
+Graph_disable_edge_index(Graph_t *);
+
+bool
+Graph_enable_reverse_adjacency(Graph_t *, bool);
+
+/*
+ * Reentrant Query API Declaration
+ */
+Graph_workspace_t *
+Graph_workspace_create(vertex_number_t);
+
+void
+Graph_workspace_destroy(Graph_workspace_t *);
+
+void
+Graph_workspace_reset(Graph_workspace_t *);
+
+bool
+Graph_dijkstra_query(const Graph_t *, Graph_workspace_t *, vertex_number_t);
+
+long
+Graph_workspace_get_distance(const Graph_t *, const Graph_workspace_t *,
+                             vertex_number_t);
+
+vertex_number_t
+Graph_workspace_get_predecessor(const Graph_t *, const Graph_workspace_t *,
+                                vertex_number_t);
+
+Graph_workspace_pool_t *
+Graph_workspace_pool_create(vertex_number_t, int);
+
+Graph_workspace_t *
+Graph_workspace_pool_acquire(Graph_workspace_pool_t *);
+
+void
+Graph_workspace_pool_release(Graph_workspace_pool_t *, Graph_workspace_t *);
+
+void
+Graph_workspace_pool_destroy(Graph_workspace_pool_t *);
+
+/*
+ * Point to Point Shortest Path API Declaration
+ */
+vertex_number_t
+Graph_shortest_path(const Graph_t *, vertex_number_t, vertex_number_t,
+                    long *, vertex_number_t *);
+
+vertex_number_t
+Graph_shortest_path_query(const Graph_t *, Graph_workspace_t *, Graph_workspace_t *,
+                          vertex_number_t, vertex_number_t, long *, vertex_number_t *);
+
+vertex_number_t
+Graph_astar(const Graph_t *, vertex_number_t, vertex_number_t, Graph_heuristic_t,
+            void *, long *, vertex_number_t *, long *);
+
+vertex_number_t
+Graph_astar_query(const Graph_t *, Graph_workspace_t *, vertex_number_t,
+                  vertex_number_t, Graph_heuristic_t, void *, long *,
+                  vertex_number_t *, long *);
+
+/*
+ * Dynamic Shortest Path API Declaration
+ */
+Graph_sssp_t *
+Graph_sssp_register(Graph_t *, vertex_number_t);
+
+void
+Graph_sssp_unregister(Graph_sssp_t *);
+
+bool
+Graph_sssp_refresh(Graph_sssp_t *);
+
+long
+Graph_sssp_distance(Graph_sssp_t *, vertex_number_t);
+
+vertex_number_t
+Graph_sssp_predecessor(Graph_sssp_t *, vertex_number_t);
+
+/*
+ * Contraction Hierarchies API Declaration
+ */
+Graph_ch_t *
+Graph_ch_build(const Graph_t *);
+
+void
+Graph_ch_destroy(Graph_ch_t *);
+
+long
+Graph_ch_query(const Graph_ch_t *, Graph_workspace_t *, Graph_workspace_t *,
+               vertex_number_t, vertex_number_t);
+
+long
+Graph_ch_distance(const Graph_ch_t *, vertex_number_t, vertex_number_t);
+
+bool
+Graph_ch_save(const Graph_ch_t *, const char *);
+
+Graph_ch_t *
+Graph_ch_load(const char *);
+
+/*
+ * Minimum Spanning Tree API Declaration
+ */
+Graph_mst_t *
+Graph_mst(const Graph_t *, Graph_mst_algorithm_t);
+
+void
+Graph_mst_destroy(Graph_mst_t *);
+
+/*
+ * Logging API Declaration
+ */
+void
+Graph_set_log_handler(Graph_log_handler_t, void *);
+
+void
+Graph_set_log_level(Graph_log_level_t);
+
+void
+Graph_set_log_rate_limit(unsigned int);
+
+/*
+ * Statistics API Declaration
+ */
+bool
+Graph_get_stats(const Graph_t *, Graph_stats_t *);
+
+void
+Graph_reset_stats(Graph_t *);
+
+bool
+Graph_workspace_get_stats(const Graph_workspace_t *, Graph_stats_t *);
+
+/*
+ * Breadth First Search API Declaration
+ */
+bool
+Graph_bfs(const Graph_t *, vertex_number_t, long *, vertex_number_t *);
+
+bool
+Graph_csr_bfs(const Graph_csr_t *, const Graph_csr_t *, vertex_number_t,
+              long *, vertex_number_t *);
+
+/*
+ * Components API Declaration
+ */
+vertex_number_t
+Graph_connected_components(const Graph_t *, vertex_number_t *);
+
+vertex_number_t
+Graph_csr_connected_components(const Graph_csr_t *, vertex_number_t *);
+
+vertex_number_t
+Graph_strongly_connected_components(const Graph_t *, Graph_scc_algorithm_t,
+                                    vertex_number_t *);
+
+vertex_number_t
+Graph_csr_strongly_connected_components(const Graph_csr_t *, const Graph_csr_t *,
+                                        Graph_scc_algorithm_t, vertex_number_t *);
+
+/*
+ * Edge List File API Declaration
+ */
+Graph_t *
+Graph_load_edge_list(const char *, Graph_file_format_t, bool);
+
+Graph_csr_t *
+Graph_csr_load_edge_list(const char *, Graph_file_format_t, bool);
+
+bool
+Graph_write_edge_list(const Graph_t *, const char *, Graph_file_format_t);
+
+/*
+ * Snapshot API Declaration
+ */
+bool
+Graph_save(const Graph_t *, const char *);
+
+bool
+Graph_csr_save(const Graph_csr_t *, const char *);
+
+Graph_csr_t *
+Graph_open_mmap(const char *);
+
+bool
+Graph_csr_verify(const Graph_csr_t *);
+
+/*
+ * Parallel Batch API Declaration
+ */
+bool
+Graph_multi_source_dijkstra(const Graph_t *, const vertex_number_t *, int, long *);
+
+bool
+Graph_csr_multi_source_dijkstra(const Graph_csr_t *, const vertex_number_t *,
+                                int, long *);
+
+void
+Graph_get_delta_stepping(Graph_t *, vertex_number_t, long);
+
+bool
+Graph_delta_stepping(const Graph_t *, vertex_number_t, long, long *);
+
+bool
+Graph_csr_delta_stepping(const Graph_csr_t *, vertex_number_t, long, long *);
+
+/*
+ * Compressed Sparse Row (CSR) API Declaration
+ */
+Graph_csr_t *
+Graph_freeze(const Graph_t *);
+
+Graph_csr_t *
+Graph_csr_from_edges(vertex_number_t, const vertex_number_t *,
+                     const vertex_number_t *, const edge_weight_t *,
+                     edge_index_t, bool);
+
+void
+Graph_csr_destroy(Graph_csr_t *);
+
+bool
+Graph_csr_has_edge(const Graph_csr_t *, vertex_number_t, vertex_number_t);
+
+bool
+Graph_csr_get_dijsktra(const Graph_csr_t *, vertex_number_t, long *);
+
+bool
+Graph_csr_dijkstra_query(const Graph_csr_t *, Graph_workspace_t *, vertex_number_t);
+
+void
+Graph_csr_display_graph(const Graph_csr_t *, const long *);
+
+Graph_csr_t *
+Graph_csr_transpose(const Graph_csr_t *);
+
+/*
+ * Priority Queue Declarations
+ */
+Graph_heap_t *
+Graph_heap_create(vertex_number_t, Graph_heap_type_t);
+
+void
+Graph_heap_destroy(Graph_heap_t *);
+
+void
+Graph_heap_push(Graph_heap_t *, vertex_number_t, long);
+
+vertex_number_t
+Graph_heap_pop(Graph_heap_t *);
+
+bool
+Graph_heap_contains(const Graph_heap_t *, vertex_number_t);
+
+bool
+Graph_heap_is_empty(const Graph_heap_t *);
+
+long
+Graph_heap_top_key(const Graph_heap_t *);
+
+void
+Graph_heap_set_type(Graph_heap_t *, Graph_heap_type_t, long);
+
+void
+Graph_heap_clear(Graph_heap_t *);
+
 /*
  * Misc Function Declarations
  */
@@ -148,6 +1054,147 @@ bool
 Graph_node_in_adjacency(Graph_edges_t *, vertex_number_t);
 
 Graph_vertices_t *
-Graph_get_vertex(Graph_t *, vertex_number_t);
+Graph_get_vertex(const Graph_t *, vertex_number_t);
+
+Graph_edges_t *
+Graph_add_edge_to_vertex(Graph_vertices_t *, Graph_edges_t *);
+
+vertex_number_t
+Graph_csr_get_row(const Graph_csr_t *, vertex_number_t);
+
+Graph_csr_t *
+Graph_csr_template(vertex_number_t, edge_index_t);
+
+bool
+Graph_csr_index_rows(Graph_csr_t *);
+
+long
+Graph_csr_max_weight(const Graph_csr_t *);
+
+uint64_t
+Graph_checksum(uint64_t, const void *, size_t);
+
+void
+Graph_log(Graph_log_level_t, const char *, int, const char *, ...)
+    __attribute__((format(printf, 4, 5)));
+
+Graph_stats_t *
+Graph_stats_create(void);
+
+void
+Graph_stats_merge(Graph_stats_t *, const Graph_stats_t *);
+
+uint64_t
+Graph_stats_clock(void);
+
+bool
+Graph_csr_sort_rows(Graph_csr_t *);
+
+bool
+Graph_sorted_contains(const vertex_number_t *, edge_index_t, vertex_number_t);
+
+bool
+Graph_sorted_insert(Graph_vertices_t *, vertex_number_t);
+
+bool
+Graph_sorted_append(Graph_vertices_t *, vertex_number_t);
+
+bool
+Graph_sorted_remove(Graph_vertices_t *, vertex_number_t);
+
+void
+Graph_sorted_shrink(Graph_vertices_t *);
+
+void
+Graph_sorted_finish(Graph_t *);
+
+void
+Graph_sssp_edge_changed(Graph_t *, const Graph_vertices_t *,
+                        const Graph_vertices_t *, long, long);
+
+void
+Graph_sssp_vertex_added(Graph_t *, const Graph_vertices_t *);
+
+void
+Graph_sssp_vertex_removing(Graph_t *, const Graph_vertices_t *);
+
+void
+Graph_sssp_vertex_moved(Graph_t *, const Graph_vertices_t *, vertex_number_t);
+
+void
+Graph_sssp_vertex_removed(Graph_t *);
+
+void
+Graph_sssp_invalidate(Graph_t *);
+
+void
+Graph_sssp_release(Graph_t *);
+
+void
+Graph_sorted_release(Graph_t *);
+
+void
+Graph_edge_index_insert(Graph_t *, vertex_number_t, vertex_number_t);
+
+void
+Graph_edge_index_remove(Graph_t *, vertex_number_t, vertex_number_t);
+
+bool
+Graph_edge_index_rebuild(Graph_t *);
+
+void
+Graph_edge_index_clear(Graph_edge_index_t *);
+
+int
+Graph_edge_index_lookup(const Graph_edge_index_t *, vertex_number_t, vertex_number_t);
+
+bool
+Graph_workspace_relax(Graph_workspace_t *, vertex_number_t, vertex_number_t, long);
+
+void
+Graph_slab_init(Graph_slab_t *, size_t);
+
+void *
+Graph_slab_alloc(Graph_slab_t *);
+
+void
+Graph_slab_free(Graph_slab_t *, void *);
+
+void
+Graph_slab_reset(Graph_slab_t *);
+
+void
+Graph_slab_release(Graph_slab_t *);
+
+int
+Graph_resolve_threads(int);
+
+bool
+Graph_parallel_run(int, void *(*)(void *), void *);
+
+void
+Graph_work_queue_init(Graph_work_queue_t *, int, long);
+
+bool
+Graph_work_queue_take(Graph_work_queue_t *, const Graph_thread_t *, long,
+                      long *, long *);
+
+bool
+Graph_barrier_init(Graph_barrier_t *, int);
+
+void
+Graph_barrier_resize(Graph_barrier_t *, int);
+
+void
+Graph_barrier_wait(Graph_barrier_t *);
+
+void
+Graph_barrier_destroy(Graph_barrier_t *);
+
+void *
+Graph_aligned_calloc(size_t, size_t);
+
+void
+Graph_aligned_free(void *);
 
 #endif /* End of __GRAPH_H__ */
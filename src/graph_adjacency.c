@@ -0,0 +1,477 @@
+/*
+ * In this File we define sorted adjacency of a Graph.
+ *
+ * Graph_has_edge on the linked adjacency list costs one
+ * pointer chase (usually a cache miss) per neighbor. With
+ * Graph_set_sorted_adjacency every vertex additionally keeps
+ * IDs of its neighbors in a sorted contiguous array, which
+ * is searched with a branchless binary search narrowing down
+ * to a short window that is scanned with SIMD compares.
+ * CSR snapshots of such Graphs have their rows sorted too.
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "graph.h"
+
+/*
+ * Function:
+ * Graph_sorted_scan
+ *
+ * In this function we look for key in list by
+ * comparing several entries per instruction
+ */
+static bool
+Graph_sorted_scan(const vertex_number_t *list, edge_index_t count,
+                  vertex_number_t key) {
+
+    edge_index_t         iterator = 0;
+
+#if defined(__AVX2__)
+    __m256i              needle = _mm256_set1_epi32(key);
+
+    for (; iterator + 8 <= count; iterator += 8) {
+      __m256i block = _mm256_loadu_si256((const __m256i *)(list + iterator));
+      if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(block, needle)) != 0) {
+        return TRUE;
+      }
+    }
+#elif defined(__SSE2__)
+    __m128i              needle = _mm_set1_epi32(key);
+
+    for (; iterator + 4 <= count; iterator += 4) {
+      __m128i block = _mm_loadu_si128((const __m128i *)(list + iterator));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi32(block, needle)) != 0) {
+        return TRUE;
+      }
+    }
+#endif
+
+    for (; iterator < count; iterator++) {
+      if (list[iterator] == key) {
+        return TRUE;
+      }
+    }
+
+    return FALSE;
+}
+
+/*
+ * Function:
+ * Graph_sorted_contains
+ *
+ * In this function we verify whether key is
+ * present in sorted list. Lists longer than
+ * GRAPH_SORTED_SCAN_MAX are halved without branches
+ * (the compare feeds a conditional move) till the
+ * window is short enough to scan
+ *
+ * Input:
+ *      const vertex_number_t *  - sorted list
+ *      edge_index_t             - no of entries
+ *      vertex_number_t          - key
+ * Output:
+ *      bool True  <-- If Present
+ *           False <-- If not Present
+ */
+bool
+Graph_sorted_contains(const vertex_number_t *list, edge_index_t count,
+                      vertex_number_t key) {
+
+    const vertex_number_t  *base = list;
+    edge_index_t            length = count;
+    edge_index_t            half;
+
+    while (length > GRAPH_SORTED_SCAN_MAX) {
+      half    = length / 2;
+      base   += (base[half] < key) ? half : 0;
+      length -= half;
+    }
+
+    /* First match can sit right past the window */
+    if (base + length < list + count) {
+      length++;
+    }
+
+    return Graph_sorted_scan(base, length, key);
+}
+
+static int
+Graph_sorted_compare(const void *a, const void *b) {
+
+    vertex_number_t      A = *(const vertex_number_t *)a;
+    vertex_number_t      B = *(const vertex_number_t *)b;
+
+    return (A > B) - (A < B);
+}
+
+/*
+ * Function:
+ * Graph_sorted_reserve
+ *
+ * In this function we make room for one
+ * more neighbor, doubling the array
+ */
+static bool
+Graph_sorted_reserve(Graph_vertices_t *V) {
+
+    vertex_number_t     *neighbors;
+    edge_index_t         capacity;
+
+    if (V->neighbors_count < V->neighbors_capacity) {
+      return TRUE;
+    }
+
+    capacity  = (V->neighbors_capacity > 0) ? V->neighbors_capacity * 2 : 4;
+    neighbors = (vertex_number_t *)realloc(V->neighbors,
+                                           capacity * sizeof(vertex_number_t));
+    if (neighbors == NULL) {
+      LOG_ERR("Unable to grow neighbors of vertex %d to %ld",
+              V->interface_number,capacity);
+      return FALSE;
+    }
+
+    V->neighbors          = neighbors;
+    V->neighbors_capacity = capacity;
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_sorted_insert
+ *
+ * In this function we add neighbor to sorted
+ * neighbors of vertex. Neighbors arriving in
+ * ascending order are appended in O(1)
+ *
+ * Input:
+ *      Graph_vertices_t  - vertex
+ *      vertex_number_t   - neighbor ID
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- On Failure
+ */
+bool
+Graph_sorted_insert(Graph_vertices_t *V, vertex_number_t node) {
+
+    edge_index_t         low  = 0;
+    edge_index_t         high = V->neighbors_count;
+    edge_index_t         mid;
+
+    if (!Graph_sorted_reserve(V)) {
+      return FALSE;
+    }
+
+    if (high > 0 && V->neighbors[high - 1] > node) {
+      while (low < high) {
+        mid = low + (high - low) / 2;
+        if (V->neighbors[mid] <= node) {
+          low = mid + 1;
+        } else {
+          high = mid;
+        }
+      }
+      memmove(V->neighbors + low + 1, V->neighbors + low,
+              (V->neighbors_count - low) * sizeof(vertex_number_t));
+    } else {
+      low = high;
+    }
+
+    V->neighbors[low] = node;
+    V->neighbors_count++;
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_sorted_append
+ *
+ * In this function we add neighbor at the end
+ * of neighbors of vertex, marking them unsorted
+ * if order breaks. Used by bulk loads, which
+ * call Graph_sorted_finish once done
+ */
+bool
+Graph_sorted_append(Graph_vertices_t *V, vertex_number_t node) {
+
+    if (!Graph_sorted_reserve(V)) {
+      return FALSE;
+    }
+
+    if (V->neighbors_count > 0 && V->neighbors[V->neighbors_count - 1] > node) {
+      V->neighbors_sorted = FALSE;
+    }
+
+    V->neighbors[V->neighbors_count++] = node;
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_sorted_remove
+ *
+ * In this function we drop one occurrence of
+ * neighbor from sorted neighbors of vertex. It is
+ * found by binary search, entries after it are
+ * shifted down
+ *
+ * Input:
+ *      Graph_vertices_t  - vertex
+ *      vertex_number_t   - neighbor ID
+ * Output:
+ *      bool True  <-- If neighbor was present
+ *           False <-- Otherwise
+ */
+bool
+Graph_sorted_remove(Graph_vertices_t *V, vertex_number_t node) {
+
+    edge_index_t         low  = 0;
+    edge_index_t         high = V->neighbors_count;
+    edge_index_t         mid;
+
+    while (low < high) {
+      mid = low + (high - low) / 2;
+      if (V->neighbors[mid] < node) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+
+    if (low == V->neighbors_count || V->neighbors[low] != node) {
+      return FALSE;
+    }
+
+    memmove(V->neighbors + low, V->neighbors + low + 1,
+            (V->neighbors_count - low - 1) * sizeof(vertex_number_t));
+    V->neighbors_count--;
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_sorted_shrink
+ *
+ * In this function we give back memory of
+ * sorted neighbors left unused after removals
+ */
+void
+Graph_sorted_shrink(Graph_vertices_t *V) {
+
+    vertex_number_t     *neighbors;
+    edge_index_t         capacity;
+
+    if (V->neighbors_capacity <= 4 ||
+        V->neighbors_count * 2 >= V->neighbors_capacity) {
+      return;
+    }
+
+    capacity = (V->neighbors_count > 4) ? V->neighbors_count : 4;
+    neighbors = (vertex_number_t *)realloc(V->neighbors,
+                                           capacity * sizeof(vertex_number_t));
+    if (neighbors == NULL) {
+      return;
+    }
+
+    V->neighbors          = neighbors;
+    V->neighbors_capacity = capacity;
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_sorted_finish
+ *
+ * In this function we sort neighbors of every
+ * vertex marked unsorted by Graph_sorted_append
+ */
+void
+Graph_sorted_finish(Graph_t *G) {
+
+    Graph_vertices_t    *V;
+
+    for (V = G->vertices_list; V != NULL; V = V->next) {
+      if (!V->neighbors_sorted) {
+        qsort(V->neighbors, V->neighbors_count, sizeof(vertex_number_t),
+              Graph_sorted_compare);
+        V->neighbors_sorted = TRUE;
+      }
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_sorted_release
+ *
+ * In this function we free sorted neighbors
+ * of every vertex of Graph
+ */
+void
+Graph_sorted_release(Graph_t *G) {
+
+    Graph_vertices_t    *V;
+
+    for (V = G->vertices_list; V != NULL; V = V->next) {
+      free(V->neighbors);
+      V->neighbors          = NULL;
+      V->neighbors_count    = 0;
+      V->neighbors_capacity = 0;
+      V->neighbors_sorted   = TRUE;
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_set_sorted_adjacency
+ *
+ * In this function we switch sorted adjacency
+ * of Graph on or off. Switching it on builds sorted
+ * neighbors from adjacency lists of existing vertices,
+ * later edges keep them up to date. Costs one
+ * vertex_number_t per edge
+ *
+ * Input:
+ *      Graph_t  - Graph
+ *      bool     - TRUE to enable, FALSE to disable
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- On Failure (Graph is left without it)
+ */
+bool
+Graph_set_sorted_adjacency(Graph_t *G, bool enable) {
+
+    Graph_vertices_t    *V;
+    Graph_edges_t       *E;
+
+    if (G == NULL) {
+      LOG_ERR("Provided Graph is NULL");
+      return FALSE;
+    }
+
+    if (G->sorted_adjacency) {
+      Graph_sorted_release(G);
+      G->sorted_adjacency = FALSE;
+    }
+
+    if (!enable) {
+      return TRUE;
+    }
+
+    for (V = G->vertices_list; V != NULL; V = V->next) {
+      for (E = V->adjacency_list; E != NULL; E = E->next) {
+        if (!Graph_sorted_append(V, E->target)) {
+          goto destroy;
+        }
+      }
+    }
+
+    Graph_sorted_finish(G);
+    G->sorted_adjacency = TRUE;
+
+    return TRUE;
+
+destroy:
+    Graph_sorted_release(G);
+    return FALSE;
+}
+
+/*
+ * Target and weight of one CSR edge,
+ * used to sort rows
+ */
+typedef struct graph_csr_edge_ {
+    vertex_number_t      target;
+    edge_weight_t        weight;
+} Graph_csr_edge_t;
+
+static int
+Graph_csr_edge_compare(const void *a, const void *b) {
+
+    const Graph_csr_edge_t *A = (const Graph_csr_edge_t *)a;
+    const Graph_csr_edge_t *B = (const Graph_csr_edge_t *)b;
+
+    return (A->target > B->target) - (A->target < B->target);
+}
+
+/*
+ * Function:
+ * Graph_csr_sort_rows
+ *
+ * In this function we sort every row of CSR
+ * by target (weights move along), so that
+ * Graph_csr_has_edge can search rows
+ *
+ * Input:
+ *      Graph_csr_t  - CSR snapshot (allocated, not mapped)
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- On Failure
+ */
+bool
+Graph_csr_sort_rows(Graph_csr_t *C) {
+
+    Graph_csr_edge_t    *edges;
+    edge_index_t         widest = 0;
+    edge_index_t         degree;
+    edge_index_t         position;
+    edge_index_t         first;
+    vertex_number_t      row;
+
+    for (row = 0; row < C->total_vertices; row++) {
+      degree = C->offsets[row + 1] - C->offsets[row];
+      if (degree > widest) {
+        widest = degree;
+      }
+    }
+
+    edges = (Graph_csr_edge_t *)malloc((widest ? widest : 1) *
+                                       sizeof(Graph_csr_edge_t));
+    if (edges == NULL) {
+      LOG_ERR("Unable to allocate %ld edges to sort CSR rows",widest);
+      return FALSE;
+    }
+
+    for (row = 0; row < C->total_vertices; row++) {
+      first  = C->offsets[row];
+      degree = C->offsets[row + 1] - first;
+
+      /* Rows built from sorted adjacency are mostly in order already */
+      for (position = 1; position < degree; position++) {
+        if (C->targets[first + position - 1] > C->targets[first + position]) {
+          break;
+        }
+      }
+      if (position >= degree) {
+        continue;
+      }
+
+      for (position = 0; position < degree; position++) {
+        edges[position].target = C->targets[first + position];
+        edges[position].weight = C->weights[first + position];
+      }
+      qsort(edges, degree, sizeof(Graph_csr_edge_t), Graph_csr_edge_compare);
+      for (position = 0; position < degree; position++) {
+        C->targets[first + position] = edges[position].target;
+        C->weights[first + position] = edges[position].weight;
+      }
+    }
+
+    free(edges);
+    C->is_sorted = TRUE;
+
+    return TRUE;
+}
@@ -0,0 +1,527 @@
+/*
+ * In this File we define direction optimizing
+ * Breadth First Search over CSR snapshot.
+ *
+ * Search runs level by level on all threads, every level
+ * is expanded in one of two directions
+ *      - top down: vertices of frontier (a queue) claim their
+ *        unvisited neighbors with compare and swap on parent
+ *      - bottom up: every unvisited vertex looks for a parent
+ *        among its incoming edges, stopping at first one in
+ *        frontier (a bitmap). Each thread owns whole words of
+ *        next bitmap, so no atomics are needed
+ * Top down is cheap while frontier is small, bottom up once
+ * frontier holds a large share of the edges (it skips most
+ * of them). Direction is switched by the heuristic of Beamer
+ * et al. comparing edges of frontier with unexplored edges.
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#include "graph.h"
+
+#define GRAPH_BFS_ALPHA           15     /* Go bottom up above edges / alpha */
+#define GRAPH_BFS_BETA            18     /* Go top down below vertices / beta */
+#define GRAPH_BFS_CHUNK           64     /* Frontier vertices taken at once */
+#define GRAPH_BFS_WORD_CHUNK      16     /* Bitmap words taken at once */
+#define GRAPH_BFS_QUEUE_MIN       64
+
+/*
+ * State of one thread, aligned so that threads
+ * do not share cache lines
+ */
+typedef struct graph_bfs_local_ {
+    vertex_number_t     *queue;         /* Vertices found this level */
+    long                 count;
+    long                 capacity;
+    edge_index_t         scout;         /* Edges of vertices found */
+} __attribute__((aligned(GRAPH_CACHE_LINE))) Graph_bfs_local_t;
+
+/*
+ * State shared by all threads
+ */
+typedef struct graph_bfs_ {
+    const Graph_csr_t   *C;             /* Outgoing edges */
+    const Graph_csr_t   *R;             /* Incoming edges */
+    long                *distance;      /* Hops per row */
+    vertex_number_t     *parent;        /* Parent row, -1 if unvisited */
+    vertex_number_t     *frontier;      /* Current level (top down) */
+    long                 frontier_size;
+    uint64_t            *current;       /* Current level (bottom up) */
+    uint64_t            *next;          /* Next level (bottom up) */
+    long                 words;         /* Words of every bitmap */
+    Graph_bfs_local_t   *locals;        /* One per thread */
+    long                *offsets;       /* Where thread copies its queue */
+    Graph_work_queue_t  *queues;
+    Graph_barrier_t      barrier;
+    int                  threads;       /* Threads which did start */
+    long                 level;         /* Hops of current level */
+    edge_index_t         unexplored;    /* Edges not yet looked at */
+    long                 awake;         /* Vertices found last level */
+    bool                 bottom_up;     /* Direction of next level */
+    bool                 failed;        /* Set if a queue could not grow */
+} Graph_bfs_t;
+
+/*
+ * Function:
+ * Graph_bfs_push
+ *
+ * In this function we add vertex to queue of
+ * thread, doubling its capacity when full
+ */
+static void
+Graph_bfs_push(Graph_bfs_t *B, Graph_bfs_local_t *L, vertex_number_t vertex) {
+
+    vertex_number_t     *queue;
+    long                 capacity;
+
+    if (L->count == L->capacity) {
+      capacity = L->capacity ? L->capacity * 2 : GRAPH_BFS_QUEUE_MIN;
+      queue = (vertex_number_t *)realloc(L->queue, capacity * sizeof(vertex_number_t));
+      if (queue == NULL) {
+        LOG_ERR("Unable to grow BFS queue to %ld vertices",capacity);
+        __atomic_store_n(&B->failed, TRUE, __ATOMIC_RELAXED);
+        return;
+      }
+      L->queue    = queue;
+      L->capacity = capacity;
+    }
+
+    L->queue[L->count++] = vertex;
+    L->scout += B->C->offsets[vertex + 1] - B->C->offsets[vertex];
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_bfs_top_down
+ *
+ * In this function thread claims unvisited
+ * neighbors of its share of frontier
+ */
+static void
+Graph_bfs_top_down(Graph_bfs_t *B, Graph_thread_t *T, Graph_bfs_local_t *L) {
+
+    const Graph_csr_t   *C = B->C;
+    vertex_number_t      vertex;
+    vertex_number_t      target;
+    vertex_number_t      unvisited;
+    edge_index_t         position;
+    long                 first;
+    long                 last;
+    long                 iterator;
+
+    while (Graph_work_queue_take(B->queues, T, GRAPH_BFS_CHUNK, &first, &last)) {
+      for (iterator = first; iterator < last; iterator++) {
+        vertex = B->frontier[iterator];
+        for (position = C->offsets[vertex]; position < C->offsets[vertex + 1]; position++) {
+          target    = C->targets[position];
+          unvisited = -1;
+          if (__atomic_load_n(&B->parent[target], __ATOMIC_RELAXED) == -1 &&
+              __atomic_compare_exchange_n(&B->parent[target], &unvisited, vertex,
+                                          FALSE, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            B->distance[target] = B->level + 1;
+            Graph_bfs_push(B, L, target);
+          }
+        }
+      }
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_bfs_bottom_up
+ *
+ * In this function thread looks for parents of
+ * unvisited vertices in its share of bitmap words,
+ * writing whole words of next bitmap
+ */
+static void
+Graph_bfs_bottom_up(Graph_bfs_t *B, Graph_thread_t *T, Graph_bfs_local_t *L) {
+
+    const Graph_csr_t   *R = B->R;
+    vertex_number_t      vertex;
+    vertex_number_t      source;
+    vertex_number_t      end;
+    edge_index_t         position;
+    uint64_t             word;
+    long                 first;
+    long                 last;
+    long                 index;
+
+    while (Graph_work_queue_take(B->queues, T, GRAPH_BFS_WORD_CHUNK, &first, &last)) {
+      for (index = first; index < last; index++) {
+        word   = 0;
+        vertex = (vertex_number_t)(index * 64);
+        end    = (index * 64 + 64 < R->total_vertices) ? (vertex_number_t)(index * 64 + 64) :
+                                                         R->total_vertices;
+        for (; vertex < end; vertex++) {
+          if (B->parent[vertex] != -1) {
+            continue;
+          }
+          for (position = R->offsets[vertex]; position < R->offsets[vertex + 1]; position++) {
+            source = R->targets[position];
+            if (B->current[source >> 6] & (1ULL << (source & 63))) {
+              B->parent[vertex]   = source;
+              B->distance[vertex] = B->level + 1;
+              word |= 1ULL << (vertex & 63);
+              L->count++;
+              break;
+            }
+          }
+        }
+        B->next[index] = word;
+      }
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_bfs_gather
+ *
+ * In this function thread 0 lays out queues of
+ * threads one after other in frontier and returns
+ * no of vertices in it
+ */
+static long
+Graph_bfs_gather(Graph_bfs_t *B) {
+
+    long                 total = 0;
+    int                  iterator;
+
+    for (iterator = 0; iterator < B->threads; iterator++) {
+      B->offsets[iterator] = total;
+      total += B->locals[iterator].count;
+    }
+
+    return total;
+}
+
+/*
+ * Function:
+ * Graph_bfs_decide
+ *
+ * In this function thread 0 sums up level just
+ * expanded and picks direction of next one.
+ * Done between two barriers
+ */
+static void
+Graph_bfs_decide(Graph_bfs_t *B) {
+
+    uint64_t            *swap;
+    edge_index_t         scout = 0;
+    long                 awake;
+    int                  iterator;
+
+    awake = Graph_bfs_gather(B);
+    for (iterator = 0; iterator < B->threads; iterator++) {
+      scout += B->locals[iterator].scout;
+      B->locals[iterator].scout = 0;
+    }
+    B->unexplored -= scout;
+
+    if (B->bottom_up) {
+      swap       = B->current;
+      B->current = B->next;
+      B->next    = swap;
+
+      /* Stay bottom up while frontier grows or is large */
+      if (awake < B->awake && awake <= B->C->total_vertices / GRAPH_BFS_BETA) {
+        B->bottom_up = FALSE;
+      }
+    } else if (scout > B->unexplored / GRAPH_BFS_ALPHA) {
+      B->bottom_up = TRUE;
+    }
+
+    B->awake         = awake;
+    B->frontier_size = awake;
+    B->level++;
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_bfs_worker
+ *
+ * In this function every thread runs the level
+ * loop in lock step with others
+ */
+static void *
+Graph_bfs_worker(void *arg) {
+
+    Graph_thread_t      *T = (Graph_thread_t *)arg;
+    Graph_bfs_t         *B = (Graph_bfs_t *)T->shared;
+    Graph_bfs_local_t   *L = &B->locals[T->id];
+    bool                 was_bottom_up;
+    long                 iterator;
+    long                 index;
+    long                 first;
+    long                 last;
+    uint64_t             word;
+
+    if (T->id == 0) {
+      /* Static shares below go to threads which did start */
+      B->threads = T->running;
+      if (T->running < T->count) {
+        Graph_barrier_resize(&B->barrier, T->running);
+      }
+    }
+    Graph_barrier_wait(&B->barrier);
+
+    while (B->frontier_size > 0) {
+      was_bottom_up = B->bottom_up;
+      L->count      = 0;
+
+      if (was_bottom_up) {
+        Graph_bfs_bottom_up(B, T, L);
+      } else {
+        Graph_bfs_top_down(B, T, L);
+      }
+      Graph_barrier_wait(&B->barrier);
+
+      if (T->id == 0) {
+        Graph_bfs_decide(B);
+      }
+      Graph_barrier_wait(&B->barrier);
+
+      if (B->frontier_size == 0) {
+        break;
+      }
+
+      first = B->words * T->id / B->threads;
+      last  = B->words * (T->id + 1) / B->threads;
+
+      if (B->bottom_up && !was_bottom_up) {
+        /* Queue to bitmap: clear own words, then set bits of own queue */
+        memset(B->current + first, 0, (last - first) * sizeof(uint64_t));
+        Graph_barrier_wait(&B->barrier);
+        for (iterator = 0; iterator < L->count; iterator++) {
+          __atomic_fetch_or(&B->current[L->queue[iterator] >> 6],
+                            1ULL << (L->queue[iterator] & 63), __ATOMIC_RELAXED);
+        }
+      } else if (!B->bottom_up) {
+        if (was_bottom_up) {
+          /* Bitmap to queue: every thread collects its own words */
+          L->count = 0;
+          for (index = first; index < last; index++) {
+            for (word = B->current[index]; word != 0; word &= word - 1) {
+              Graph_bfs_push(B, L, (vertex_number_t)(index * 64 + __builtin_ctzll(word)));
+            }
+          }
+          Graph_barrier_wait(&B->barrier);
+          if (T->id == 0) {
+            Graph_bfs_gather(B);
+          }
+          Graph_barrier_wait(&B->barrier);
+        }
+        if (L->count > 0) {
+          memcpy(B->frontier + B->offsets[T->id], L->queue,
+                 L->count * sizeof(vertex_number_t));
+        }
+      }
+      Graph_barrier_wait(&B->barrier);
+
+      if (T->id == 0) {
+        Graph_work_queue_init(B->queues, T->count,
+                              B->bottom_up ? B->words : B->frontier_size);
+      }
+      Graph_barrier_wait(&B->barrier);
+    }
+
+    return NULL;
+}
+
+/*
+ * Function
+ * Graph_csr_bfs
+ *
+ * In this function we find no of hops from Source
+ * to all the vertices of CSR snapshot, spread over
+ * threads of the snapshot (see Graph_set_num_threads).
+ * Bottom up levels walk incoming edges: R is the
+ * transposed snapshot (see Graph_csr_transpose), for
+ * undirected snapshots C itself is used. Directed
+ * snapshot without R is transposed for this call.
+ *
+ * Both arrays have total_vertices entries indexed by row.
+ * Unreachable vertices get GRAPH_INFINITE_DISTANCE and
+ * parent -1, Source gets 0 and parent -1
+ *
+ * Input:
+ *       Graph_csr_t * C
+ *       Graph_csr_t * R (incoming edges, can be NULL)
+ *       vertex_number_t S (Source)
+ *       long * distance (Output)
+ *       vertex_number_t * parent (Output, row of parent, can be NULL)
+ * Output:
+ *       bool True  <-- On Success
+ *            False <-- On Failure
+ */
+bool
+Graph_csr_bfs(const Graph_csr_t *C, const Graph_csr_t *R, vertex_number_t S,
+              long *distance, vertex_number_t *parent) {
+
+    Graph_bfs_t          B;
+    Graph_csr_t         *transposed = NULL;
+    vertex_number_t      source;
+    vertex_number_t      row;
+    size_t               slots;
+    int                  no_of_threads;
+    int                  iterator;
+    bool                 barrier_ready = FALSE;
+    bool                 result        = FALSE;
+
+    if (C == NULL || distance == NULL) {
+      LOG_ERR("Provided CSR or distance array is NULL");
+      return FALSE;
+    }
+
+    source = Graph_csr_get_row(C, S);
+    if (source < 0) {
+      LOG_ERR("Unable to find vertex %d",S);
+      return FALSE;
+    }
+
+    if (R == NULL) {
+      if (C->is_directed) {
+        transposed = Graph_csr_transpose(C);
+        if (transposed == NULL) {
+          return FALSE;
+        }
+      }
+      R = (transposed != NULL) ? transposed : C;
+    }
+
+    no_of_threads = Graph_resolve_threads(C->num_threads);
+    slots         = (C->total_vertices > 0) ? (size_t)C->total_vertices : 1;
+
+    memset(&B, 0, sizeof(B));
+    B.C          = C;
+    B.R          = R;
+    B.distance   = distance;
+    B.parent     = (parent != NULL) ? parent :
+                   (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    B.words      = (C->total_vertices + 63) / 64;
+    B.frontier   = (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    B.current    = (uint64_t *)calloc(B.words + 1, sizeof(uint64_t));
+    B.next       = (uint64_t *)calloc(B.words + 1, sizeof(uint64_t));
+    B.locals     = (Graph_bfs_local_t *)Graph_aligned_calloc(no_of_threads,
+                                                 sizeof(Graph_bfs_local_t));
+    B.offsets    = (long *)calloc(no_of_threads, sizeof(long));
+    B.queues     = (Graph_work_queue_t *)Graph_aligned_calloc(no_of_threads,
+                                                 sizeof(Graph_work_queue_t));
+    if (B.parent == NULL || B.frontier == NULL || B.current == NULL ||
+        B.next == NULL || B.locals == NULL || B.offsets == NULL || B.queues == NULL) {
+      LOG_ERR("Unable to allocate BFS state for %d vertices",C->total_vertices);
+      goto destroy;
+    }
+
+    if (!Graph_barrier_init(&B.barrier, no_of_threads)) {
+      goto destroy;
+    }
+    barrier_ready = TRUE;
+
+    for (row = 0; row < C->total_vertices; row++) {
+      distance[row] = GRAPH_INFINITE_DISTANCE;
+      B.parent[row] = -1;
+    }
+
+    /* Source is its own parent while searching, so it is never claimed */
+    distance[source]  = 0;
+    B.parent[source]  = source;
+    B.frontier[0]     = source;
+    B.frontier_size   = 1;
+    B.awake           = 1;
+    B.unexplored      = C->total_edges;
+    Graph_work_queue_init(B.queues, no_of_threads, 1);
+
+    /* Threads which did start cover for the ones which did not */
+    Graph_parallel_run(no_of_threads, Graph_bfs_worker, &B);
+
+    B.parent[source] = -1;
+    result = !B.failed;
+
+destroy:
+    if (barrier_ready) {
+      Graph_barrier_destroy(&B.barrier);
+    }
+    if (B.locals != NULL) {
+      for (iterator = 0; iterator < no_of_threads; iterator++) {
+        free(B.locals[iterator].queue);
+      }
+    }
+    if (parent == NULL) {
+      free(B.parent);
+    }
+    free(B.frontier);
+    free(B.current);
+    free(B.next);
+    Graph_aligned_free(B.locals);
+    free(B.offsets);
+    Graph_aligned_free(B.queues);
+    Graph_csr_destroy(transposed);
+
+    return result;
+}
+
+/*
+ * Function
+ * Graph_bfs
+ *
+ * In this function we find no of hops from Source
+ * to all the vertices of the Graph, see Graph_csr_bfs.
+ * Graph is frozen (and transposed, if directed) for
+ * every call, freeze it once and use Graph_csr_bfs for
+ * repeated searches.
+ *
+ * Both arrays have total_vertices entries indexed by
+ * dense vertex index, parent holds Vertex ID of parent
+ * (-1 for Source and unreachable vertices)
+ *
+ * Input:
+ *       Graph_t * G (Graph)
+ *       vertex_number_t S (Source)
+ *       long * distance (Output)
+ *       vertex_number_t * parent (Output, can be NULL)
+ * Output:
+ *       bool True  <-- On Success
+ *            False <-- On Failure
+ */
+bool
+Graph_bfs(const Graph_t *G, vertex_number_t S, long *distance,
+          vertex_number_t *parent) {
+
+    Graph_csr_t         *C;
+    vertex_number_t      row;
+    bool                 result;
+
+    if (G == NULL) {
+      LOG_ERR("Provided Graph is NULL");
+      return FALSE;
+    }
+
+    C = Graph_freeze(G);
+    if (C == NULL) {
+      return FALSE;
+    }
+
+    result = Graph_csr_bfs(C, NULL, S, distance, parent);
+    if (result && parent != NULL) {
+      for (row = 0; row < C->total_vertices; row++) {
+        if (parent[row] != -1) {
+          parent[row] = C->vertex_ids[parent[row]];
+        }
+      }
+    }
+
+    Graph_csr_destroy(C);
+
+    return result;
+}
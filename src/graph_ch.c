@@ -0,0 +1,1364 @@
+/*
+ * In this File we define Contraction Hierarchies (CH)
+ * for fast point to point distance queries.
+ *
+ * Preprocessing contracts vertices in rounds, least
+ * important first (importance is edge difference plus
+ * no of contracted neighbors and their level). Every
+ * round picks vertices which go before all vertices up
+ * to two edges away; none of them share a neighbor, so
+ * their shortcuts are found in parallel, each thread
+ * with its own workspace. Contracting v adds shortcut
+ * u -> x for every pair of neighbors whose shortest path
+ * runs through v, which is checked with a local Dijkstra
+ * bounded by distance, settled vertices and hops (witness
+ * search). Importance of a vertex whose neighborhood
+ * changed is only computed again once it is about to
+ * be picked (lazy updates).
+ *
+ * Result is kept as two CSR arrays holding only edges
+ * towards higher ranked vertices, forward (up) and
+ * reversed (down). Query runs Dijkstra upwards from Source
+ * on up and from Target on down, both searches settle
+ * only a few hundred vertices even on large road Graphs.
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#include "graph.h"
+
+/*
+ * Neighbor in the remaining (not yet contracted) Graph
+ */
+typedef struct graph_ch_arc_ {
+    vertex_number_t      vertex;
+    edge_weight_t        weight;
+} Graph_ch_arc_t;
+
+typedef struct graph_ch_list_ {
+    Graph_ch_arc_t      *arcs;
+    vertex_number_t      count;
+    vertex_number_t      capacity;
+} Graph_ch_list_t;
+
+/*
+ * Growable edge arrays, input of Graph_csr_from_edges
+ */
+typedef struct graph_ch_edges_ {
+    vertex_number_t     *src;
+    vertex_number_t     *dst;
+    edge_weight_t       *weight;
+    edge_index_t         count;
+    edge_index_t         capacity;
+} Graph_ch_edges_t;
+
+/*
+ * State of one thread, aligned so that threads
+ * do not share cache lines
+ */
+typedef struct graph_ch_local_ {
+    Graph_workspace_t   *W;             /* Witness searches */
+    int                 *hops;          /* Edges on path to every vertex reached */
+    char                *target;        /* Set for targets of witness searches */
+    Graph_ch_edges_t     shortcuts;     /* Found for vertices of present round */
+} __attribute__((aligned(GRAPH_CACHE_LINE))) Graph_ch_local_t;
+
+/*
+ * Vertex contracted in present round
+ */
+typedef struct graph_ch_batch_ {
+    vertex_number_t      vertex;
+    int                  thread;        /* Thread holding its shortcuts */
+    edge_index_t         first;         /* Its shortcuts in that thread */
+    edge_index_t         count;
+} Graph_ch_batch_t;
+
+/*
+ * State of preprocessing
+ */
+typedef struct graph_ch_builder_ {
+    vertex_number_t      total;         /* Vertices (rows) */
+    Graph_ch_list_t     *out;           /* Outgoing arcs of every vertex */
+    Graph_ch_list_t     *in;            /* Incoming arcs of every vertex */
+    vertex_number_t     *deleted;       /* Contracted neighbors of every vertex */
+    vertex_number_t     *level;         /* Longest chain of contracted
+                                         * vertices below every vertex */
+    long                *priority;      /* Importance of every vertex */
+    char                *dirty;         /* Priority must be computed again */
+    char                *selected;      /* Goes before all neighbors */
+    char                *contracting;   /* Contracted in present round */
+    vertex_number_t     *slot;          /* Position in list being merged, -1 */
+    vertex_number_t     *remaining;     /* Vertices not contracted yet */
+    vertex_number_t      remaining_count;
+    Graph_ch_batch_t    *batch;         /* Vertices of present round */
+    vertex_number_t      batch_count;
+    edge_index_t        *offsets;       /* Shortcuts of a vertex by target */
+    Graph_ch_edges_t     up;            /* Edges of up, in contraction order */
+    Graph_ch_edges_t     down;          /* Edges of down */
+    Graph_ch_edges_t     pending;       /* Shortcuts of a vertex sorted by target */
+    Graph_ch_local_t    *locals;        /* One per thread */
+    Graph_work_queue_t  *queues;        /* One per thread */
+    int                  no_of_threads;
+    bool                 refreshed;     /* Set if a priority was computed again */
+    bool                 failed;        /* Set if a thread could not allocate */
+} Graph_ch_builder_t;
+
+/*
+ * Function:
+ * Graph_ch_list_reserve
+ *
+ * In this function we make room for count more
+ * arcs in list
+ */
+static bool
+Graph_ch_list_reserve(Graph_ch_list_t *L, long count) {
+
+    Graph_ch_arc_t      *arcs;
+    long                 capacity;
+
+    if (L->count + count <= L->capacity) {
+      return TRUE;
+    }
+
+    capacity = (L->capacity > 0) ? 2L * L->capacity : 4;
+    if (capacity < L->count + count) {
+      capacity = L->count + count;
+    }
+
+    arcs = (Graph_ch_arc_t *)realloc(L->arcs, capacity * sizeof(Graph_ch_arc_t));
+    if (arcs == NULL) {
+      LOG_ERR("Unable to grow arcs to %ld",capacity);
+      return FALSE;
+    }
+    L->arcs     = arcs;
+    L->capacity = (vertex_number_t)capacity;
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_ch_list_merge
+ *
+ * In this function we drop arc to removed vertex
+ * from list and add given arcs (other than to removed
+ * vertex), keeping lower weight
+ * if arc to a vertex already exists. Position of every
+ * arc is kept in slot meanwhile, so merge costs
+ * O(list + arcs) and not O(list * arcs)
+ */
+static bool
+Graph_ch_list_merge(Graph_ch_builder_t *B, Graph_ch_list_t *L, vertex_number_t removed,
+                    const vertex_number_t *vertices, const edge_weight_t *weights,
+                    long count) {
+
+    vertex_number_t      iterator;
+    vertex_number_t      position;
+    long                 arc;
+    bool                 result = TRUE;
+
+    for (iterator = 0; iterator < L->count; ) {
+      if (L->arcs[iterator].vertex == removed) {
+        L->arcs[iterator] = L->arcs[--L->count];
+        continue;
+      }
+      B->slot[L->arcs[iterator].vertex] = iterator;
+      iterator++;
+    }
+
+    if (count > 0 && !Graph_ch_list_reserve(L, count)) {
+      result = FALSE;
+      count  = 0;
+    }
+
+    for (arc = 0; arc < count; arc++) {
+      if (vertices[arc] == removed) {
+        continue;
+      }
+      position = B->slot[vertices[arc]];
+      if (position < 0) {
+        B->slot[vertices[arc]]    = L->count;
+        L->arcs[L->count].vertex  = vertices[arc];
+        L->arcs[L->count].weight  = weights[arc];
+        L->count++;
+      } else if (weights[arc] < L->arcs[position].weight) {
+        L->arcs[position].weight = weights[arc];
+      }
+    }
+
+    for (iterator = 0; iterator < L->count; iterator++) {
+      B->slot[L->arcs[iterator].vertex] = -1;
+    }
+
+    return result;
+}
+
+/*
+ * Function:
+ * Graph_ch_edges_reserve
+ *
+ * In this function we make room for count edges
+ * in growable arrays
+ */
+static bool
+Graph_ch_edges_reserve(Graph_ch_edges_t *E, edge_index_t count) {
+
+    edge_index_t         capacity;
+    vertex_number_t     *sources;
+    vertex_number_t     *targets;
+    edge_weight_t       *weights;
+
+    if (count <= E->capacity) {
+      return TRUE;
+    }
+
+    capacity = (E->capacity > 0) ? E->capacity * 2 : 64;
+    if (capacity < count) {
+      capacity = count;
+    }
+    sources  = (vertex_number_t *)realloc(E->src, capacity * sizeof(vertex_number_t));
+    if (sources != NULL) {
+      E->src = sources;
+    }
+    targets  = (vertex_number_t *)realloc(E->dst, capacity * sizeof(vertex_number_t));
+    if (targets != NULL) {
+      E->dst = targets;
+    }
+    weights  = (edge_weight_t *)realloc(E->weight, capacity * sizeof(edge_weight_t));
+    if (weights != NULL) {
+      E->weight = weights;
+    }
+    if (sources == NULL || targets == NULL || weights == NULL) {
+      LOG_ERR("Unable to grow edges to %ld",capacity);
+      return FALSE;
+    }
+    E->capacity = capacity;
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_ch_edges_add
+ *
+ * In this function we append edge to growable arrays
+ */
+static bool
+Graph_ch_edges_add(Graph_ch_edges_t *E, vertex_number_t src, vertex_number_t dst,
+                   edge_weight_t weight) {
+
+    if (!Graph_ch_edges_reserve(E, E->count + 1)) {
+      return FALSE;
+    }
+
+    E->src[E->count]    = src;
+    E->dst[E->count]    = dst;
+    E->weight[E->count] = weight;
+    E->count++;
+
+    return TRUE;
+}
+
+static void
+Graph_ch_edges_release(Graph_ch_edges_t *E) {
+
+    free(E->src);
+    free(E->dst);
+    free(E->weight);
+    memset(E, 0, sizeof(*E));
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_ch_witness
+ *
+ * In this function we run Dijkstra from source in
+ * the remaining Graph without vertex skip and vertices
+ * contracted in present round, till distances beyond
+ * limit, max_settled vertices or all remaining targets
+ * settled. Vertices max_hops edges away are not
+ * expanded. Distances found are upper bounds
+ */
+static void
+Graph_ch_witness(const Graph_ch_builder_t *B, Graph_ch_local_t *L,
+                 vertex_number_t source, vertex_number_t skip, long limit,
+                 vertex_number_t targets, int max_settled, int max_hops) {
+
+    Graph_workspace_t      *W = L->W;
+    const Graph_ch_list_t  *list;
+    vertex_number_t         vertex;
+    vertex_number_t         next;
+    vertex_number_t         iterator;
+    int                     settled = 0;
+
+    Graph_workspace_reset(W);
+    Graph_workspace_relax(W, source, -1, 0);
+    L->hops[source] = 0;
+
+    while (!Graph_heap_is_empty(W->heap) &&
+           Graph_heap_top_key(W->heap) <= limit &&
+           settled++ < max_settled) {
+      vertex = Graph_heap_pop(W->heap);
+      if (L->target[vertex] && --targets == 0) {
+        break;
+      }
+      if (L->hops[vertex] >= max_hops) {
+        continue;
+      }
+
+      list = &B->out[vertex];
+      for (iterator = 0; iterator < list->count; iterator++) {
+        next = list->arcs[iterator].vertex;
+        if (next == skip || B->contracting[next]) {
+          continue;
+        }
+        if (Graph_workspace_relax(W, next, vertex,
+                                  W->min_distance[vertex] + list->arcs[iterator].weight)) {
+          L->hops[next] = L->hops[vertex] + 1;
+        }
+      }
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_ch_shortcuts
+ *
+ * In this function we find shortcuts needed to
+ * contract vertex: u -> vertex -> x for which
+ * witness search finds nothing shorter. Shortcuts
+ * are collected in thread's list if contract is set
+ * (grouped by u in order of incoming arcs), else
+ * only counted with cheaper witness searches
+ * (which can only overestimate)
+ *
+ * Output:
+ *      long - no of shortcuts, -1 on failure
+ */
+static long
+Graph_ch_shortcuts(const Graph_ch_builder_t *B, Graph_ch_local_t *L,
+                   vertex_number_t vertex, bool contract) {
+
+    const Graph_ch_list_t  *in  = &B->in[vertex];
+    const Graph_ch_list_t  *out = &B->out[vertex];
+    vertex_number_t         first;
+    vertex_number_t         second;
+    vertex_number_t         source;
+    vertex_number_t         target;
+    long                    widest = 0;
+    long                    via;
+    long                    count  = 0;
+
+    for (second = 0; second < out->count; second++) {
+      L->target[out->arcs[second].vertex] = TRUE;
+      if (out->arcs[second].weight > widest) {
+        widest = out->arcs[second].weight;
+      }
+    }
+
+    for (first = 0; first < in->count && count >= 0; first++) {
+      source = in->arcs[first].vertex;
+      Graph_ch_witness(B, L, source, vertex, in->arcs[first].weight + widest,
+                       out->count,
+                       contract ? GRAPH_CH_WITNESS_SETTLED : GRAPH_CH_ESTIMATE_SETTLED,
+                       contract ? GRAPH_CH_WITNESS_HOPS : GRAPH_CH_ESTIMATE_HOPS);
+
+      for (second = 0; second < out->count; second++) {
+        target = out->arcs[second].vertex;
+        if (target == source) {
+          continue;
+        }
+
+        via = (long)in->arcs[first].weight + out->arcs[second].weight;
+        if (L->W->min_distance[target] <= via) {
+          continue;
+        }
+
+        count++;
+        if (contract &&
+            !Graph_ch_edges_add(&L->shortcuts, source, target, (edge_weight_t)via)) {
+          count = -1;
+          break;
+        }
+      }
+    }
+
+    for (second = 0; second < out->count; second++) {
+      L->target[out->arcs[second].vertex] = FALSE;
+    }
+
+    return count;
+}
+
+/*
+ * Function:
+ * Graph_ch_priority
+ *
+ * In this function we compute importance of vertex,
+ * twice the edge difference (shortcuts added minus
+ * edges removed) plus no of neighbors contracted before
+ * it and its level, so that contraction spreads evenly
+ * over the Graph, plus its remaining degree, so that low
+ * degree vertices go first
+ */
+static long
+Graph_ch_priority(const Graph_ch_builder_t *B, Graph_ch_local_t *L,
+                  vertex_number_t vertex) {
+
+    long                 shortcuts;
+
+    shortcuts = Graph_ch_shortcuts(B, L, vertex, FALSE);
+
+    return 2 * (shortcuts - B->in[vertex].count - B->out[vertex].count) +
+           B->deleted[vertex] + B->level[vertex] +
+           B->in[vertex].count + B->out[vertex].count;
+}
+
+/*
+ * Function:
+ * Graph_ch_before
+ *
+ * In this function we tell whether first vertex
+ * goes before second one. Ties of priority are broken
+ * by a hash of the vertex, so that vertices picked in
+ * a round are spread over the Graph
+ */
+static bool
+Graph_ch_before(const Graph_ch_builder_t *B, vertex_number_t first,
+                vertex_number_t second) {
+
+    if (B->priority[first] != B->priority[second]) {
+      return B->priority[first] < B->priority[second];
+    }
+
+    return (uint32_t)first * 2654435761u < (uint32_t)second * 2654435761u;
+}
+
+/*
+ * Function:
+ * Graph_ch_before_neighbors
+ *
+ * In this function we tell whether vertex goes
+ * before all other neighbors of its neighbor
+ */
+static bool
+Graph_ch_before_neighbors(const Graph_ch_builder_t *B, vertex_number_t vertex,
+                          vertex_number_t neighbor) {
+
+    const Graph_ch_list_t *list;
+    vertex_number_t        position;
+
+    list = &B->out[neighbor];
+    for (position = 0; position < list->count; position++) {
+      if (list->arcs[position].vertex != vertex &&
+          !Graph_ch_before(B, vertex, list->arcs[position].vertex)) {
+        return FALSE;
+      }
+    }
+    list = &B->in[neighbor];
+    for (position = 0; position < list->count; position++) {
+      if (list->arcs[position].vertex != vertex &&
+          !Graph_ch_before(B, vertex, list->arcs[position].vertex)) {
+        return FALSE;
+      }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_ch_priority_worker
+ *
+ * In this function every thread computes priority
+ * of picked vertices whose neighborhood changed
+ * since it was last computed
+ */
+static void *
+Graph_ch_priority_worker(void *arg) {
+
+    Graph_thread_t        *T = (Graph_thread_t *)arg;
+    Graph_ch_builder_t    *B = (Graph_ch_builder_t *)T->shared;
+    Graph_ch_local_t      *L = &B->locals[T->id];
+    vertex_number_t        vertex;
+    long                   first;
+    long                   last;
+    long                   iterator;
+
+    while (Graph_work_queue_take(B->queues, T, 64, &first, &last)) {
+      for (iterator = first; iterator < last; iterator++) {
+        vertex = B->remaining[iterator];
+        if (B->dirty[vertex] && B->selected[vertex]) {
+          B->priority[vertex] = Graph_ch_priority(B, L, vertex);
+          B->dirty[vertex]    = FALSE;
+          __atomic_store_n(&B->refreshed, TRUE, __ATOMIC_RELAXED);
+        }
+      }
+    }
+
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_ch_select_worker
+ *
+ * In this function every thread picks remaining
+ * vertices which go before all vertices up to two
+ * edges away. No two of them are adjacent or share
+ * a neighbor, so they are contracted together
+ */
+static void *
+Graph_ch_select_worker(void *arg) {
+
+    Graph_thread_t        *T = (Graph_thread_t *)arg;
+    Graph_ch_builder_t    *B = (Graph_ch_builder_t *)T->shared;
+    const Graph_ch_list_t *list;
+    vertex_number_t        vertex;
+    vertex_number_t        position;
+    long                   first;
+    long                   last;
+    long                   iterator;
+    bool                   selected;
+
+    while (Graph_work_queue_take(B->queues, T, 256, &first, &last)) {
+      for (iterator = first; iterator < last; iterator++) {
+        vertex   = B->remaining[iterator];
+        selected = TRUE;
+
+        list = &B->out[vertex];
+        for (position = 0; position < list->count && selected; position++) {
+          selected = Graph_ch_before(B, vertex, list->arcs[position].vertex) &&
+                     Graph_ch_before_neighbors(B, vertex, list->arcs[position].vertex);
+        }
+        list = &B->in[vertex];
+        for (position = 0; position < list->count && selected; position++) {
+          selected = Graph_ch_before(B, vertex, list->arcs[position].vertex) &&
+                     Graph_ch_before_neighbors(B, vertex, list->arcs[position].vertex);
+        }
+
+        B->selected[vertex] = (char)selected;
+      }
+    }
+
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_ch_contract_worker
+ *
+ * In this function every thread finds shortcuts of
+ * vertices picked for present round. Witness searches
+ * avoid all of them, so paths they find survive the
+ * round. Graph is only read
+ */
+static void *
+Graph_ch_contract_worker(void *arg) {
+
+    Graph_thread_t        *T = (Graph_thread_t *)arg;
+    Graph_ch_builder_t    *B = (Graph_ch_builder_t *)T->shared;
+    Graph_ch_local_t      *L = &B->locals[T->id];
+    Graph_ch_batch_t      *entry;
+    long                   first;
+    long                   last;
+    long                   iterator;
+    long                   count;
+
+    while (Graph_work_queue_take(B->queues, T, 8, &first, &last)) {
+      for (iterator = first; iterator < last; iterator++) {
+        entry        = &B->batch[iterator];
+        entry->first = L->shortcuts.count;
+        count        = Graph_ch_shortcuts(B, L, entry->vertex, TRUE);
+        if (count < 0) {
+          __atomic_store_n(&B->failed, TRUE, __ATOMIC_RELAXED);
+          return NULL;
+        }
+        entry->thread = T->id;
+        entry->count  = count;
+      }
+    }
+
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_ch_run
+ *
+ * In this function we run routine over total items
+ * on threads of the builder. Threads which did start
+ * take over items of the others
+ */
+static bool
+Graph_ch_run(Graph_ch_builder_t *B, void *(*routine)(void *), long total) {
+
+    int                  iterator;
+
+    Graph_work_queue_init(B->queues, B->no_of_threads, total);
+    Graph_parallel_run(B->no_of_threads, routine, B);
+
+    /* Items are left only if no thread could run */
+    for (iterator = 0; iterator < B->no_of_threads; iterator++) {
+      if (B->queues[iterator].next < B->queues[iterator].end) {
+        B->failed = TRUE;
+      }
+    }
+
+    return !B->failed;
+}
+
+/*
+ * Function:
+ * Graph_ch_neighbor_done
+ *
+ * In this function we note that neighbor of
+ * vertex lost it, its priority is computed again
+ * before next round
+ */
+static void
+Graph_ch_neighbor_done(Graph_ch_builder_t *B, vertex_number_t vertex,
+                       vertex_number_t neighbor) {
+
+    B->deleted[neighbor]++;
+    if (B->level[neighbor] <= B->level[vertex]) {
+      B->level[neighbor] = B->level[vertex] + 1;
+    }
+    B->dirty[neighbor] = TRUE;
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_ch_contract
+ *
+ * In this function we contract vertex: its remaining
+ * edges go to up / down (all neighbors are ranked higher),
+ * shortcuts found by Graph_ch_contract_worker replace
+ * paths through it and it is removed from lists of its
+ * neighbors
+ */
+static bool
+Graph_ch_contract(Graph_ch_builder_t *B, const Graph_ch_batch_t *entry,
+                  edge_index_t *shortcuts) {
+
+    vertex_number_t      vertex = entry->vertex;
+    Graph_ch_list_t     *in     = &B->in[vertex];
+    Graph_ch_list_t     *out    = &B->out[vertex];
+    Graph_ch_edges_t    *found  = &B->locals[entry->thread].shortcuts;
+    Graph_ch_edges_t    *sorted = &B->pending;
+    vertex_number_t      iterator;
+    vertex_number_t      neighbor;
+    edge_index_t         position;
+    edge_index_t         start;
+    edge_index_t         end    = entry->first + entry->count;
+
+    for (iterator = 0; iterator < out->count; iterator++) {
+      if (!Graph_ch_edges_add(&B->up, vertex, out->arcs[iterator].vertex,
+                              out->arcs[iterator].weight)) {
+        return FALSE;
+      }
+    }
+    for (iterator = 0; iterator < in->count; iterator++) {
+      if (!Graph_ch_edges_add(&B->down, vertex, in->arcs[iterator].vertex,
+                              in->arcs[iterator].weight)) {
+        return FALSE;
+      }
+    }
+
+    /* Outgoing lists of incoming neighbors, shortcuts come grouped by them */
+    position = entry->first;
+    for (iterator = 0; iterator < in->count; iterator++) {
+      neighbor = in->arcs[iterator].vertex;
+      for (start = position; position < end && found->src[position] == neighbor;
+           position++) {
+      }
+      if (!Graph_ch_list_merge(B, &B->out[neighbor], vertex, found->dst + start,
+                               found->weight + start, position - start)) {
+        return FALSE;
+      }
+      Graph_ch_neighbor_done(B, vertex, neighbor);
+    }
+
+    /* Incoming lists of outgoing neighbors, shortcuts counting sorted by target */
+    if (!Graph_ch_edges_reserve(sorted, entry->count)) {
+      return FALSE;
+    }
+    for (iterator = 0; iterator <= out->count; iterator++) {
+      B->offsets[iterator] = 0;
+    }
+    for (iterator = 0; iterator < out->count; iterator++) {
+      B->slot[out->arcs[iterator].vertex] = iterator;
+    }
+    for (position = entry->first; position < end; position++) {
+      B->offsets[B->slot[found->dst[position]] + 1]++;
+    }
+    for (iterator = 0; iterator < out->count; iterator++) {
+      B->offsets[iterator + 1] += B->offsets[iterator];
+    }
+    for (position = entry->first; position < end; position++) {
+      start = B->offsets[B->slot[found->dst[position]]]++;
+      sorted->src[start]    = found->src[position];
+      sorted->weight[start] = found->weight[position];
+    }
+    for (iterator = 0; iterator < out->count; iterator++) {
+      B->slot[out->arcs[iterator].vertex] = -1;
+    }
+
+    /* offsets[i] now ends shortcuts of target i */
+    start = 0;
+    for (iterator = 0; iterator < out->count; iterator++) {
+      neighbor = out->arcs[iterator].vertex;
+      if (!Graph_ch_list_merge(B, &B->in[neighbor], vertex, sorted->src + start,
+                               sorted->weight + start, B->offsets[iterator] - start)) {
+        return FALSE;
+      }
+      start = B->offsets[iterator];
+      Graph_ch_neighbor_done(B, vertex, neighbor);
+    }
+    *shortcuts += entry->count;
+
+    free(in->arcs);
+    free(out->arcs);
+    memset(in, 0, sizeof(*in));
+    memset(out, 0, sizeof(*out));
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_ch_builder_release
+ *
+ * In this function we free state of preprocessing
+ */
+static void
+Graph_ch_builder_release(Graph_ch_builder_t *B) {
+
+    vertex_number_t      vertex;
+    int                  iterator;
+
+    if (B->out != NULL) {
+      for (vertex = 0; vertex < B->total; vertex++) {
+        free(B->out[vertex].arcs);
+      }
+    }
+    if (B->in != NULL) {
+      for (vertex = 0; vertex < B->total; vertex++) {
+        free(B->in[vertex].arcs);
+      }
+    }
+    if (B->locals != NULL) {
+      for (iterator = 0; iterator < B->no_of_threads; iterator++) {
+        Graph_workspace_destroy(B->locals[iterator].W);
+        free(B->locals[iterator].hops);
+        free(B->locals[iterator].target);
+        Graph_ch_edges_release(&B->locals[iterator].shortcuts);
+      }
+    }
+
+    free(B->out);
+    free(B->in);
+    free(B->deleted);
+    free(B->level);
+    free(B->priority);
+    free(B->dirty);
+    free(B->selected);
+    free(B->contracting);
+    free(B->slot);
+    free(B->remaining);
+    free(B->batch);
+    free(B->offsets);
+    Graph_aligned_free(B->locals);
+    Graph_aligned_free(B->queues);
+    Graph_ch_edges_release(&B->up);
+    Graph_ch_edges_release(&B->down);
+    Graph_ch_edges_release(&B->pending);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_ch_order
+ *
+ * In this function we contract all vertices in
+ * rounds. Every round vertices which go before all
+ * vertices around them are picked; stale priorities
+ * of picked ones are computed again and picking is
+ * repeated till all picked ones are up to date. Their
+ * shortcuts are then found in parallel and they are
+ * contracted one after other
+ */
+static bool
+Graph_ch_order(Graph_ch_builder_t *B, edge_index_t *shortcuts) {
+
+    vertex_number_t      vertex;
+    vertex_number_t      iterator;
+    vertex_number_t      kept;
+    int                  thread;
+
+    /* All vertices start selected, so all priorities are computed */
+    if (!Graph_ch_run(B, Graph_ch_priority_worker, B->remaining_count)) {
+      return FALSE;
+    }
+
+    while (B->remaining_count > 0) {
+      for (;;) {
+        if (!Graph_ch_run(B, Graph_ch_select_worker, B->remaining_count)) {
+          return FALSE;
+        }
+        B->refreshed = FALSE;
+        if (!Graph_ch_run(B, Graph_ch_priority_worker, B->remaining_count)) {
+          return FALSE;
+        }
+        if (!B->refreshed) {
+          break;
+        }
+      }
+
+      B->batch_count = 0;
+      kept           = 0;
+      for (iterator = 0; iterator < B->remaining_count; iterator++) {
+        vertex = B->remaining[iterator];
+        if (B->selected[vertex]) {
+          B->selected[vertex]    = FALSE;
+          B->contracting[vertex] = TRUE;
+          B->batch[B->batch_count++].vertex = vertex;
+        } else {
+          B->remaining[kept++] = vertex;
+        }
+      }
+      B->remaining_count = kept;
+
+      /* Vertex going first overall is always picked */
+      if (B->batch_count == 0 ||
+          !Graph_ch_run(B, Graph_ch_contract_worker, B->batch_count)) {
+        return FALSE;
+      }
+
+      for (iterator = 0; iterator < B->batch_count; iterator++) {
+        if (!Graph_ch_contract(B, &B->batch[iterator], shortcuts)) {
+          return FALSE;
+        }
+      }
+      for (iterator = 0; iterator < B->batch_count; iterator++) {
+        B->contracting[B->batch[iterator].vertex] = FALSE;
+      }
+      for (thread = 0; thread < B->no_of_threads; thread++) {
+        B->locals[thread].shortcuts.count = 0;
+      }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_ch_build
+ *
+ * In this function we build Contraction Hierarchy
+ * of the Graph. Graph is only read, later changes
+ * to it are not reflected. Priorities and shortcuts
+ * are computed by Graph threads (see
+ * Graph_set_num_threads)
+ *
+ * Input:
+ *      Graph_t  - Graph (non negative weights)
+ * Output:
+ *      Graph_ch_t Object or NULL
+ */
+Graph_ch_t *
+Graph_ch_build(const Graph_t *G) {
+
+    Graph_ch_builder_t   B;
+    Graph_ch_local_t    *L;
+    Graph_ch_list_t     *list;
+    Graph_ch_t          *H = NULL;
+    Graph_csr_t         *C;
+    vertex_number_t      row;
+    vertex_number_t      iterator;
+    edge_index_t         position;
+    int                  thread;
+
+    memset(&B, 0, sizeof(B));
+
+    C = Graph_freeze(G);
+    if (C == NULL) {
+      LOG_ERR("Unable to freeze Graph for Contraction Hierarchy");
+      return NULL;
+    }
+
+    B.total       = C->total_vertices;
+    B.out         = (Graph_ch_list_t *)calloc(B.total + 1, sizeof(Graph_ch_list_t));
+    B.in          = (Graph_ch_list_t *)calloc(B.total + 1, sizeof(Graph_ch_list_t));
+    B.deleted     = (vertex_number_t *)calloc(B.total + 1, sizeof(vertex_number_t));
+    B.level       = (vertex_number_t *)calloc(B.total + 1, sizeof(vertex_number_t));
+    B.priority    = (long *)calloc(B.total + 1, sizeof(long));
+    B.dirty       = (char *)malloc(B.total + 1);
+    B.selected    = (char *)malloc(B.total + 1);
+    B.contracting = (char *)calloc(B.total + 1, sizeof(char));
+    B.slot        = (vertex_number_t *)malloc((B.total + 1) * sizeof(vertex_number_t));
+    B.remaining   = (vertex_number_t *)malloc((B.total + 1) * sizeof(vertex_number_t));
+    B.batch       = (Graph_ch_batch_t *)malloc((B.total + 1) * sizeof(Graph_ch_batch_t));
+    B.offsets     = (edge_index_t *)malloc((B.total + 2) * sizeof(edge_index_t));
+    H             = (Graph_ch_t *)calloc(1, sizeof(Graph_ch_t));
+    if (B.out == NULL || B.in == NULL || B.deleted == NULL || B.level == NULL ||
+        B.priority == NULL || B.dirty == NULL || B.selected == NULL ||
+        B.contracting == NULL ||
+        B.slot == NULL || B.remaining == NULL || B.batch == NULL ||
+        B.offsets == NULL || H == NULL) {
+      LOG_ERR("Unable to allocate Contraction Hierarchy for %d vertices",B.total);
+      goto destroy;
+    }
+
+    memset(B.dirty, TRUE, B.total + 1);
+    memset(B.selected, TRUE, B.total + 1);
+    for (row = 0; row < B.total; row++) {
+      B.slot[row]      = -1;
+      B.remaining[row] = row;
+    }
+    B.remaining_count = B.total;
+
+    /* Parallel edges collapse to the lightest one, self loops never help */
+    for (row = 0; row < B.total; row++) {
+      position = C->offsets[row];
+      if (!Graph_ch_list_merge(&B, &B.out[row], row, C->targets + position,
+                               C->weights + position, C->offsets[row + 1] - position)) {
+        goto destroy;
+      }
+    }
+    for (row = 0; row < B.total; row++) {
+      for (iterator = 0; iterator < B.out[row].count; iterator++) {
+        list = &B.in[B.out[row].arcs[iterator].vertex];
+        if (!Graph_ch_list_reserve(list, 1)) {
+          goto destroy;
+        }
+        list->arcs[list->count].vertex = row;
+        list->arcs[list->count].weight = B.out[row].arcs[iterator].weight;
+        list->count++;
+      }
+    }
+
+    B.no_of_threads = Graph_resolve_threads(G->num_threads);
+    if (B.no_of_threads > B.total) {
+      B.no_of_threads = (B.total > 0) ? B.total : 1;
+    }
+    B.locals = (Graph_ch_local_t *)Graph_aligned_calloc(B.no_of_threads,
+                                                        sizeof(Graph_ch_local_t));
+    B.queues = (Graph_work_queue_t *)Graph_aligned_calloc(B.no_of_threads,
+                                                          sizeof(Graph_work_queue_t));
+    if (B.locals == NULL || B.queues == NULL) {
+      LOG_ERR("Unable to allocate work queues for %d threads",B.no_of_threads);
+      goto destroy;
+    }
+    for (thread = 0; thread < B.no_of_threads; thread++) {
+      L         = &B.locals[thread];
+      L->W      = Graph_workspace_create(B.total);
+      L->hops   = (int *)malloc((B.total + 1) * sizeof(int));
+      L->target = (char *)calloc(B.total + 1, sizeof(char));
+      if (L->W == NULL || L->hops == NULL || L->target == NULL) {
+        LOG_ERR("Unable to create workspace for thread %d",thread);
+        goto destroy;
+      }
+    }
+
+    if (!Graph_ch_order(&B, &H->shortcuts)) {
+      goto destroy;
+    }
+
+    H->total_vertices = B.total;
+    H->heap_type      = G->heap_type;
+    H->up   = Graph_csr_from_edges(B.total, B.up.src, B.up.dst, B.up.weight,
+                                   B.up.count, TRUE);
+    H->down = Graph_csr_from_edges(B.total, B.down.src, B.down.dst, B.down.weight,
+                                   B.down.count, TRUE);
+    if (H->up == NULL || H->down == NULL) {
+      goto destroy;
+    }
+
+    /* Vertex IDs of the Graph are resolved through up */
+    memcpy(H->up->vertex_ids, C->vertex_ids, B.total * sizeof(vertex_number_t));
+    if (!Graph_csr_index_rows(H->up)) {
+      goto destroy;
+    }
+
+    Graph_ch_builder_release(&B);
+    Graph_csr_destroy(C);
+
+    return H;
+
+destroy:
+    LOG_ERR("Unable to build Contraction Hierarchy");
+    Graph_ch_builder_release(&B);
+    Graph_csr_destroy(C);
+    Graph_ch_destroy(H);
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_ch_destroy
+ *
+ * In this function we release Contraction Hierarchy
+ *
+ * Input:
+ *      Graph_ch_t  - CH Pointer (can be NULL)
+ * Output:
+ *      none
+ */
+void
+Graph_ch_destroy(Graph_ch_t *H) {
+
+    if (H == NULL) {
+      return;
+    }
+
+    Graph_csr_destroy(H->up);
+    Graph_csr_destroy(H->down);
+    free(H);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_ch_query
+ *
+ * In this function we find shortest distance from
+ * Source to Target. Both searches only climb to higher
+ * ranked vertices, each stops once its frontier is not
+ * closer than the best meeting found. Workspaces are
+ * owned by the caller, so queries run concurrently
+ *
+ * Input:
+ *      Graph_ch_t         - Contraction Hierarchy
+ *      Graph_workspace_t  - forward workspace (capacity >= total_vertices)
+ *      Graph_workspace_t  - backward workspace (capacity >= total_vertices)
+ *      vertex_number_t    - Source
+ *      vertex_number_t    - Target
+ * Output:
+ *      long - distance, GRAPH_INFINITE_DISTANCE if Target
+ *             is unreachable or on failure
+ */
+long
+Graph_ch_query(const Graph_ch_t *H, Graph_workspace_t *W, Graph_workspace_t *Wr,
+               vertex_number_t S, vertex_number_t T) {
+
+    const Graph_csr_t   *C;
+    Graph_workspace_t   *side;
+    Graph_workspace_t   *other;
+    vertex_number_t      source;
+    vertex_number_t      target;
+    vertex_number_t      vertex;
+    edge_index_t         position;
+    long                 best = GRAPH_INFINITE_DISTANCE;
+    long                 max_weight;
+    bool                 forward_done;
+    bool                 backward_done;
+
+    if (H == NULL || W == NULL || Wr == NULL ||
+        W->capacity < H->total_vertices || Wr->capacity < H->total_vertices) {
+      LOG_ERR("Provided CH is NULL or workspace is too small");
+      return GRAPH_INFINITE_DISTANCE;
+    }
+
+    source = Graph_csr_get_row(H->up, S);
+    target = Graph_csr_get_row(H->up, T);
+    if (source < 0 || target < 0) {
+      LOG_ERR("Unable to find vertex %d or %d",S,T);
+      return GRAPH_INFINITE_DISTANCE;
+    }
+
+    max_weight = H->up->max_weight;
+    if (max_weight >= 0 && (H->down->max_weight < 0 || H->down->max_weight > max_weight)) {
+      max_weight = H->down->max_weight;
+    }
+
+    Graph_workspace_reset(W);
+    Graph_workspace_reset(Wr);
+    Graph_heap_set_type(W->heap, H->heap_type, max_weight);
+    Graph_heap_set_type(Wr->heap, H->heap_type, max_weight);
+    W->source  = source;
+    Wr->source = target;
+    GRAPH_STATS_ADD(&W->stats, queries, 1);
+    Graph_workspace_relax(W, source, -1, 0);
+    Graph_workspace_relax(Wr, target, -1, 0);
+
+    while (TRUE) {
+      forward_done  = Graph_heap_top_key(W->heap) >= best;
+      backward_done = Graph_heap_top_key(Wr->heap) >= best;
+      if (forward_done && backward_done) {
+        break;
+      }
+
+      if (!forward_done &&
+          (backward_done || Graph_heap_top_key(W->heap) <= Graph_heap_top_key(Wr->heap))) {
+        side  = W;
+        other = Wr;
+        C     = H->up;
+      } else {
+        side  = Wr;
+        other = W;
+        C     = H->down;
+      }
+
+      GRAPH_STATS_TIMED(&side->stats, heap_pops, frontier_ticks,
+                        vertex = Graph_heap_pop(side->heap));
+      GRAPH_STATS_ADD(&side->stats, vertices_settled, 1);
+      if (other->min_distance[vertex] != GRAPH_INFINITE_DISTANCE &&
+          side->min_distance[vertex] + other->min_distance[vertex] < best) {
+        best = side->min_distance[vertex] + other->min_distance[vertex];
+      }
+
+      GRAPH_STATS_BEGIN(side);
+      for (position = C->offsets[vertex]; position < C->offsets[vertex + 1]; position++) {
+        Graph_workspace_relax(side, C->targets[position], vertex,
+                              side->min_distance[vertex] + C->weights[position]);
+      }
+      GRAPH_STATS_END(side, relax_ticks);
+    }
+
+    return best;
+}
+
+/*
+ * Function:
+ * Graph_ch_distance
+ *
+ * In this function we find shortest distance from
+ * Source to Target, see Graph_ch_query. Workspaces
+ * are created for the call, which costs O(vertices);
+ * reuse them with Graph_ch_query on hot paths
+ */
+long
+Graph_ch_distance(const Graph_ch_t *H, vertex_number_t S, vertex_number_t T) {
+
+    Graph_workspace_t   *W;
+    Graph_workspace_t   *Wr;
+    long                 distance = GRAPH_INFINITE_DISTANCE;
+
+    if (H == NULL) {
+      LOG_ERR("Provided CH is NULL");
+      return distance;
+    }
+
+    W  = Graph_workspace_create(H->total_vertices);
+    Wr = Graph_workspace_create(H->total_vertices);
+    if (W != NULL && Wr != NULL) {
+      distance = Graph_ch_query(H, W, Wr, S, T);
+    }
+
+    Graph_workspace_destroy(W);
+    Graph_workspace_destroy(Wr);
+
+    return distance;
+}
+
+/*
+ * Arrays of CH file in file order
+ */
+static void
+Graph_ch_arrays(const Graph_ch_t *H, void *data[7], size_t size[7]) {
+
+    data[0] = H->up->vertex_ids;
+    size[0] = H->total_vertices * sizeof(vertex_number_t);
+    data[1] = H->up->offsets;
+    size[1] = (H->total_vertices + 1) * sizeof(edge_index_t);
+    data[2] = H->up->targets;
+    size[2] = H->up->total_edges * sizeof(vertex_number_t);
+    data[3] = H->up->weights;
+    size[3] = H->up->total_edges * sizeof(edge_weight_t);
+    data[4] = H->down->offsets;
+    size[4] = (H->total_vertices + 1) * sizeof(edge_index_t);
+    data[5] = H->down->targets;
+    size[5] = H->down->total_edges * sizeof(vertex_number_t);
+    data[6] = H->down->weights;
+    size[6] = H->down->total_edges * sizeof(edge_weight_t);
+
+    return;
+}
+
+static uint64_t
+Graph_ch_header_checksum(const Graph_ch_header_t *header) {
+
+    Graph_ch_header_t    copy = *header;
+
+    copy.header_checksum = 0;
+
+    return Graph_checksum(GRAPH_CHECKSUM_SEED, &copy, sizeof(copy));
+}
+
+/*
+ * Function:
+ * Graph_ch_save
+ *
+ * In this function we write Contraction Hierarchy
+ * to file, so preprocessing is done once offline
+ *
+ * Input:
+ *      Graph_ch_t    - Contraction Hierarchy
+ *      const char *  - path
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- On Failure
+ */
+bool
+Graph_ch_save(const Graph_ch_t *H, const char *path) {
+
+    Graph_ch_header_t    header;
+    void                *data[7];
+    size_t               size[7];
+    FILE                *file;
+    int                  array;
+    bool                 result;
+
+    if (H == NULL) {
+      LOG_ERR("Provided CH to save is NULL");
+      return FALSE;
+    }
+
+    Graph_ch_arrays(H, data, size);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GRAPH_CH_MAGIC, 4);
+    header.version          = GRAPH_CH_VERSION;
+    header.endian           = 0x01020304u;
+    header.vertex_size      = sizeof(vertex_number_t);
+    header.weight_size      = sizeof(edge_weight_t);
+    header.index_size       = sizeof(edge_index_t);
+    header.total_vertices   = H->total_vertices;
+    header.up_edges         = H->up->total_edges;
+    header.down_edges       = H->down->total_edges;
+    header.shortcuts        = H->shortcuts;
+    header.payload_checksum = GRAPH_CHECKSUM_SEED;
+    for (array = 0; array < 7; array++) {
+      header.payload_checksum = Graph_checksum(header.payload_checksum,
+                                               data[array], size[array]);
+    }
+    header.header_checksum  = Graph_ch_header_checksum(&header);
+
+    file = fopen(path, "wb");
+    if (file == NULL) {
+      LOG_ERR("Unable to create %s",path);
+      return FALSE;
+    }
+
+    result = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (array = 0; array < 7 && result; array++) {
+      result = size[array] == 0 || fwrite(data[array], size[array], 1, file) == 1;
+    }
+
+    if (fclose(file) != 0) {
+      result = FALSE;
+    }
+
+    if (!result) {
+      LOG_ERR("Unable to write Contraction Hierarchy %s",path);
+    }
+
+    return result;
+}
+
+/*
+ * Function:
+ * Graph_ch_load
+ *
+ * In this function we read Contraction Hierarchy
+ * written by Graph_ch_save, verifying its checksums
+ *
+ * Input:
+ *      const char *  - path
+ * Output:
+ *      Graph_ch_t Object or NULL
+ */
+Graph_ch_t *
+Graph_ch_load(const char *path) {
+
+    Graph_ch_header_t    header;
+    Graph_ch_t          *H = NULL;
+    FILE                *file;
+    void                *data[7];
+    size_t               size[7];
+    uint64_t             checksum = GRAPH_CHECKSUM_SEED;
+    vertex_number_t      row;
+    int                  array;
+
+    file = fopen(path, "rb");
+    if (file == NULL) {
+      LOG_ERR("Unable to open %s",path);
+      return NULL;
+    }
+
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, GRAPH_CH_MAGIC, 4) != 0 ||
+        header.version != GRAPH_CH_VERSION ||
+        header.header_checksum != Graph_ch_header_checksum(&header)) {
+      LOG_ERR("Contraction Hierarchy %s is corrupt or of unsupported version",path);
+      goto destroy;
+    }
+
+    if (header.endian != 0x01020304u ||
+        header.vertex_size != sizeof(vertex_number_t) ||
+        header.weight_size != sizeof(edge_weight_t) ||
+        header.index_size != sizeof(edge_index_t) ||
+        header.total_vertices > INT_MAX) {
+      LOG_ERR("Contraction Hierarchy %s was written on an incompatible machine",path);
+      goto destroy;
+    }
+
+    H = (Graph_ch_t *)calloc(1, sizeof(Graph_ch_t));
+    if (H == NULL) {
+      LOG_ERR("Unable to allocate Contraction Hierarchy");
+      goto destroy;
+    }
+    H->total_vertices = (vertex_number_t)header.total_vertices;
+    H->shortcuts      = (edge_index_t)header.shortcuts;
+    H->heap_type      = GRAPH_HEAP_AUTO;
+    H->up   = Graph_csr_template(H->total_vertices, (edge_index_t)header.up_edges);
+    H->down = Graph_csr_template(H->total_vertices, (edge_index_t)header.down_edges);
+    if (H->up == NULL || H->down == NULL) {
+      goto destroy;
+    }
+    H->up->is_directed   = TRUE;
+    H->down->is_directed = TRUE;
+
+    Graph_ch_arrays(H, data, size);
+    for (array = 0; array < 7; array++) {
+      if (size[array] > 0 && fread(data[array], size[array], 1, file) != 1) {
+        LOG_ERR("Contraction Hierarchy %s is truncated",path);
+        goto destroy;
+      }
+      checksum = Graph_checksum(checksum, data[array], size[array]);
+    }
+
+    if (checksum != header.payload_checksum) {
+      LOG_ERR("Contraction Hierarchy %s payload checksum mismatch",path);
+      goto destroy;
+    }
+
+    /* down rows are internal, up rows carry Vertex IDs */
+    for (row = 0; row < H->total_vertices; row++) {
+      H->down->vertex_ids[row] = row;
+    }
+    if (!Graph_csr_index_rows(H->up) || !Graph_csr_index_rows(H->down)) {
+      goto destroy;
+    }
+    H->up->max_weight   = Graph_csr_max_weight(H->up);
+    H->down->max_weight = Graph_csr_max_weight(H->down);
+
+    fclose(file);
+
+    return H;
+
+destroy:
+    fclose(file);
+    Graph_ch_destroy(H);
+    return NULL;
+}
@@ -0,0 +1,1088 @@
+/*
+ * In this File we define Connected Components (direction
+ * of edges ignored) and Strongly Connected Components
+ * (directed Graphs) over CSR snapshot.
+ *
+ * Connected Components link endpoints of every edge in a
+ * concurrent union-find, threads taking rows in chunks.
+ * Roots are always linked towards smaller index, so root of
+ * every component is its smallest vertex.
+ *
+ * Strongly Connected Components are found either with
+ * Tarjan (one depth first search, explicit stack instead of
+ * recursion) or in parallel with forward-backward steps:
+ *      - trim: vertices without incoming or outgoing edges
+ *        are components of their own, repeated as their
+ *        edges are taken off neighbors
+ *      - forward-backward: vertices reached from a pivot and
+ *        reaching it are one component, likely the giant one
+ *      - coloring: largest index reaching a vertex is pushed
+ *        forward until nothing changes, every vertex keeping
+ *        its own index is root of a component made of the
+ *        same colored vertices reaching it. Repeated on what
+ *        is left
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#include "graph.h"
+
+#define GRAPH_COMPONENTS_CHUNK    256    /* Rows taken at once */
+
+/*
+ * State shared by threads of one step
+ */
+typedef struct graph_components_ {
+    const Graph_csr_t   *C;             /* Outgoing edges */
+    const Graph_csr_t   *R;             /* Incoming edges */
+    const Graph_csr_t   *walk;          /* Reach: edges followed */
+    vertex_number_t     *parent;        /* Union-find forest */
+    vertex_number_t     *component;     /* Representative, -1 if not found yet */
+    vertex_number_t     *color;         /* Forward-backward marks and colors */
+    vertex_number_t     *frontier;      /* Reach: current level */
+    vertex_number_t     *next;          /* Reach: next level */
+    long                 frontier_size;
+    long                 next_size;
+    vertex_number_t     *rest;          /* Vertices without component */
+    long                 rest_size;
+    long                *in_degree;     /* Trim: edges from vertices left */
+    long                *out_degree;    /* Trim: edges to vertices left */
+    vertex_number_t      from;          /* Reach: color of eligible vertices */
+    vertex_number_t      to;            /* Reach: color of reached vertices */
+    Graph_work_queue_t  *queues;
+    Graph_barrier_t      barrier;
+    bool                 changed;       /* Coloring: set if a color moved */
+    bool                 failed;        /* Set if a thread could not allocate */
+} Graph_components_t;
+
+/*
+ * Function:
+ * Graph_components_find
+ *
+ * In this function we find root of vertex, halving
+ * path on the way. Roots only ever get linked, so
+ * stale reads just take a longer walk
+ */
+static vertex_number_t
+Graph_components_find(vertex_number_t *parent, vertex_number_t vertex) {
+
+    vertex_number_t      up;
+    vertex_number_t      grand;
+
+    for (;;) {
+      up = __atomic_load_n(&parent[vertex], __ATOMIC_RELAXED);
+      if (up == vertex) {
+        return vertex;
+      }
+      grand = __atomic_load_n(&parent[up], __ATOMIC_RELAXED);
+      if (grand != up) {
+        __atomic_compare_exchange_n(&parent[vertex], &up, grand, FALSE,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+      }
+      vertex = grand;
+    }
+}
+
+/*
+ * Function:
+ * Graph_components_union
+ *
+ * In this function we join trees of both vertices,
+ * root with larger index is linked below the other.
+ * Link is a compare and swap on a root, retried when
+ * another thread linked that root first
+ */
+static void
+Graph_components_union(vertex_number_t *parent, vertex_number_t first,
+                       vertex_number_t second) {
+
+    vertex_number_t      swap;
+    vertex_number_t      root;
+
+    for (;;) {
+      first  = Graph_components_find(parent, first);
+      second = Graph_components_find(parent, second);
+      if (first == second) {
+        return;
+      }
+      if (first < second) {
+        swap   = first;
+        first  = second;
+        second = swap;
+      }
+      root = first;
+      if (__atomic_compare_exchange_n(&parent[first], &root, second, FALSE,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        return;
+      }
+    }
+}
+
+/*
+ * Function:
+ * Graph_components_link_worker
+ *
+ * In this function thread joins endpoints of all
+ * edges of rows it takes
+ */
+static void *
+Graph_components_link_worker(void *arg) {
+
+    Graph_thread_t      *T = (Graph_thread_t *)arg;
+    Graph_components_t  *S = (Graph_components_t *)T->shared;
+    const Graph_csr_t   *C = S->C;
+    edge_index_t         position;
+    long                 first;
+    long                 last;
+    long                 row;
+
+    while (Graph_work_queue_take(S->queues, T, GRAPH_COMPONENTS_CHUNK, &first, &last)) {
+      for (row = first; row < last; row++) {
+        for (position = C->offsets[row]; position < C->offsets[row + 1]; position++) {
+          Graph_components_union(S->parent, (vertex_number_t)row, C->targets[position]);
+        }
+      }
+    }
+
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_components_flatten_worker
+ *
+ * In this function thread points every vertex of
+ * rows it takes straight at its root
+ */
+static void *
+Graph_components_flatten_worker(void *arg) {
+
+    Graph_thread_t      *T = (Graph_thread_t *)arg;
+    Graph_components_t  *S = (Graph_components_t *)T->shared;
+    long                 first;
+    long                 last;
+    long                 row;
+
+    while (Graph_work_queue_take(S->queues, T, GRAPH_COMPONENTS_CHUNK, &first, &last)) {
+      for (row = first; row < last; row++) {
+        S->component[row] = Graph_components_find(S->parent, (vertex_number_t)row);
+      }
+    }
+
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_components_run
+ *
+ * In this function we run routine over total items
+ * on threads of the snapshot
+ */
+static bool
+Graph_components_run(Graph_components_t *S, void *(*routine)(void *), long total) {
+
+    int                  no_of_threads;
+
+    no_of_threads = Graph_resolve_threads(S->C->num_threads);
+    Graph_work_queue_init(S->queues, no_of_threads, total);
+
+    /* Threads which did start cover for the ones which did not */
+    Graph_parallel_run(no_of_threads, routine, S);
+
+    return !S->failed;
+}
+
+/*
+ * Function:
+ * Graph_components_number
+ *
+ * In this function we replace representative of
+ * every vertex by component ID, IDs are handed out
+ * in order of first vertex of every component
+ *
+ * Input:
+ *      vertex_number_t *  - representative per row (Input/Output)
+ *      vertex_number_t    - no of rows
+ *      vertex_number_t *  - scratch of no of rows entries
+ * Output:
+ *      vertex_number_t    - no of components
+ */
+static vertex_number_t
+Graph_components_number(vertex_number_t *component, vertex_number_t no_of_rows,
+                        vertex_number_t *scratch) {
+
+    vertex_number_t      count = 0;
+    vertex_number_t      row;
+
+    for (row = 0; row < no_of_rows; row++) {
+      scratch[row] = -1;
+    }
+
+    for (row = 0; row < no_of_rows; row++) {
+      if (scratch[component[row]] == -1) {
+        scratch[component[row]] = count++;
+      }
+      component[row] = scratch[component[row]];
+    }
+
+    return count;
+}
+
+/*
+ * Function
+ * Graph_csr_connected_components
+ *
+ * In this function we find connected components of
+ * CSR snapshot, direction of edges is ignored (weakly
+ * connected components of directed snapshot). Rows
+ * are spread over threads of the snapshot
+ *
+ * Input:
+ *       Graph_csr_t * C
+ *       vertex_number_t * component (Output, total_vertices entries by row)
+ * Output:
+ *       vertex_number_t - no of components, IDs run 0 .. count-1
+ *                         in order of first row of every component
+ *                         -1 <-- On Failure
+ */
+vertex_number_t
+Graph_csr_connected_components(const Graph_csr_t *C, vertex_number_t *component) {
+
+    Graph_components_t   S;
+    vertex_number_t      count = -1;
+    vertex_number_t      row;
+
+    if (C == NULL || component == NULL) {
+      LOG_ERR("Provided CSR or component array is NULL");
+      return -1;
+    }
+
+    memset(&S, 0, sizeof(S));
+    S.C         = C;
+    S.component = component;
+    S.parent    = (vertex_number_t *)malloc((C->total_vertices + 1) * sizeof(vertex_number_t));
+    S.queues    = (Graph_work_queue_t *)Graph_aligned_calloc(
+                                        Graph_resolve_threads(C->num_threads),
+                                        sizeof(Graph_work_queue_t));
+    if (S.parent == NULL || S.queues == NULL) {
+      LOG_ERR("Unable to allocate union-find for %d vertices",C->total_vertices);
+      goto destroy;
+    }
+
+    for (row = 0; row < C->total_vertices; row++) {
+      S.parent[row] = row;
+    }
+
+    if (!Graph_components_run(&S, Graph_components_link_worker, C->total_vertices) ||
+        !Graph_components_run(&S, Graph_components_flatten_worker, C->total_vertices)) {
+      goto destroy;
+    }
+
+    /* Root is smallest vertex of its component, so it is numbered first */
+    count = 0;
+    for (row = 0; row < C->total_vertices; row++) {
+      component[row] = (component[row] == row) ? count++ : component[component[row]];
+    }
+
+destroy:
+    free(S.parent);
+    Graph_aligned_free(S.queues);
+
+    return count;
+}
+
+/*
+ * Function:
+ * Graph_scc_tarjan
+ *
+ * In this function we find strongly connected
+ * components with Tarjan. Depth first search keeps
+ * (vertex, next edge) frames on an explicit stack,
+ * so depth of Graph is not bound by call stack.
+ * component receives representative of every row
+ */
+static bool
+Graph_scc_tarjan(const Graph_csr_t *C, vertex_number_t *component) {
+
+    vertex_number_t     *order;         /* Discovery order, -1 if not seen */
+    vertex_number_t     *low;           /* Smallest order reachable */
+    vertex_number_t     *stack;         /* Vertices of open components */
+    vertex_number_t     *frames;        /* Search path */
+    edge_index_t        *cursor;        /* Next edge of every frame */
+    vertex_number_t      stack_size = 0;
+    vertex_number_t      depth;
+    vertex_number_t      counter = 0;
+    vertex_number_t      root;
+    vertex_number_t      vertex;
+    vertex_number_t      target;
+    vertex_number_t      member;
+    size_t               slots;
+    bool                 result = FALSE;
+
+    slots  = (C->total_vertices > 0) ? (size_t)C->total_vertices : 1;
+    order  = (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    low    = (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    stack  = (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    frames = (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    cursor = (edge_index_t *)malloc(slots * sizeof(edge_index_t));
+    if (order == NULL || low == NULL || stack == NULL || frames == NULL || cursor == NULL) {
+      LOG_ERR("Unable to allocate Tarjan stacks for %d vertices",C->total_vertices);
+      goto destroy;
+    }
+
+    for (vertex = 0; vertex < C->total_vertices; vertex++) {
+      order[vertex]     = -1;
+      component[vertex] = -1;
+    }
+
+    for (root = 0; root < C->total_vertices; root++) {
+      if (order[root] != -1) {
+        continue;
+      }
+
+      depth = 0;
+      frames[depth] = root;
+      cursor[depth] = C->offsets[root];
+      order[root] = low[root] = counter++;
+      stack[stack_size++] = root;
+
+      while (depth >= 0) {
+        vertex = frames[depth];
+
+        if (cursor[depth] < C->offsets[vertex + 1]) {
+          target = C->targets[cursor[depth]++];
+          if (order[target] == -1) {
+            /* Descend */
+            depth++;
+            frames[depth] = target;
+            cursor[depth] = C->offsets[target];
+            order[target] = low[target] = counter++;
+            stack[stack_size++] = target;
+          } else if (component[target] == -1 && order[target] < low[vertex]) {
+            /* Still on stack */
+            low[vertex] = order[target];
+          }
+          continue;
+        }
+
+        /* All edges done, close component if vertex is its root */
+        if (low[vertex] == order[vertex]) {
+          do {
+            member = stack[--stack_size];
+            component[member] = vertex;
+          } while (member != vertex);
+        }
+
+        depth--;
+        if (depth >= 0 && low[vertex] < low[frames[depth]]) {
+          low[frames[depth]] = low[vertex];
+        }
+      }
+    }
+    result = TRUE;
+
+destroy:
+    free(order);
+    free(low);
+    free(stack);
+    free(frames);
+    free(cursor);
+
+    return result;
+}
+
+/*
+ * Function:
+ * Graph_scc_collect
+ *
+ * In this function we gather vertices still
+ * without component into S->rest
+ */
+static void
+Graph_scc_collect(Graph_components_t *S) {
+
+    vertex_number_t      row;
+
+    S->rest_size = 0;
+    for (row = 0; row < S->C->total_vertices; row++) {
+      if (S->component[row] == -1) {
+        S->rest[S->rest_size++] = row;
+      }
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_scc_trim_edges
+ *
+ * In this function we count edges of vertex to
+ * or from other vertices left (self loops aside)
+ */
+static long
+Graph_scc_trim_edges(const Graph_components_t *S, const Graph_csr_t *C,
+                     vertex_number_t vertex) {
+
+    edge_index_t         position;
+    vertex_number_t      target;
+    long                 count = 0;
+
+    for (position = C->offsets[vertex]; position < C->offsets[vertex + 1]; position++) {
+      target = C->targets[position];
+      if (target != vertex && S->component[target] == -1) {
+        count++;
+      }
+    }
+
+    return count;
+}
+
+/*
+ * Function:
+ * Graph_scc_trim_drop
+ *
+ * In this function vertex just trimmed takes its
+ * edges off neighbors left, neighbor losing its
+ * last edge of that direction is trimmed next
+ */
+static void
+Graph_scc_trim_drop(Graph_components_t *S, const Graph_csr_t *C, long *degree,
+                    vertex_number_t vertex) {
+
+    edge_index_t         position;
+    vertex_number_t      target;
+    vertex_number_t      unassigned;
+
+    for (position = C->offsets[vertex]; position < C->offsets[vertex + 1]; position++) {
+      target = C->targets[position];
+      if (target == vertex || __atomic_load_n(&S->component[target], __ATOMIC_RELAXED) != -1) {
+        continue;
+      }
+      unassigned = -1;
+      if (__atomic_sub_fetch(&degree[target], 1, __ATOMIC_RELAXED) == 0 &&
+          __atomic_compare_exchange_n(&S->component[target], &unassigned, target, FALSE,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        S->next[__atomic_fetch_add(&S->next_size, 1, __ATOMIC_RELAXED)] = target;
+      }
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_scc_trim_worker
+ *
+ * In this function threads trim vertices left
+ * without incoming or outgoing edges, they are
+ * components of their own. Edges of trimmed vertices
+ * are taken off their neighbors, so trimming goes on
+ * level by level until no vertex loses its last edge
+ * (whole Graph for acyclic parts)
+ */
+static void *
+Graph_scc_trim_worker(void *arg) {
+
+    Graph_thread_t      *T = (Graph_thread_t *)arg;
+    Graph_components_t  *S = (Graph_components_t *)T->shared;
+    vertex_number_t     *swap;
+    vertex_number_t      vertex;
+    long                 first;
+    long                 last;
+    long                 iterator;
+    int                  step;
+
+    if (T->id == 0 && T->running < T->count) {
+      Graph_barrier_resize(&S->barrier, T->running);
+    }
+
+    /* Count edges among vertices left, then seed vertices without any */
+    for (step = 0; step < 2; step++) {
+      while (Graph_work_queue_take(S->queues, T, GRAPH_COMPONENTS_CHUNK, &first, &last)) {
+        for (iterator = first; iterator < last; iterator++) {
+          vertex = S->rest[iterator];
+          if (step == 0) {
+            S->in_degree[vertex]  = Graph_scc_trim_edges(S, S->R, vertex);
+            S->out_degree[vertex] = Graph_scc_trim_edges(S, S->C, vertex);
+          } else if (S->in_degree[vertex] == 0 || S->out_degree[vertex] == 0) {
+            S->component[vertex] = vertex;
+            S->next[__atomic_fetch_add(&S->next_size, 1, __ATOMIC_RELAXED)] = vertex;
+          }
+        }
+      }
+      Graph_barrier_wait(&S->barrier);
+
+      if (T->id == 0) {
+        Graph_work_queue_init(S->queues, T->count, S->rest_size);
+      }
+      Graph_barrier_wait(&S->barrier);
+    }
+
+    for (;;) {
+      if (T->id == 0) {
+        swap             = S->frontier;
+        S->frontier      = S->next;
+        S->next          = swap;
+        S->frontier_size = S->next_size;
+        S->next_size     = 0;
+        Graph_work_queue_init(S->queues, T->count, S->frontier_size);
+      }
+      Graph_barrier_wait(&S->barrier);
+
+      if (S->frontier_size == 0) {
+        break;
+      }
+
+      while (Graph_work_queue_take(S->queues, T, GRAPH_COMPONENTS_CHUNK, &first, &last)) {
+        for (iterator = first; iterator < last; iterator++) {
+          vertex = S->frontier[iterator];
+          Graph_scc_trim_drop(S, S->C, S->in_degree, vertex);
+          Graph_scc_trim_drop(S, S->R, S->out_degree, vertex);
+        }
+      }
+      Graph_barrier_wait(&S->barrier);
+    }
+
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_scc_trim
+ *
+ * In this function we trim vertices of S->rest
+ * and gather what is left back into S->rest
+ */
+static bool
+Graph_scc_trim(Graph_components_t *S) {
+
+    S->next_size = 0;
+    Graph_barrier_resize(&S->barrier, Graph_resolve_threads(S->C->num_threads));
+    if (!Graph_components_run(S, Graph_scc_trim_worker, S->rest_size)) {
+      return FALSE;
+    }
+    Graph_scc_collect(S);
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_scc_reach_worker
+ *
+ * In this function threads expand search level by
+ * level together. Vertex colored S->from is taken
+ * into search by recoloring it S->to, following
+ * edges of S->walk
+ */
+static void *
+Graph_scc_reach_worker(void *arg) {
+
+    Graph_thread_t      *T = (Graph_thread_t *)arg;
+    Graph_components_t  *S = (Graph_components_t *)T->shared;
+    const Graph_csr_t   *C = S->walk;
+    vertex_number_t     *swap;
+    vertex_number_t      vertex;
+    vertex_number_t      target;
+    vertex_number_t      expected;
+    edge_index_t         position;
+    long                 first;
+    long                 last;
+    long                 iterator;
+
+    if (T->id == 0 && T->running < T->count) {
+      Graph_barrier_resize(&S->barrier, T->running);
+    }
+
+    while (S->frontier_size > 0) {
+      while (Graph_work_queue_take(S->queues, T, GRAPH_COMPONENTS_CHUNK, &first, &last)) {
+        for (iterator = first; iterator < last; iterator++) {
+          vertex = S->frontier[iterator];
+          for (position = C->offsets[vertex]; position < C->offsets[vertex + 1]; position++) {
+            target   = C->targets[position];
+            expected = S->from;
+            if (__atomic_load_n(&S->color[target], __ATOMIC_RELAXED) == expected &&
+                __atomic_compare_exchange_n(&S->color[target], &expected, S->to, FALSE,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+              S->next[__atomic_fetch_add(&S->next_size, 1, __ATOMIC_RELAXED)] = target;
+            }
+          }
+        }
+      }
+      Graph_barrier_wait(&S->barrier);
+
+      if (T->id == 0) {
+        swap             = S->frontier;
+        S->frontier      = S->next;
+        S->next          = swap;
+        S->frontier_size = S->next_size;
+        S->next_size     = 0;
+        Graph_work_queue_init(S->queues, T->count, S->frontier_size);
+      }
+      Graph_barrier_wait(&S->barrier);
+    }
+
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_scc_reach
+ *
+ * In this function we recolor to all vertices
+ * colored from which are reachable from source
+ * over edges of walk
+ */
+static void
+Graph_scc_reach(Graph_components_t *S, const Graph_csr_t *walk, vertex_number_t source,
+                vertex_number_t from, vertex_number_t to) {
+
+    int                  no_of_threads;
+
+    no_of_threads = Graph_resolve_threads(S->C->num_threads);
+
+    S->walk          = walk;
+    S->from          = from;
+    S->to            = to;
+    S->color[source] = to;
+    S->frontier[0]   = source;
+    S->frontier_size = 1;
+    S->next_size     = 0;
+    Graph_barrier_resize(&S->barrier, no_of_threads);
+    Graph_work_queue_init(S->queues, no_of_threads, 1);
+
+    Graph_parallel_run(no_of_threads, Graph_scc_reach_worker, S);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_scc_rank
+ *
+ * In this function we scramble color into its rank
+ * (one to one). Ranking colors by index would make
+ * every round of a Graph whose edges run from high
+ * to low index peel off few roots
+ */
+static inline uint32_t
+Graph_scc_rank(vertex_number_t color) {
+
+    uint32_t             rank = (uint32_t)color;
+
+    rank ^= rank >> 16;
+    rank *= 0x7FEB352DU;
+    rank ^= rank >> 15;
+    rank *= 0x846CA68BU;
+    rank ^= rank >> 16;
+
+    return rank;
+}
+
+/*
+ * Function:
+ * Graph_scc_color_worker
+ *
+ * In this function threads push colors forward
+ * along edges between vertices left, a vertex
+ * taking the highest ranked color of its
+ * predecessors, until no color moves in a whole pass
+ */
+static void *
+Graph_scc_color_worker(void *arg) {
+
+    Graph_thread_t      *T = (Graph_thread_t *)arg;
+    Graph_components_t  *S = (Graph_components_t *)T->shared;
+    const Graph_csr_t   *C = S->C;
+    vertex_number_t      vertex;
+    vertex_number_t      target;
+    vertex_number_t      color;
+    vertex_number_t      current;
+    edge_index_t         position;
+    bool                 changed;
+    long                 first;
+    long                 last;
+    long                 iterator;
+
+    if (T->id == 0 && T->running < T->count) {
+      Graph_barrier_resize(&S->barrier, T->running);
+    }
+
+    for (;;) {
+      changed = FALSE;
+      while (Graph_work_queue_take(S->queues, T, GRAPH_COMPONENTS_CHUNK, &first, &last)) {
+        for (iterator = first; iterator < last; iterator++) {
+          vertex = S->rest[iterator];
+          color  = __atomic_load_n(&S->color[vertex], __ATOMIC_RELAXED);
+          for (position = C->offsets[vertex]; position < C->offsets[vertex + 1]; position++) {
+            target = C->targets[position];
+            if (S->component[target] != -1) {
+              continue;
+            }
+            current = __atomic_load_n(&S->color[target], __ATOMIC_RELAXED);
+            while (Graph_scc_rank(current) < Graph_scc_rank(color) &&
+                   !__atomic_compare_exchange_n(&S->color[target], &current, color, TRUE,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+              ;
+            }
+            if (Graph_scc_rank(current) < Graph_scc_rank(color)) {
+              changed = TRUE;
+            }
+          }
+        }
+      }
+      if (changed) {
+        __atomic_store_n(&S->changed, TRUE, __ATOMIC_RELAXED);
+      }
+      Graph_barrier_wait(&S->barrier);
+
+      changed = __atomic_load_n(&S->changed, __ATOMIC_RELAXED);
+      Graph_barrier_wait(&S->barrier);
+      if (!changed) {
+        break;
+      }
+
+      if (T->id == 0) {
+        S->changed = FALSE;
+        Graph_work_queue_init(S->queues, T->count, S->rest_size);
+      }
+      Graph_barrier_wait(&S->barrier);
+    }
+
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_scc_root_worker
+ *
+ * In this function thread takes roots (vertices
+ * which kept their own color) and collects vertices
+ * of same color reaching them into their component.
+ * Colors do not overlap, so every thread walks its
+ * own vertices only
+ */
+static void *
+Graph_scc_root_worker(void *arg) {
+
+    Graph_thread_t      *T = (Graph_thread_t *)arg;
+    Graph_components_t  *S = (Graph_components_t *)T->shared;
+    const Graph_csr_t   *R = S->R;
+    vertex_number_t     *stack = NULL;
+    vertex_number_t      stack_size;
+    vertex_number_t      root;
+    vertex_number_t      vertex;
+    vertex_number_t      source;
+    edge_index_t         position;
+    long                 first;
+    long                 last;
+    long                 iterator;
+
+    while (Graph_work_queue_take(S->queues, T, GRAPH_COMPONENTS_CHUNK, &first, &last)) {
+      for (iterator = first; iterator < last; iterator++) {
+        root = S->rest[iterator];
+        if (S->color[root] != root) {
+          continue;
+        }
+
+        if (stack == NULL) {
+          /* Component can not outgrow vertices left */
+          stack = (vertex_number_t *)malloc(S->rest_size * sizeof(vertex_number_t));
+          if (stack == NULL) {
+            LOG_ERR("Unable to allocate stack of %ld vertices",S->rest_size);
+            __atomic_store_n(&S->failed, TRUE, __ATOMIC_RELAXED);
+            return NULL;
+          }
+        }
+
+        S->component[root] = root;
+        stack[0]   = root;
+        stack_size = 1;
+        while (stack_size > 0) {
+          vertex = stack[--stack_size];
+          for (position = R->offsets[vertex]; position < R->offsets[vertex + 1]; position++) {
+            source = R->targets[position];
+            if (S->color[source] == root && S->component[source] == -1) {
+              S->component[source] = root;
+              stack[stack_size++]  = source;
+            }
+          }
+        }
+      }
+    }
+
+    free(stack);
+
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_scc_forward_backward
+ *
+ * In this function we find strongly connected
+ * components with parallel trim, forward-backward
+ * and coloring steps (see top of file). component
+ * receives representative of every row
+ */
+static bool
+Graph_scc_forward_backward(const Graph_csr_t *C, const Graph_csr_t *R,
+                           vertex_number_t *component) {
+
+    Graph_components_t   S;
+    vertex_number_t      pivot = -1;
+    vertex_number_t      row;
+    edge_index_t         degree;
+    edge_index_t         best = -1;
+    size_t               slots;
+    int                  no_of_threads;
+    bool                 barrier_ready = FALSE;
+    bool                 result        = FALSE;
+
+    no_of_threads = Graph_resolve_threads(C->num_threads);
+    slots         = (C->total_vertices > 0) ? (size_t)C->total_vertices : 1;
+
+    memset(&S, 0, sizeof(S));
+    S.C          = C;
+    S.R          = R;
+    S.component  = component;
+    S.color      = (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    S.frontier   = (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    S.next       = (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    S.rest       = (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    S.in_degree  = (long *)malloc(slots * sizeof(long));
+    S.out_degree = (long *)malloc(slots * sizeof(long));
+    S.queues     = (Graph_work_queue_t *)Graph_aligned_calloc(no_of_threads,
+                                                 sizeof(Graph_work_queue_t));
+    if (S.color == NULL || S.frontier == NULL || S.next == NULL || S.rest == NULL ||
+        S.in_degree == NULL || S.out_degree == NULL || S.queues == NULL) {
+      LOG_ERR("Unable to allocate SCC state for %d vertices",C->total_vertices);
+      goto destroy;
+    }
+
+    if (!Graph_barrier_init(&S.barrier, no_of_threads)) {
+      goto destroy;
+    }
+    barrier_ready = TRUE;
+
+    /* Trim, then forward-backward from vertex with most paths through it */
+    for (row = 0; row < C->total_vertices; row++) {
+      component[row] = -1;
+    }
+    Graph_scc_collect(&S);
+    if (!Graph_scc_trim(&S)) {
+      goto destroy;
+    }
+
+    for (row = 0; row < C->total_vertices; row++) {
+      S.color[row] = -1;
+      if (component[row] != -1) {
+        continue;
+      }
+      S.color[row] = 0;
+      degree = (C->offsets[row + 1] - C->offsets[row]) *
+               (R->offsets[row + 1] - R->offsets[row]);
+      if (degree > best) {
+        best  = degree;
+        pivot = row;
+      }
+    }
+
+    if (pivot != -1) {
+      Graph_scc_reach(&S, C, pivot, 0, 1);
+      Graph_scc_reach(&S, R, pivot, 1, 2);
+      for (row = 0; row < C->total_vertices; row++) {
+        if (S.color[row] == 2) {
+          component[row] = pivot;
+        }
+      }
+    }
+
+    /* Coloring rounds on what is left, each after a trim */
+    for (Graph_scc_collect(&S); S.rest_size > 0; Graph_scc_collect(&S)) {
+      if (!Graph_scc_trim(&S)) {
+        goto destroy;
+      }
+      if (S.rest_size == 0) {
+        break;
+      }
+
+      for (row = 0; row < S.rest_size; row++) {
+        S.color[S.rest[row]] = S.rest[row];
+      }
+
+      S.changed = FALSE;
+      Graph_barrier_resize(&S.barrier, no_of_threads);
+      if (!Graph_components_run(&S, Graph_scc_color_worker, S.rest_size) ||
+          !Graph_components_run(&S, Graph_scc_root_worker, S.rest_size)) {
+        goto destroy;
+      }
+    }
+    result = TRUE;
+
+destroy:
+    if (barrier_ready) {
+      Graph_barrier_destroy(&S.barrier);
+    }
+    free(S.color);
+    free(S.frontier);
+    free(S.next);
+    free(S.rest);
+    free(S.in_degree);
+    free(S.out_degree);
+    Graph_aligned_free(S.queues);
+
+    return result;
+}
+
+/*
+ * Function
+ * Graph_csr_strongly_connected_components
+ *
+ * In this function we find strongly connected
+ * components of CSR snapshot with given algorithm.
+ * GRAPH_SCC_FORWARD_BACKWARD walks incoming edges:
+ * R is the transposed snapshot (see Graph_csr_transpose),
+ * snapshot without R is transposed for this call.
+ * Every vertex of undirected snapshot is strongly
+ * connected to its neighbors
+ *
+ * Input:
+ *       Graph_csr_t * C
+ *       Graph_csr_t * R (incoming edges, can be NULL)
+ *       Graph_scc_algorithm_t algorithm
+ *       vertex_number_t * component (Output, total_vertices entries by row)
+ * Output:
+ *       vertex_number_t - no of components, IDs run 0 .. count-1
+ *                         in order of first row of every component
+ *                         -1 <-- On Failure
+ */
+vertex_number_t
+Graph_csr_strongly_connected_components(const Graph_csr_t *C, const Graph_csr_t *R,
+                                        Graph_scc_algorithm_t algorithm,
+                                        vertex_number_t *component) {
+
+    Graph_csr_t         *transposed = NULL;
+    vertex_number_t     *scratch;
+    vertex_number_t      count = -1;
+    bool                 result;
+
+    if (C == NULL || component == NULL) {
+      LOG_ERR("Provided CSR or component array is NULL");
+      return -1;
+    }
+
+    if (!C->is_directed) {
+      return Graph_csr_connected_components(C, component);
+    }
+
+    switch (algorithm) {
+      case GRAPH_SCC_TARJAN:
+        result = Graph_scc_tarjan(C, component);
+        break;
+      case GRAPH_SCC_FORWARD_BACKWARD:
+        if (R == NULL) {
+          transposed = Graph_csr_transpose(C);
+          if (transposed == NULL) {
+            return -1;
+          }
+          R = transposed;
+        }
+        result = Graph_scc_forward_backward(C, R, component);
+        break;
+      default:
+        LOG_ERR("Unknown SCC algorithm %d",algorithm);
+        return -1;
+    }
+
+    scratch = (vertex_number_t *)malloc((C->total_vertices + 1) * sizeof(vertex_number_t));
+    if (result && scratch == NULL) {
+      LOG_ERR("Unable to allocate component numbering for %d vertices",C->total_vertices);
+    } else if (result) {
+      count = Graph_components_number(component, C->total_vertices, scratch);
+    }
+
+    free(scratch);
+    Graph_csr_destroy(transposed);
+
+    return count;
+}
+
+/*
+ * Function
+ * Graph_connected_components
+ *
+ * In this function we find connected components of
+ * the Graph ignoring direction of edges, see
+ * Graph_csr_connected_components. component holds
+ * total_vertices entries by dense vertex index
+ *
+ * Input:
+ *       Graph_t * G (Graph)
+ *       vertex_number_t * component (Output)
+ * Output:
+ *       vertex_number_t - no of components, -1 <-- On Failure
+ */
+vertex_number_t
+Graph_connected_components(const Graph_t *G, vertex_number_t *component) {
+
+    Graph_csr_t         *C;
+    vertex_number_t      count;
+
+    if (G == NULL) {
+      LOG_ERR("Provided Graph is NULL");
+      return -1;
+    }
+
+    C = Graph_freeze(G);
+    if (C == NULL) {
+      return -1;
+    }
+
+    count = Graph_csr_connected_components(C, component);
+    Graph_csr_destroy(C);
+
+    return count;
+}
+
+/*
+ * Function
+ * Graph_strongly_connected_components
+ *
+ * In this function we find strongly connected
+ * components of the Graph with given algorithm, see
+ * Graph_csr_strongly_connected_components. component
+ * holds total_vertices entries by dense vertex index
+ *
+ * Input:
+ *       Graph_t * G (Graph)
+ *       Graph_scc_algorithm_t algorithm
+ *       vertex_number_t * component (Output)
+ * Output:
+ *       vertex_number_t - no of components, -1 <-- On Failure
+ */
+vertex_number_t
+Graph_strongly_connected_components(const Graph_t *G, Graph_scc_algorithm_t algorithm,
+                                    vertex_number_t *component) {
+
+    Graph_csr_t         *C;
+    vertex_number_t      count;
+
+    if (G == NULL) {
+      LOG_ERR("Provided Graph is NULL");
+      return -1;
+    }
+
+    C = Graph_freeze(G);
+    if (C == NULL) {
+      return -1;
+    }
+
+    count = Graph_csr_strongly_connected_components(C, NULL, algorithm, component);
+    Graph_csr_destroy(C);
+
+    return count;
+}
@@ -0,0 +1,712 @@
+/*
+ * In this File we define the Compressed Sparse Row (CSR)
+ * representation of a Graph.
+ *
+ * Graph_t keeps vertices and edges as linked lists which
+ * is flexible while building the Graph, but every neighbor
+ * visit is a pointer chase. Graph_freeze copies the Graph
+ * into three contiguous arrays (offsets, targets, weights)
+ * so that read only queries walk memory sequentially.
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#include <sys/mman.h>
+
+#include "graph.h"
+
+/*
+ * Function:
+ * Graph_csr_template
+ *
+ * In this function we allocate CSR Object
+ * along with its arrays
+ *
+ * Input:
+ *      vertex_number_t  - No of rows
+ *      edge_index_t     - No of edges
+ * Output:
+ *      Graph_csr_t Object or NULL
+ */
+Graph_csr_t *
+Graph_csr_template(vertex_number_t no_of_vertices, edge_index_t no_of_edges) {
+
+    Graph_csr_t         *C;
+
+    C = (Graph_csr_t *)calloc(1, sizeof(Graph_csr_t));
+    if (C == NULL) {
+      LOG_ERR("Unable to allocate memory for CSR");
+      goto destroy;
+    }
+
+    C->total_vertices = no_of_vertices;
+    C->total_edges    = no_of_edges;
+
+    C->offsets = (edge_index_t *)calloc(no_of_vertices + 1, sizeof(edge_index_t));
+    C->targets = (vertex_number_t *)malloc((no_of_edges ? no_of_edges : 1) *
+                                           sizeof(vertex_number_t));
+    C->weights = (edge_weight_t *)malloc((no_of_edges ? no_of_edges : 1) *
+                                         sizeof(edge_weight_t));
+    C->vertex_ids = (vertex_number_t *)malloc((no_of_vertices ? no_of_vertices : 1) *
+                                              sizeof(vertex_number_t));
+    if (C->offsets == NULL || C->targets == NULL || C->weights == NULL ||
+        C->vertex_ids == NULL) {
+      LOG_ERR("Unable to allocate CSR arrays for %d vertices, %ld edges",
+              no_of_vertices, no_of_edges);
+      goto destroy;
+    }
+
+    return C;
+
+destroy:
+    Graph_csr_destroy(C);
+    return NULL;
+}
+
+/*
+ * ID to Row pair, used to sort rows by
+ * vertex ID for sparse ID lookup
+ */
+typedef struct graph_csr_pair_ {
+    vertex_number_t      id;
+    vertex_number_t      row;
+} Graph_csr_pair_t;
+
+static int
+Graph_csr_pair_compare(const void *a, const void *b) {
+
+    const Graph_csr_pair_t *A = (const Graph_csr_pair_t *)a;
+    const Graph_csr_pair_t *B = (const Graph_csr_pair_t *)b;
+
+    return (A->id > B->id) - (A->id < B->id);
+}
+
+/*
+ * Function:
+ * Graph_csr_index_rows
+ *
+ * In this function we check whether rows are
+ * same as vertex IDs, else we build sorted_rows
+ * so that Graph_csr_get_row can binary search
+ *
+ * Input:
+ *      Graph_csr_t  - CSR with vertex_ids filled
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- On Failure
+ */
+bool
+Graph_csr_index_rows(Graph_csr_t *C) {
+
+    Graph_csr_pair_t    *pairs;
+    vertex_number_t      row;
+
+    C->is_identity = TRUE;
+    for (row = 0; row < C->total_vertices; row++) {
+      if (C->vertex_ids[row] != row) {
+        C->is_identity = FALSE;
+        break;
+      }
+    }
+
+    if (C->is_identity) {
+      return TRUE;
+    }
+
+    pairs = (Graph_csr_pair_t *)malloc(C->total_vertices * sizeof(Graph_csr_pair_t));
+    C->sorted_rows = (vertex_number_t *)malloc(C->total_vertices *
+                                               sizeof(vertex_number_t));
+    if (pairs == NULL || C->sorted_rows == NULL) {
+      LOG_ERR("Unable to allocate row index for %d vertices",C->total_vertices);
+      free(pairs);
+      return FALSE;
+    }
+
+    for (row = 0; row < C->total_vertices; row++) {
+      pairs[row].id  = C->vertex_ids[row];
+      pairs[row].row = row;
+    }
+    qsort(pairs, C->total_vertices, sizeof(Graph_csr_pair_t),
+          Graph_csr_pair_compare);
+    for (row = 0; row < C->total_vertices; row++) {
+      C->sorted_rows[row] = pairs[row].row;
+    }
+
+    free(pairs);
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_csr_max_weight
+ *
+ * In this function we find largest edge weight
+ * of CSR, used to pick frontier of Dijkstra
+ *
+ * Input:
+ *      Graph_csr_t
+ * Output:
+ *      long  - max weight (0 if there are no edges),
+ *              -1 if any weight is negative
+ */
+long
+Graph_csr_max_weight(const Graph_csr_t *C) {
+
+    edge_index_t         position;
+    long                 max_weight = 0;
+
+    for (position = 0; position < C->total_edges; position++) {
+      if (C->weights[position] < 0) {
+        return -1;
+      }
+      if (C->weights[position] > max_weight) {
+        max_weight = C->weights[position];
+      }
+    }
+
+    return max_weight;
+}
+
+/*
+ * Function:
+ * Graph_csr_get_row
+ *
+ * In this function we resolve vertex ID to
+ * its row in the CSR snapshot
+ *
+ * Input:
+ *      Graph_csr_t
+ *      vertex_number_t  - Vertex ID
+ * Output:
+ *      vertex_number_t  - Row, -1 if vertex is not present
+ */
+vertex_number_t
+Graph_csr_get_row(const Graph_csr_t *C, vertex_number_t node) {
+
+    vertex_number_t      low;
+    vertex_number_t      high;
+    vertex_number_t      mid;
+    vertex_number_t      id;
+
+    if (C->is_identity) {
+      return (node >= 0 && node < C->total_vertices) ? node : -1;
+    }
+
+    low  = 0;
+    high = C->total_vertices - 1;
+    while (low <= high) {
+      mid = low + (high - low) / 2;
+      id  = C->vertex_ids[C->sorted_rows[mid]];
+      if (id == node) {
+        return C->sorted_rows[mid];
+      }
+      if (id < node) {
+        low = mid + 1;
+      } else {
+        high = mid - 1;
+      }
+    }
+
+    return -1;
+}
+
+/*
+ * Function:
+ * Graph_freeze
+ *
+ * In this function we build an immutable CSR
+ * snapshot of the Graph. Later changes to the
+ * Graph are not reflected in the snapshot.
+ *
+ * Edges whose target is not a vertex of the Graph
+ * are dropped from the snapshot.
+ *
+ * Input:
+ *      Graph_t  - Graph Pointer
+ * Output:
+ *      Graph_csr_t Object or NULL
+ */
+Graph_csr_t *
+Graph_freeze(const Graph_t *G) {
+
+    Graph_csr_t         *C = NULL;
+    Graph_vertices_t    *V;
+    Graph_vertices_t    *target;
+    Graph_edges_t       *E;
+    edge_index_t         no_of_edges    = 0;
+    edge_index_t         position;
+    vertex_number_t      row;
+
+    if (G == NULL) {
+      LOG_ERR("Provided Graph to freeze is NULL");
+      return NULL;
+    }
+
+    /* First pass: count the edges */
+    for (V = G->vertices_list; V != NULL; V = V->next) {
+      for (E = V->adjacency_list; E != NULL; E = E->next) {
+        if (Graph_get_vertex(G, E->target) != NULL) {
+          no_of_edges++;
+        }
+      }
+    }
+
+    C = Graph_csr_template(G->total_vertices, no_of_edges);
+    if (C == NULL) {
+      LOG_ERR("Unable to freeze Graph with %d vertices",G->total_vertices);
+      return NULL;
+    }
+    C->is_directed = G->is_directed;
+    C->heap_type   = G->heap_type;
+    C->num_threads = G->num_threads;
+
+    /* Second pass: degree of every row, then prefix sum */
+    for (V = G->vertices_list; V != NULL; V = V->next) {
+      C->vertex_ids[V->index] = V->interface_number;
+      for (E = V->adjacency_list; E != NULL; E = E->next) {
+        if (Graph_get_vertex(G, E->target) != NULL) {
+          C->offsets[V->index + 1]++;
+        }
+      }
+    }
+
+    for (row = 0; row < C->total_vertices; row++) {
+      C->offsets[row + 1] += C->offsets[row];
+    }
+
+    /* Third pass: copy edges, preserving adjacency order */
+    for (V = G->vertices_list; V != NULL; V = V->next) {
+      position = C->offsets[V->index];
+      for (E = V->adjacency_list; E != NULL; E = E->next) {
+        target = Graph_get_vertex(G, E->target);
+        if (target != NULL) {
+          C->targets[position] = target->index;
+          C->weights[position] = E->weight;
+          position++;
+        }
+      }
+    }
+
+    if (!Graph_csr_index_rows(C) ||
+        (G->sorted_adjacency && !Graph_csr_sort_rows(C))) {
+      Graph_csr_destroy(C);
+      return NULL;
+    }
+    C->max_weight = Graph_csr_max_weight(C);
+
+    return C;
+}
+
+/*
+ * Function:
+ * Graph_csr_from_edges
+ *
+ * In this function we build CSR snapshot straight
+ * from edge arrays, without building linked list
+ * Graph first. Vertices are 0 .. no_of_vertices-1,
+ * edges are bucketed by source with a counting sort
+ * keeping their input order within every row.
+ * Edges with unknown vertices are dropped
+ *
+ * Input:
+ *      vertex_number_t   - No of vertices
+ *      vertex_number_t * - Source of every edge
+ *      vertex_number_t * - Destination of every edge
+ *      edge_weight_t *   - Weight of every edge (NULL for weight 1)
+ *      edge_index_t      - No of edges
+ *      bool              - is_directed (else both directions are stored)
+ * Output:
+ *      Graph_csr_t Object or NULL
+ */
+Graph_csr_t *
+Graph_csr_from_edges(vertex_number_t no_of_vertices, const vertex_number_t *src,
+                     const vertex_number_t *dst, const edge_weight_t *weight,
+                     edge_index_t no_of_edges, bool is_directed) {
+
+    Graph_csr_t         *C;
+    edge_index_t        *cursor;
+    edge_index_t         stored = 0;
+    edge_index_t         iterator;
+    vertex_number_t      row;
+    edge_weight_t        edge_weight;
+
+    if (no_of_vertices < 0 || (no_of_edges > 0 && (src == NULL || dst == NULL))) {
+      LOG_ERR("Provided edge arrays are NULL");
+      return NULL;
+    }
+
+    /* First pass: count valid edges */
+    for (iterator = 0; iterator < no_of_edges; iterator++) {
+      if (src[iterator] >= 0 && src[iterator] < no_of_vertices &&
+          dst[iterator] >= 0 && dst[iterator] < no_of_vertices) {
+        stored += is_directed ? 1 : 2;
+      }
+    }
+
+    C = Graph_csr_template(no_of_vertices, stored);
+    cursor = (edge_index_t *)malloc((no_of_vertices + 1) * sizeof(edge_index_t));
+    if (C == NULL || cursor == NULL) {
+      LOG_ERR("Unable to build CSR with %d vertices, %ld edges",
+              no_of_vertices, stored);
+      Graph_csr_destroy(C);
+      free(cursor);
+      return NULL;
+    }
+    C->is_directed = is_directed;
+    C->heap_type   = GRAPH_HEAP_AUTO;
+    C->num_threads = 0;
+
+    /* Second pass: degree of every row, then prefix sum */
+    for (iterator = 0; iterator < no_of_edges; iterator++) {
+      if (src[iterator] >= 0 && src[iterator] < no_of_vertices &&
+          dst[iterator] >= 0 && dst[iterator] < no_of_vertices) {
+        C->offsets[src[iterator] + 1]++;
+        if (!is_directed) {
+          C->offsets[dst[iterator] + 1]++;
+        }
+      }
+    }
+
+    for (row = 0; row < no_of_vertices; row++) {
+      C->offsets[row + 1] += C->offsets[row];
+      C->vertex_ids[row]   = row;
+    }
+    memcpy(cursor, C->offsets, (no_of_vertices + 1) * sizeof(edge_index_t));
+
+    /* Third pass: scatter edges into their rows */
+    for (iterator = 0; iterator < no_of_edges; iterator++) {
+      if (src[iterator] < 0 || src[iterator] >= no_of_vertices ||
+          dst[iterator] < 0 || dst[iterator] >= no_of_vertices) {
+        continue;
+      }
+
+      edge_weight = (weight != NULL) ? weight[iterator] : 1;
+
+      C->targets[cursor[src[iterator]]]   = dst[iterator];
+      C->weights[cursor[src[iterator]]++] = edge_weight;
+      if (!is_directed) {
+        C->targets[cursor[dst[iterator]]]   = src[iterator];
+        C->weights[cursor[dst[iterator]]++] = edge_weight;
+      }
+    }
+
+    free(cursor);
+
+    C->is_identity = TRUE;
+    C->max_weight  = Graph_csr_max_weight(C);
+
+    return C;
+}
+
+/*
+ * Function:
+ * Graph_csr_transpose
+ *
+ * In this function we build CSR snapshot with every
+ * edge reversed, row R holds edges entering row R of
+ * the given snapshot (same rows and Vertex IDs). Used
+ * by searches walking edges backwards
+ *
+ * Input:
+ *      Graph_csr_t  - CSR snapshot
+ * Output:
+ *      Graph_csr_t Object or NULL
+ */
+Graph_csr_t *
+Graph_csr_transpose(const Graph_csr_t *C) {
+
+    Graph_csr_t         *T;
+    edge_index_t        *cursor;
+    edge_index_t         position;
+    vertex_number_t      row;
+
+    if (C == NULL) {
+      LOG_ERR("Provided CSR is NULL");
+      return NULL;
+    }
+
+    T = Graph_csr_template(C->total_vertices, C->total_edges);
+    cursor = (edge_index_t *)malloc((C->total_vertices + 1) * sizeof(edge_index_t));
+    if (T == NULL || cursor == NULL) {
+      LOG_ERR("Unable to transpose CSR with %d vertices",C->total_vertices);
+      Graph_csr_destroy(T);
+      free(cursor);
+      return NULL;
+    }
+    T->is_directed = C->is_directed;
+    T->heap_type   = C->heap_type;
+    T->max_weight  = C->max_weight;
+    T->num_threads = C->num_threads;
+
+    /* Count edges entering every row, then prefix sum */
+    for (position = 0; position < C->total_edges; position++) {
+      T->offsets[C->targets[position] + 1]++;
+    }
+    for (row = 0; row < C->total_vertices; row++) {
+      T->offsets[row + 1] += T->offsets[row];
+    }
+    memcpy(cursor, T->offsets, (C->total_vertices + 1) * sizeof(edge_index_t));
+
+    /* Rows are walked in order, so reversed rows come out sorted */
+    for (row = 0; row < C->total_vertices; row++) {
+      for (position = C->offsets[row]; position < C->offsets[row + 1]; position++) {
+        T->targets[cursor[C->targets[position]]]   = row;
+        T->weights[cursor[C->targets[position]]++] = C->weights[position];
+      }
+    }
+    free(cursor);
+
+    memcpy(T->vertex_ids, C->vertex_ids, C->total_vertices * sizeof(vertex_number_t));
+    if (!Graph_csr_index_rows(T)) {
+      Graph_csr_destroy(T);
+      return NULL;
+    }
+    T->is_sorted = TRUE;
+
+    return T;
+}
+
+/*
+ * Function:
+ * Graph_csr_destroy
+ *
+ * In this function we release CSR snapshot,
+ * unmapping it if opened by Graph_open_mmap
+ *
+ * Input:
+ *      Graph_csr_t  - CSR Pointer (can be NULL)
+ * Output:
+ *      none
+ */
+void
+Graph_csr_destroy(Graph_csr_t *C) {
+
+    if (C == NULL) {
+      return;
+    }
+
+    if (C->mapping != NULL) {
+      /* Arrays live in mapped snapshot */
+      munmap(C->mapping, C->mapping_size);
+    } else {
+      free(C->offsets);
+      free(C->targets);
+      free(C->weights);
+      free(C->vertex_ids);
+      free(C->sorted_rows);
+    }
+    free(C);
+
+    return;
+}
+
+/*
+ * Function:
+ *  Graph_csr_has_edge
+ *
+ * In this function we validate whether
+ * there is a edge between two vertices
+ * of the CSR snapshot
+ *
+ * Input:
+ *    Graph_csr_t
+ *    vertex_number_t (Source)
+ *    vertex_number_t (Destination)
+ *
+ * Output:
+ *     bool True <-- If there is Edge
+ *          False <-- If there is no Edge
+ */
+bool
+Graph_csr_has_edge(const Graph_csr_t *C, vertex_number_t S, vertex_number_t D) {
+
+    edge_index_t         position;
+
+    if (C == NULL) {
+      return FALSE;
+    }
+
+    S = Graph_csr_get_row(C, S);
+    D = Graph_csr_get_row(C, D);
+    if (S < 0 || D < 0) {
+      return FALSE;
+    }
+
+    if (C->is_sorted) {
+      return Graph_sorted_contains(C->targets + C->offsets[S],
+                                   C->offsets[S + 1] - C->offsets[S], D);
+    }
+
+    for (position = C->offsets[S]; position < C->offsets[S + 1]; position++) {
+      if (C->targets[position] == D) {
+        return TRUE;
+      }
+    }
+
+    return FALSE;
+}
+
+/*
+ * Function
+ * Graph_csr_dijkstra_query
+ *
+ * In this function we find shortest distance
+ * from Source to all the vertices of CSR snapshot.
+ * Distances and predecessors (indexed by row) are
+ * kept in the caller owned workspace
+ *
+ * Input:
+ *       Graph_csr_t * C
+ *       Graph_workspace_t * W (capacity >= total_vertices)
+ *       vertex_number_t S (Source)
+ * Output:
+ *       bool True  <-- On Success
+ *            False <-- On Failure
+ */
+bool
+Graph_csr_dijkstra_query(const Graph_csr_t *C, Graph_workspace_t *W,
+                         vertex_number_t S) {
+
+    vertex_number_t      vertex;
+    edge_index_t         position;
+
+    if (C == NULL || W == NULL || W->capacity < C->total_vertices) {
+      LOG_ERR("Provided CSR is NULL or workspace is too small");
+      return FALSE;
+    }
+
+    vertex = Graph_csr_get_row(C, S);
+    if (vertex < 0) {
+      LOG_ERR("Unable to find vertex %d",S);
+      return FALSE;
+    }
+
+    Graph_workspace_reset(W);
+    Graph_heap_set_type(W->heap, C->heap_type, C->max_weight);
+    W->source     = vertex;
+    GRAPH_STATS_ADD(&W->stats, queries, 1);
+
+    Graph_workspace_relax(W, vertex, -1, 0);
+
+    while (!Graph_heap_is_empty(W->heap)) {
+      GRAPH_STATS_TIMED(&W->stats, heap_pops, frontier_ticks,
+                        vertex = Graph_heap_pop(W->heap));
+      GRAPH_STATS_ADD(&W->stats, vertices_settled, 1);
+
+      GRAPH_STATS_BEGIN(W);
+      for (position = C->offsets[vertex];
+           position < C->offsets[vertex + 1]; position++) {
+        Graph_workspace_relax(W, C->targets[position], vertex,
+                              W->min_distance[vertex] + C->weights[position]);
+      }
+      GRAPH_STATS_END(W, relax_ticks);
+    }
+
+    return TRUE;
+}
+
+/*
+ * Function
+ * Graph_csr_get_dijsktra
+ *
+ * In this function we find shortest distance
+ * from Source to all the vertices of CSR snapshot.
+ * Snapshot is not modified, distances are written
+ * to caller provided array of total_vertices entries
+ * indexed by row. Unreachable vertices get
+ * GRAPH_INFINITE_DISTANCE
+ *
+ * Input:
+ *       Graph_csr_t * C
+ *       vertex_number_t S (Source)
+ *       long * min_distance (Output)
+ * Output:
+ *       bool True  <-- On Success
+ *            False <-- On Failure
+ */
+bool
+Graph_csr_get_dijsktra(const Graph_csr_t *C, vertex_number_t S,
+                       long *min_distance) {
+
+    Graph_workspace_t   *W;
+    bool                 result;
+
+    if (C == NULL || min_distance == NULL) {
+      LOG_ERR("Provided CSR or distance array is NULL");
+      return FALSE;
+    }
+
+    W = Graph_workspace_create(C->total_vertices);
+    if (W == NULL) {
+      LOG_ERR("Unable to create workspace for %d vertices",C->total_vertices);
+      return FALSE;
+    }
+
+    result = Graph_csr_dijkstra_query(C, W, S);
+    if (result) {
+      memcpy(min_distance, W->min_distance,
+             C->total_vertices * sizeof(long));
+    }
+
+    Graph_workspace_destroy(W);
+
+    return result;
+}
+
+/*
+ * Function:
+ * Graph_csr_display_graph
+ *
+ * In this function we display complete CSR snapshot
+ * in the same format as Graph_display_graph
+ *
+ * Input:
+ *      Graph_csr_t  - CSR Pointer
+ *      long *       - min distance per row (can be NULL)
+ *
+ * Output:
+ *      NULL
+ */
+void
+Graph_csr_display_graph(const Graph_csr_t *C, const long *min_distance) {
+
+    vertex_number_t      vertex;
+    edge_index_t         position;
+
+    if (C == NULL) {
+      LOG_INFO("Provided CSR to display is NULL");
+      return;
+    }
+
+    if (C->total_vertices == 0) {
+      LOG_INFO("There are no vertices in the CSR");
+      return;
+    }
+
+    for (vertex = 0; vertex < C->total_vertices; vertex++) {
+      printf("-------------------------\n");
+      printf("| Vertex ID : %4d      |\n",C->vertex_ids[vertex]);
+      if (min_distance == NULL ||
+          min_distance[vertex] == GRAPH_INFINITE_DISTANCE) {
+        printf("| min_dis   : NaN       |\n");
+      } else {
+        printf("| min_dis   : %3lu       |\n",(min_distance[vertex]));
+      }
+      printf("-------------------------\n");
+
+      if (C->offsets[vertex] != C->offsets[vertex + 1]) {
+        printf("-------------------------\n");
+        printf("Adjacency ");
+        for (position = C->offsets[vertex];
+             position < C->offsets[vertex + 1]; position++) {
+          printf("%3d",C->vertex_ids[C->targets[position]]);
+        }
+        printf("\n");
+        printf("-------------------------\n");
+      }
+    }
+
+    return;
+}
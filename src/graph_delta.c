@@ -0,0 +1,608 @@
+/*
+ * In this File we define parallel delta stepping
+ * single source shortest path over CSR snapshot.
+ *
+ * Vertices are kept in buckets of width delta by their
+ * tentative distance. Buckets are emptied in order, all
+ * vertices of the smallest non empty bucket are expanded
+ * together by all threads:
+ *      - light edges (weight <= delta) are relaxed in phases
+ *        until the bucket stays empty, as they may put
+ *        vertices back into it
+ *      - heavy edges (weight > delta) of every vertex taken
+ *        from the bucket are relaxed once, they can only
+ *        reach later buckets
+ * Distances are lowered with atomic compare and swap,
+ * every thread keeps its own buckets so that only the
+ * distance array is shared while expanding.
+ *
+ * Small delta does little extra work but has many phases,
+ * large delta has few phases but vertices get expanded
+ * more than once. Width <= 0 picks max weight divided
+ * by average degree.
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#include "graph.h"
+
+#define GRAPH_DELTA_CHUNK         64
+#define GRAPH_DELTA_BIN_MIN       16
+
+/*
+ * Vertices of one bucket found by one thread,
+ * may hold duplicates and stale entries
+ */
+typedef struct graph_delta_bin_ {
+    vertex_number_t     *items;
+    long                 count;
+    long                 capacity;
+} Graph_delta_bin_t;
+
+/*
+ * State of one thread, aligned so that threads
+ * do not share cache lines
+ */
+typedef struct graph_delta_local_ {
+    Graph_delta_bin_t   *bins;          /* Bucket i holds distances
+                                         * [i * delta, (i + 1) * delta) */
+    long                 no_of_bins;
+    Graph_delta_bin_t    settled;       /* Taken from current bucket,
+                                         * heavy edges still to relax */
+} __attribute__((aligned(GRAPH_CACHE_LINE))) Graph_delta_local_t;
+
+/*
+ * State shared by all threads
+ */
+typedef struct graph_delta_ {
+    const Graph_csr_t   *C;
+    long                 delta;         /* Bucket width */
+    long                *distance;      /* Tentative distance per row */
+    long                *expanded;      /* Distance row was expanded with */
+    Graph_delta_local_t *locals;        /* One per thread */
+    long                *offsets;       /* Where thread copies its bucket
+                                         * into frontier */
+    vertex_number_t     *frontier;      /* Current bucket, all threads */
+    long                 frontier_size;
+    long                 frontier_capacity;
+    Graph_work_queue_t  *queues;        /* Split of frontier */
+    Graph_barrier_t      barrier;
+    long                 next_bucket;   /* Smallest non empty bucket */
+    bool                 failed;        /* Set if a bucket could not grow */
+} Graph_delta_t;
+
+/*
+ * Function:
+ * Graph_delta_atomic_min
+ *
+ * In this function we lower value in slot to
+ * distance, unless slot already holds less
+ *
+ * Output:
+ *      bool True  <-- If slot was lowered
+ *           False <-- Otherwise
+ */
+static bool
+Graph_delta_atomic_min(long *slot, long distance) {
+
+    long                 current = __atomic_load_n(slot, __ATOMIC_RELAXED);
+
+    while (distance < current) {
+      if (__atomic_compare_exchange_n(slot, &current, distance, TRUE,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        return TRUE;
+      }
+    }
+
+    return FALSE;
+}
+
+/*
+ * Function:
+ * Graph_delta_push
+ *
+ * In this function we append vertex to bin,
+ * doubling its capacity when full
+ */
+static bool
+Graph_delta_push(Graph_delta_bin_t *bin, vertex_number_t vertex) {
+
+    vertex_number_t     *items;
+    long                 capacity;
+
+    if (bin->count == bin->capacity) {
+      capacity = bin->capacity ? bin->capacity * 2 : GRAPH_DELTA_BIN_MIN;
+      items = (vertex_number_t *)realloc(bin->items, capacity * sizeof(vertex_number_t));
+      if (items == NULL) {
+        return FALSE;
+      }
+      bin->items    = items;
+      bin->capacity = capacity;
+    }
+
+    bin->items[bin->count++] = vertex;
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_delta_bin
+ *
+ * In this function we find bin of bucket in
+ * buckets of thread, adding empty bins up to it
+ */
+static Graph_delta_bin_t *
+Graph_delta_bin(Graph_delta_local_t *L, long bucket) {
+
+    Graph_delta_bin_t   *bins;
+    long                 no_of_bins;
+
+    if (bucket >= L->no_of_bins) {
+      no_of_bins = L->no_of_bins ? L->no_of_bins : GRAPH_DELTA_BIN_MIN;
+      while (no_of_bins <= bucket) {
+        no_of_bins *= 2;
+      }
+
+      bins = (Graph_delta_bin_t *)realloc(L->bins, no_of_bins * sizeof(Graph_delta_bin_t));
+      if (bins == NULL) {
+        return NULL;
+      }
+      memset(bins + L->no_of_bins, 0,
+             (no_of_bins - L->no_of_bins) * sizeof(Graph_delta_bin_t));
+      L->bins       = bins;
+      L->no_of_bins = no_of_bins;
+    }
+
+    return &L->bins[bucket];
+}
+
+/*
+ * Function:
+ * Graph_delta_relax
+ *
+ * In this function we offer distance to vertex,
+ * if it is lowered vertex goes to bucket of
+ * its new distance
+ */
+static void
+Graph_delta_relax(Graph_delta_t *D, Graph_delta_local_t *L,
+                  vertex_number_t vertex, long distance) {
+
+    Graph_delta_bin_t   *bin;
+
+    if (!Graph_delta_atomic_min(&D->distance[vertex], distance)) {
+      return;
+    }
+
+    bin = Graph_delta_bin(L, distance / D->delta);
+    if (bin == NULL || !Graph_delta_push(bin, vertex)) {
+      LOG_ERR("Unable to grow bucket %ld",distance / D->delta);
+      __atomic_store_n(&D->failed, TRUE, __ATOMIC_RELAXED);
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_delta_expand
+ *
+ * In this function we relax light edges of vertex
+ * taken from current bucket. Vertex is skipped if it
+ * was already expanded with the same distance, it is
+ * remembered for heavy edges the first time it is
+ * expanded (vertex is only ever expanded in one bucket)
+ */
+static void
+Graph_delta_expand(Graph_delta_t *D, Graph_delta_local_t *L,
+                   vertex_number_t vertex) {
+
+    const Graph_csr_t   *C = D->C;
+    edge_index_t         position;
+    long                 distance;
+    long                 previous;
+
+    distance = __atomic_load_n(&D->distance[vertex], __ATOMIC_RELAXED);
+    previous = __atomic_exchange_n(&D->expanded[vertex], distance, __ATOMIC_RELAXED);
+    if (previous == distance) {
+      return;
+    }
+
+    if (previous == GRAPH_INFINITE_DISTANCE &&
+        !Graph_delta_push(&L->settled, vertex)) {
+      LOG_ERR("Unable to remember vertex %d for heavy edges",vertex);
+      __atomic_store_n(&D->failed, TRUE, __ATOMIC_RELAXED);
+    }
+
+    for (position = C->offsets[vertex]; position < C->offsets[vertex + 1]; position++) {
+      if (C->weights[position] <= D->delta) {
+        Graph_delta_relax(D, L, C->targets[position], distance + C->weights[position]);
+      }
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_delta_gather
+ *
+ * In this function thread 0 lays out frontier of
+ * current bucket, every thread gets offset for its
+ * own entries. Done between two barriers, over threads
+ * which did start only, offsets of the others are
+ * never written
+ */
+static void
+Graph_delta_gather(Graph_delta_t *D, int no_of_threads) {
+
+    vertex_number_t     *frontier;
+    long                 total = 0;
+    long                 count;
+    int                  iterator;
+
+    for (iterator = 0; iterator < no_of_threads; iterator++) {
+      count = D->offsets[iterator];
+      D->offsets[iterator] = total;
+      total += count;
+    }
+
+    if (total > D->frontier_capacity) {
+      frontier = (vertex_number_t *)realloc(D->frontier, total * sizeof(vertex_number_t));
+      if (frontier == NULL) {
+        /* Entries of this bucket are lost, result is marked failed */
+        LOG_ERR("Unable to allocate frontier of %ld vertices",total);
+        D->failed = TRUE;
+        total     = 0;
+      } else {
+        D->frontier          = frontier;
+        D->frontier_capacity = total;
+      }
+    }
+
+    D->frontier_size = total;
+    D->next_bucket   = LONG_MAX;
+    Graph_work_queue_init(D->queues, no_of_threads, total);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_delta_worker
+ *
+ * In this function every thread runs the bucket
+ * loop in lock step with others
+ */
+static void *
+Graph_delta_worker(void *arg) {
+
+    Graph_thread_t      *T = (Graph_thread_t *)arg;
+    Graph_delta_t       *D = (Graph_delta_t *)T->shared;
+    Graph_delta_local_t *L = &D->locals[T->id];
+    const Graph_csr_t   *C = D->C;
+    Graph_delta_bin_t   *bin;
+    edge_index_t         position;
+    vertex_number_t      vertex;
+    long                 bucket = 0;
+    long                 next;
+    long                 first;
+    long                 last;
+    long                 iterator;
+
+    if (T->id == 0 && T->running < T->count) {
+      Graph_barrier_resize(&D->barrier, T->running);
+    }
+
+    while (TRUE) {
+      bin = (bucket < L->no_of_bins) ? &L->bins[bucket] : NULL;
+      D->offsets[T->id] = (bin != NULL) ? bin->count : 0;
+      Graph_barrier_wait(&D->barrier);
+
+      if (T->id == 0) {
+        Graph_delta_gather(D, T->running);
+      }
+      Graph_barrier_wait(&D->barrier);
+
+      if (D->frontier_size > 0) {
+        /* Light phase: expand bucket, it may refill */
+        if (bin != NULL && bin->count > 0) {
+          memcpy(D->frontier + D->offsets[T->id], bin->items,
+                 bin->count * sizeof(vertex_number_t));
+          bin->count = 0;
+        }
+        Graph_barrier_wait(&D->barrier);
+
+        while (Graph_work_queue_take(D->queues, T, GRAPH_DELTA_CHUNK, &first, &last)) {
+          for (iterator = first; iterator < last; iterator++) {
+            Graph_delta_expand(D, L, D->frontier[iterator]);
+          }
+        }
+        continue;
+      }
+
+      /* Bucket stays empty, distances in it are final */
+      for (iterator = 0; iterator < L->settled.count; iterator++) {
+        vertex = L->settled.items[iterator];
+        for (position = C->offsets[vertex]; position < C->offsets[vertex + 1]; position++) {
+          if (C->weights[position] > D->delta) {
+            Graph_delta_relax(D, L, C->targets[position],
+                              D->distance[vertex] + C->weights[position]);
+          }
+        }
+      }
+      L->settled.count = 0;
+
+      for (next = bucket + 1; next < L->no_of_bins; next++) {
+        if (L->bins[next].count > 0) {
+          Graph_delta_atomic_min(&D->next_bucket, next);
+          break;
+        }
+      }
+      Graph_barrier_wait(&D->barrier);
+
+      bucket = D->next_bucket;
+      if (bucket == LONG_MAX) {
+        break;
+      }
+    }
+
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_delta_width
+ *
+ * In this function we validate weights of CSR and
+ * pick bucket width, max weight over average degree
+ *
+ * Output:
+ *      long  - width (>= 1), -1 if there are negative weights
+ */
+static long
+Graph_delta_width(const Graph_csr_t *C) {
+
+    edge_index_t         position;
+    long                 max_weight = 1;
+
+    for (position = 0; position < C->total_edges; position++) {
+      if (C->weights[position] < 0) {
+        return -1;
+      }
+      if (C->weights[position] > max_weight) {
+        max_weight = C->weights[position];
+      }
+    }
+
+    if (C->total_edges > C->total_vertices && C->total_vertices > 0) {
+      max_weight = max_weight * C->total_vertices / C->total_edges;
+    }
+
+    return (max_weight > 0) ? max_weight : 1;
+}
+
+/*
+ * Function
+ * Graph_csr_delta_stepping
+ *
+ * In this function we find shortest distance from
+ * Source to all the vertices of CSR snapshot with
+ * delta stepping, spread over threads of the snapshot
+ * (see Graph_set_num_threads). Distances are the same
+ * as Graph_csr_get_dijsktra, written to caller provided
+ * array of total_vertices entries indexed by row.
+ * Unreachable vertices get GRAPH_INFINITE_DISTANCE.
+ * Weights must not be negative
+ *
+ * Input:
+ *       Graph_csr_t * C
+ *       vertex_number_t S (Source)
+ *       long delta (bucket width, <= 0 to pick one)
+ *       long * min_distance (Output)
+ * Output:
+ *       bool True  <-- On Success
+ *            False <-- On Failure
+ */
+bool
+Graph_csr_delta_stepping(const Graph_csr_t *C, vertex_number_t S, long delta,
+                         long *min_distance) {
+
+    Graph_delta_t        D;
+    vertex_number_t      source;
+    vertex_number_t      row;
+    long                 width;
+    int                  no_of_threads;
+    int                  iterator;
+    bool                 barrier_ready = FALSE;
+    bool                 result        = FALSE;
+
+    if (C == NULL || min_distance == NULL) {
+      LOG_ERR("Provided CSR or distance array is NULL");
+      return FALSE;
+    }
+
+    source = Graph_csr_get_row(C, S);
+    if (source < 0) {
+      LOG_ERR("Unable to find vertex %d",S);
+      return FALSE;
+    }
+
+    width = Graph_delta_width(C);
+    if (width < 0) {
+      LOG_ERR("Delta stepping needs non negative weights");
+      return FALSE;
+    }
+
+    no_of_threads = Graph_resolve_threads(C->num_threads);
+
+    memset(&D, 0, sizeof(D));
+    D.C        = C;
+    D.delta    = (delta > 0) ? delta : width;
+    D.distance = min_distance;
+    D.expanded = (long *)malloc((C->total_vertices ? C->total_vertices : 1) * sizeof(long));
+    D.locals   = (Graph_delta_local_t *)Graph_aligned_calloc(no_of_threads,
+                                                 sizeof(Graph_delta_local_t));
+    D.offsets  = (long *)calloc(no_of_threads, sizeof(long));
+    D.queues   = (Graph_work_queue_t *)Graph_aligned_calloc(no_of_threads,
+                                                 sizeof(Graph_work_queue_t));
+    if (D.expanded == NULL || D.locals == NULL || D.offsets == NULL ||
+        D.queues == NULL) {
+      LOG_ERR("Unable to allocate delta stepping state for %d threads",no_of_threads);
+      goto destroy;
+    }
+
+    if (!Graph_barrier_init(&D.barrier, no_of_threads)) {
+      goto destroy;
+    }
+    barrier_ready = TRUE;
+
+    for (row = 0; row < C->total_vertices; row++) {
+      min_distance[row] = GRAPH_INFINITE_DISTANCE;
+      D.expanded[row]   = GRAPH_INFINITE_DISTANCE;
+    }
+
+    min_distance[source] = 0;
+    if (Graph_delta_bin(&D.locals[0], 0) == NULL ||
+        !Graph_delta_push(&D.locals[0].bins[0], source)) {
+      LOG_ERR("Unable to allocate first bucket");
+      goto destroy;
+    }
+
+    /* Threads which did start cover for the ones which did not */
+    Graph_parallel_run(no_of_threads, Graph_delta_worker, &D);
+
+    result = !D.failed;
+
+destroy:
+    if (barrier_ready) {
+      Graph_barrier_destroy(&D.barrier);
+    }
+    if (D.locals != NULL) {
+      for (iterator = 0; iterator < no_of_threads; iterator++) {
+        for (row = 0; row < D.locals[iterator].no_of_bins; row++) {
+          free(D.locals[iterator].bins[row].items);
+        }
+        free(D.locals[iterator].bins);
+        free(D.locals[iterator].settled.items);
+      }
+    }
+    Graph_aligned_free(D.locals);
+    free(D.expanded);
+    free(D.offsets);
+    Graph_aligned_free(D.queues);
+    free(D.frontier);
+
+    return result;
+}
+
+/*
+ * Function
+ * Graph_delta_stepping
+ *
+ * In this function we find shortest distance from
+ * Source to all the vertices with parallel delta
+ * stepping. Graph is not modified and nothing is
+ * printed, distances are written to caller provided
+ * array of total_vertices entries indexed by dense
+ * vertex index (GRAPH_INFINITE_DISTANCE if unreachable).
+ *
+ * Graph is frozen for every call, freeze it once and use
+ * Graph_csr_delta_stepping for repeated queries
+ *
+ * Input:
+ *       Graph_t * G (Graph)
+ *       vertex_number_t S (Source)
+ *       long delta (bucket width, <= 0 to pick one)
+ *       long * min_distance (Output)
+ * Output:
+ *       bool True  <-- On Success
+ *            False <-- On Failure
+ */
+bool
+Graph_delta_stepping(const Graph_t *G, vertex_number_t S, long delta,
+                     long *min_distance) {
+
+  Graph_csr_t           *C;
+  bool                   result;
+
+  if (G == NULL || min_distance == NULL) {
+    LOG_ERR("Provided Graph or distance array is NULL");
+    return FALSE;
+  }
+
+  /* CSR rows follow dense vertex index */
+  C = Graph_freeze(G);
+  if (C == NULL) {
+    LOG_ERR("Unable to freeze Graph of %d vertices",G->total_vertices);
+    return FALSE;
+  }
+
+  result = Graph_csr_delta_stepping(C, S, delta, min_distance);
+
+  Graph_csr_destroy(C);
+
+  return result;
+}
+
+/*
+ * Function
+ * Graph_get_delta_stepping
+ *
+ * In this function we find shortest distance from
+ * Source to all the vertices with parallel delta
+ * stepping, drop in alternative of Graph_get_dijsktra:
+ * result of every vertex is stored in Graph_vertices_t,
+ * Graph_display_graph shows it.
+ *
+ * Graph is frozen for every call, freeze it once and use
+ * Graph_csr_delta_stepping for repeated queries
+ *
+ * Input:
+ *       Graph_t * G (Graph)
+ *       vertex_number_t S (Source)
+ *       long delta (bucket width, <= 0 to pick one)
+ * Output:
+ *       none
+ */
+void
+Graph_get_delta_stepping(Graph_t *G, vertex_number_t S, long delta) {
+
+  Graph_csr_t           *C;
+  Graph_vertices_t      *vertex;
+  long                  *min_distance;
+
+  if (G == NULL) {
+    LOG_ERR("Provided Graph is NULL");
+    return;
+  }
+
+  C = Graph_freeze(G);
+  min_distance = (long *)malloc((G->total_vertices ? G->total_vertices : 1) * sizeof(long));
+  if (C == NULL || min_distance == NULL) {
+    LOG_ERR("Unable to prepare delta stepping for %d vertices",G->total_vertices);
+    goto destroy;
+  }
+
+  if (!Graph_csr_delta_stepping(C, S, delta, min_distance)) {
+    goto destroy;
+  }
+
+  for (vertex = G->vertices_list; vertex != NULL; vertex = vertex->next) {
+    if (min_distance[vertex->index] == GRAPH_INFINITE_DISTANCE) {
+      vertex->min_distance = NaN;
+      vertex->is_visited   = FALSE;
+    } else {
+      vertex->min_distance = min_distance[vertex->index];
+      vertex->is_visited   = TRUE;
+    }
+  }
+
+destroy:
+  Graph_csr_destroy(C);
+  free(min_distance);
+
+  return;
+}
@@ -0,0 +1,778 @@
+/*
+ * In this File we define shortest path trees which
+ * are kept up to date while the Graph changes.
+ *
+ * Every registered source keeps distance and parent
+ * (dense index) of all vertices. Edge changes made
+ * through the Graph API's call in here and only the part
+ * of a tree which depends on the change is repaired,
+ * in the manner of Ramalingam and Reps:
+ *
+ *  - Shorter edge (insert, weight decrease) lowers
+ *    distance of its target, Dijkstra then runs only over
+ *    vertices whose distance drops
+ *  - Longer edge (weight increase, removal) matters only
+ *    if it is a tree edge. Target first looks for another
+ *    parent at the same distance, else its subtree is cut
+ *    off, every cut vertex takes best distance offered by
+ *    incoming edges from outside the subtree and Dijkstra
+ *    runs over the subtree
+ *
+ * Incoming edges come from reverse adjacency, which is
+ * switched on by Graph_sssp_register. Edge weights must
+ * not be negative. Changes which can not be repaired
+ * locally (source removed and added again, Graph_clear,
+ * out of memory) mark tree stale, it is recomputed on
+ * next read.
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#include "graph.h"
+
+/*
+ * Function:
+ * Graph_sssp_reserve
+ *
+ * In this function we grow arrays of tree to hold
+ * count vertices, new entries are unreachable.
+ * Heap must be empty
+ */
+static bool
+Graph_sssp_reserve(Graph_sssp_t *T, vertex_number_t count) {
+
+    long                *distance;
+    vertex_number_t     *parent;
+    char                *affected;
+    vertex_number_t     *queue;
+    Graph_heap_t        *heap;
+    long                 new_size;
+    vertex_number_t      iterator;
+
+    if (count <= T->capacity && T->heap != NULL) {
+      return TRUE;
+    }
+
+    new_size = T->capacity ? 2L * T->capacity : GRAPH_VERTEX_TABLE_MIN;
+    if (new_size < count) {
+      new_size = count;
+    }
+    if (new_size > INT_MAX) {
+      new_size = INT_MAX;
+    }
+
+    distance = (long *)realloc(T->distance, new_size * sizeof(long));
+    if (distance == NULL) {
+      goto destroy;
+    }
+    T->distance = distance;
+
+    parent = (vertex_number_t *)realloc(T->parent, new_size * sizeof(vertex_number_t));
+    if (parent == NULL) {
+      goto destroy;
+    }
+    T->parent = parent;
+
+    affected = (char *)realloc(T->affected, new_size * sizeof(char));
+    if (affected == NULL) {
+      goto destroy;
+    }
+    T->affected = affected;
+
+    queue = (vertex_number_t *)realloc(T->queue, new_size * sizeof(vertex_number_t));
+    if (queue == NULL) {
+      goto destroy;
+    }
+    T->queue = queue;
+
+    heap = Graph_heap_create((vertex_number_t)new_size, GRAPH_HEAP_QUATERNARY);
+    if (heap == NULL) {
+      goto destroy;
+    }
+    Graph_heap_destroy(T->heap);
+    T->heap = heap;
+
+    for (iterator = T->capacity; iterator < new_size; iterator++) {
+      T->distance[iterator] = GRAPH_INFINITE_DISTANCE;
+      T->parent[iterator]   = -1;
+      T->affected[iterator] = FALSE;
+    }
+    T->capacity = (vertex_number_t)new_size;
+
+    return TRUE;
+
+destroy:
+    /* Arrays grown so far are kept, capacity tells what is valid */
+    LOG_ERR("Unable to grow shortest path tree to %ld vertices",new_size);
+    return FALSE;
+}
+
+/*
+ * Function:
+ * Graph_sssp_settle
+ *
+ * In this function we run Dijkstra from vertices
+ * on the heap. Only vertices whose distance drops
+ * are pushed, so work is bounded by the change
+ */
+static void
+Graph_sssp_settle(Graph_sssp_t *T) {
+
+    const Graph_t       *G = T->graph;
+    Graph_vertices_t    *target;
+    Graph_edges_t       *edge;
+    vertex_number_t      index;
+    long                 distance;
+
+    while (!Graph_heap_is_empty(T->heap)) {
+      index = Graph_heap_pop(T->heap);
+      for (edge = G->index_table[index]->adjacency_list; edge != NULL;
+           edge = edge->next) {
+        target = Graph_get_vertex(G, edge->target);
+        if (target == NULL) {
+          continue;
+        }
+        distance = T->distance[index] + edge->weight;
+        if (distance < T->distance[target->index]) {
+          T->distance[target->index] = distance;
+          T->parent[target->index]   = index;
+          Graph_heap_push(T->heap, target->index, distance);
+        }
+      }
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_sssp_cut
+ *
+ * In this function we append subtree of root to
+ * queue and make its vertices unreachable. Children
+ * of a vertex are targets of its edges which have it
+ * as parent, so cost is out degree of the subtree
+ */
+static void
+Graph_sssp_cut(Graph_sssp_t *T, vertex_number_t root) {
+
+    const Graph_t       *G = T->graph;
+    Graph_vertices_t    *target;
+    Graph_edges_t       *edge;
+    vertex_number_t      first = T->queue_count;
+    vertex_number_t      next  = first;
+    vertex_number_t      index;
+
+    T->affected[root]          = TRUE;
+    T->queue[T->queue_count++] = root;
+
+    while (next < T->queue_count) {
+      index = T->queue[next++];
+      for (edge = G->index_table[index]->adjacency_list; edge != NULL;
+           edge = edge->next) {
+        target = Graph_get_vertex(G, edge->target);
+        if (target == NULL || T->affected[target->index] ||
+            T->parent[target->index] != index) {
+          continue;
+        }
+        T->affected[target->index] = TRUE;
+        T->queue[T->queue_count++] = target->index;
+      }
+    }
+
+    for (next = first; next < T->queue_count; next++) {
+      T->distance[T->queue[next]] = GRAPH_INFINITE_DISTANCE;
+      T->parent[T->queue[next]]   = -1;
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_sssp_reconnect
+ *
+ * In this function we give every cut vertex best
+ * distance over its incoming edges from vertices
+ * outside the cut, then settle the cut from them
+ */
+static void
+Graph_sssp_reconnect(Graph_sssp_t *T) {
+
+    const Graph_t       *G = T->graph;
+    Graph_vertices_t    *source;
+    Graph_edges_t       *edge;
+    vertex_number_t      index;
+    vertex_number_t      iterator;
+    long                 distance;
+
+    for (iterator = 0; iterator < T->queue_count; iterator++) {
+      index = T->queue[iterator];
+      for (edge = G->index_table[index]->reverse_list; edge != NULL;
+           edge = edge->next) {
+        source = Graph_get_vertex(G, edge->target);
+        if (source == NULL || T->affected[source->index] ||
+            T->distance[source->index] == GRAPH_INFINITE_DISTANCE) {
+          continue;
+        }
+        distance = T->distance[source->index] + edge->weight;
+        if (distance < T->distance[index]) {
+          T->distance[index] = distance;
+          T->parent[index]   = source->index;
+        }
+      }
+    }
+
+    for (iterator = 0; iterator < T->queue_count; iterator++) {
+      index = T->queue[iterator];
+      T->affected[index] = FALSE;
+      if (T->distance[index] != GRAPH_INFINITE_DISTANCE) {
+        Graph_heap_push(T->heap, index, T->distance[index]);
+      }
+    }
+    T->queue_count = 0;
+
+    Graph_sssp_settle(T);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_sssp_adopt
+ *
+ * In this function we look for another parent of
+ * vertex giving it the same distance. Parent must be
+ * closer to source than vertex (or be its present
+ * parent) so that it is not in the subtree of vertex
+ */
+static bool
+Graph_sssp_adopt(Graph_sssp_t *T, const Graph_vertices_t *vertex) {
+
+    const Graph_t       *G = T->graph;
+    Graph_vertices_t    *source;
+    Graph_edges_t       *edge;
+    vertex_number_t      index = vertex->index;
+    long                 parent_distance;
+
+    for (edge = vertex->reverse_list; edge != NULL; edge = edge->next) {
+      source = Graph_get_vertex(G, edge->target);
+      if (source == NULL) {
+        continue;
+      }
+      parent_distance = T->distance[source->index];
+      if (parent_distance == GRAPH_INFINITE_DISTANCE ||
+          parent_distance + edge->weight != T->distance[index]) {
+        continue;
+      }
+      if (source->index == T->parent[index] || parent_distance < T->distance[index]) {
+        T->parent[index] = source->index;
+        return TRUE;
+      }
+    }
+
+    return FALSE;
+}
+
+/*
+ * Function:
+ * Graph_sssp_rebuild
+ *
+ * In this function we compute tree from scratch
+ */
+static bool
+Graph_sssp_rebuild(Graph_sssp_t *T) {
+
+    const Graph_t       *G = T->graph;
+    Graph_vertices_t    *source;
+    vertex_number_t      iterator;
+
+    if (!Graph_sssp_reserve(T, G->total_vertices)) {
+      return FALSE;
+    }
+
+    for (iterator = 0; iterator < T->capacity; iterator++) {
+      T->distance[iterator] = GRAPH_INFINITE_DISTANCE;
+      T->parent[iterator]   = -1;
+      T->affected[iterator] = FALSE;
+    }
+    T->queue_count = 0;
+
+    /* Removed source leaves every vertex unreachable */
+    source = Graph_get_vertex(G, T->source);
+    if (source != NULL) {
+      T->distance[source->index] = 0;
+      Graph_heap_push(T->heap, source->index, 0);
+      Graph_sssp_settle(T);
+    }
+
+    T->stale = FALSE;
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_sssp_register
+ *
+ * In this function we compute shortest path tree
+ * of source and register it with the Graph, so that
+ * edge and vertex changes made afterwards repair it.
+ * Reverse adjacency of Graph is switched on (and can
+ * not be switched off while trees are registered).
+ * Trees are released by Graph_sssp_unregister or along
+ * with the Graph by Graph_destroy
+ *
+ * Input:
+ *      Graph_t          - Graph (weights must not be negative)
+ *      vertex_number_t  - Vertex ID of source
+ * Output:
+ *      Graph_sssp_t Object or NULL
+ */
+Graph_sssp_t *
+Graph_sssp_register(Graph_t *G, vertex_number_t S) {
+
+    Graph_sssp_t        *T = NULL;
+
+    if (G == NULL) {
+      LOG_ERR("Provided Graph is NULL");
+      return NULL;
+    }
+
+    if (Graph_get_vertex(G, S) == NULL) {
+      LOG_ERR("Unable to find vertex %d",S);
+      return NULL;
+    }
+
+    if (!G->reverse_adjacency && !Graph_enable_reverse_adjacency(G, TRUE)) {
+      return NULL;
+    }
+
+    T = (Graph_sssp_t *)calloc(1, sizeof(Graph_sssp_t));
+    if (T == NULL) {
+      LOG_ERR("Unable to allocate shortest path tree");
+      goto destroy;
+    }
+
+    T->graph  = G;
+    T->source = S;
+
+    if (!Graph_sssp_rebuild(T)) {
+      goto destroy;
+    }
+
+    T->next        = G->sssp_trees;
+    G->sssp_trees  = T;
+
+    return T;
+
+destroy:
+    if (T != NULL) {
+      free(T->distance);
+      free(T->parent);
+      free(T->affected);
+      free(T->queue);
+      Graph_heap_destroy(T->heap);
+      free(T);
+    }
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_sssp_unregister
+ *
+ * In this function we stop maintaining tree
+ * and release it
+ *
+ * Input:
+ *      Graph_sssp_t  - Tree (can be NULL)
+ * Output:
+ *      none
+ */
+void
+Graph_sssp_unregister(Graph_sssp_t *T) {
+
+    Graph_sssp_t       **link;
+
+    if (T == NULL) {
+      return;
+    }
+
+    for (link = &T->graph->sssp_trees; *link != NULL; link = &(*link)->next) {
+      if (*link == T) {
+        *link = T->next;
+        break;
+      }
+    }
+
+    free(T->distance);
+    free(T->parent);
+    free(T->affected);
+    free(T->queue);
+    Graph_heap_destroy(T->heap);
+    free(T);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_sssp_refresh
+ *
+ * In this function we recompute stale tree,
+ * nothing is done for an up to date one
+ *
+ * Input:
+ *      Graph_sssp_t  - Tree
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- On Failure (tree stays stale)
+ */
+bool
+Graph_sssp_refresh(Graph_sssp_t *T) {
+
+    if (T == NULL) {
+      LOG_ERR("Provided tree is NULL");
+      return FALSE;
+    }
+
+    if (!T->stale) {
+      return TRUE;
+    }
+
+    return Graph_sssp_rebuild(T);
+}
+
+/*
+ * Function:
+ * Graph_sssp_distance
+ *
+ * In this function we return distance of vertex
+ * from source of the tree, O(1) unless tree is stale
+ *
+ * Input:
+ *      Graph_sssp_t     - Tree
+ *      vertex_number_t  - Vertex ID
+ * Output:
+ *      long - distance, GRAPH_INFINITE_DISTANCE if unreachable
+ */
+long
+Graph_sssp_distance(Graph_sssp_t *T, vertex_number_t node) {
+
+    Graph_vertices_t    *vertex;
+
+    if (T == NULL || !Graph_sssp_refresh(T)) {
+      return GRAPH_INFINITE_DISTANCE;
+    }
+
+    vertex = Graph_get_vertex(T->graph, node);
+    if (vertex == NULL) {
+      return GRAPH_INFINITE_DISTANCE;
+    }
+
+    return T->distance[vertex->index];
+}
+
+/*
+ * Function:
+ * Graph_sssp_predecessor
+ *
+ * In this function we return previous vertex
+ * on shortest path from source of the tree
+ *
+ * Input:
+ *      Graph_sssp_t     - Tree
+ *      vertex_number_t  - Vertex ID
+ * Output:
+ *      vertex_number_t  - Vertex ID of predecessor,
+ *                         -1 for source or unreachable vertex
+ *                         (NaN is a valid Vertex ID)
+ */
+vertex_number_t
+Graph_sssp_predecessor(Graph_sssp_t *T, vertex_number_t node) {
+
+    Graph_vertices_t    *vertex;
+
+    if (T == NULL || !Graph_sssp_refresh(T)) {
+      return -1;
+    }
+
+    vertex = Graph_get_vertex(T->graph, node);
+    if (vertex == NULL || T->parent[vertex->index] == -1) {
+      return -1;
+    }
+
+    return T->graph->index_table[T->parent[vertex->index]]->interface_number;
+}
+
+/*
+ * Function:
+ * Graph_sssp_edge_changed
+ *
+ * In this function we repair trees of Graph after
+ * edge from source to target was added, removed or
+ * given new weight. Graph already holds the change
+ *
+ * Input:
+ *      Graph_t           - Graph
+ *      Graph_vertices_t  - Source vertex of the edge
+ *      Graph_vertices_t  - Target vertex of the edge
+ *      long              - Old weight, GRAPH_INFINITE_DISTANCE if added
+ *      long              - New weight, GRAPH_INFINITE_DISTANCE if removed
+ * Output:
+ *      none
+ */
+void
+Graph_sssp_edge_changed(Graph_t *G, const Graph_vertices_t *source,
+                        const Graph_vertices_t *target, long old_weight,
+                        long new_weight) {
+
+    Graph_sssp_t        *T;
+    vertex_number_t      from = source->index;
+    vertex_number_t      to   = target->index;
+    long                 distance;
+
+    for (T = G->sssp_trees; T != NULL; T = T->next) {
+      if (T->stale || T->distance[from] == GRAPH_INFINITE_DISTANCE) {
+        continue;
+      }
+
+      if (new_weight < old_weight) {
+        distance = T->distance[from] + new_weight;
+        if (distance < T->distance[to]) {
+          T->distance[to] = distance;
+          T->parent[to]   = from;
+          Graph_heap_push(T->heap, to, distance);
+          Graph_sssp_settle(T);
+        }
+        continue;
+      }
+
+      /* Only tree edges matter once they get longer */
+      if (new_weight == old_weight || T->parent[to] != from ||
+          T->distance[from] + old_weight != T->distance[to]) {
+        continue;
+      }
+
+      if (!Graph_sssp_adopt(T, target)) {
+        Graph_sssp_cut(T, to);
+        Graph_sssp_reconnect(T);
+      }
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_sssp_vertex_added
+ *
+ * In this function we make room for vertex just
+ * linked to Graph, it is unreachable as it has no
+ * edges yet. Edges added towards its ID before it
+ * existed are reported by Graph_sssp_edge_changed
+ * right after
+ *
+ * Input:
+ *      Graph_t           - Graph
+ *      Graph_vertices_t  - New vertex
+ * Output:
+ *      none
+ */
+void
+Graph_sssp_vertex_added(Graph_t *G, const Graph_vertices_t *V) {
+
+    Graph_sssp_t        *T;
+
+    for (T = G->sssp_trees; T != NULL; T = T->next) {
+      if (T->stale) {
+        continue;
+      }
+
+      if (V->interface_number == T->source ||
+          !Graph_sssp_reserve(T, G->total_vertices)) {
+        T->stale = TRUE;
+        continue;
+      }
+
+      T->distance[V->index] = GRAPH_INFINITE_DISTANCE;
+      T->parent[V->index]   = -1;
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_sssp_vertex_removing
+ *
+ * In this function we cut subtree below vertex
+ * about to be removed, before its edges go. Cut
+ * vertices are reconnected by Graph_sssp_vertex_removed
+ *
+ * Input:
+ *      Graph_t           - Graph
+ *      Graph_vertices_t  - Vertex being removed
+ * Output:
+ *      none
+ */
+void
+Graph_sssp_vertex_removing(Graph_t *G, const Graph_vertices_t *V) {
+
+    Graph_sssp_t        *T;
+    vertex_number_t      first;
+
+    for (T = G->sssp_trees; T != NULL; T = T->next) {
+      if (T->stale) {
+        continue;
+      }
+
+      if (V->interface_number == T->source) {
+        T->stale = TRUE;
+        continue;
+      }
+
+      if (T->distance[V->index] == GRAPH_INFINITE_DISTANCE) {
+        continue;
+      }
+
+      /* Vertex itself is cut too, but is not reconnected */
+      first = T->queue_count;
+      Graph_sssp_cut(T, V->index);
+      T->affected[V->index] = FALSE;
+      T->queue[first]       = T->queue[--T->queue_count];
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_sssp_vertex_moved
+ *
+ * In this function we follow last vertex of Graph
+ * taking over dense index of removed vertex, its
+ * children are found through its edges
+ *
+ * Input:
+ *      Graph_t           - Graph
+ *      Graph_vertices_t  - Vertex which moved (index already updated)
+ *      vertex_number_t   - Its old dense index
+ * Output:
+ *      none
+ */
+void
+Graph_sssp_vertex_moved(Graph_t *G, const Graph_vertices_t *V,
+                        vertex_number_t from) {
+
+    Graph_sssp_t        *T;
+    Graph_vertices_t    *target;
+    Graph_edges_t       *edge;
+    vertex_number_t      to = V->index;
+    vertex_number_t      iterator;
+
+    for (T = G->sssp_trees; T != NULL; T = T->next) {
+      if (T->stale || from == to) {
+        continue;
+      }
+
+      T->distance[to] = T->distance[from];
+      T->parent[to]   = T->parent[from];
+      T->affected[to] = T->affected[from];
+      T->distance[from] = GRAPH_INFINITE_DISTANCE;
+      T->parent[from]   = -1;
+      T->affected[from] = FALSE;
+
+      if (T->affected[to]) {
+        for (iterator = 0; iterator < T->queue_count; iterator++) {
+          if (T->queue[iterator] == from) {
+            T->queue[iterator] = to;
+            break;
+          }
+        }
+      }
+
+      for (edge = V->adjacency_list; edge != NULL; edge = edge->next) {
+        target = Graph_get_vertex(G, edge->target);
+        if (target != NULL && T->parent[target->index] == from) {
+          T->parent[target->index] = to;
+        }
+      }
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_sssp_vertex_removed
+ *
+ * In this function we reconnect vertices cut by
+ * Graph_sssp_vertex_removing once vertex is gone
+ *
+ * Input:
+ *      Graph_t  - Graph
+ * Output:
+ *      none
+ */
+void
+Graph_sssp_vertex_removed(Graph_t *G) {
+
+    Graph_sssp_t        *T;
+
+    for (T = G->sssp_trees; T != NULL; T = T->next) {
+      if (!T->stale && T->queue_count > 0) {
+        Graph_sssp_reconnect(T);
+      }
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_sssp_invalidate
+ *
+ * In this function we mark every tree of Graph
+ * stale (Graph_clear)
+ *
+ * Input:
+ *      Graph_t  - Graph
+ * Output:
+ *      none
+ */
+void
+Graph_sssp_invalidate(Graph_t *G) {
+
+    Graph_sssp_t        *T;
+
+    for (T = G->sssp_trees; T != NULL; T = T->next) {
+      T->stale = TRUE;
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_sssp_release
+ *
+ * In this function we release every tree of
+ * Graph (Graph_destroy)
+ *
+ * Input:
+ *      Graph_t  - Graph
+ * Output:
+ *      none
+ */
+void
+Graph_sssp_release(Graph_t *G) {
+
+    while (G->sssp_trees != NULL) {
+      Graph_sssp_unregister(G->sssp_trees);
+    }
+
+    return;
+}
@@ -0,0 +1,502 @@
+/*
+ * In this File we define edge existence index of a Graph.
+ *
+ * Index answers Graph_has_edge without touching adjacency
+ * of the source vertex. It is made of
+ *      - blocked Bloom filter over (source, destination) pairs,
+ *        every pair sets one bit in each word of one 64 byte
+ *        block, so a lookup reads a single cache line and most
+ *        negative lookups end there
+ *      - open addressing hash set of the pairs, which answers
+ *        positive lookups exactly
+ * Both are sized for twice the present edges and rebuilt from
+ * the Graph when edges outgrow them. Removed pairs leave a
+ * tombstone in the hash set and stale bits in the Bloom filter,
+ * index is rebuilt once they reach half of the edges it was
+ * sized for, so cost of removals is amortized O(1) and lookups
+ * do not degrade. Memory is kept within the
+ * budget given to Graph_enable_edge_index: when the hash set
+ * does not fit it is dropped and Bloom filter hits fall back
+ * to adjacency.
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#include "graph.h"
+
+#define GRAPH_EDGE_INDEX_EMPTY      UINT64_MAX
+#define GRAPH_EDGE_INDEX_TOMBSTONE  (UINT64_MAX - 1)
+#define GRAPH_EDGE_INDEX_MIN_EDGES  1024
+#define GRAPH_BLOOM_BLOCK_WORDS     8
+
+/*
+ * Function:
+ * Graph_edge_key
+ *
+ * In this function we pack pair into 64 bit key
+ */
+static uint64_t
+Graph_edge_key(vertex_number_t S, vertex_number_t D) {
+
+    return ((uint64_t)(uint32_t)S << 32) | (uint32_t)D;
+}
+
+/*
+ * Function:
+ * Graph_edge_hash
+ *
+ * In this function we mix key so that every
+ * bit of hash depends on every bit of key
+ * (splitmix64 finalizer)
+ */
+static uint64_t
+Graph_edge_hash(uint64_t key) {
+
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+
+    return key;
+}
+
+/*
+ * Function:
+ * Graph_bloom_set / Graph_bloom_test
+ *
+ * In these functions we set / test bits of pair,
+ * one bit in each word of the block chosen by
+ * low bits of hash, bit positions come from high bits
+ */
+static void
+Graph_bloom_set(Graph_edge_index_t *I, uint64_t hash) {
+
+    uint64_t            *block;
+    int                  word;
+
+    block = I->bloom + (hash & (I->bloom_blocks - 1)) * GRAPH_BLOOM_BLOCK_WORDS;
+    hash  = Graph_edge_hash(hash);
+
+    for (word = 0; word < GRAPH_BLOOM_BLOCK_WORDS; word++) {
+      block[word] |= 1ULL << ((hash >> (6 * word)) & 63);
+    }
+
+    return;
+}
+
+static bool
+Graph_bloom_test(const Graph_edge_index_t *I, uint64_t hash) {
+
+    const uint64_t      *block;
+    uint64_t             missing = 0;
+    int                  word;
+
+    block = I->bloom + (hash & (I->bloom_blocks - 1)) * GRAPH_BLOOM_BLOCK_WORDS;
+    hash  = Graph_edge_hash(hash);
+
+    for (word = 0; word < GRAPH_BLOOM_BLOCK_WORDS; word++) {
+      missing |= ~block[word] & (1ULL << ((hash >> (6 * word)) & 63));
+    }
+
+    return missing == 0;
+}
+
+/*
+ * Function:
+ * Graph_edge_set_insert
+ *
+ * In this function we add key to hash set,
+ * keys already present are left as is. Key takes
+ * first tombstone on its probe sequence if any
+ */
+static void
+Graph_edge_set_insert(Graph_edge_index_t *I, uint64_t key, uint64_t hash) {
+
+    size_t               mask = I->set_size - 1;
+    size_t               slot;
+    size_t               free_slot = I->set_size;
+
+    for (slot = hash & mask; I->set[slot] != GRAPH_EDGE_INDEX_EMPTY;
+         slot = (slot + 1) & mask) {
+      if (I->set[slot] == key) {
+        return;
+      }
+      if (I->set[slot] == GRAPH_EDGE_INDEX_TOMBSTONE && free_slot == I->set_size) {
+        free_slot = slot;
+      }
+    }
+
+    if (free_slot != I->set_size) {
+      slot = free_slot;
+      I->set_tombstones--;
+    }
+
+    I->set[slot] = key;
+    I->set_count++;
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_edge_set_erase
+ *
+ * In this function we replace key in hash set
+ * by a tombstone, so probe sequences running
+ * through its slot stay intact
+ */
+static void
+Graph_edge_set_erase(Graph_edge_index_t *I, uint64_t key, uint64_t hash) {
+
+    size_t               mask = I->set_size - 1;
+    size_t               slot;
+
+    for (slot = hash & mask; I->set[slot] != GRAPH_EDGE_INDEX_EMPTY;
+         slot = (slot + 1) & mask) {
+      if (I->set[slot] == key) {
+        I->set[slot] = GRAPH_EDGE_INDEX_TOMBSTONE;
+        I->set_count--;
+        I->set_tombstones++;
+        return;
+      }
+    }
+
+    return;
+}
+
+static bool
+Graph_edge_set_contains(const Graph_edge_index_t *I, uint64_t key, uint64_t hash) {
+
+    size_t               mask = I->set_size - 1;
+    size_t               slot;
+
+    for (slot = hash & mask; I->set[slot] != GRAPH_EDGE_INDEX_EMPTY;
+         slot = (slot + 1) & mask) {
+      if (I->set[slot] == key) {
+        return TRUE;
+      }
+    }
+
+    return FALSE;
+}
+
+/*
+ * Function:
+ * Graph_edge_index_add
+ *
+ * In this function we record pair in Bloom
+ * filter and (if present) hash set
+ */
+static void
+Graph_edge_index_add(Graph_edge_index_t *I, vertex_number_t S, vertex_number_t D) {
+
+    uint64_t             key  = Graph_edge_key(S, D);
+    uint64_t             hash = Graph_edge_hash(key);
+
+    Graph_bloom_set(I, hash);
+    if (I->set != NULL && key < GRAPH_EDGE_INDEX_TOMBSTONE) {
+      Graph_edge_set_insert(I, key, hash);
+    }
+
+    return;
+}
+
+static size_t
+Graph_edge_index_pow2(size_t value) {
+
+    size_t               power = 1;
+
+    while (power < value) {
+      power <<= 1;
+    }
+
+    return power;
+}
+
+/*
+ * Function:
+ * Graph_edge_index_build
+ *
+ * In this function we size index for twice the
+ * present edges within budget and fill it from
+ * adjacency of the Graph
+ */
+static bool
+Graph_edge_index_build(Graph_t *G, Graph_edge_index_t *I) {
+
+    Graph_vertices_t    *V;
+    Graph_edges_t       *E;
+    size_t               planned;
+    size_t               set_size;
+    size_t               bloom_blocks;
+    size_t               block_bytes = GRAPH_BLOOM_BLOCK_WORDS * sizeof(uint64_t);
+
+    free(I->bloom);
+    free(I->set);
+    I->bloom     = NULL;
+    I->set            = NULL;
+    I->set_size       = 0;
+    I->set_count      = 0;
+    I->set_tombstones = 0;
+    I->removed        = 0;
+
+    planned = (size_t)G->total_edges * 2;
+    if (planned < GRAPH_EDGE_INDEX_MIN_EDGES) {
+      planned = GRAPH_EDGE_INDEX_MIN_EDGES;
+    }
+
+    /* Bloom filter gets ~16 bits per edge, hash set stays under half full */
+    bloom_blocks = Graph_edge_index_pow2(planned * 2 / block_bytes);
+    set_size     = Graph_edge_index_pow2(planned * 2);
+
+    if (I->budget > 0) {
+      if (set_size * sizeof(uint64_t) + bloom_blocks * block_bytes > I->budget) {
+        set_size = 0;
+      }
+      while (bloom_blocks > 1 && bloom_blocks * block_bytes > I->budget) {
+        bloom_blocks >>= 1;
+      }
+    }
+
+    I->bloom = (uint64_t *)calloc(bloom_blocks, block_bytes);
+    if (set_size > 0) {
+      I->set = (uint64_t *)malloc(set_size * sizeof(uint64_t));
+    }
+    if (I->bloom == NULL || (set_size > 0 && I->set == NULL)) {
+      LOG_ERR("Unable to allocate edge index for %zu edges",planned);
+      return FALSE;
+    }
+    GRAPH_STATS_ALLOC(G->stats, bloom_blocks * block_bytes + set_size * sizeof(uint64_t));
+
+    I->bloom_blocks  = bloom_blocks;
+    I->set_size      = set_size;
+    I->planned_edges = planned;
+    if (I->set != NULL) {
+      memset(I->set, 0xff, set_size * sizeof(uint64_t));
+    }
+
+    for (V = G->vertices_list; V != NULL; V = V->next) {
+      for (E = V->adjacency_list; E != NULL; E = E->next) {
+        Graph_edge_index_add(I, V->interface_number, E->target);
+      }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_enable_edge_index
+ *
+ * In this function we attach edge existence index
+ * to the Graph and fill it with present edges.
+ * Later edges are added to it incrementally
+ *
+ * Input:
+ *      Graph_t  - Graph
+ *      size_t   - memory budget in bytes, 0 for no limit
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- On Failure (Graph is left without index)
+ */
+bool
+Graph_enable_edge_index(Graph_t *G, size_t budget) {
+
+    Graph_edge_index_t  *I;
+
+    if (G == NULL) {
+      LOG_ERR("Provided Graph is NULL");
+      return FALSE;
+    }
+
+    Graph_disable_edge_index(G);
+
+    I = (Graph_edge_index_t *)calloc(1, sizeof(Graph_edge_index_t));
+    if (I == NULL) {
+      LOG_ERR("Unable to allocate edge index");
+      return FALSE;
+    }
+    I->budget = budget;
+
+    if (!Graph_edge_index_build(G, I)) {
+      free(I->bloom);
+      free(I->set);
+      free(I);
+      return FALSE;
+    }
+
+    G->edge_index = I;
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_disable_edge_index
+ *
+ * In this function we release edge existence
+ * index of the Graph (if any)
+ */
+void
+Graph_disable_edge_index(Graph_t *G) {
+
+    if (G == NULL || G->edge_index == NULL) {
+      return;
+    }
+
+    free(G->edge_index->bloom);
+    free(G->edge_index->set);
+    free(G->edge_index);
+    G->edge_index = NULL;
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_edge_index_insert
+ *
+ * In this function we record new edge of Graph
+ * in its index, rebuilding index once edges
+ * outgrow it. Index is dropped if it cannot
+ * be rebuilt, Graph_has_edge stays correct
+ *
+ * Input:
+ *      Graph_t          - Graph (with index)
+ *      vertex_number_t  - Source
+ *      vertex_number_t  - Destination
+ * Output:
+ *      none
+ */
+void
+Graph_edge_index_insert(Graph_t *G, vertex_number_t S, vertex_number_t D) {
+
+    Graph_edge_index_t  *I = G->edge_index;
+
+    if ((size_t)G->total_edges > I->planned_edges) {
+      /* Edge is already linked, rebuild picks it up */
+      Graph_edge_index_rebuild(G);
+      return;
+    }
+
+    Graph_edge_index_add(I, S, D);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_edge_index_remove
+ *
+ * In this function we forget pair of Graph
+ * whose last edge was removed. Index is rebuilt
+ * once removed pairs reach half of the edges it
+ * is sized for, which clears stale Bloom filter
+ * bits and tombstones
+ *
+ * Input:
+ *      Graph_t          - Graph (with index)
+ *      vertex_number_t  - Source
+ *      vertex_number_t  - Destination
+ * Output:
+ *      none
+ */
+void
+Graph_edge_index_remove(Graph_t *G, vertex_number_t S, vertex_number_t D) {
+
+    Graph_edge_index_t  *I = G->edge_index;
+    uint64_t             key  = Graph_edge_key(S, D);
+
+    if (I->set != NULL && key < GRAPH_EDGE_INDEX_TOMBSTONE) {
+      Graph_edge_set_erase(I, key, Graph_edge_hash(key));
+    }
+    I->removed++;
+
+    if (I->removed > I->planned_edges / 2) {
+      Graph_edge_index_rebuild(G);
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_edge_index_rebuild
+ *
+ * In this function we build index of Graph
+ * again from its adjacency, sized for present
+ * edges. Index is dropped if it cannot be rebuilt
+ *
+ * Input:
+ *      Graph_t  - Graph (with index)
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- If index was dropped
+ */
+bool
+Graph_edge_index_rebuild(Graph_t *G) {
+
+    if (!Graph_edge_index_build(G, G->edge_index)) {
+      LOG_ERR("Dropping edge index of Graph");
+      Graph_disable_edge_index(G);
+      return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_edge_index_clear
+ *
+ * In this function we forget all edges of
+ * index, keeping its memory
+ */
+void
+Graph_edge_index_clear(Graph_edge_index_t *I) {
+
+    memset(I->bloom, 0, I->bloom_blocks * GRAPH_BLOOM_BLOCK_WORDS * sizeof(uint64_t));
+    if (I->set != NULL) {
+      memset(I->set, 0xff, I->set_size * sizeof(uint64_t));
+    }
+    I->set_count      = 0;
+    I->set_tombstones = 0;
+    I->removed        = 0;
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_edge_index_lookup
+ *
+ * In this function we look pair up in index
+ *
+ * Input:
+ *      Graph_edge_index_t
+ *      vertex_number_t  - Source
+ *      vertex_number_t  - Destination
+ * Output:
+ *      int  0 <-- Edge is absent
+ *           1 <-- Edge is present
+ *          -1 <-- Unknown, adjacency must be searched
+ */
+int
+Graph_edge_index_lookup(const Graph_edge_index_t *I, vertex_number_t S,
+                        vertex_number_t D) {
+
+    uint64_t             key  = Graph_edge_key(S, D);
+    uint64_t             hash = Graph_edge_hash(key);
+
+    if (!Graph_bloom_test(I, hash)) {
+      return 0;
+    }
+
+    if (I->set == NULL || key >= GRAPH_EDGE_INDEX_TOMBSTONE) {
+      return -1;
+    }
+
+    return Graph_edge_set_contains(I, key, hash) ? 1 : 0;
+}
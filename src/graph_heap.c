@@ -0,0 +1,734 @@
+/*
+ * In this File we define indexed min priority queue
+ * used as frontier of the shortest path algorithms.
+ *
+ * Elements are dense vertex indices (0 .. capacity-1) so
+ * every array is allocated once, from one flat block, when
+ * the heap is created. Following variants are available
+ *      GRAPH_HEAP_BINARY      - Binary heap
+ *      GRAPH_HEAP_QUATERNARY  - 4-ary heap (shallower, better cache use)
+ *      GRAPH_HEAP_PAIRING     - Pairing heap (O(1) insert/decrease-key)
+ *      GRAPH_HEAP_RADIX       - Radix heap, keys are kept in buckets by
+ *                               highest bit differing from last popped key
+ *      GRAPH_HEAP_DIAL        - Dial bucket ring, one bucket per key in
+ *                               [last popped, last popped + max weight]
+ * Radix and Dial need monotone keys (no key below last popped
+ * one), as Dijkstra with non negative weights has. Elements of
+ * a bucket form a doubly linked list so that decrease-key is O(1).
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#include "graph.h"
+
+/*
+ * Function:
+ * Graph_heap_arity
+ *
+ * In this function we return no of children
+ * of every node for d-ary variants
+ */
+static int
+Graph_heap_arity(const Graph_heap_t *H) {
+
+    return (H->type == GRAPH_HEAP_QUATERNARY) ? 4 : 2;
+}
+
+/*
+ * Function:
+ * Graph_heap_create
+ *
+ * In this function we create heap which can hold
+ * elements 0 .. capacity-1. All arrays are carved
+ * from a single allocation
+ *
+ * Input:
+ *      vertex_number_t    - capacity
+ *      Graph_heap_type_t  - variant
+ * Output:
+ *      Graph_heap_t Object or NULL
+ */
+Graph_heap_t *
+Graph_heap_create(vertex_number_t capacity, Graph_heap_type_t type) {
+
+    Graph_heap_t        *H;
+    size_t               slots;
+    size_t               block_size;
+    char                *block;
+    vertex_number_t      iterator;
+
+    slots      = (capacity > 0) ? (size_t)capacity : 1;
+    block_size = sizeof(Graph_heap_t) + slots * sizeof(long) +
+                 5 * slots * sizeof(vertex_number_t);
+
+    block = (char *)malloc(block_size);
+    if (block == NULL) {
+      LOG_ERR("Unable to allocate heap for %d elements",capacity);
+      return NULL;
+    }
+
+    H           = (Graph_heap_t *)block;
+    block      += sizeof(Graph_heap_t);
+    H->key      = (long *)block;
+    block      += slots * sizeof(long);
+    H->heap     = (vertex_number_t *)block;
+    H->position = H->heap     + slots;
+    H->child    = H->position + slots;
+    H->sibling  = H->child    + slots;
+    H->prev     = H->sibling  + slots;
+
+    H->capacity = capacity;
+    H->size     = 0;
+    H->root     = -1;
+    H->last     = 0;
+    H->span     = 0;
+    H->ring     = NULL;
+
+    for (iterator = 0; iterator < capacity; iterator++) {
+      H->position[iterator] = -1;
+    }
+    for (iterator = 0; iterator < (vertex_number_t)GRAPH_HEAP_RADIX_BUCKETS; iterator++) {
+      H->radix[iterator] = -1;
+    }
+
+    /* Weights are not known yet, Dial is sized by Graph_heap_set_type */
+    Graph_heap_set_type(H, type, LONG_MAX);
+
+    return H;
+}
+
+/*
+ * Function:
+ * Graph_heap_set_type
+ *
+ * In this function we select variant of empty heap.
+ * GRAPH_HEAP_AUTO picks Dial when keys grow by at most
+ * GRAPH_HEAP_DIAL_MAX_WEIGHT per pop, else 4-ary heap.
+ * Dial asked for larger weights falls back to Radix.
+ * Bucket variants need monotone keys, when keys are not
+ * (negative weights, A*) Binary heap is used instead
+ *
+ * Input:
+ *      Graph_heap_t
+ *      Graph_heap_type_t  - variant
+ *      long               - max weight, largest key above last popped
+ *                           one, -1 if keys are not monotone
+ * Output:
+ *      none
+ */
+void
+Graph_heap_set_type(Graph_heap_t *H, Graph_heap_type_t type, long max_weight) {
+
+    vertex_number_t     *ring;
+    long                 bucket;
+
+    if (type == GRAPH_HEAP_AUTO) {
+      type = (max_weight >= 0 && max_weight <= GRAPH_HEAP_DIAL_MAX_WEIGHT) ?
+             GRAPH_HEAP_DIAL : GRAPH_HEAP_QUATERNARY;
+    }
+
+    if (type == GRAPH_HEAP_DIAL && max_weight > GRAPH_HEAP_DIAL_MAX_WEIGHT) {
+      type = GRAPH_HEAP_RADIX;
+    }
+
+    if ((type == GRAPH_HEAP_DIAL || type == GRAPH_HEAP_RADIX) && max_weight < 0) {
+      type = GRAPH_HEAP_BINARY;
+    }
+
+    if (type == GRAPH_HEAP_DIAL && max_weight + 1 > H->span) {
+      ring = (vertex_number_t *)realloc(H->ring, (max_weight + 1) * sizeof(vertex_number_t));
+      if (ring == NULL) {
+        LOG_ERR("Unable to allocate %ld buckets, using Radix heap",max_weight + 1);
+        type = GRAPH_HEAP_RADIX;
+      } else {
+        for (bucket = H->span; bucket < max_weight + 1; bucket++) {
+          ring[bucket] = -1;
+        }
+        H->ring = ring;
+        H->span = max_weight + 1;
+      }
+    }
+
+    H->type = type;
+    H->last = 0;
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_heap_destroy
+ *
+ * In this function we release heap
+ */
+void
+Graph_heap_destroy(Graph_heap_t *H) {
+
+    if (H != NULL) {
+      free(H->ring);
+    }
+    free(H);
+    return;
+}
+
+/*
+ * Function:
+ * Graph_heap_contains
+ *
+ * In this function we verify whether element
+ * is presently in the heap
+ */
+bool
+Graph_heap_contains(const Graph_heap_t *H, vertex_number_t element) {
+
+    return H->position[element] != -1;
+}
+
+/*
+ * Function:
+ * Graph_heap_is_empty
+ */
+bool
+Graph_heap_is_empty(const Graph_heap_t *H) {
+
+    return H->size == 0;
+}
+
+/*
+ * Function:
+ * Graph_heap_sift_up
+ *
+ * In this function we move element at slot
+ * towards root till heap order is restored (d-ary)
+ */
+static void
+Graph_heap_sift_up(Graph_heap_t *H, vertex_number_t slot) {
+
+    vertex_number_t      element = H->heap[slot];
+    long                 key     = H->key[element];
+    vertex_number_t      parent;
+    int                  arity   = Graph_heap_arity(H);
+
+    while (slot > 0) {
+      parent = (slot - 1) / arity;
+      if (H->key[H->heap[parent]] <= key) {
+        break;
+      }
+      H->heap[slot]                = H->heap[parent];
+      H->position[H->heap[slot]]   = slot;
+      slot                         = parent;
+    }
+
+    H->heap[slot]        = element;
+    H->position[element] = slot;
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_heap_sift_down
+ *
+ * In this function we move element at slot
+ * towards leaves till heap order is restored (d-ary)
+ */
+static void
+Graph_heap_sift_down(Graph_heap_t *H, vertex_number_t slot) {
+
+    vertex_number_t      element = H->heap[slot];
+    long                 key     = H->key[element];
+    vertex_number_t      first;
+    vertex_number_t      last;
+    vertex_number_t      best;
+    vertex_number_t      runner;
+    int                  arity   = Graph_heap_arity(H);
+
+    while (TRUE) {
+      first = slot * arity + 1;
+      if (first >= H->size) {
+        break;
+      }
+
+      last = first + arity;
+      if (last > H->size) {
+        last = H->size;
+      }
+
+      best = first;
+      for (runner = first + 1; runner < last; runner++) {
+        if (H->key[H->heap[runner]] < H->key[H->heap[best]]) {
+          best = runner;
+        }
+      }
+
+      if (H->key[H->heap[best]] >= key) {
+        break;
+      }
+
+      H->heap[slot]              = H->heap[best];
+      H->position[H->heap[slot]] = slot;
+      slot                       = best;
+    }
+
+    H->heap[slot]        = element;
+    H->position[element] = slot;
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_heap_meld
+ *
+ * In this function we link two pairing heap
+ * roots, the one with larger key becomes
+ * leftmost child of the other
+ *
+ * Output:
+ *      vertex_number_t - New root
+ */
+static vertex_number_t
+Graph_heap_meld(Graph_heap_t *H, vertex_number_t A, vertex_number_t B) {
+
+    vertex_number_t      swap;
+
+    if (A == -1) {
+      return B;
+    }
+    if (B == -1) {
+      return A;
+    }
+
+    if (H->key[B] < H->key[A]) {
+      swap = A;
+      A    = B;
+      B    = swap;
+    }
+
+    H->sibling[B] = H->child[A];
+    if (H->child[A] != -1) {
+      H->prev[H->child[A]] = B;
+    }
+    H->prev[B]    = A;
+    H->child[A]   = B;
+
+    return A;
+}
+
+/*
+ * Function:
+ * Graph_heap_is_bucketed
+ *
+ * In this function we check whether heap keeps
+ * elements in buckets (Radix / Dial)
+ */
+static bool
+Graph_heap_is_bucketed(const Graph_heap_t *H) {
+
+    return H->type == GRAPH_HEAP_RADIX || H->type == GRAPH_HEAP_DIAL;
+}
+
+/*
+ * Function:
+ * Graph_heap_bucket_of
+ *
+ * In this function we find bucket of key, for Radix
+ * it is position of highest bit in which key differs
+ * from last popped key (0 if equal), for Dial it is
+ * key modulo no of buckets in ring
+ */
+static vertex_number_t
+Graph_heap_bucket_of(const Graph_heap_t *H, long key) {
+
+    if (H->type == GRAPH_HEAP_DIAL) {
+      return (vertex_number_t)(key % H->span);
+    }
+
+    if (key == H->last) {
+      return 0;
+    }
+
+    return (vertex_number_t)(sizeof(long) * CHAR_BIT) -
+           __builtin_clzl((unsigned long)(key ^ H->last));
+}
+
+/*
+ * Function:
+ * Graph_heap_link / Graph_heap_unlink
+ *
+ * In these functions we add element to front of
+ * bucket list / remove element from its bucket list
+ */
+static void
+Graph_heap_link(Graph_heap_t *H, vertex_number_t element, vertex_number_t bucket) {
+
+    vertex_number_t     *heads = (H->type == GRAPH_HEAP_DIAL) ? H->ring : H->radix;
+
+    H->sibling[element] = heads[bucket];
+    H->prev[element]    = -1;
+    if (heads[bucket] != -1) {
+      H->prev[heads[bucket]] = element;
+    }
+    heads[bucket]        = element;
+    H->position[element] = bucket;
+
+    return;
+}
+
+static void
+Graph_heap_unlink(Graph_heap_t *H, vertex_number_t element) {
+
+    vertex_number_t     *heads = (H->type == GRAPH_HEAP_DIAL) ? H->ring : H->radix;
+
+    if (H->prev[element] != -1) {
+      H->sibling[H->prev[element]] = H->sibling[element];
+    } else {
+      heads[H->position[element]]  = H->sibling[element];
+    }
+    if (H->sibling[element] != -1) {
+      H->prev[H->sibling[element]] = H->prev[element];
+    }
+    H->position[element] = -1;
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_heap_radix_first
+ *
+ * In this function we find first non empty bucket
+ * of Radix heap and smallest key in it
+ *
+ * Output:
+ *      vertex_number_t  - bucket, -1 if heap is empty
+ */
+static vertex_number_t
+Graph_heap_radix_first(const Graph_heap_t *H, long *smallest) {
+
+    vertex_number_t      bucket;
+    vertex_number_t      runner;
+
+    for (bucket = 0; bucket < (vertex_number_t)GRAPH_HEAP_RADIX_BUCKETS; bucket++) {
+      if (H->radix[bucket] != -1) {
+        break;
+      }
+    }
+    if (bucket == (vertex_number_t)GRAPH_HEAP_RADIX_BUCKETS) {
+      return -1;
+    }
+
+    *smallest = LONG_MAX;
+    for (runner = H->radix[bucket]; runner != -1; runner = H->sibling[runner]) {
+      if (H->key[runner] < *smallest) {
+        *smallest = H->key[runner];
+      }
+    }
+
+    return bucket;
+}
+
+/*
+ * Function:
+ * Graph_heap_bucket_pop
+ *
+ * In this function we remove element with minimum
+ * key from Radix / Dial heap. Radix heap moves
+ * smallest key to last and spreads its bucket into
+ * lower buckets, Dial heap walks ring from last
+ */
+static vertex_number_t
+Graph_heap_bucket_pop(Graph_heap_t *H) {
+
+    vertex_number_t      bucket;
+    vertex_number_t      runner;
+    vertex_number_t      next;
+    vertex_number_t      top;
+    long                 smallest;
+
+    if (H->type == GRAPH_HEAP_DIAL) {
+      while (H->ring[H->last % H->span] == -1) {
+        H->last++;
+      }
+      top = H->ring[H->last % H->span];
+    } else {
+      if (H->radix[0] == -1) {
+        bucket  = Graph_heap_radix_first(H, &smallest);
+        H->last = smallest;
+
+        runner = H->radix[bucket];
+        H->radix[bucket] = -1;
+        while (runner != -1) {
+          next = H->sibling[runner];
+          Graph_heap_link(H, runner, Graph_heap_bucket_of(H, H->key[runner]));
+          runner = next;
+        }
+      }
+      top = H->radix[0];
+    }
+
+    Graph_heap_unlink(H, top);
+    H->size--;
+
+    return top;
+}
+
+/*
+ * Function:
+ * Graph_heap_push
+ *
+ * In this function we insert element with key,
+ * If element is already present its key is
+ * decreased (larger keys are ignored)
+ *
+ * Input:
+ *      Graph_heap_t
+ *      vertex_number_t  - element
+ *      long             - key
+ * Output:
+ *      none
+ */
+void
+Graph_heap_push(Graph_heap_t *H, vertex_number_t element, long key) {
+
+    vertex_number_t      prev;
+
+    if (Graph_heap_is_bucketed(H)) {
+      if (H->position[element] != -1) {
+        if (key >= H->key[element]) {
+          return;
+        }
+        Graph_heap_unlink(H, element);
+      } else {
+        H->size++;
+      }
+      H->key[element] = key;
+      Graph_heap_link(H, element, Graph_heap_bucket_of(H, key));
+      return;
+    }
+
+    if (H->position[element] != -1) {
+      if (key >= H->key[element]) {
+        return;
+      }
+      H->key[element] = key;
+
+      if (H->type != GRAPH_HEAP_PAIRING) {
+        Graph_heap_sift_up(H, H->position[element]);
+        return;
+      }
+
+      if (element == H->root) {
+        return;
+      }
+
+      /* Cut element subtree and meld it back with root */
+      prev = H->prev[element];
+      if (H->child[prev] == element) {
+        H->child[prev] = H->sibling[element];
+      } else {
+        H->sibling[prev] = H->sibling[element];
+      }
+      if (H->sibling[element] != -1) {
+        H->prev[H->sibling[element]] = prev;
+      }
+      H->sibling[element] = -1;
+      H->prev[element]    = -1;
+      H->root = Graph_heap_meld(H, H->root, element);
+      return;
+    }
+
+    H->key[element] = key;
+    H->size++;
+
+    if (H->type != GRAPH_HEAP_PAIRING) {
+      H->heap[H->size - 1] = element;
+      Graph_heap_sift_up(H, H->size - 1);
+      return;
+    }
+
+    H->position[element] = 0;
+    H->child[element]    = -1;
+    H->sibling[element]  = -1;
+    H->prev[element]     = -1;
+    H->root = Graph_heap_meld(H, H->root, element);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_heap_pop
+ *
+ * In this function we remove element with
+ * minimum key
+ *
+ * Input:
+ *      Graph_heap_t
+ * Output:
+ *      vertex_number_t - element, -1 if heap is empty
+ */
+vertex_number_t
+Graph_heap_pop(Graph_heap_t *H) {
+
+    vertex_number_t      top;
+    vertex_number_t      runner;
+    vertex_number_t      count;
+    vertex_number_t      pairs;
+    vertex_number_t      iterator;
+
+    if (H->size == 0) {
+      return -1;
+    }
+
+    if (Graph_heap_is_bucketed(H)) {
+      return Graph_heap_bucket_pop(H);
+    }
+
+    H->size--;
+
+    if (H->type != GRAPH_HEAP_PAIRING) {
+      top = H->heap[0];
+      H->position[top] = -1;
+      if (H->size > 0) {
+        H->heap[0] = H->heap[H->size];
+        Graph_heap_sift_down(H, 0);
+      }
+      return top;
+    }
+
+    top = H->root;
+    H->position[top] = -1;
+
+    /* Detach children of root, heap array is scratch for pairing */
+    count  = 0;
+    runner = H->child[top];
+    while (runner != -1) {
+      H->heap[count++]  = runner;
+      H->prev[runner]   = -1;
+      runner            = H->sibling[runner];
+      H->sibling[H->heap[count - 1]] = -1;
+    }
+
+    /* First pass: meld pairs left to right */
+    pairs = 0;
+    for (iterator = 0; iterator + 1 < count; iterator += 2) {
+      H->heap[pairs++] = Graph_heap_meld(H, H->heap[iterator],
+                                         H->heap[iterator + 1]);
+    }
+    if (iterator < count) {
+      H->heap[pairs++] = H->heap[iterator];
+    }
+
+    /* Second pass: meld right to left into single root */
+    H->root = -1;
+    for (iterator = pairs - 1; iterator >= 0; iterator--) {
+      H->root = Graph_heap_meld(H, H->heap[iterator], H->root);
+    }
+
+    return top;
+}
+
+/*
+ * Function:
+ * Graph_heap_top_key
+ *
+ * In this function we return minimum key
+ * without removing its element. Radix heap scans
+ * its first non empty bucket, Dial heap the ring
+ *
+ * Input:
+ *      Graph_heap_t
+ * Output:
+ *      long - key, GRAPH_INFINITE_DISTANCE if heap is empty
+ */
+long
+Graph_heap_top_key(const Graph_heap_t *H) {
+
+    long                 key;
+
+    if (H->size == 0) {
+      return GRAPH_INFINITE_DISTANCE;
+    }
+
+    if (H->type == GRAPH_HEAP_DIAL) {
+      for (key = H->last; H->ring[key % H->span] == -1; key++);
+      return key;
+    }
+
+    if (H->type == GRAPH_HEAP_RADIX) {
+      Graph_heap_radix_first(H, &key);
+      return key;
+    }
+
+    if (H->type != GRAPH_HEAP_PAIRING) {
+      return H->key[H->heap[0]];
+    }
+
+    return H->key[H->root];
+}
+
+/*
+ * Function:
+ * Graph_heap_clear
+ *
+ * In this function we remove all elements,
+ * cost is proportional to elements present
+ * (no reordering is done), plus buckets of
+ * Radix / Dial
+ */
+void
+Graph_heap_clear(Graph_heap_t *H) {
+
+    vertex_number_t      slot;
+    vertex_number_t      top;
+    vertex_number_t      element;
+    vertex_number_t     *heads;
+    long                 buckets;
+    long                 bucket;
+
+    if (Graph_heap_is_bucketed(H)) {
+      heads   = (H->type == GRAPH_HEAP_DIAL) ? H->ring : H->radix;
+      buckets = (H->type == GRAPH_HEAP_DIAL) ? H->span : (long)GRAPH_HEAP_RADIX_BUCKETS;
+      for (bucket = 0; bucket < buckets && H->size > 0; bucket++) {
+        for (element = heads[bucket]; element != -1; element = H->sibling[element]) {
+          H->position[element] = -1;
+          H->size--;
+        }
+        heads[bucket] = -1;
+      }
+      H->size = 0;
+      H->last = 0;
+      return;
+    }
+
+    if (H->type != GRAPH_HEAP_PAIRING) {
+      for (slot = 0; slot < H->size; slot++) {
+        H->position[H->heap[slot]] = -1;
+      }
+      H->size = 0;
+      return;
+    }
+
+    /* Walk the tree with heap array as stack, no melding needed */
+    top = 0;
+    if (H->root != -1) {
+      H->heap[top++] = H->root;
+    }
+    while (top > 0) {
+      element = H->heap[--top];
+      H->position[element] = -1;
+      if (H->child[element] != -1) {
+        H->heap[top++] = H->child[element];
+      }
+      if (H->sibling[element] != -1) {
+        H->heap[top++] = H->sibling[element];
+      }
+    }
+
+    H->root = -1;
+    H->size = 0;
+
+    return;
+}
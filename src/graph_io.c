@@ -0,0 +1,752 @@
+/*
+ * In this File we define loading and storing
+ * of Graphs as edge list files.
+ *
+ * Following formats are available
+ *      GRAPH_FORMAT_TEXT    - one "source destination [weight]" per line,
+ *                             lines starting with '#' or '%' are comments
+ *      GRAPH_FORMAT_BINARY  - Graph_edge_file_header_t followed by
+ *                             int32 source, destination (and weight) records
+ *
+ * Input is memory mapped and parsed in parallel chunks,
+ * parsed edges go straight to Graph_add_edges_bulk.
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "graph.h"
+
+/*
+ * Parsed edges of an edge list file
+ */
+typedef struct graph_edge_list_ {
+    vertex_number_t     *src;          /* Source of every edge */
+    vertex_number_t     *dst;          /* Destination of every edge */
+    edge_weight_t       *weight;       /* Weight of every edge */
+    edge_index_t         count;        /* No of edges */
+    vertex_number_t      min_vertex;   /* Smallest vertex ID seen */
+    vertex_number_t      max_vertex;   /* Largest vertex ID seen */
+} Graph_edge_list_t;
+
+/*
+ * Shared state of parallel text parsing
+ */
+typedef struct graph_text_parse_ {
+    const char          *data;         /* Mapped file */
+    size_t               size;         /* Bytes in file */
+    size_t              *chunk_start;  /* First byte of every chunk, one extra entry for end */
+    edge_index_t        *chunk_lines;  /* Lines in every chunk, then output offset */
+    edge_index_t        *chunk_edges;  /* Edges parsed from every chunk */
+    edge_index_t        *chunk_errors; /* Malformed lines of every chunk */
+    vertex_number_t     *chunk_min;    /* Smallest ID of every chunk */
+    vertex_number_t     *chunk_max;    /* Largest ID of every chunk */
+    Graph_edge_list_t   *list;         /* Output */
+    int                  pass;         /* 1 - count lines, 2 - parse */
+} Graph_text_parse_t;
+
+/*
+ * Shared state of parallel binary decoding
+ */
+typedef struct graph_binary_parse_ {
+    const int32_t       *records;      /* First record */
+    int                  fields;       /* 2 or 3 int32 per record */
+    edge_index_t         count;        /* No of records */
+    vertex_number_t     *chunk_min;    /* Smallest ID of every thread */
+    vertex_number_t     *chunk_max;    /* Largest ID of every thread */
+    Graph_edge_list_t   *list;         /* Output */
+} Graph_binary_parse_t;
+
+/*
+ * Function:
+ * Graph_parse_number
+ *
+ * In this function we parse signed decimal
+ * number at cursor, skipping blanks before it
+ *
+ * Input:
+ *      const char **  - cursor, moved past number
+ *      const char *   - end of line
+ *      long *         - parsed number (Output)
+ * Output:
+ *      bool True  <-- If number was found
+ *           False <-- Otherwise
+ */
+static bool
+Graph_parse_number(const char **cursor, const char *end, long *number) {
+
+    const char          *runner = *cursor;
+    long                 value  = 0;
+    bool                 negative = FALSE;
+
+    while (runner < end && (*runner == ' ' || *runner == '\t' ||
+                            *runner == ',' || *runner == '\r')) {
+      runner++;
+    }
+
+    if (runner < end && (*runner == '-' || *runner == '+')) {
+      negative = (*runner == '-');
+      runner++;
+    }
+
+    if (runner == end || *runner < '0' || *runner > '9') {
+      return FALSE;
+    }
+
+    /* Magnitude of INT_MIN is one above INT_MAX */
+    while (runner < end && *runner >= '0' && *runner <= '9') {
+      value = value * 10 + (*runner - '0');
+      if (value > (long)INT_MAX + negative) {
+        return FALSE;
+      }
+      runner++;
+    }
+
+    *number = negative ? -value : value;
+    *cursor = runner;
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_text_parse_worker
+ *
+ * In this function every thread counts lines of
+ * its chunk (pass 1) or parses them into the edge
+ * arrays starting at its output offset (pass 2)
+ */
+static void *
+Graph_text_parse_worker(void *arg) {
+
+    Graph_thread_t      *T = (Graph_thread_t *)arg;
+    Graph_text_parse_t  *P = (Graph_text_parse_t *)T->shared;
+    const char          *cursor;
+    const char          *end;
+    const char          *line_end;
+    edge_index_t         out;
+    edge_index_t         lines  = 0;
+    edge_index_t         errors = 0;
+    vertex_number_t      low    = INT_MAX;
+    vertex_number_t      high   = INT_MIN;
+    long                 source;
+    long                 destination;
+    long                 weight;
+
+    cursor = P->data + P->chunk_start[T->id];
+    end    = P->data + P->chunk_start[T->id + 1];
+
+    if (P->pass == 1) {
+      while (cursor < end) {
+        line_end = memchr(cursor, '\n', end - cursor);
+        lines++;
+        if (line_end == NULL) {
+          break;
+        }
+        cursor = line_end + 1;
+      }
+      P->chunk_lines[T->id] = lines;
+      return NULL;
+    }
+
+    out = P->chunk_lines[T->id];
+
+    while (cursor < end) {
+      line_end = memchr(cursor, '\n', end - cursor);
+      if (line_end == NULL) {
+        line_end = end;
+      }
+
+      while (cursor < line_end && (*cursor == ' ' || *cursor == '\t')) {
+        cursor++;
+      }
+
+      if (cursor == line_end || *cursor == '#' || *cursor == '%' ||
+          *cursor == '\r') {
+        cursor = line_end + 1;
+        continue;
+      }
+
+      if (!Graph_parse_number(&cursor, line_end, &source) ||
+          !Graph_parse_number(&cursor, line_end, &destination)) {
+        errors++;
+        cursor = line_end + 1;
+        continue;
+      }
+
+      /* Weight is optional, but what is there must parse */
+      if (!Graph_parse_number(&cursor, line_end, &weight)) {
+        while (cursor < line_end && (*cursor == ' ' || *cursor == '\t' ||
+                                     *cursor == ',' || *cursor == '\r')) {
+          cursor++;
+        }
+        if (cursor < line_end) {
+          errors++;
+          cursor = line_end + 1;
+          continue;
+        }
+        weight = 1;
+      }
+
+      P->list->src[out]    = (vertex_number_t)source;
+      P->list->dst[out]    = (vertex_number_t)destination;
+      P->list->weight[out] = (edge_weight_t)weight;
+      out++;
+
+      if (source < low)       low  = source;
+      if (destination < low)  low  = destination;
+      if (source > high)      high = source;
+      if (destination > high) high = destination;
+
+      cursor = line_end + 1;
+    }
+
+    P->chunk_edges[T->id]  = out - P->chunk_lines[T->id];
+    P->chunk_errors[T->id] = errors;
+    P->chunk_min[T->id]    = low;
+    P->chunk_max[T->id]    = high;
+
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_edge_list_alloc
+ *
+ * In this function we allocate edge arrays
+ */
+static bool
+Graph_edge_list_alloc(Graph_edge_list_t *list, edge_index_t capacity) {
+
+    size_t               slots = (capacity > 0) ? (size_t)capacity : 1;
+
+    list->src    = (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    list->dst    = (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    list->weight = (edge_weight_t *)malloc(slots * sizeof(edge_weight_t));
+    list->count  = 0;
+    list->min_vertex = INT_MAX;
+    list->max_vertex = INT_MIN;
+
+    if (list->src == NULL || list->dst == NULL || list->weight == NULL) {
+      LOG_ERR("Unable to allocate edge list of %ld edges",capacity);
+      return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_edge_list_free
+ */
+static void
+Graph_edge_list_free(Graph_edge_list_t *list) {
+
+    free(list->src);
+    free(list->dst);
+    free(list->weight);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_parse_text
+ *
+ * In this function we parse text edge list.
+ * File is split into one chunk per thread at
+ * line boundaries, lines are counted to give every
+ * chunk its output offset, then chunks are parsed
+ * in parallel and compacted
+ */
+static bool
+Graph_parse_text(const char *data, size_t size, Graph_edge_list_t *list) {
+
+    Graph_text_parse_t   P;
+    const char          *newline;
+    edge_index_t         total = 0;
+    edge_index_t         errors = 0;
+    edge_index_t         lines;
+    int                  no_of_threads;
+    int                  iterator;
+    bool                 result = FALSE;
+
+    memset(&P, 0, sizeof(P));
+
+    no_of_threads = Graph_resolve_threads(0);
+    if ((size_t)no_of_threads > size / GRAPH_IO_MIN_CHUNK + 1) {
+      no_of_threads = (int)(size / GRAPH_IO_MIN_CHUNK + 1);
+    }
+
+    P.data         = data;
+    P.size         = size;
+    P.list         = list;
+    P.chunk_start  = (size_t *)calloc(no_of_threads + 1, sizeof(size_t));
+    P.chunk_lines  = (edge_index_t *)calloc(no_of_threads, sizeof(edge_index_t));
+    P.chunk_edges  = (edge_index_t *)calloc(no_of_threads, sizeof(edge_index_t));
+    P.chunk_errors = (edge_index_t *)calloc(no_of_threads, sizeof(edge_index_t));
+    P.chunk_min    = (vertex_number_t *)calloc(no_of_threads, sizeof(vertex_number_t));
+    P.chunk_max    = (vertex_number_t *)calloc(no_of_threads, sizeof(vertex_number_t));
+    if (P.chunk_start == NULL || P.chunk_lines == NULL || P.chunk_edges == NULL ||
+        P.chunk_errors == NULL || P.chunk_min == NULL || P.chunk_max == NULL) {
+      LOG_ERR("Unable to allocate parse state for %d threads",no_of_threads);
+      goto destroy;
+    }
+
+    /* Chunks start right after a newline */
+    P.chunk_start[no_of_threads] = size;
+    for (iterator = 1; iterator < no_of_threads; iterator++) {
+      P.chunk_start[iterator] = size * iterator / no_of_threads;
+      if (P.chunk_start[iterator] < P.chunk_start[iterator - 1]) {
+        P.chunk_start[iterator] = P.chunk_start[iterator - 1];
+      }
+      newline = memchr(data + P.chunk_start[iterator] - 1, '\n',
+                       size - P.chunk_start[iterator] + 1);
+      P.chunk_start[iterator] = (newline == NULL) ? size
+                                                  : (size_t)(newline - data) + 1;
+    }
+
+    P.pass = 1;
+    if (!Graph_parallel_run(no_of_threads, Graph_text_parse_worker, &P)) {
+      goto destroy;
+    }
+
+    for (iterator = 0; iterator < no_of_threads; iterator++) {
+      lines                   = P.chunk_lines[iterator];
+      P.chunk_lines[iterator] = total;
+      total                  += lines;
+    }
+
+    if (!Graph_edge_list_alloc(list, total)) {
+      goto destroy;
+    }
+
+    P.pass = 2;
+    if (!Graph_parallel_run(no_of_threads, Graph_text_parse_worker, &P)) {
+      goto destroy;
+    }
+
+    /* Compact chunks, comments and blank lines left holes */
+    for (iterator = 0; iterator < no_of_threads; iterator++) {
+      if (P.chunk_edges[iterator] == 0) {
+        continue;
+      }
+      if (P.chunk_lines[iterator] != list->count) {
+        memmove(list->src + list->count, list->src + P.chunk_lines[iterator],
+                P.chunk_edges[iterator] * sizeof(vertex_number_t));
+        memmove(list->dst + list->count, list->dst + P.chunk_lines[iterator],
+                P.chunk_edges[iterator] * sizeof(vertex_number_t));
+        memmove(list->weight + list->count, list->weight + P.chunk_lines[iterator],
+                P.chunk_edges[iterator] * sizeof(edge_weight_t));
+      }
+      list->count += P.chunk_edges[iterator];
+      errors      += P.chunk_errors[iterator];
+      if (P.chunk_min[iterator] < list->min_vertex) {
+        list->min_vertex = P.chunk_min[iterator];
+      }
+      if (P.chunk_max[iterator] > list->max_vertex) {
+        list->max_vertex = P.chunk_max[iterator];
+      }
+    }
+
+    if (errors > 0) {
+      LOG_ERR("Skipped %ld malformed lines",errors);
+    }
+
+    result = TRUE;
+
+destroy:
+    free(P.chunk_start);
+    free(P.chunk_lines);
+    free(P.chunk_edges);
+    free(P.chunk_errors);
+    free(P.chunk_min);
+    free(P.chunk_max);
+    return result;
+}
+
+/*
+ * Function:
+ * Graph_binary_parse_worker
+ *
+ * In this function every thread splits its share
+ * of records into the edge arrays
+ */
+static void *
+Graph_binary_parse_worker(void *arg) {
+
+    Graph_thread_t        *T = (Graph_thread_t *)arg;
+    Graph_binary_parse_t  *P = (Graph_binary_parse_t *)T->shared;
+    const int32_t         *record;
+    edge_index_t           first;
+    edge_index_t           last;
+    edge_index_t           iterator;
+    vertex_number_t        low  = INT_MAX;
+    vertex_number_t        high = INT_MIN;
+
+    first = P->count * T->id / T->count;
+    last  = P->count * (T->id + 1) / T->count;
+
+    for (iterator = first; iterator < last; iterator++) {
+      record = P->records + iterator * P->fields;
+      P->list->src[iterator]    = record[0];
+      P->list->dst[iterator]    = record[1];
+      P->list->weight[iterator] = (P->fields == 3) ? record[2] : 1;
+
+      if (record[0] < low)  low  = record[0];
+      if (record[1] < low)  low  = record[1];
+      if (record[0] > high) high = record[0];
+      if (record[1] > high) high = record[1];
+    }
+
+    P->chunk_min[T->id] = low;
+    P->chunk_max[T->id] = high;
+
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_parse_binary
+ *
+ * In this function we validate header of binary
+ * edge list and decode its records in parallel
+ */
+static bool
+Graph_parse_binary(const char *data, size_t size, Graph_edge_list_t *list) {
+
+    Graph_edge_file_header_t  header;
+    Graph_binary_parse_t      P;
+    int                       no_of_threads;
+    int                       iterator;
+    bool                      result = FALSE;
+
+    if (size < sizeof(header)) {
+      LOG_ERR("Binary edge list is truncated");
+      return FALSE;
+    }
+
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, GRAPH_EDGE_FILE_MAGIC, 4) != 0 ||
+        header.version != GRAPH_EDGE_FILE_VERSION) {
+      LOG_ERR("Unsupported binary edge list (version %u)",header.version);
+      return FALSE;
+    }
+
+    memset(&P, 0, sizeof(P));
+    P.fields  = (header.flags & GRAPH_EDGE_FILE_WEIGHTED) ? 3 : 2;
+    P.count   = (edge_index_t)header.no_of_edges;
+    P.records = (const int32_t *)(data + sizeof(header));
+    P.list    = list;
+
+    if ((size - sizeof(header)) / (P.fields * sizeof(int32_t)) <
+        (size_t)header.no_of_edges) {
+      LOG_ERR("Binary edge list is truncated, expected %lu edges",
+              (unsigned long)header.no_of_edges);
+      return FALSE;
+    }
+
+    no_of_threads = Graph_resolve_threads(0);
+    if (no_of_threads > P.count / (GRAPH_IO_MIN_CHUNK / 8) + 1) {
+      no_of_threads = (int)(P.count / (GRAPH_IO_MIN_CHUNK / 8) + 1);
+    }
+
+    P.chunk_min = (vertex_number_t *)calloc(no_of_threads, sizeof(vertex_number_t));
+    P.chunk_max = (vertex_number_t *)calloc(no_of_threads, sizeof(vertex_number_t));
+    if (P.chunk_min == NULL || P.chunk_max == NULL ||
+        !Graph_edge_list_alloc(list, P.count)) {
+      goto destroy;
+    }
+
+    if (!Graph_parallel_run(no_of_threads, Graph_binary_parse_worker, &P)) {
+      goto destroy;
+    }
+
+    list->count = P.count;
+    for (iterator = 0; iterator < no_of_threads; iterator++) {
+      if (P.chunk_min[iterator] < list->min_vertex) {
+        list->min_vertex = P.chunk_min[iterator];
+      }
+      if (P.chunk_max[iterator] > list->max_vertex) {
+        list->max_vertex = P.chunk_max[iterator];
+      }
+    }
+
+    result = TRUE;
+
+destroy:
+    free(P.chunk_min);
+    free(P.chunk_max);
+    return result;
+}
+
+/*
+ * Function:
+ * Graph_read_edge_list
+ *
+ * In this function we map file and parse
+ * it into edge arrays
+ */
+static bool
+Graph_read_edge_list(const char *path, Graph_file_format_t format,
+                     Graph_edge_list_t *list) {
+
+    struct stat          info;
+    const char          *data = NULL;
+    int                  fd;
+    bool                 result;
+
+    memset(list, 0, sizeof(*list));
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+      LOG_ERR("Unable to open %s",path);
+      return FALSE;
+    }
+
+    if (fstat(fd, &info) != 0) {
+      LOG_ERR("Unable to stat %s",path);
+      close(fd);
+      return FALSE;
+    }
+
+    if (info.st_size > 0) {
+      data = (const char *)mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        LOG_ERR("Unable to map %s",path);
+        close(fd);
+        return FALSE;
+      }
+      madvise((void *)data, info.st_size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    if (format == GRAPH_FORMAT_AUTO) {
+      format = (info.st_size >= 4 &&
+                memcmp(data, GRAPH_EDGE_FILE_MAGIC, 4) == 0) ? GRAPH_FORMAT_BINARY
+                                                             : GRAPH_FORMAT_TEXT;
+    }
+
+    if (format == GRAPH_FORMAT_BINARY) {
+      result = Graph_parse_binary(data, info.st_size, list);
+    } else {
+      result = Graph_parse_text(data, info.st_size, list);
+    }
+
+    if (data != NULL) {
+      munmap((void *)data, info.st_size);
+    }
+
+    if (!result) {
+      Graph_edge_list_free(list);
+    }
+
+    return result;
+}
+
+/*
+ * Function:
+ * Graph_edge_list_is_dense
+ *
+ * In this function we decide whether vertex IDs
+ * can be created as 0 .. max_vertex, else only
+ * IDs which appear in the file are created
+ */
+static bool
+Graph_edge_list_is_dense(const Graph_edge_list_t *list) {
+
+    if (list->count == 0) {
+      return TRUE;
+    }
+
+    return list->min_vertex >= 0 &&
+           (edge_index_t)list->max_vertex < 4 * list->count + GRAPH_VERTEX_TABLE_MIN;
+}
+
+/*
+ * Function:
+ * Graph_load_edge_list
+ *
+ * In this function we create Graph from edge
+ * list file. Dense IDs create vertices 0 .. max ID,
+ * sparse ones create only IDs present in the file
+ *
+ * Input:
+ *      const char *         - path
+ *      Graph_file_format_t  - GRAPH_FORMAT_TEXT / GRAPH_FORMAT_BINARY /
+ *                             GRAPH_FORMAT_AUTO (detect by magic)
+ *      bool                 - is_directed (else every edge is added both ways)
+ * Output:
+ *      Graph_t Object or NULL
+ */
+Graph_t *
+Graph_load_edge_list(const char *path, Graph_file_format_t format,
+                     bool is_directed) {
+
+    Graph_edge_list_t    list;
+    Graph_t             *G;
+    edge_index_t         iterator;
+    bool                 dense;
+
+    if (!Graph_read_edge_list(path, format, &list)) {
+      return NULL;
+    }
+
+    dense = Graph_edge_list_is_dense(&list);
+
+    G = Graph_init(0, is_directed);
+    if (G == NULL) {
+      goto destroy;
+    }
+
+    if (dense && list.count > 0) {
+      Graph_add_vertices(G, list.max_vertex + 1);
+      if (G->total_vertices != list.max_vertex + 1) {
+        goto destroy;
+      }
+    } else {
+      for (iterator = 0; iterator < list.count; iterator++) {
+        if (Graph_add_vertex(G, list.src[iterator]) == NULL ||
+            Graph_add_vertex(G, list.dst[iterator]) == NULL) {
+          goto destroy;
+        }
+      }
+    }
+
+    /* All vertices exist, so only lack of memory drops edges */
+    if (Graph_add_edges_bulk(G, list.src, list.dst, list.weight, list.count,
+                             is_directed) != list.count) {
+      goto destroy;
+    }
+
+    Graph_edge_list_free(&list);
+
+    return G;
+
+destroy:
+    LOG_ERR("Unable to load Graph from %s",path);
+    Graph_edge_list_free(&list);
+    Graph_destroy(G);
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_csr_load_edge_list
+ *
+ * In this function we create CSR snapshot from
+ * edge list file without building linked lists.
+ * Files with sparse IDs go through Graph_load_edge_list
+ * and Graph_freeze
+ *
+ * Input:
+ *      const char *         - path
+ *      Graph_file_format_t  - format
+ *      bool                 - is_directed
+ * Output:
+ *      Graph_csr_t Object or NULL
+ */
+Graph_csr_t *
+Graph_csr_load_edge_list(const char *path, Graph_file_format_t format,
+                         bool is_directed) {
+
+    Graph_edge_list_t    list;
+    Graph_csr_t         *C;
+    Graph_t             *G;
+
+    if (!Graph_read_edge_list(path, format, &list)) {
+      return NULL;
+    }
+
+    if (!Graph_edge_list_is_dense(&list)) {
+      Graph_edge_list_free(&list);
+      G = Graph_load_edge_list(path, format, is_directed);
+      C = Graph_freeze(G);
+      Graph_destroy(G);
+      return C;
+    }
+
+    C = Graph_csr_from_edges(list.count ? list.max_vertex + 1 : 0,
+                             list.src, list.dst, list.weight, list.count,
+                             is_directed);
+
+    Graph_edge_list_free(&list);
+
+    return C;
+}
+
+/*
+ * Function:
+ * Graph_write_edge_list
+ *
+ * In this function we write every edge of Graph
+ * to edge list file. Undirected edges are stored
+ * as two directed ones, so Graph should be loaded
+ * back as directed
+ *
+ * Input:
+ *      Graph_t              - Graph
+ *      const char *         - path
+ *      Graph_file_format_t  - GRAPH_FORMAT_TEXT / GRAPH_FORMAT_BINARY
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- On Failure
+ */
+bool
+Graph_write_edge_list(const Graph_t *G, const char *path,
+                      Graph_file_format_t format) {
+
+    Graph_edge_file_header_t  header;
+    Graph_vertices_t         *V;
+    Graph_edges_t            *E;
+    FILE                     *file;
+    int32_t                   record[3];
+    bool                      result = TRUE;
+
+    file = fopen(path, "wb");
+    if (file == NULL) {
+      LOG_ERR("Unable to create %s",path);
+      return FALSE;
+    }
+
+    if (format == GRAPH_FORMAT_BINARY) {
+      memset(&header, 0, sizeof(header));
+      memcpy(header.magic, GRAPH_EDGE_FILE_MAGIC, 4);
+      header.version     = GRAPH_EDGE_FILE_VERSION;
+      header.flags       = GRAPH_EDGE_FILE_WEIGHTED;
+      header.no_of_edges = 0;
+      for (V = G->vertices_list; V != NULL; V = V->next) {
+        header.no_of_edges += V->degree;
+      }
+      result = fwrite(&header, sizeof(header), 1, file) == 1;
+    }
+
+    for (V = G->vertices_list; V != NULL && result; V = V->next) {
+      for (E = V->adjacency_list; E != NULL && result; E = E->next) {
+        if (format == GRAPH_FORMAT_BINARY) {
+          record[0] = V->interface_number;
+          record[1] = E->target;
+          record[2] = E->weight;
+          result = fwrite(record, sizeof(record), 1, file) == 1;
+        } else {
+          result = fprintf(file, "%d %d %d\n", V->interface_number,
+                           E->target, E->weight) > 0;
+        }
+      }
+    }
+
+    if (fclose(file) != 0) {
+      result = FALSE;
+    }
+
+    if (!result) {
+      LOG_ERR("Unable to write %s",path);
+    }
+
+    return result;
+}
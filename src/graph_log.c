@@ -0,0 +1,215 @@
+/*
+ * In this File we define logging of the library.
+ *
+ * LOG_ERR / LOG_INFO hand messages to Graph_log, which
+ * drops them below the selected level, keeps at most
+ * GRAPH_LOG_RATE_LIMIT of them per second (so a failing
+ * lookup inside a search can not flood the output) and
+ * passes the rest to a registered handler. Default
+ * handler writes to stderr, library itself never writes
+ * to stdout except in Graph_display_graph.
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#include <stdarg.h>
+#include <time.h>
+
+#include "graph.h"
+
+static Graph_log_handler_t  Graph_log_handler_fn;    /* NULL for default */
+static void                *Graph_log_context;
+static Graph_log_level_t    Graph_log_threshold = GRAPH_LOG_INFO;
+static unsigned int         Graph_log_limit     = GRAPH_LOG_RATE_LIMIT;
+static long                 Graph_log_window    = -1; /* Second being counted */
+static unsigned int         Graph_log_count;          /* Messages in window */
+static unsigned long        Graph_log_dropped;        /* Suppressed in window */
+
+/*
+ * Function:
+ * Graph_log_default
+ *
+ * In this function we write message to stderr,
+ * handler used till one is registered
+ */
+static void
+Graph_log_default(Graph_log_level_t level, const char *file, int line,
+                  const char *message, void *context) {
+
+    (void)context;
+
+    fprintf(stderr, "%s:%d %s %s\n", file, line,
+            level == GRAPH_LOG_ERR ? "ERROR:" : "INFO: ", message);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_log_emit
+ *
+ * In this function we pass formatted message
+ * to registered handler
+ */
+static void
+Graph_log_emit(Graph_log_level_t level, const char *file, int line,
+               const char *message) {
+
+    Graph_log_handler_t  handler;
+    void                *context;
+
+    handler = __atomic_load_n(&Graph_log_handler_fn, __ATOMIC_ACQUIRE);
+    context = __atomic_load_n(&Graph_log_context, __ATOMIC_ACQUIRE);
+
+    if (handler == NULL) {
+      Graph_log_default(level, file, line, message, context);
+    } else {
+      handler(level, file, line, message, context);
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_log_admit
+ *
+ * In this function we decide whether rate limit
+ * lets one more message through. First message of a
+ * new second reports how many were dropped before it
+ */
+static bool
+Graph_log_admit(Graph_log_level_t level, const char *file, int line) {
+
+    struct timespec      now;
+    unsigned int         limit;
+    unsigned long        dropped;
+    long                 window;
+    char                 message[64];
+
+    limit = __atomic_load_n(&Graph_log_limit, __ATOMIC_RELAXED);
+    if (limit == 0) {
+      return TRUE;
+    }
+
+#ifdef CLOCK_MONOTONIC_COARSE
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+
+    window = __atomic_load_n(&Graph_log_window, __ATOMIC_RELAXED);
+    if (window != (long)now.tv_sec &&
+        __atomic_compare_exchange_n(&Graph_log_window, &window, (long)now.tv_sec,
+                                    FALSE, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+      __atomic_store_n(&Graph_log_count, 0, __ATOMIC_RELAXED);
+      dropped = __atomic_exchange_n(&Graph_log_dropped, 0, __ATOMIC_RELAXED);
+      if (dropped > 0) {
+        snprintf(message, sizeof(message), "%lu messages suppressed", dropped);
+        Graph_log_emit(level, file, line, message);
+      }
+    }
+
+    if (__atomic_fetch_add(&Graph_log_count, 1, __ATOMIC_RELAXED) >= limit) {
+      __atomic_fetch_add(&Graph_log_dropped, 1, __ATOMIC_RELAXED);
+      return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_log
+ *
+ * In this function we report message of the library
+ * (used through LOG_ERR and LOG_INFO)
+ *
+ * Input:
+ *      Graph_log_level_t  - level of message
+ *      const char *       - source file
+ *      int                - source line
+ *      const char *       - printf format, arguments follow
+ * Output:
+ *      none
+ */
+void
+Graph_log(Graph_log_level_t level, const char *file, int line,
+          const char *format, ...) {
+
+    char                 message[GRAPH_LOG_MESSAGE_MAX];
+    va_list              arguments;
+
+    if (level == GRAPH_LOG_NONE ||
+        level > __atomic_load_n(&Graph_log_threshold, __ATOMIC_RELAXED)) {
+      return;
+    }
+
+    if (!Graph_log_admit(level, file, line)) {
+      return;
+    }
+
+    va_start(arguments, format);
+    vsnprintf(message, sizeof(message), format, arguments);
+    va_end(arguments);
+
+    Graph_log_emit(level, file, line, message);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_set_log_handler
+ *
+ * In this function we register receiver of
+ * library messages. Handler may be called from any
+ * thread running library code, concurrently
+ *
+ * Input:
+ *      Graph_log_handler_t  - handler, NULL restores stderr
+ *      void *               - context passed to handler
+ * Output:
+ *      none
+ */
+void
+Graph_set_log_handler(Graph_log_handler_t handler, void *context) {
+
+    __atomic_store_n(&Graph_log_context, context, __ATOMIC_RELEASE);
+    __atomic_store_n(&Graph_log_handler_fn, handler, __ATOMIC_RELEASE);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_set_log_level
+ *
+ * In this function we select most detailed level
+ * reported, GRAPH_LOG_NONE silences the library
+ * (default GRAPH_LOG_INFO)
+ */
+void
+Graph_set_log_level(Graph_log_level_t level) {
+
+    __atomic_store_n(&Graph_log_threshold, level, __ATOMIC_RELAXED);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_set_log_rate_limit
+ *
+ * In this function we select how many messages
+ * are reported per second, 0 for no limit
+ * (default GRAPH_LOG_RATE_LIMIT)
+ */
+void
+Graph_set_log_rate_limit(unsigned int per_second) {
+
+    __atomic_store_n(&Graph_log_limit, per_second, __ATOMIC_RELAXED);
+
+    return;
+}
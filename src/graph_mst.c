@@ -0,0 +1,742 @@
+/*
+ * In this File we define minimum spanning tree
+ * (forest, if Graph is not connected) engines.
+ *
+ * Edges of the Graph are first copied into flat arrays of
+ * dense vertex indices, direction of edges is ignored. On
+ * these arrays
+ *      - Prim grows every tree from a root with an indexed
+ *        heap keyed by weight of cheapest connecting edge
+ *      - Kruskal sorts edges by weight with a parallel LSD
+ *        radix sort and joins them with union-find
+ *      - Boruvka lets every component pick its cheapest
+ *        outgoing edge in parallel and joins them, halving
+ *        no of components every round
+ * Kruskal and Boruvka break ties between equal weights by
+ * edge position, so they return the same forest. Forests of
+ * all engines have the same total weight.
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#include "graph.h"
+
+#define GRAPH_MST_RADIX_BITS      8
+#define GRAPH_MST_RADIX_SIZE      (1 << GRAPH_MST_RADIX_BITS)
+#define GRAPH_MST_PARALLEL_EDGES  (1 << 16)
+#define GRAPH_MST_CHUNK           4096
+#define GRAPH_MST_NO_EDGE         UINT64_MAX
+
+/*
+ * Edges of the Graph by dense vertex index
+ */
+typedef struct graph_mst_edges_ {
+    vertex_number_t      total_vertices;
+    edge_index_t         count;
+    vertex_number_t     *src;
+    vertex_number_t     *dst;
+    edge_weight_t       *weight;
+} Graph_mst_edges_t;
+
+/*
+ * Function:
+ * Graph_mst_collect
+ *
+ * In this function we copy edges of Graph into
+ * flat arrays. Undirected Graph keeps every edge
+ * twice in adjacency, only one copy is taken.
+ * Self loops never join a tree and are skipped
+ */
+static bool
+Graph_mst_collect(const Graph_t *G, Graph_mst_edges_t *E) {
+
+    Graph_vertices_t    *V;
+    Graph_vertices_t    *target;
+    Graph_edges_t       *edge;
+    size_t               slots = (G->total_edges > 0) ? (size_t)G->total_edges : 1;
+
+    E->total_vertices = G->total_vertices;
+    E->count          = 0;
+    E->src    = (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    E->dst    = (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    E->weight = (edge_weight_t *)malloc(slots * sizeof(edge_weight_t));
+    if (E->src == NULL || E->dst == NULL || E->weight == NULL) {
+      LOG_ERR("Unable to allocate %ld edges for spanning tree",G->total_edges);
+      return FALSE;
+    }
+
+    for (V = G->vertices_list; V != NULL; V = V->next) {
+      for (edge = V->adjacency_list; edge != NULL; edge = edge->next) {
+        target = Graph_get_vertex(G, edge->target);
+        if (target == NULL || target == V ||
+            (!G->is_directed && target->index < V->index)) {
+          continue;
+        }
+        E->src[E->count]    = V->index;
+        E->dst[E->count]    = target->index;
+        E->weight[E->count] = edge->weight;
+        E->count++;
+      }
+    }
+
+    return TRUE;
+}
+
+static void
+Graph_mst_release(Graph_mst_edges_t *E) {
+
+    free(E->src);
+    free(E->dst);
+    free(E->weight);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_mst_find / Graph_mst_union
+ *
+ * In these functions we look up root of vertex with
+ * path halving, and join two trees by size. Parent
+ * array is shared by Kruskal and Boruvka
+ */
+static vertex_number_t
+Graph_mst_find(vertex_number_t *parent, vertex_number_t vertex) {
+
+    while (parent[vertex] != vertex) {
+      parent[vertex] = parent[parent[vertex]];
+      vertex         = parent[vertex];
+    }
+
+    return vertex;
+}
+
+static bool
+Graph_mst_union(vertex_number_t *parent, vertex_number_t *size,
+                vertex_number_t A, vertex_number_t B) {
+
+    vertex_number_t      swap;
+
+    A = Graph_mst_find(parent, A);
+    B = Graph_mst_find(parent, B);
+    if (A == B) {
+      return FALSE;
+    }
+
+    if (size[A] < size[B]) {
+      swap = A;
+      A    = B;
+      B    = swap;
+    }
+    parent[B] = A;
+    size[A]  += size[B];
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_mst_add
+ *
+ * In this function we append edge (by dense
+ * indices) to result, as Vertex IDs
+ */
+static void
+Graph_mst_add(const Graph_t *G, Graph_mst_t *M, vertex_number_t A,
+              vertex_number_t B, edge_weight_t weight) {
+
+    M->source[M->no_of_edges]      = G->index_table[A]->interface_number;
+    M->destination[M->no_of_edges] = G->index_table[B]->interface_number;
+    M->weight[M->no_of_edges]      = weight;
+    M->no_of_edges++;
+    M->total_weight += weight;
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_mst_prim
+ *
+ * In this function we grow tree from every vertex
+ * not yet spanned. Heap key of vertex is weight of
+ * cheapest edge joining it to the tree
+ */
+static bool
+Graph_mst_prim(const Graph_t *G, const Graph_mst_edges_t *E, Graph_mst_t *M) {
+
+    Graph_csr_t         *C;
+    Graph_heap_t        *H;
+    vertex_number_t     *parent;
+    bool                *spanned;
+    vertex_number_t      root;
+    vertex_number_t      vertex;
+    vertex_number_t      target;
+    edge_index_t         position;
+    bool                 result = FALSE;
+
+    /* Both directions of every edge */
+    C       = Graph_csr_from_edges(E->total_vertices, E->src, E->dst, E->weight,
+                                   E->count, FALSE);
+    H       = Graph_heap_create(E->total_vertices, GRAPH_HEAP_BINARY);
+    parent  = (vertex_number_t *)malloc((E->total_vertices + 1) * sizeof(vertex_number_t));
+    spanned = (bool *)calloc(E->total_vertices + 1, sizeof(bool));
+    if (C == NULL || H == NULL || parent == NULL || spanned == NULL) {
+      LOG_ERR("Unable to allocate Prim state for %d vertices",E->total_vertices);
+      goto destroy;
+    }
+
+    /* Keys are edge weights, not monotone distances */
+    Graph_heap_set_type(H, G->heap_type, -1);
+
+    for (root = 0; root < E->total_vertices; root++) {
+      if (spanned[root]) {
+        continue;
+      }
+
+      parent[root] = -1;
+      Graph_heap_push(H, root, 0);
+
+      while (!Graph_heap_is_empty(H)) {
+        vertex = Graph_heap_pop(H);
+        spanned[vertex] = TRUE;
+        if (parent[vertex] != -1) {
+          Graph_mst_add(G, M, parent[vertex], vertex, (edge_weight_t)H->key[vertex]);
+        }
+
+        for (position = C->offsets[vertex]; position < C->offsets[vertex + 1]; position++) {
+          target = C->targets[position];
+          if (spanned[target] ||
+              (Graph_heap_contains(H, target) && H->key[target] <= C->weights[position])) {
+            continue;
+          }
+          parent[target] = vertex;
+          Graph_heap_push(H, target, C->weights[position]);
+        }
+      }
+    }
+
+    result = TRUE;
+
+destroy:
+    Graph_csr_destroy(C);
+    Graph_heap_destroy(H);
+    free(parent);
+    free(spanned);
+
+    return result;
+}
+
+/*
+ * Shared state of parallel radix sort
+ */
+typedef struct graph_mst_sort_ {
+    uint32_t            *keys;          /* Keys being sorted */
+    edge_index_t        *order;         /* Edge of every key */
+    uint32_t            *keys_out;      /* Scatter target of a pass */
+    edge_index_t        *order_out;
+    edge_index_t         count;
+    size_t              *histogram;     /* Per thread digit counts, then
+                                         * scatter offsets */
+    int                  threads;       /* Threads actually running */
+    bool                 skip;          /* All keys share digit of pass */
+    Graph_barrier_t      barrier;
+} Graph_mst_sort_t;
+
+/*
+ * Function:
+ * Graph_mst_sort_worker
+ *
+ * In this function every thread counts digits of
+ * its slice, thread 0 turns counts into offsets,
+ * then slices are scattered. Slices are scattered
+ * in thread order so every pass is stable
+ */
+static void *
+Graph_mst_sort_worker(void *arg) {
+
+    Graph_thread_t      *T = (Graph_thread_t *)arg;
+    Graph_mst_sort_t    *S = (Graph_mst_sort_t *)T->shared;
+    size_t              *histogram;
+    uint32_t            *swap_keys;
+    edge_index_t        *swap_order;
+    edge_index_t         first;
+    edge_index_t         last;
+    edge_index_t         iterator;
+    size_t               running;
+    size_t               start;
+    size_t               count;
+    int                  shift;
+    int                  digit;
+    int                  thread;
+
+    if (T->id == 0) {
+      /* Slices are cut for threads which did start */
+      S->threads = T->running;
+      Graph_barrier_resize(&S->barrier, T->running);
+    }
+    Graph_barrier_wait(&S->barrier);
+
+    first     = S->count * T->id / S->threads;
+    last      = S->count * (T->id + 1) / S->threads;
+    histogram = S->histogram + (size_t)T->id * GRAPH_MST_RADIX_SIZE;
+
+    for (shift = 0; shift < 32; shift += GRAPH_MST_RADIX_BITS) {
+      memset(histogram, 0, GRAPH_MST_RADIX_SIZE * sizeof(size_t));
+      for (iterator = first; iterator < last; iterator++) {
+        histogram[(S->keys[iterator] >> shift) & (GRAPH_MST_RADIX_SIZE - 1)]++;
+      }
+      Graph_barrier_wait(&S->barrier);
+
+      if (T->id == 0) {
+        S->skip = FALSE;
+        running = 0;
+        for (digit = 0; digit < GRAPH_MST_RADIX_SIZE; digit++) {
+          start = running;
+          for (thread = 0; thread < S->threads; thread++) {
+            count = S->histogram[(size_t)thread * GRAPH_MST_RADIX_SIZE + digit];
+            S->histogram[(size_t)thread * GRAPH_MST_RADIX_SIZE + digit] = running;
+            running += count;
+          }
+          if (running - start == (size_t)S->count) {
+            /* Every key has this digit, pass would not move them */
+            S->skip = TRUE;
+          }
+        }
+      }
+      Graph_barrier_wait(&S->barrier);
+
+      if (S->skip) {
+        continue;
+      }
+
+      for (iterator = first; iterator < last; iterator++) {
+        digit = (S->keys[iterator] >> shift) & (GRAPH_MST_RADIX_SIZE - 1);
+        S->keys_out[histogram[digit]]    = S->keys[iterator];
+        S->order_out[histogram[digit]++] = S->order[iterator];
+      }
+      Graph_barrier_wait(&S->barrier);
+
+      if (T->id == 0) {
+        swap_keys    = S->keys;
+        swap_order   = S->order;
+        S->keys      = S->keys_out;
+        S->order     = S->order_out;
+        S->keys_out  = swap_keys;
+        S->order_out = swap_order;
+      }
+      Graph_barrier_wait(&S->barrier);
+    }
+
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_mst_weight_key
+ *
+ * In this function we map signed weight to
+ * unsigned key of the same order
+ */
+static uint32_t
+Graph_mst_weight_key(edge_weight_t weight) {
+
+    return (uint32_t)weight ^ 0x80000000U;
+}
+
+/*
+ * Function:
+ * Graph_mst_sort
+ *
+ * In this function we order edges by weight
+ * (stable, so ties keep edge position)
+ *
+ * Output:
+ *      edge_index_t *  - edges in order, NULL on failure
+ */
+static edge_index_t *
+Graph_mst_sort(const Graph_mst_edges_t *E, int no_of_threads) {
+
+    Graph_mst_sort_t     S;
+    uint32_t            *keys[2];
+    edge_index_t        *order[2];
+    edge_index_t        *result = NULL;
+    edge_index_t         iterator;
+    size_t               slots = (E->count > 0) ? (size_t)E->count : 1;
+
+    if (E->count < GRAPH_MST_PARALLEL_EDGES) {
+      no_of_threads = 1;
+    }
+
+    memset(&S, 0, sizeof(S));
+    keys[0]     = (uint32_t *)malloc(slots * sizeof(uint32_t));
+    keys[1]     = (uint32_t *)malloc(slots * sizeof(uint32_t));
+    order[0]    = (edge_index_t *)malloc(slots * sizeof(edge_index_t));
+    order[1]    = (edge_index_t *)malloc(slots * sizeof(edge_index_t));
+    S.histogram = (size_t *)malloc((size_t)no_of_threads * GRAPH_MST_RADIX_SIZE *
+                                   sizeof(size_t));
+    if (keys[0] == NULL || keys[1] == NULL || order[0] == NULL ||
+        order[1] == NULL || S.histogram == NULL) {
+      LOG_ERR("Unable to allocate sort of %ld edges",E->count);
+      goto destroy;
+    }
+
+    if (!Graph_barrier_init(&S.barrier, no_of_threads)) {
+      goto destroy;
+    }
+
+    for (iterator = 0; iterator < E->count; iterator++) {
+      keys[0][iterator]  = Graph_mst_weight_key(E->weight[iterator]);
+      order[0][iterator] = iterator;
+    }
+
+    S.keys      = keys[0];
+    S.order     = order[0];
+    S.keys_out  = keys[1];
+    S.order_out = order[1];
+    S.count     = E->count;
+
+    Graph_parallel_run(no_of_threads, Graph_mst_sort_worker, &S);
+    Graph_barrier_destroy(&S.barrier);
+
+    /* Sorted order is in whichever buffer the last pass wrote */
+    result = S.order;
+    if (result == order[0]) {
+      order[0] = NULL;
+    } else {
+      order[1] = NULL;
+    }
+
+destroy:
+    free(keys[0]);
+    free(keys[1]);
+    free(order[0]);
+    free(order[1]);
+    free(S.histogram);
+
+    return result;
+}
+
+/*
+ * Function:
+ * Graph_mst_kruskal
+ *
+ * In this function we take edges in order of
+ * weight, keeping every edge which joins two trees
+ */
+static bool
+Graph_mst_kruskal(const Graph_t *G, const Graph_mst_edges_t *E, Graph_mst_t *M,
+                  int no_of_threads) {
+
+    edge_index_t        *order;
+    vertex_number_t     *parent;
+    vertex_number_t     *size;
+    edge_index_t         iterator;
+    edge_index_t         edge;
+    vertex_number_t      vertex;
+    bool                 result = FALSE;
+
+    order  = Graph_mst_sort(E, no_of_threads);
+    parent = (vertex_number_t *)malloc((E->total_vertices + 1) * sizeof(vertex_number_t));
+    size   = (vertex_number_t *)malloc((E->total_vertices + 1) * sizeof(vertex_number_t));
+    if (order == NULL || parent == NULL || size == NULL) {
+      LOG_ERR("Unable to allocate Kruskal state for %d vertices",E->total_vertices);
+      goto destroy;
+    }
+
+    for (vertex = 0; vertex < E->total_vertices; vertex++) {
+      parent[vertex] = vertex;
+      size[vertex]   = 1;
+    }
+
+    for (iterator = 0; iterator < E->count &&
+         M->no_of_edges + 1 < E->total_vertices; iterator++) {
+      edge = order[iterator];
+      if (Graph_mst_union(parent, size, E->src[edge], E->dst[edge])) {
+        Graph_mst_add(G, M, E->src[edge], E->dst[edge], E->weight[edge]);
+      }
+    }
+
+    result = TRUE;
+
+destroy:
+    free(order);
+    free(parent);
+    free(size);
+
+    return result;
+}
+
+/*
+ * Shared state of Boruvka rounds
+ */
+typedef struct graph_mst_boruvka_ {
+    const Graph_mst_edges_t *E;
+    vertex_number_t     *parent;        /* Union-find forest */
+    vertex_number_t     *component;     /* Root of every vertex this round */
+    uint64_t            *cheapest;      /* (weight key, edge) per root */
+    Graph_work_queue_t  *queues;
+    bool                 flatten;       /* Phase: find roots, else cheapest */
+} Graph_mst_boruvka_t;
+
+/*
+ * Function:
+ * Graph_mst_atomic_min
+ *
+ * In this function we lower 64 bit slot to value
+ */
+static void
+Graph_mst_atomic_min(uint64_t *slot, uint64_t value) {
+
+    uint64_t             current = __atomic_load_n(slot, __ATOMIC_RELAXED);
+
+    while (value < current &&
+           !__atomic_compare_exchange_n(slot, &current, value, TRUE,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_mst_boruvka_worker
+ *
+ * In this function threads either find root of
+ * every vertex (parent is only read, no unions run
+ * meanwhile) or offer every edge joining two
+ * components as cheapest edge of both. Weight key
+ * is in high bits, edge position breaks ties
+ */
+static void *
+Graph_mst_boruvka_worker(void *arg) {
+
+    Graph_thread_t        *T = (Graph_thread_t *)arg;
+    Graph_mst_boruvka_t   *B = (Graph_mst_boruvka_t *)T->shared;
+    const Graph_mst_edges_t *E = B->E;
+    vertex_number_t        root;
+    vertex_number_t        A;
+    vertex_number_t        D;
+    uint64_t               key;
+    long                   first;
+    long                   last;
+    long                   iterator;
+
+    while (Graph_work_queue_take(B->queues, T, GRAPH_MST_CHUNK, &first, &last)) {
+      for (iterator = first; iterator < last; iterator++) {
+        if (B->flatten) {
+          for (root = (vertex_number_t)iterator; B->parent[root] != root;
+               root = B->parent[root]);
+          B->component[iterator] = root;
+          continue;
+        }
+
+        A = B->component[E->src[iterator]];
+        D = B->component[E->dst[iterator]];
+        if (A == D) {
+          continue;
+        }
+        key = ((uint64_t)Graph_mst_weight_key(E->weight[iterator]) << 32) |
+              (uint64_t)iterator;
+        Graph_mst_atomic_min(&B->cheapest[A], key);
+        Graph_mst_atomic_min(&B->cheapest[D], key);
+      }
+    }
+
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_mst_boruvka_phase
+ *
+ * In this function we run one phase of Boruvka
+ * round over given no of items on all threads
+ */
+static void
+Graph_mst_boruvka_phase(Graph_mst_boruvka_t *B, bool flatten, long items,
+                        int no_of_threads) {
+
+    B->flatten = flatten;
+    Graph_work_queue_init(B->queues, no_of_threads, items);
+
+    /* Threads which did start steal work of the ones which did not */
+    Graph_parallel_run(no_of_threads, Graph_mst_boruvka_worker, B);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_mst_boruvka
+ *
+ * In this function every round each component picks
+ * its cheapest outgoing edge and these edges are
+ * joined, till no component has an outgoing edge
+ */
+static bool
+Graph_mst_boruvka(const Graph_t *G, const Graph_mst_edges_t *E, Graph_mst_t *M,
+                  int no_of_threads) {
+
+    Graph_mst_boruvka_t  B;
+    vertex_number_t     *size;
+    vertex_number_t      vertex;
+    edge_index_t         edge;
+    bool                 joined = TRUE;
+    bool                 result = FALSE;
+
+    if (E->count >= ((edge_index_t)1 << 32)) {
+      /* Edge position must fit low half of key */
+      return Graph_mst_kruskal(G, E, M, no_of_threads);
+    }
+
+    memset(&B, 0, sizeof(B));
+    B.E         = E;
+    B.parent    = (vertex_number_t *)malloc((E->total_vertices + 1) * sizeof(vertex_number_t));
+    B.component = (vertex_number_t *)malloc((E->total_vertices + 1) * sizeof(vertex_number_t));
+    B.cheapest  = (uint64_t *)malloc((E->total_vertices + 1) * sizeof(uint64_t));
+    B.queues    = (Graph_work_queue_t *)Graph_aligned_calloc(no_of_threads,
+                                                 sizeof(Graph_work_queue_t));
+    size        = (vertex_number_t *)malloc((E->total_vertices + 1) * sizeof(vertex_number_t));
+    if (B.parent == NULL || B.component == NULL || B.cheapest == NULL ||
+        B.queues == NULL || size == NULL) {
+      LOG_ERR("Unable to allocate Boruvka state for %d vertices",E->total_vertices);
+      goto destroy;
+    }
+
+    for (vertex = 0; vertex < E->total_vertices; vertex++) {
+      B.parent[vertex]   = vertex;
+      B.cheapest[vertex] = GRAPH_MST_NO_EDGE;
+      size[vertex]       = 1;
+    }
+
+    while (joined) {
+      joined = FALSE;
+
+      Graph_mst_boruvka_phase(&B, TRUE, E->total_vertices, no_of_threads);
+      Graph_mst_boruvka_phase(&B, FALSE, E->count, no_of_threads);
+
+      /* Join picked edges, same edge may be picked by both ends */
+      for (vertex = 0; vertex < E->total_vertices; vertex++) {
+        if (B.cheapest[vertex] == GRAPH_MST_NO_EDGE) {
+          continue;
+        }
+        edge = (edge_index_t)(B.cheapest[vertex] & 0xffffffffULL);
+        B.cheapest[vertex] = GRAPH_MST_NO_EDGE;
+        if (Graph_mst_union(B.parent, size, E->src[edge], E->dst[edge])) {
+          Graph_mst_add(G, M, E->src[edge], E->dst[edge], E->weight[edge]);
+          joined = TRUE;
+        }
+      }
+    }
+
+    result = TRUE;
+
+destroy:
+    free(B.parent);
+    free(B.component);
+    free(B.cheapest);
+    Graph_aligned_free(B.queues);
+    free(size);
+
+    return result;
+}
+
+/*
+ * Function:
+ * Graph_mst
+ *
+ * In this function we find minimum spanning forest
+ * of the Graph, direction of edges is ignored. Parallel
+ * parts (sort of Kruskal, rounds of Boruvka) use
+ * Graph threads (see Graph_set_num_threads). Nothing is
+ * printed, release result with Graph_mst_destroy
+ *
+ * Input:
+ *      Graph_t                 - Graph
+ *      Graph_mst_algorithm_t   - GRAPH_MST_PRIM / GRAPH_MST_KRUSKAL /
+ *                                GRAPH_MST_BORUVKA
+ * Output:
+ *      Graph_mst_t Object or NULL
+ */
+Graph_mst_t *
+Graph_mst(const Graph_t *G, Graph_mst_algorithm_t algorithm) {
+
+    Graph_mst_t         *M = NULL;
+    Graph_mst_edges_t    E;
+    size_t               slots;
+    int                  no_of_threads;
+    bool                 result = FALSE;
+
+    if (G == NULL) {
+      LOG_ERR("Provided Graph is NULL");
+      return NULL;
+    }
+
+    memset(&E, 0, sizeof(E));
+    if (!Graph_mst_collect(G, &E)) {
+      goto destroy;
+    }
+
+    slots = (G->total_vertices > 1) ? (size_t)G->total_vertices - 1 : 1;
+    M = (Graph_mst_t *)calloc(1, sizeof(Graph_mst_t));
+    if (M == NULL) {
+      LOG_ERR("Unable to allocate spanning tree");
+      goto destroy;
+    }
+    M->source      = (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    M->destination = (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    M->weight      = (edge_weight_t *)malloc(slots * sizeof(edge_weight_t));
+    if (M->source == NULL || M->destination == NULL || M->weight == NULL) {
+      LOG_ERR("Unable to allocate spanning tree of %d vertices",G->total_vertices);
+      goto destroy;
+    }
+
+    no_of_threads = Graph_resolve_threads(G->num_threads);
+
+    switch (algorithm) {
+      case GRAPH_MST_PRIM:
+        result = Graph_mst_prim(G, &E, M);
+        break;
+      case GRAPH_MST_KRUSKAL:
+        result = Graph_mst_kruskal(G, &E, M, no_of_threads);
+        break;
+      case GRAPH_MST_BORUVKA:
+        result = Graph_mst_boruvka(G, &E, M, no_of_threads);
+        break;
+      default:
+        LOG_ERR("Unknown spanning tree algorithm %d",algorithm);
+        break;
+    }
+
+destroy:
+    Graph_mst_release(&E);
+    if (!result) {
+      Graph_mst_destroy(M);
+      M = NULL;
+    }
+
+    return M;
+}
+
+/*
+ * Function:
+ * Graph_mst_destroy
+ *
+ * In this function we release spanning tree
+ * returned by Graph_mst
+ */
+void
+Graph_mst_destroy(Graph_mst_t *M) {
+
+    if (M == NULL) {
+      return;
+    }
+
+    free(M->source);
+    free(M->destination);
+    free(M->weight);
+    free(M);
+
+    return;
+}
@@ -0,0 +1,514 @@
+/*
+ * In this File we define thread helpers and
+ * batch API's which spread work across threads.
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#include <unistd.h>
+
+#include "graph.h"
+
+/*
+ * Function:
+ * Graph_resolve_threads
+ *
+ * In this function we turn requested thread count
+ * into the one to use, 0 (or less) means no of
+ * online processors
+ *
+ * Input:
+ *      int  - requested threads
+ * Output:
+ *      int  - threads to use (>= 1)
+ */
+int
+Graph_resolve_threads(int requested) {
+
+    long                 online;
+
+    if (requested > 0) {
+      return requested;
+    }
+
+    online = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (online > 0) ? (int)online : 1;
+}
+
+/*
+ * Function:
+ * Graph_aligned_calloc
+ *
+ * In this function we allocate zeroed array of
+ * per thread state starting on a cache line. calloc
+ * only promises 16 byte alignment, types aligned to
+ * GRAPH_CACHE_LINE (so that threads do not share lines)
+ * need more. Size is rounded up to whole lines, memory
+ * is released with Graph_aligned_free
+ *
+ * Input:
+ *      size_t  - no of elements
+ *      size_t  - size of element
+ * Output:
+ *      void * - array, or NULL on failure
+ */
+void *
+Graph_aligned_calloc(size_t count, size_t size) {
+
+    void                *block;
+    size_t               bytes;
+
+    if (count == 0) {
+      count = 1;
+    }
+    if (size != 0 && count > SIZE_MAX / size - GRAPH_CACHE_LINE) {
+      return NULL;
+    }
+
+    bytes = (count * size + GRAPH_CACHE_LINE - 1) & ~(size_t)(GRAPH_CACHE_LINE - 1);
+    if (posix_memalign(&block, GRAPH_CACHE_LINE, bytes) != 0) {
+      return NULL;
+    }
+    memset(block, 0, bytes);
+
+    return block;
+}
+
+/*
+ * Function:
+ * Graph_aligned_free
+ *
+ * In this function we release array allocated
+ * by Graph_aligned_calloc
+ *
+ * Input:
+ *      void *  - array (can be NULL)
+ * Output:
+ *      none
+ */
+void
+Graph_aligned_free(void *block) {
+
+    free(block);
+    return;
+}
+
+/*
+ * Function:
+ * Graph_parallel_run
+ *
+ * In this function we run routine on no_of_threads
+ * threads and wait for all of them. Thread 0 is the
+ * calling thread. Every routine receives its own
+ * Graph_thread_t with id and shared argument
+ *
+ * Input:
+ *      int       - no of threads
+ *      routine   - function to run
+ *      void *    - argument shared by all threads
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- If threads could not be created
+ */
+bool
+Graph_parallel_run(int no_of_threads, void *(*routine)(void *), void *shared) {
+
+    Graph_thread_t      *threads;
+    pthread_t           *handles;
+    int                  iterator;
+    int                  started;
+    bool                 result = TRUE;
+
+    if (no_of_threads < 1) {
+      no_of_threads = 1;
+    }
+
+    threads = (Graph_thread_t *)calloc(no_of_threads, sizeof(Graph_thread_t));
+    handles = (pthread_t *)calloc(no_of_threads, sizeof(pthread_t));
+    if (threads == NULL || handles == NULL) {
+      LOG_ERR("Unable to allocate %d threads",no_of_threads);
+      free(threads);
+      free(handles);
+      return FALSE;
+    }
+
+    for (iterator = 0; iterator < no_of_threads; iterator++) {
+      threads[iterator].id      = iterator;
+      threads[iterator].count   = no_of_threads;
+      threads[iterator].running = no_of_threads;
+      threads[iterator].shared  = shared;
+    }
+
+    for (started = 1; started < no_of_threads; started++) {
+      if (pthread_create(&handles[started], NULL, routine, &threads[started]) != 0) {
+        LOG_ERR("Unable to start thread %d",started);
+        result = FALSE;
+        break;
+      }
+    }
+
+    /* Thread 0 starts last, so it can tell how many are running */
+    threads[0].running = started;
+    routine(&threads[0]);
+
+    for (iterator = 1; iterator < started; iterator++) {
+      pthread_join(handles[iterator], NULL);
+    }
+
+    free(threads);
+    free(handles);
+
+    return result;
+}
+
+/*
+ * Function:
+ * Graph_work_queue_init
+ *
+ * In this function we split items 0 .. total-1 into
+ * one contiguous range per thread
+ *
+ * Input:
+ *      Graph_work_queue_t  - queues, one per thread
+ *      int                 - no of threads
+ *      long                - total items
+ * Output:
+ *      none
+ */
+void
+Graph_work_queue_init(Graph_work_queue_t *queues, int no_of_threads, long total) {
+
+    int                  iterator;
+
+    for (iterator = 0; iterator < no_of_threads; iterator++) {
+      queues[iterator].next = total * iterator / no_of_threads;
+      queues[iterator].end  = total * (iterator + 1) / no_of_threads;
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_work_queue_take
+ *
+ * In this function thread takes next chunk of
+ * items from its own range, once that is drained
+ * it steals chunks from ranges of other threads
+ *
+ * Input:
+ *      Graph_work_queue_t  - queues, one per thread
+ *      Graph_thread_t      - calling thread
+ *      long                - chunk size
+ *      long *              - first item of chunk (Output)
+ *      long *              - end of chunk (Output)
+ * Output:
+ *      bool True  <-- If chunk was taken
+ *           False <-- If no work is left
+ */
+bool
+Graph_work_queue_take(Graph_work_queue_t *queues, const Graph_thread_t *T,
+                      long chunk, long *first, long *last) {
+
+    Graph_work_queue_t  *Q;
+    long                 start;
+    int                  victim;
+
+    for (victim = 0; victim < T->count; victim++) {
+      Q = &queues[(T->id + victim) % T->count];
+
+      if (__atomic_load_n(&Q->next, __ATOMIC_RELAXED) >= Q->end) {
+        continue;
+      }
+
+      start = __atomic_fetch_add(&Q->next, chunk, __ATOMIC_RELAXED);
+      if (start < Q->end) {
+        *first = start;
+        *last  = (start + chunk < Q->end) ? start + chunk : Q->end;
+        return TRUE;
+      }
+    }
+
+    return FALSE;
+}
+
+/*
+ * Function:
+ * Graph_barrier_init
+ *
+ * In this function we prepare barrier for
+ * given no of threads
+ *
+ * Input:
+ *      Graph_barrier_t  - Barrier
+ *      int              - no of threads
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- On Failure
+ */
+bool
+Graph_barrier_init(Graph_barrier_t *B, int participants) {
+
+    if (pthread_mutex_init(&B->lock, NULL) != 0) {
+      LOG_ERR("Unable to initialize barrier lock");
+      return FALSE;
+    }
+
+    if (pthread_cond_init(&B->cond, NULL) != 0) {
+      LOG_ERR("Unable to initialize barrier condition");
+      pthread_mutex_destroy(&B->lock);
+      return FALSE;
+    }
+
+    B->participants = participants;
+    B->arrived      = 0;
+    B->generation   = 0;
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_barrier_resize
+ *
+ * In this function we change no of threads barrier
+ * waits for. Graph_parallel_run may start fewer threads
+ * than asked, thread 0 calls this with its running
+ * count before it waits, so others are not left waiting
+ * for threads which never started
+ */
+void
+Graph_barrier_resize(Graph_barrier_t *B, int participants) {
+
+    pthread_mutex_lock(&B->lock);
+
+    B->participants = participants;
+    if (B->arrived > 0 && B->arrived >= B->participants) {
+      B->arrived = 0;
+      B->generation++;
+      pthread_cond_broadcast(&B->cond);
+    }
+
+    pthread_mutex_unlock(&B->lock);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_barrier_wait
+ *
+ * In this function calling thread waits until
+ * all participants have reached barrier
+ */
+void
+Graph_barrier_wait(Graph_barrier_t *B) {
+
+    unsigned long        generation;
+
+    pthread_mutex_lock(&B->lock);
+
+    generation = B->generation;
+    if (++B->arrived >= B->participants) {
+      B->arrived = 0;
+      B->generation++;
+      pthread_cond_broadcast(&B->cond);
+    } else {
+      while (generation == B->generation) {
+        pthread_cond_wait(&B->cond, &B->lock);
+      }
+    }
+
+    pthread_mutex_unlock(&B->lock);
+
+    return;
+}
+
+void
+Graph_barrier_destroy(Graph_barrier_t *B) {
+
+    pthread_cond_destroy(&B->cond);
+    pthread_mutex_destroy(&B->lock);
+
+    return;
+}
+
+/*
+ * Shared state of multi source Dijkstra
+ */
+typedef struct graph_multi_source_ {
+    const Graph_t         *G;          /* Graph, or NULL if C is used */
+    const Graph_csr_t     *C;          /* CSR snapshot, or NULL if G is used */
+    vertex_number_t        columns;    /* Vertices in Graph */
+    const vertex_number_t *sources;    /* Source of every row */
+    long                  *out_matrix; /* Row major distances */
+    Graph_work_queue_t    *queues;     /* One per thread */
+    long                   completed;  /* Rows computed */
+} Graph_multi_source_t;
+
+/*
+ * Function:
+ * Graph_multi_source_worker
+ *
+ * In this function every thread takes sources and
+ * runs Dijkstra for them with its own workspace
+ */
+static void *
+Graph_multi_source_worker(void *arg) {
+
+    Graph_thread_t        *T = (Graph_thread_t *)arg;
+    Graph_multi_source_t  *M = (Graph_multi_source_t *)T->shared;
+    Graph_workspace_t     *W;
+    long                  *row;
+    long                   first;
+    long                   last;
+    long                   iterator;
+    vertex_number_t        column;
+    bool                   result;
+
+    W = Graph_workspace_create(M->columns);
+    if (W == NULL) {
+      LOG_ERR("Unable to create workspace for thread %d",T->id);
+      /* Rows of this thread are picked up by other threads */
+      return NULL;
+    }
+
+    while (Graph_work_queue_take(M->queues, T, 1, &first, &last)) {
+      for (iterator = first; iterator < last; iterator++) {
+        row = M->out_matrix + iterator * (long)M->columns;
+
+        if (M->G != NULL) {
+          result = Graph_dijkstra_query(M->G, W, M->sources[iterator]);
+        } else {
+          result = Graph_csr_dijkstra_query(M->C, W, M->sources[iterator]);
+        }
+
+        if (result) {
+          memcpy(row, W->min_distance, M->columns * sizeof(long));
+          __atomic_fetch_add(&M->completed, 1, __ATOMIC_RELAXED);
+        } else {
+          for (column = 0; column < M->columns; column++) {
+            row[column] = GRAPH_INFINITE_DISTANCE;
+          }
+        }
+      }
+    }
+
+    Graph_workspace_destroy(W);
+
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_multi_source_run
+ *
+ * In this function we spread sources over threads.
+ * Threads which fail to start (or to get a workspace)
+ * leave their rows to the others, so result only tells
+ * whether every row was computed
+ */
+static bool
+Graph_multi_source_run(Graph_multi_source_t *M, int no_of_sources,
+                       int no_of_threads) {
+
+    if (M->sources == NULL || M->out_matrix == NULL || no_of_sources < 0) {
+      LOG_ERR("Provided sources or distance matrix is NULL");
+      return FALSE;
+    }
+
+    if (no_of_threads > no_of_sources) {
+      no_of_threads = no_of_sources > 0 ? no_of_sources : 1;
+    }
+
+    M->queues = (Graph_work_queue_t *)Graph_aligned_calloc(no_of_threads,
+                                                 sizeof(Graph_work_queue_t));
+    if (M->queues == NULL) {
+      LOG_ERR("Unable to allocate work queues for %d threads",no_of_threads);
+      return FALSE;
+    }
+    Graph_work_queue_init(M->queues, no_of_threads, no_of_sources);
+
+    Graph_parallel_run(no_of_threads, Graph_multi_source_worker, M);
+
+    Graph_aligned_free(M->queues);
+
+    return M->completed == no_of_sources;
+}
+
+/*
+ * Function:
+ * Graph_multi_source_dijkstra
+ *
+ * In this function we find shortest distance from
+ * every source to all the vertices. Sources are spread
+ * over Graph threads (see Graph_set_num_threads) with
+ * work stealing, each thread using its own workspace.
+ *
+ * Row i of out_matrix (total_vertices entries, row major)
+ * receives distances from sources[i] indexed by dense
+ * vertex index. Rows of invalid sources are filled with
+ * GRAPH_INFINITE_DISTANCE
+ *
+ * Input:
+ *      Graph_t                 - Graph
+ *      const vertex_number_t * - sources
+ *      int                     - no of sources
+ *      long *                  - out_matrix (Output)
+ * Output:
+ *      bool True  <-- If all rows were computed
+ *           False <-- Otherwise
+ */
+bool
+Graph_multi_source_dijkstra(const Graph_t *G, const vertex_number_t *sources,
+                            int no_of_sources, long *out_matrix) {
+
+    Graph_multi_source_t    M;
+
+    if (G == NULL) {
+      LOG_ERR("Provided Graph is NULL");
+      return FALSE;
+    }
+
+    memset(&M, 0, sizeof(M));
+    M.G          = G;
+    M.columns    = G->total_vertices;
+    M.sources    = sources;
+    M.out_matrix = out_matrix;
+
+    return Graph_multi_source_run(&M, no_of_sources,
+                                  Graph_resolve_threads(G->num_threads));
+}
+
+/*
+ * Function:
+ * Graph_csr_multi_source_dijkstra
+ *
+ * In this function we find shortest distance from
+ * every source to all the vertices of CSR snapshot,
+ * same as Graph_multi_source_dijkstra. Columns are rows
+ * of the snapshot
+ */
+bool
+Graph_csr_multi_source_dijkstra(const Graph_csr_t *C,
+                                const vertex_number_t *sources,
+                                int no_of_sources, long *out_matrix) {
+
+    Graph_multi_source_t    M;
+
+    if (C == NULL) {
+      LOG_ERR("Provided CSR is NULL");
+      return FALSE;
+    }
+
+    memset(&M, 0, sizeof(M));
+    M.C          = C;
+    M.columns    = C->total_vertices;
+    M.sources    = sources;
+    M.out_matrix = out_matrix;
+
+    return Graph_multi_source_run(&M, no_of_sources,
+                                  Graph_resolve_threads(C->num_threads));
+}
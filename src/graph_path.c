@@ -0,0 +1,507 @@
+/*
+ * In this File we define point to point shortest
+ * path queries.
+ *
+ * Unlike Graph_dijkstra_query, which settles every vertex
+ * reachable from Source, these queries stop as soon as the
+ * distance to Target is known and return the path itself.
+ * With reverse adjacency (Graph_enable_reverse_adjacency)
+ * search runs from both ends at once and stops when the two
+ * frontiers can no longer improve the best meeting found,
+ * which settles far fewer vertices on large Graphs.
+ * A* orders the frontier by a caller given heuristic
+ * estimate of remaining distance to Target.
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#include "graph.h"
+
+/*
+ * Function:
+ * Graph_path_meet
+ *
+ * In this function we check whether edge just
+ * relaxed by one search reaches a vertex already
+ * reached by the other one, and keep it as meeting
+ * edge (left -> right in Graph) if it gives a
+ * shorter path
+ */
+static void
+Graph_path_meet(const Graph_workspace_t *other, vertex_number_t from,
+                vertex_number_t to, long distance, bool backward,
+                long *best, vertex_number_t *left, vertex_number_t *right) {
+
+    if (other->min_distance[to] == GRAPH_INFINITE_DISTANCE ||
+        distance + other->min_distance[to] >= *best) {
+      return;
+    }
+
+    *best  = distance + other->min_distance[to];
+    *left  = backward ? to : from;
+    *right = backward ? from : to;
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_path_expand
+ *
+ * In this function we relax all edges of a just
+ * settled vertex, outgoing ones for forward search
+ * and incoming ones for backward search. If other
+ * search is given, meetings with it are recorded
+ */
+static void
+Graph_path_expand(const Graph_t *G, Graph_workspace_t *W, vertex_number_t index,
+                  bool backward, const Graph_workspace_t *other,
+                  long *best, vertex_number_t *left, vertex_number_t *right) {
+
+    Graph_vertices_t      *target;
+    Graph_edges_t         *edge;
+    long                   distance;
+
+    edge = backward ? G->index_table[index]->reverse_list :
+                      G->index_table[index]->adjacency_list;
+
+    GRAPH_STATS_BEGIN(W);
+    for (; edge != NULL; edge = edge->next) {
+      GRAPH_STATS_TIMED(&W->stats, vertex_lookups, lookup_ticks,
+                        target = Graph_get_vertex(G, edge->target));
+      if (target == NULL) {
+        continue;
+      }
+
+      distance = W->min_distance[index] + edge->weight;
+      Graph_workspace_relax(W, target->index, index, distance);
+
+      if (other != NULL) {
+        Graph_path_meet(other, index, target->index, distance, backward,
+                        best, left, right);
+      }
+    }
+    GRAPH_STATS_END(W, relax_ticks);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_path_build
+ *
+ * In this function we write Vertex IDs of path
+ * Source .. left (forward predecessors) followed by
+ * right .. Target (backward predecessors, if any)
+ *
+ * Output:
+ *      vertex_number_t - no of vertices in path
+ */
+static vertex_number_t
+Graph_path_build(const Graph_t *G, const Graph_workspace_t *forward,
+                 const Graph_workspace_t *backward, vertex_number_t left,
+                 vertex_number_t right, vertex_number_t *path_out) {
+
+    vertex_number_t      count = 0;
+    vertex_number_t      runner;
+    vertex_number_t      first;
+    vertex_number_t      last;
+    vertex_number_t      swap;
+
+    for (runner = left; runner != -1; runner = forward->predecessor[runner]) {
+      if (path_out != NULL) {
+        path_out[count] = G->index_table[runner]->interface_number;
+      }
+      count++;
+    }
+
+    /* Forward part was collected from left back to Source */
+    if (path_out != NULL) {
+      for (first = 0, last = count - 1; first < last; first++, last--) {
+        swap            = path_out[first];
+        path_out[first] = path_out[last];
+        path_out[last]  = swap;
+      }
+    }
+
+    for (runner = right; runner != -1; runner = backward->predecessor[runner]) {
+      if (path_out != NULL) {
+        path_out[count] = G->index_table[runner]->interface_number;
+      }
+      count++;
+    }
+
+    return count;
+}
+
+/*
+ * Function:
+ * Graph_shortest_path_query
+ *
+ * In this function we find shortest path from
+ * Source to Target using caller owned workspaces.
+ * Search stops once Target is settled. If backward
+ * workspace is given and Graph has reverse adjacency
+ * search runs from both ends (bidirectional), else
+ * only forward workspace is used.
+ *
+ * path_out (if not NULL) must hold total_vertices
+ * entries and receives Vertex IDs from Source to Target
+ *
+ * Input:
+ *      Graph_t            - Graph
+ *      Graph_workspace_t  - forward workspace
+ *      Graph_workspace_t  - backward workspace (or NULL)
+ *      vertex_number_t    - Source
+ *      vertex_number_t    - Target
+ *      long *             - distance (Output, GRAPH_INFINITE_DISTANCE
+ *                           if Target is unreachable)
+ *      vertex_number_t *  - path_out (Output, can be NULL)
+ * Output:
+ *      vertex_number_t    - no of vertices in path,
+ *                           0 if Target is unreachable or on failure
+ */
+vertex_number_t
+Graph_shortest_path_query(const Graph_t *G, Graph_workspace_t *W,
+                          Graph_workspace_t *Wr, vertex_number_t S,
+                          vertex_number_t T, long *distance,
+                          vertex_number_t *path_out) {
+
+    Graph_vertices_t    *source;
+    Graph_vertices_t    *target;
+    Graph_workspace_t   *side;
+    Graph_workspace_t   *other;
+    vertex_number_t      index;
+    vertex_number_t      left  = -1;
+    vertex_number_t      right = -1;
+    long                 best  = GRAPH_INFINITE_DISTANCE;
+
+    if (distance != NULL) {
+      *distance = GRAPH_INFINITE_DISTANCE;
+    }
+
+    source = Graph_get_vertex(G, S);
+    target = Graph_get_vertex(G, T);
+    if (source == NULL || target == NULL) {
+      LOG_ERR("Unable to find vertex %d or %d",S,T);
+      return 0;
+    }
+
+    if (W == NULL || W->capacity < G->total_vertices ||
+        (Wr != NULL && Wr->capacity < G->total_vertices)) {
+      LOG_ERR("Workspace can not hold %d vertices",G->total_vertices);
+      return 0;
+    }
+
+    if (!G->reverse_adjacency) {
+      Wr = NULL;
+    }
+
+    Graph_workspace_reset(W);
+    Graph_heap_set_type(W->heap, G->heap_type, G->max_weight);
+    W->source = source->index;
+    GRAPH_STATS_ADD(&W->stats, queries, 1);
+    Graph_workspace_relax(W, source->index, -1, 0);
+
+    if (Wr == NULL) {
+      while (!Graph_heap_is_empty(W->heap)) {
+        GRAPH_STATS_TIMED(&W->stats, heap_pops, frontier_ticks,
+                          index = Graph_heap_pop(W->heap));
+        GRAPH_STATS_ADD(&W->stats, vertices_settled, 1);
+        if (index == target->index) {
+          best = W->min_distance[index];
+          left = index;
+          break;
+        }
+        Graph_path_expand(G, W, index, FALSE, NULL, NULL, NULL, NULL);
+      }
+    } else {
+      Graph_workspace_reset(Wr);
+      Graph_heap_set_type(Wr->heap, G->heap_type, G->max_weight);
+      Wr->source = target->index;
+      Graph_workspace_relax(Wr, target->index, -1, 0);
+
+      if (source == target) {
+        best = 0;
+        left = source->index;
+      }
+
+      /*
+       * Every path through unsettled vertices is at least
+       * as long as sum of the two frontier minimums
+       */
+      while (!Graph_heap_is_empty(W->heap) && !Graph_heap_is_empty(Wr->heap) &&
+             Graph_heap_top_key(W->heap) + Graph_heap_top_key(Wr->heap) < best) {
+        /* Grow the side whose frontier is closer */
+        if (Graph_heap_top_key(W->heap) <= Graph_heap_top_key(Wr->heap)) {
+          side  = W;
+          other = Wr;
+        } else {
+          side  = Wr;
+          other = W;
+        }
+
+        GRAPH_STATS_TIMED(&side->stats, heap_pops, frontier_ticks,
+                          index = Graph_heap_pop(side->heap));
+        GRAPH_STATS_ADD(&side->stats, vertices_settled, 1);
+        Graph_path_expand(G, side, index, side == Wr, other,
+                          &best, &left, &right);
+      }
+    }
+
+    GRAPH_STATS_MERGE(G, W);
+    if (Wr != NULL) {
+      GRAPH_STATS_MERGE(G, Wr);
+    }
+
+    if (left == -1) {
+      return 0;
+    }
+
+    if (distance != NULL) {
+      *distance = best;
+    }
+
+    return Graph_path_build(G, W, Wr, left, right, path_out);
+}
+
+/*
+ * Function:
+ * Graph_shortest_path
+ *
+ * In this function we find shortest path from
+ * Source to Target, see Graph_shortest_path_query.
+ * Search is bidirectional if Graph has reverse
+ * adjacency. Workspaces are created for the call,
+ * use Graph_shortest_path_query to reuse them
+ *
+ * Input:
+ *      Graph_t            - Graph
+ *      vertex_number_t    - Source
+ *      vertex_number_t    - Target
+ *      long *             - distance (Output)
+ *      vertex_number_t *  - path_out (Output, total_vertices
+ *                           entries, can be NULL)
+ * Output:
+ *      vertex_number_t    - no of vertices in path,
+ *                           0 if Target is unreachable or on failure
+ */
+vertex_number_t
+Graph_shortest_path(const Graph_t *G, vertex_number_t S, vertex_number_t T,
+                    long *distance, vertex_number_t *path_out) {
+
+    Graph_workspace_t   *W;
+    Graph_workspace_t   *Wr = NULL;
+    vertex_number_t      count = 0;
+
+    if (distance != NULL) {
+      *distance = GRAPH_INFINITE_DISTANCE;
+    }
+
+    if (G == NULL) {
+      LOG_ERR("Provided Graph is NULL");
+      return 0;
+    }
+
+    W = Graph_workspace_create(G->total_vertices);
+    if (G->reverse_adjacency) {
+      Wr = Graph_workspace_create(G->total_vertices);
+    }
+    if (W == NULL || (G->reverse_adjacency && Wr == NULL)) {
+      LOG_ERR("Unable to create workspace for %d vertices",G->total_vertices);
+      goto destroy;
+    }
+
+    count = Graph_shortest_path_query(G, W, Wr, S, T, distance, path_out);
+
+destroy:
+    Graph_workspace_destroy(W);
+    Graph_workspace_destroy(Wr);
+    return count;
+}
+
+/*
+ * Function:
+ * Graph_astar_relax
+ *
+ * In this function we offer new distance to vertex
+ * same as Graph_workspace_relax, but vertex is kept
+ * in frontier by distance plus heuristic estimate
+ */
+static void
+Graph_astar_relax(Graph_workspace_t *W, vertex_number_t vertex,
+                  vertex_number_t predecessor, long distance, long estimate) {
+
+    if (distance >= W->min_distance[vertex]) {
+      return;
+    }
+    GRAPH_STATS_ADD(&W->stats, distance_updates, 1);
+
+    if (W->min_distance[vertex] == GRAPH_INFINITE_DISTANCE) {
+      W->touched[W->touched_count++] = vertex;
+    }
+
+    W->min_distance[vertex] = distance;
+    W->predecessor[vertex]  = predecessor;
+    GRAPH_STATS_TIMED(&W->stats, heap_pushes, frontier_ticks,
+                      Graph_heap_push(W->heap, vertex, distance + estimate));
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_astar_query
+ *
+ * In this function we find shortest path from
+ * Source to Target with A*: frontier is ordered by
+ * distance from Source plus heuristic estimate of
+ * distance to Target, so vertices leading away from
+ * Target are expanded late or never.
+ *
+ * Heuristic is called as heuristic(Vertex ID, Target ID,
+ * context) and must not overestimate for the path to
+ * be shortest. Vertices are reopened if it is not
+ * consistent. Heuristic returning 0 gives Dijkstra
+ *
+ * Input:
+ *      Graph_t            - Graph
+ *      Graph_workspace_t  - workspace
+ *      vertex_number_t    - Source
+ *      vertex_number_t    - Target
+ *      Graph_heuristic_t  - heuristic
+ *      void *             - context passed to heuristic
+ *      long *             - distance (Output, GRAPH_INFINITE_DISTANCE
+ *                           if Target is unreachable)
+ *      vertex_number_t *  - path_out (Output, total_vertices
+ *                           entries, can be NULL)
+ *      long *             - expanded (Output, vertices taken off
+ *                           frontier, can be NULL)
+ * Output:
+ *      vertex_number_t    - no of vertices in path,
+ *                           0 if Target is unreachable or on failure
+ */
+vertex_number_t
+Graph_astar_query(const Graph_t *G, Graph_workspace_t *W, vertex_number_t S,
+                  vertex_number_t T, Graph_heuristic_t heuristic, void *context,
+                  long *distance, vertex_number_t *path_out, long *expanded) {
+
+    Graph_vertices_t    *source;
+    Graph_vertices_t    *target;
+    Graph_vertices_t    *neighbor;
+    Graph_edges_t       *edge;
+    vertex_number_t      index;
+    long                 popped = 0;
+
+    if (distance != NULL) {
+      *distance = GRAPH_INFINITE_DISTANCE;
+    }
+    if (expanded != NULL) {
+      *expanded = 0;
+    }
+
+    source = Graph_get_vertex(G, S);
+    target = Graph_get_vertex(G, T);
+    if (source == NULL || target == NULL || heuristic == NULL) {
+      LOG_ERR("Unable to find vertex %d or %d, or heuristic is NULL",S,T);
+      return 0;
+    }
+
+    if (W == NULL || W->capacity < G->total_vertices) {
+      LOG_ERR("Workspace can not hold %d vertices",G->total_vertices);
+      return 0;
+    }
+
+    /* Keys g + h are not monotone unless heuristic is consistent */
+    Graph_workspace_reset(W);
+    Graph_heap_set_type(W->heap, G->heap_type, -1);
+    W->source = source->index;
+    GRAPH_STATS_ADD(&W->stats, queries, 1);
+    Graph_astar_relax(W, source->index, -1, 0, heuristic(S, T, context));
+
+    while (!Graph_heap_is_empty(W->heap)) {
+      GRAPH_STATS_TIMED(&W->stats, heap_pops, frontier_ticks,
+                        index = Graph_heap_pop(W->heap));
+      GRAPH_STATS_ADD(&W->stats, vertices_settled, 1);
+      popped++;
+
+      if (index == target->index) {
+        break;
+      }
+
+      GRAPH_STATS_BEGIN(W);
+      for (edge = G->index_table[index]->adjacency_list; edge != NULL;
+           edge = edge->next) {
+        GRAPH_STATS_TIMED(&W->stats, vertex_lookups, lookup_ticks,
+                          neighbor = Graph_get_vertex(G, edge->target));
+        if (neighbor == NULL) {
+          continue;
+        }
+        GRAPH_STATS_ADD(&W->stats, edges_relaxed, 1);
+
+        /* Estimate is only needed if distance improves */
+        if (W->min_distance[index] + edge->weight <
+            W->min_distance[neighbor->index]) {
+          Graph_astar_relax(W, neighbor->index, index,
+                            W->min_distance[index] + edge->weight,
+                            heuristic(edge->target, T, context));
+        }
+      }
+      GRAPH_STATS_END(W, relax_ticks);
+    }
+
+    GRAPH_STATS_MERGE(G, W);
+    if (expanded != NULL) {
+      *expanded = popped;
+    }
+
+    if (W->min_distance[target->index] == GRAPH_INFINITE_DISTANCE) {
+      return 0;
+    }
+
+    if (distance != NULL) {
+      *distance = W->min_distance[target->index];
+    }
+
+    return Graph_path_build(G, W, NULL, target->index, -1, path_out);
+}
+
+/*
+ * Function:
+ * Graph_astar
+ *
+ * In this function we find shortest path from
+ * Source to Target with A*, see Graph_astar_query.
+ * Workspace is created for the call
+ */
+vertex_number_t
+Graph_astar(const Graph_t *G, vertex_number_t S, vertex_number_t T,
+            Graph_heuristic_t heuristic, void *context, long *distance,
+            vertex_number_t *path_out, long *expanded) {
+
+    Graph_workspace_t   *W;
+    vertex_number_t      count;
+
+    if (distance != NULL) {
+      *distance = GRAPH_INFINITE_DISTANCE;
+    }
+
+    if (G == NULL) {
+      LOG_ERR("Provided Graph is NULL");
+      return 0;
+    }
+
+    W = Graph_workspace_create(G->total_vertices);
+    if (W == NULL) {
+      LOG_ERR("Unable to create workspace for %d vertices",G->total_vertices);
+      return 0;
+    }
+
+    count = Graph_astar_query(G, W, S, T, heuristic, context, distance,
+                              path_out, expanded);
+
+    Graph_workspace_destroy(W);
+
+    return count;
+}
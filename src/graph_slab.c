@@ -0,0 +1,236 @@
+/*
+ * In this File we define slab allocator used for
+ * Graph nodes (vertices and edges).
+ *
+ * Every Graph owns one slab per node type. Nodes are
+ * carved from large blocks which grow geometrically, freed
+ * nodes are kept on a free list for reuse, and the whole
+ * slab is released in O(blocks) when Graph is destroyed.
+ * Graph_clear resets the slab keeping its blocks as
+ * spares, so a rebuild reuses the same memory.
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#include "graph.h"
+
+/*
+ * Every block starts with this header,
+ * objects follow it
+ */
+typedef struct graph_slab_block_ {
+    struct graph_slab_block_   *next;      /* Next block */
+    size_t                      objects;   /* No of objects in block */
+} __attribute__((aligned(16))) Graph_slab_block_t;
+
+/*
+ * Function:
+ * Graph_slab_init
+ *
+ * In this function we prepare empty slab for
+ * objects of object_size bytes. No memory is
+ * allocated till first object is requested
+ *
+ * Input:
+ *      Graph_slab_t  - slab
+ *      size_t        - object size
+ * Output:
+ *      none
+ */
+void
+Graph_slab_init(Graph_slab_t *S, size_t object_size) {
+
+    /* Objects must be able to hold free list link and stay aligned */
+    if (object_size < sizeof(void *)) {
+      object_size = sizeof(void *);
+    }
+    object_size = (object_size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+
+    S->object_size = object_size;
+    S->blocks      = NULL;
+    S->cursor      = NULL;
+    S->limit       = NULL;
+    S->free_list   = NULL;
+    S->spare       = NULL;
+    S->block_count = 0;
+    S->bytes       = 0;
+    S->stats       = NULL;
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_slab_grow
+ *
+ * In this function we add new block to slab,
+ * spare block if any, else new one twice as big
+ * as previous one (bounded by GRAPH_SLAB_MAX_OBJECTS)
+ */
+static bool
+Graph_slab_grow(Graph_slab_t *S) {
+
+    Graph_slab_block_t  *block;
+    size_t               objects;
+
+    if (S->spare != NULL) {
+      block          = (Graph_slab_block_t *)S->spare;
+      S->spare       = block->next;
+      block->next    = (Graph_slab_block_t *)S->blocks;
+      S->blocks      = block;
+      S->cursor      = (char *)(block + 1);
+      S->limit       = S->cursor + block->objects * S->object_size;
+      return TRUE;
+    }
+
+    objects = GRAPH_SLAB_MIN_OBJECTS;
+    if (S->blocks != NULL) {
+      objects = ((Graph_slab_block_t *)S->blocks)->objects * 2;
+      if (objects > GRAPH_SLAB_MAX_OBJECTS) {
+        objects = GRAPH_SLAB_MAX_OBJECTS;
+      }
+    }
+
+    block = (Graph_slab_block_t *)malloc(sizeof(Graph_slab_block_t) +
+                                         objects * S->object_size);
+    if (block == NULL) {
+      LOG_ERR("Unable to allocate slab block of %zu objects",objects);
+      return FALSE;
+    }
+
+    block->next    = (Graph_slab_block_t *)S->blocks;
+    block->objects = objects;
+
+    S->blocks  = block;
+    S->cursor  = (char *)(block + 1);
+    S->limit   = S->cursor + objects * S->object_size;
+    S->block_count++;
+    S->bytes  += sizeof(Graph_slab_block_t) + objects * S->object_size;
+    GRAPH_STATS_ALLOC(S->stats, sizeof(Graph_slab_block_t) + objects * S->object_size);
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_slab_alloc
+ *
+ * In this function we hand out one object,
+ * from free list if possible
+ *
+ * Input:
+ *      Graph_slab_t  - slab
+ * Output:
+ *      void * - object (uninitialized) or NULL
+ */
+void *
+Graph_slab_alloc(Graph_slab_t *S) {
+
+    void                *object;
+
+    if (S->free_list != NULL) {
+      object       = S->free_list;
+      S->free_list = *(void **)object;
+      return object;
+    }
+
+    if (S->cursor == S->limit && !Graph_slab_grow(S)) {
+      return NULL;
+    }
+
+    object     = S->cursor;
+    S->cursor += S->object_size;
+
+    return object;
+}
+
+/*
+ * Function:
+ * Graph_slab_free
+ *
+ * In this function we return object to slab
+ * for reuse, memory stays with the slab
+ *
+ * Input:
+ *      Graph_slab_t  - slab
+ *      void *        - object (can be NULL)
+ * Output:
+ *      none
+ */
+void
+Graph_slab_free(Graph_slab_t *S, void *object) {
+
+    if (object == NULL) {
+      return;
+    }
+
+    *(void **)object = S->free_list;
+    S->free_list     = object;
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_slab_reset
+ *
+ * In this function we take back every object of
+ * slab at once. Blocks are kept as spares and
+ * handed out again before any new block is allocated
+ *
+ * Input:
+ *      Graph_slab_t  - slab
+ * Output:
+ *      none
+ */
+void
+Graph_slab_reset(Graph_slab_t *S) {
+
+    Graph_slab_block_t  *block;
+    Graph_slab_block_t  *next;
+
+    /* Reverse onto spare list so blocks are reused in allocation order */
+    for (block = (Graph_slab_block_t *)S->blocks; block != NULL; block = next) {
+      next        = block->next;
+      block->next = (Graph_slab_block_t *)S->spare;
+      S->spare    = block;
+    }
+
+    S->blocks    = NULL;
+    S->cursor    = NULL;
+    S->limit     = NULL;
+    S->free_list = NULL;
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_slab_release
+ *
+ * In this function we free every block of slab,
+ * all objects handed out become invalid
+ *
+ * Input:
+ *      Graph_slab_t  - slab
+ * Output:
+ *      none
+ */
+void
+Graph_slab_release(Graph_slab_t *S) {
+
+    Graph_slab_block_t  *block;
+    Graph_slab_block_t  *next;
+
+    Graph_slab_reset(S);
+
+    for (block = (Graph_slab_block_t *)S->spare; block != NULL; block = next) {
+      next = block->next;
+      free(block);
+    }
+
+    Graph_slab_init(S, S->object_size);
+
+    return;
+}
@@ -0,0 +1,477 @@
+/*
+ * In this File we define binary snapshots of Graphs.
+ *
+ * Snapshot is the CSR layout of the Graph written as is:
+ * a Graph_snapshot_header_t followed by offsets, targets,
+ * weights, vertex_ids and (for sparse IDs) sorted_rows, every
+ * section aligned to GRAPH_SNAPSHOT_ALIGN. Graph_open_mmap maps
+ * the file read only and points a Graph_csr_t at the sections,
+ * so nothing is parsed or copied and processes mapping the same
+ * file share its pages.
+ *
+ * Header carries a checksum of itself and the byte order
+ * of the saving machine. Opening checks both and walks
+ * offsets and targets once, so a corrupt file can not make
+ * searches read outside the mapping. Payload carries a
+ * checksum which is verified on demand by Graph_csr_verify.
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "graph.h"
+
+/*
+ * Sections of snapshot in file order
+ */
+enum {
+    GRAPH_SNAPSHOT_OFFSETS = 0,
+    GRAPH_SNAPSHOT_TARGETS,
+    GRAPH_SNAPSHOT_WEIGHTS,
+    GRAPH_SNAPSHOT_VERTEX_IDS,
+    GRAPH_SNAPSHOT_SORTED_ROWS,
+    GRAPH_SNAPSHOT_SECTIONS
+};
+
+#define GRAPH_SNAPSHOT_ENDIAN     0x01020304u
+#define GRAPH_CHECKSUM_PRIME      1099511628211ULL
+
+/*
+ * Function:
+ * Graph_snapshot_align
+ *
+ * In this function we round size up to
+ * section alignment
+ */
+static uint64_t
+Graph_snapshot_align(uint64_t size) {
+
+    return (size + GRAPH_SNAPSHOT_ALIGN - 1) & ~(uint64_t)(GRAPH_SNAPSHOT_ALIGN - 1);
+}
+
+/*
+ * Function:
+ * Graph_checksum
+ *
+ * In this function we fold bytes into running
+ * checksum, 8 bytes at a time (FNV-1a over words).
+ * Trailing bytes are folded as a zero padded word
+ *
+ * Input:
+ *      uint64_t      - running checksum
+ *      const void *  - bytes
+ *      size_t        - no of bytes
+ * Output:
+ *      uint64_t      - new checksum
+ */
+uint64_t
+Graph_checksum(uint64_t checksum, const void *data, size_t size) {
+
+    const unsigned char *bytes = (const unsigned char *)data;
+    uint64_t             word;
+    size_t               iterator;
+
+    for (iterator = 0; iterator + 8 <= size; iterator += 8) {
+      memcpy(&word, bytes + iterator, 8);
+      checksum ^= word;
+      checksum *= GRAPH_CHECKSUM_PRIME;
+    }
+
+    if (iterator < size) {
+      word = 0;
+      memcpy(&word, bytes + iterator, size - iterator);
+      checksum ^= word;
+      checksum *= GRAPH_CHECKSUM_PRIME;
+    }
+
+    return checksum;
+}
+
+/*
+ * Function:
+ * Graph_header_checksum
+ *
+ * In this function we compute checksum of header
+ * with its own checksum field taken as zero
+ */
+static uint64_t
+Graph_header_checksum(const Graph_snapshot_header_t *header) {
+
+    Graph_snapshot_header_t  copy = *header;
+
+    copy.header_checksum = 0;
+
+    return Graph_checksum(GRAPH_CHECKSUM_SEED, &copy, sizeof(copy));
+}
+
+/*
+ * Function:
+ * Graph_snapshot_write_section
+ *
+ * In this function we write section followed by
+ * zero padding up to alignment, folding both into
+ * payload checksum
+ */
+static bool
+Graph_snapshot_write_section(FILE *file, const void *data, uint64_t size,
+                             uint64_t *checksum) {
+
+    static const char    padding[GRAPH_SNAPSHOT_ALIGN];
+    uint64_t             aligned = Graph_snapshot_align(size);
+    uint64_t             words   = (size + 7) & ~(uint64_t)7;
+
+    if (size > 0 && fwrite(data, 1, size, file) != size) {
+      return FALSE;
+    }
+    if (aligned > size && fwrite(padding, 1, aligned - size, file) != aligned - size) {
+      return FALSE;
+    }
+
+    /* Checksum sees section exactly as it is laid out in file */
+    *checksum = Graph_checksum(*checksum, data, size);
+    *checksum = Graph_checksum(*checksum, padding, aligned - words);
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_csr_save
+ *
+ * In this function we write CSR snapshot to file
+ *
+ * Input:
+ *      Graph_csr_t   - CSR snapshot
+ *      const char *  - path
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- On Failure
+ */
+bool
+Graph_csr_save(const Graph_csr_t *C, const char *path) {
+
+    Graph_snapshot_header_t  header;
+    const void              *data[GRAPH_SNAPSHOT_SECTIONS];
+    uint64_t                 size[GRAPH_SNAPSHOT_SECTIONS];
+    uint64_t                 offset;
+    uint64_t                 unused = 0;
+    FILE                    *file;
+    int                      section;
+    bool                     result = TRUE;
+
+    if (C == NULL) {
+      LOG_ERR("Provided CSR to save is NULL");
+      return FALSE;
+    }
+
+    data[GRAPH_SNAPSHOT_OFFSETS]     = C->offsets;
+    size[GRAPH_SNAPSHOT_OFFSETS]     = (C->total_vertices + 1) * sizeof(edge_index_t);
+    data[GRAPH_SNAPSHOT_TARGETS]     = C->targets;
+    size[GRAPH_SNAPSHOT_TARGETS]     = C->total_edges * sizeof(vertex_number_t);
+    data[GRAPH_SNAPSHOT_WEIGHTS]     = C->weights;
+    size[GRAPH_SNAPSHOT_WEIGHTS]     = C->total_edges * sizeof(edge_weight_t);
+    data[GRAPH_SNAPSHOT_VERTEX_IDS]  = C->vertex_ids;
+    size[GRAPH_SNAPSHOT_VERTEX_IDS]  = C->total_vertices * sizeof(vertex_number_t);
+    data[GRAPH_SNAPSHOT_SORTED_ROWS] = C->sorted_rows;
+    size[GRAPH_SNAPSHOT_SORTED_ROWS] = C->is_identity ? 0 :
+                                       C->total_vertices * sizeof(vertex_number_t);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GRAPH_SNAPSHOT_MAGIC, 4);
+    header.version          = GRAPH_SNAPSHOT_VERSION;
+    header.flags            = (C->is_directed ? GRAPH_SNAPSHOT_DIRECTED : 0) |
+                              (C->is_identity ? GRAPH_SNAPSHOT_IDENTITY : 0) |
+                              (C->is_sorted ? GRAPH_SNAPSHOT_SORTED : 0);
+    header.endian           = GRAPH_SNAPSHOT_ENDIAN;
+    header.vertex_size      = sizeof(vertex_number_t);
+    header.weight_size      = sizeof(edge_weight_t);
+    header.index_size       = sizeof(edge_index_t);
+    header.total_vertices   = C->total_vertices;
+    header.total_edges      = C->total_edges;
+    header.payload_checksum = GRAPH_CHECKSUM_SEED;
+
+    offset = Graph_snapshot_align(sizeof(header));
+    for (section = 0; section < GRAPH_SNAPSHOT_SECTIONS; section++) {
+      header.section[section] = offset;
+      offset += Graph_snapshot_align(size[section]);
+    }
+    header.file_size = offset;
+
+    file = fopen(path, "wb");
+    if (file == NULL) {
+      LOG_ERR("Unable to create %s",path);
+      return FALSE;
+    }
+
+    /* Header is rewritten once payload checksum is known */
+    result = Graph_snapshot_write_section(file, &header, sizeof(header),
+                                          &unused);
+    for (section = 0; section < GRAPH_SNAPSHOT_SECTIONS && result; section++) {
+      result = Graph_snapshot_write_section(file, data[section], size[section],
+                                            &header.payload_checksum);
+    }
+
+    header.header_checksum = Graph_header_checksum(&header);
+    if (result) {
+      result = fseek(file, 0, SEEK_SET) == 0 &&
+               fwrite(&header, sizeof(header), 1, file) == 1;
+    }
+
+    if (fclose(file) != 0) {
+      result = FALSE;
+    }
+
+    if (!result) {
+      LOG_ERR("Unable to write snapshot %s",path);
+    }
+
+    return result;
+}
+
+/*
+ * Function:
+ * Graph_save
+ *
+ * In this function we write snapshot of Graph
+ * (its CSR layout) to file
+ *
+ * Input:
+ *      Graph_t       - Graph
+ *      const char *  - path
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- On Failure
+ */
+bool
+Graph_save(const Graph_t *G, const char *path) {
+
+    Graph_csr_t         *C;
+    bool                 result;
+
+    C = Graph_freeze(G);
+    if (C == NULL) {
+      LOG_ERR("Unable to freeze Graph for snapshot %s",path);
+      return FALSE;
+    }
+
+    result = Graph_csr_save(C, path);
+
+    Graph_csr_destroy(C);
+
+    return result;
+}
+
+/*
+ * Function:
+ * Graph_snapshot_validate
+ *
+ * In this function we check that arrays of mapped
+ * snapshot can be walked safely: offsets start at 0,
+ * never decrease and end at total_edges, every target
+ * and sorted row is a row. Corrupt values inside these
+ * bounds only give wrong answers, Graph_csr_verify
+ * catches them
+ *
+ * Input:
+ *      Graph_csr_t  - CSR pointing into the mapping
+ * Output:
+ *      bool True  <-- If arrays are consistent
+ *           False <-- Otherwise
+ */
+static bool
+Graph_snapshot_validate(const Graph_csr_t *C) {
+
+    edge_index_t         position;
+    vertex_number_t      row;
+
+    if (C->offsets[0] != 0 || C->offsets[C->total_vertices] != C->total_edges) {
+      return FALSE;
+    }
+
+    for (row = 0; row < C->total_vertices; row++) {
+      if (C->offsets[row + 1] < C->offsets[row]) {
+        return FALSE;
+      }
+      if (C->sorted_rows != NULL &&
+          (C->sorted_rows[row] < 0 || C->sorted_rows[row] >= C->total_vertices)) {
+        return FALSE;
+      }
+    }
+
+    for (position = 0; position < C->total_edges; position++) {
+      if (C->targets[position] < 0 || C->targets[position] >= C->total_vertices) {
+        return FALSE;
+      }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_open_mmap
+ *
+ * In this function we map snapshot read only and
+ * return CSR whose arrays point into the mapping.
+ * Header and structure of the arrays are validated
+ * (see Graph_snapshot_validate), which reads offsets,
+ * targets and sorted rows once. Payload checksum is
+ * checked by Graph_csr_verify. Graph_csr_destroy
+ * unmaps the file
+ *
+ * Input:
+ *      const char *  - path
+ * Output:
+ *      Graph_csr_t Object or NULL
+ */
+Graph_csr_t *
+Graph_open_mmap(const char *path) {
+
+    Graph_snapshot_header_t  header;
+    Graph_csr_t             *C;
+    struct stat              info;
+    char                    *data;
+    uint64_t                 needed[GRAPH_SNAPSHOT_SECTIONS];
+    int                      section;
+    int                      fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+      LOG_ERR("Unable to open %s",path);
+      return NULL;
+    }
+
+    if (fstat(fd, &info) != 0 || (uint64_t)info.st_size < sizeof(header)) {
+      LOG_ERR("Snapshot %s is truncated",path);
+      close(fd);
+      return NULL;
+    }
+
+    data = (char *)mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+      LOG_ERR("Unable to map %s",path);
+      return NULL;
+    }
+
+    /* Byte order comes first, header checksum is not portable across it */
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, GRAPH_SNAPSHOT_MAGIC, 4) == 0 &&
+        header.endian != GRAPH_SNAPSHOT_ENDIAN) {
+      LOG_ERR("Snapshot %s was written with another byte order",path);
+      goto destroy;
+    }
+
+    if (memcmp(header.magic, GRAPH_SNAPSHOT_MAGIC, 4) != 0 ||
+        header.version != GRAPH_SNAPSHOT_VERSION ||
+        header.header_checksum != Graph_header_checksum(&header)) {
+      LOG_ERR("Snapshot %s is corrupt or of unsupported version",path);
+      goto destroy;
+    }
+
+    if (header.vertex_size != sizeof(vertex_number_t) ||
+        header.weight_size != sizeof(edge_weight_t) ||
+        header.index_size != sizeof(edge_index_t)) {
+      LOG_ERR("Snapshot %s was written on an incompatible machine",path);
+      goto destroy;
+    }
+
+    needed[GRAPH_SNAPSHOT_OFFSETS]     = (header.total_vertices + 1) * sizeof(edge_index_t);
+    needed[GRAPH_SNAPSHOT_TARGETS]     = header.total_edges * sizeof(vertex_number_t);
+    needed[GRAPH_SNAPSHOT_WEIGHTS]     = header.total_edges * sizeof(edge_weight_t);
+    needed[GRAPH_SNAPSHOT_VERTEX_IDS]  = header.total_vertices * sizeof(vertex_number_t);
+    needed[GRAPH_SNAPSHOT_SORTED_ROWS] = (header.flags & GRAPH_SNAPSHOT_IDENTITY) ? 0 :
+                                         header.total_vertices * sizeof(vertex_number_t);
+
+    if (header.file_size != (uint64_t)info.st_size ||
+        header.total_vertices > INT_MAX || header.total_edges > header.file_size) {
+      LOG_ERR("Snapshot %s is truncated",path);
+      goto destroy;
+    }
+    for (section = 0; section < GRAPH_SNAPSHOT_SECTIONS; section++) {
+      if (header.section[section] % GRAPH_SNAPSHOT_ALIGN != 0 ||
+          header.section[section] + needed[section] > header.file_size) {
+        LOG_ERR("Snapshot %s is truncated",path);
+        goto destroy;
+      }
+    }
+
+    C = (Graph_csr_t *)calloc(1, sizeof(Graph_csr_t));
+    if (C == NULL) {
+      LOG_ERR("Unable to allocate memory for CSR");
+      goto destroy;
+    }
+
+    C->total_vertices = (vertex_number_t)header.total_vertices;
+    C->total_edges    = (edge_index_t)header.total_edges;
+    C->is_directed    = (header.flags & GRAPH_SNAPSHOT_DIRECTED) ? TRUE : FALSE;
+    C->is_identity    = (header.flags & GRAPH_SNAPSHOT_IDENTITY) ? TRUE : FALSE;
+    C->is_sorted      = (header.flags & GRAPH_SNAPSHOT_SORTED) ? TRUE : FALSE;
+    C->heap_type      = GRAPH_HEAP_AUTO;
+    C->max_weight     = -1;        /* Weights are not scanned */
+    C->num_threads    = 0;
+    C->offsets        = (edge_index_t *)(data + header.section[GRAPH_SNAPSHOT_OFFSETS]);
+    C->targets        = (vertex_number_t *)(data + header.section[GRAPH_SNAPSHOT_TARGETS]);
+    C->weights        = (edge_weight_t *)(data + header.section[GRAPH_SNAPSHOT_WEIGHTS]);
+    C->vertex_ids     = (vertex_number_t *)(data + header.section[GRAPH_SNAPSHOT_VERTEX_IDS]);
+    C->sorted_rows    = C->is_identity ? NULL :
+                        (vertex_number_t *)(data + header.section[GRAPH_SNAPSHOT_SORTED_ROWS]);
+    C->mapping        = data;
+    C->mapping_size   = info.st_size;
+
+    if (!Graph_snapshot_validate(C)) {
+      LOG_ERR("Snapshot %s is corrupt",path);
+      free(C);
+      goto destroy;
+    }
+
+    return C;
+
+destroy:
+    munmap(data, info.st_size);
+    return NULL;
+}
+
+/*
+ * Function:
+ * Graph_csr_verify
+ *
+ * In this function we verify payload checksum of
+ * CSR opened by Graph_open_mmap. Whole file is read,
+ * so it is meant for start up checks, not query path
+ *
+ * Input:
+ *      Graph_csr_t  - CSR snapshot
+ * Output:
+ *      bool True  <-- If checksum matches (or CSR is not mapped)
+ *           False <-- Otherwise
+ */
+bool
+Graph_csr_verify(const Graph_csr_t *C) {
+
+    Graph_snapshot_header_t  header;
+    uint64_t                 start;
+    uint64_t                 checksum;
+
+    if (C == NULL || C->mapping == NULL) {
+      return C != NULL;
+    }
+
+    memcpy(&header, C->mapping, sizeof(header));
+    start    = Graph_snapshot_align(sizeof(header));
+    checksum = Graph_checksum(GRAPH_CHECKSUM_SEED,
+                              (const char *)C->mapping + start,
+                              header.file_size - start);
+
+    if (checksum != header.payload_checksum) {
+      LOG_ERR("Snapshot payload checksum mismatch");
+      return FALSE;
+    }
+
+    return TRUE;
+}
@@ -0,0 +1,236 @@
+/*
+ * In this File we define statistics counters of
+ * Graph and its queries.
+ *
+ * Counters are only kept when library is built with
+ * GRAPH_STATS (gcc -DGRAPH_STATS ...), otherwise hot path
+ * macros of graph.h compile to nothing and Graph_get_stats
+ * reports FALSE. Queries count into their own workspace
+ * without atomics and add it to counters of the Graph once
+ * they are done.
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#include <time.h>
+
+#include "graph.h"
+
+/*
+ * Function:
+ * Graph_stats_clock
+ *
+ * In this function we read monotonic clock in
+ * nanoseconds, ticks of platforms without TSC
+ */
+uint64_t
+Graph_stats_clock(void) {
+
+    struct timespec      now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/*
+ * Function:
+ * Graph_stats_ticks_per_second
+ *
+ * In this function we find rate of GRAPH_STATS_CLOCK,
+ * TSC is measured against monotonic clock once
+ */
+static uint64_t
+Graph_stats_ticks_per_second(void) {
+
+#if defined(GRAPH_STATS) && (defined(__x86_64__) || defined(__i386__))
+    static uint64_t      rate;
+    uint64_t             ticks;
+    uint64_t             start;
+    uint64_t             now;
+
+    if (__atomic_load_n(&rate, __ATOMIC_RELAXED) == 0) {
+      start = Graph_stats_clock();
+      ticks = GRAPH_STATS_CLOCK();
+      do {
+        now = Graph_stats_clock();
+      } while (now - start < 10000000ULL);
+      ticks = GRAPH_STATS_CLOCK() - ticks;
+      __atomic_store_n(&rate, ticks * 1000000000ULL / (now - start), __ATOMIC_RELAXED);
+    }
+
+    return __atomic_load_n(&rate, __ATOMIC_RELAXED);
+#else
+    return 1000000000ULL;
+#endif
+}
+
+/*
+ * Function:
+ * Graph_stats_create
+ *
+ * In this function we allocate counters of a new
+ * Graph, NULL if library is built without GRAPH_STATS
+ *
+ * Input:
+ *      none
+ * Output:
+ *      Graph_stats_t Object or NULL
+ */
+Graph_stats_t *
+Graph_stats_create(void) {
+
+#ifdef GRAPH_STATS
+    Graph_stats_t       *S;
+
+    S = (Graph_stats_t *)calloc(1, sizeof(Graph_stats_t));
+    if (S == NULL) {
+      LOG_ERR("Unable to allocate Graph statistics");
+    }
+
+    return S;
+#else
+    return NULL;
+#endif
+}
+
+/*
+ * Function:
+ * Graph_stats_merge
+ *
+ * In this function we add counters of a query to
+ * counters of the Graph. Queries on one Graph may run
+ * on many threads, so additions are atomic
+ *
+ * Input:
+ *      Graph_stats_t  - counters of the Graph
+ *      Graph_stats_t  - counters of the query
+ * Output:
+ *      none
+ */
+void
+Graph_stats_merge(Graph_stats_t *into, const Graph_stats_t *from) {
+
+    __atomic_fetch_add(&into->queries, from->queries, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&into->vertices_settled, from->vertices_settled, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&into->edges_relaxed, from->edges_relaxed, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&into->distance_updates, from->distance_updates, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&into->heap_pushes, from->heap_pushes, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&into->heap_pops, from->heap_pops, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&into->vertex_lookups, from->vertex_lookups, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&into->frontier_ticks, from->frontier_ticks, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&into->lookup_ticks, from->lookup_ticks, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&into->relax_ticks, from->relax_ticks, __ATOMIC_RELAXED);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_get_stats
+ *
+ * In this function we copy counters of the Graph:
+ * allocations made for it and work of all queries run
+ * on it (Graph_dijkstra_query, Graph_shortest_path_query,
+ * Graph_astar_query and API's built on them) since it was
+ * created or Graph_reset_stats
+ *
+ * Input:
+ *      Graph_t        - Graph
+ *      Graph_stats_t  - counters (Output)
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- If library is built without GRAPH_STATS
+ *                     (counters are zeroed)
+ */
+bool
+Graph_get_stats(const Graph_t *G, Graph_stats_t *stats) {
+
+    if (stats == NULL) {
+      LOG_ERR("Provided stats is NULL");
+      return FALSE;
+    }
+
+    memset(stats, 0, sizeof(Graph_stats_t));
+    if (G == NULL || G->stats == NULL) {
+      return FALSE;
+    }
+
+    __atomic_load(&G->stats->queries, &stats->queries, __ATOMIC_RELAXED);
+    __atomic_load(&G->stats->vertices_settled, &stats->vertices_settled, __ATOMIC_RELAXED);
+    __atomic_load(&G->stats->edges_relaxed, &stats->edges_relaxed, __ATOMIC_RELAXED);
+    __atomic_load(&G->stats->distance_updates, &stats->distance_updates, __ATOMIC_RELAXED);
+    __atomic_load(&G->stats->heap_pushes, &stats->heap_pushes, __ATOMIC_RELAXED);
+    __atomic_load(&G->stats->heap_pops, &stats->heap_pops, __ATOMIC_RELAXED);
+    __atomic_load(&G->stats->vertex_lookups, &stats->vertex_lookups, __ATOMIC_RELAXED);
+    __atomic_load(&G->stats->allocations, &stats->allocations, __ATOMIC_RELAXED);
+    __atomic_load(&G->stats->allocated_bytes, &stats->allocated_bytes, __ATOMIC_RELAXED);
+    __atomic_load(&G->stats->frontier_ticks, &stats->frontier_ticks, __ATOMIC_RELAXED);
+    __atomic_load(&G->stats->lookup_ticks, &stats->lookup_ticks, __ATOMIC_RELAXED);
+    __atomic_load(&G->stats->relax_ticks, &stats->relax_ticks, __ATOMIC_RELAXED);
+    stats->ticks_per_second = Graph_stats_ticks_per_second();
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_reset_stats
+ *
+ * In this function we zero counters of the Graph,
+ * no query should be running on it
+ *
+ * Input:
+ *      Graph_t  - Graph
+ * Output:
+ *      none
+ */
+void
+Graph_reset_stats(Graph_t *G) {
+
+    if (G != NULL && G->stats != NULL) {
+      memset(G->stats, 0, sizeof(Graph_stats_t));
+    }
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_workspace_get_stats
+ *
+ * In this function we copy counters of last query
+ * run with the workspace (both workspaces of a
+ * bidirectional search count their own side)
+ *
+ * Input:
+ *      Graph_workspace_t  - Workspace
+ *      Graph_stats_t      - counters (Output)
+ * Output:
+ *      bool True  <-- On Success
+ *           False <-- If library is built without GRAPH_STATS
+ *                     (counters are zeroed)
+ */
+bool
+Graph_workspace_get_stats(const Graph_workspace_t *W, Graph_stats_t *stats) {
+
+    if (stats == NULL) {
+      LOG_ERR("Provided stats is NULL");
+      return FALSE;
+    }
+
+#ifdef GRAPH_STATS
+    if (W != NULL) {
+      memcpy(stats, &W->stats, sizeof(Graph_stats_t));
+      stats->ticks_per_second = Graph_stats_ticks_per_second();
+      return TRUE;
+    }
+#else
+    (void)W;
+#endif
+
+    memset(stats, 0, sizeof(Graph_stats_t));
+
+    return FALSE;
+}
@@ -0,0 +1,338 @@
+/*
+ * In this File we define per query workspace for
+ * shortest path queries.
+ *
+ * Queries keep distances, predecessors and the frontier
+ * in a Graph_workspace_t owned by the caller instead of
+ * writing into Graph_vertices_t, so the Graph stays read
+ * only and any number of threads can query it at once,
+ * each with its own workspace. Graph_workspace_pool_t
+ * hands out reusable workspaces to worker threads.
+ *
+ * Author: Kaushik, Koneru
+ * Email: konerukaushik@gmail.com
+ */
+
+#include "graph.h"
+
+/*
+ * Function:
+ * Graph_workspace_create
+ *
+ * In this function we create workspace which
+ * can serve queries on Graphs (or CSR snapshots)
+ * with up to capacity vertices
+ *
+ * Input:
+ *      vertex_number_t  - capacity
+ * Output:
+ *      Graph_workspace_t Object or NULL
+ */
+Graph_workspace_t *
+Graph_workspace_create(vertex_number_t capacity) {
+
+    Graph_workspace_t   *W;
+    size_t               slots;
+    vertex_number_t      iterator;
+
+    W = (Graph_workspace_t *)calloc(1, sizeof(Graph_workspace_t));
+    if (W == NULL) {
+      LOG_ERR("Unable to allocate workspace");
+      return NULL;
+    }
+
+    slots = (capacity > 0) ? (size_t)capacity : 1;
+
+    W->capacity     = capacity;
+    W->source       = -1;
+    W->min_distance = (long *)malloc(slots * sizeof(long));
+    W->predecessor  = (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    W->touched      = (vertex_number_t *)malloc(slots * sizeof(vertex_number_t));
+    W->heap         = Graph_heap_create(capacity, GRAPH_HEAP_BINARY);
+    if (W->min_distance == NULL || W->predecessor == NULL ||
+        W->touched == NULL || W->heap == NULL) {
+      LOG_ERR("Unable to allocate workspace for %d vertices",capacity);
+      Graph_workspace_destroy(W);
+      return NULL;
+    }
+
+    for (iterator = 0; iterator < capacity; iterator++) {
+      W->min_distance[iterator] = GRAPH_INFINITE_DISTANCE;
+      W->predecessor[iterator]  = -1;
+    }
+
+    return W;
+}
+
+/*
+ * Function:
+ * Graph_workspace_destroy
+ *
+ * In this function we release workspace
+ */
+void
+Graph_workspace_destroy(Graph_workspace_t *W) {
+
+    if (W == NULL) {
+      return;
+    }
+
+    free(W->min_distance);
+    free(W->predecessor);
+    free(W->touched);
+    Graph_heap_destroy(W->heap);
+    free(W);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_workspace_reset
+ *
+ * In this function we forget result of previous
+ * query. Only vertices reached by that query are
+ * reset, so cost is proportional to its work
+ * and not to size of the Graph
+ *
+ * Input:
+ *      Graph_workspace_t
+ * Output:
+ *      none
+ */
+void
+Graph_workspace_reset(Graph_workspace_t *W) {
+
+    vertex_number_t      iterator;
+    vertex_number_t      vertex;
+
+    for (iterator = 0; iterator < W->touched_count; iterator++) {
+      vertex = W->touched[iterator];
+      W->min_distance[vertex] = GRAPH_INFINITE_DISTANCE;
+      W->predecessor[vertex]  = -1;
+    }
+
+    W->touched_count = 0;
+    W->source        = -1;
+    Graph_heap_clear(W->heap);
+#ifdef GRAPH_STATS
+    memset(&W->stats, 0, sizeof(Graph_stats_t));
+#endif
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_workspace_relax
+ *
+ * In this function we offer new distance to
+ * vertex (dense index) through predecessor,
+ * pushing it to the frontier if it is shorter
+ *
+ * Input:
+ *      Graph_workspace_t
+ *      vertex_number_t  - vertex (dense index)
+ *      vertex_number_t  - predecessor (dense index, -1 for source)
+ *      long             - distance
+ * Output:
+ *      bool True  <-- If distance was improved
+ *           False <-- Otherwise
+ */
+bool
+Graph_workspace_relax(Graph_workspace_t *W, vertex_number_t vertex,
+                      vertex_number_t predecessor, long distance) {
+
+    GRAPH_STATS_ADD(&W->stats, edges_relaxed, 1);
+    if (distance >= W->min_distance[vertex]) {
+      return FALSE;
+    }
+    GRAPH_STATS_ADD(&W->stats, distance_updates, 1);
+
+    if (W->min_distance[vertex] == GRAPH_INFINITE_DISTANCE) {
+      W->touched[W->touched_count++] = vertex;
+    }
+
+    W->min_distance[vertex] = distance;
+    W->predecessor[vertex]  = predecessor;
+    GRAPH_STATS_TIMED(&W->stats, heap_pushes, frontier_ticks,
+                      Graph_heap_push(W->heap, vertex, distance));
+
+    return TRUE;
+}
+
+/*
+ * Function:
+ * Graph_workspace_get_distance
+ *
+ * In this function we return distance of vertex
+ * computed by last query on the Graph
+ *
+ * Input:
+ *      Graph_t
+ *      Graph_workspace_t
+ *      vertex_number_t  - Vertex ID
+ * Output:
+ *      long - distance, GRAPH_INFINITE_DISTANCE if unreachable
+ */
+long
+Graph_workspace_get_distance(const Graph_t *G, const Graph_workspace_t *W,
+                             vertex_number_t node) {
+
+    Graph_vertices_t    *vertex;
+
+    vertex = Graph_get_vertex(G, node);
+    if (vertex == NULL || vertex->index >= W->capacity) {
+      return GRAPH_INFINITE_DISTANCE;
+    }
+
+    return W->min_distance[vertex->index];
+}
+
+/*
+ * Function:
+ * Graph_workspace_get_predecessor
+ *
+ * In this function we return previous vertex on
+ * shortest path to vertex computed by last query
+ *
+ * Input:
+ *      Graph_t
+ *      Graph_workspace_t
+ *      vertex_number_t  - Vertex ID
+ * Output:
+ *      vertex_number_t  - Vertex ID of predecessor,
+ *                         -1 for source or unreachable vertex
+ *                         (NaN is a valid Vertex ID)
+ */
+vertex_number_t
+Graph_workspace_get_predecessor(const Graph_t *G, const Graph_workspace_t *W,
+                                vertex_number_t node) {
+
+    Graph_vertices_t    *vertex;
+
+    vertex = Graph_get_vertex(G, node);
+    if (vertex == NULL || vertex->index >= W->capacity ||
+        W->predecessor[vertex->index] == -1) {
+      return -1;
+    }
+
+    return G->index_table[W->predecessor[vertex->index]]->interface_number;
+}
+
+/*
+ * Function:
+ * Graph_workspace_pool_create
+ *
+ * In this function we create pool of workspaces
+ * for Graphs with up to capacity vertices.
+ * Workspaces are created on demand and reused
+ *
+ * Input:
+ *      vertex_number_t  - capacity of every workspace
+ *      int              - max idle workspaces kept by pool
+ * Output:
+ *      Graph_workspace_pool_t Object or NULL
+ */
+Graph_workspace_pool_t *
+Graph_workspace_pool_create(vertex_number_t capacity, int max_idle) {
+
+    Graph_workspace_pool_t  *P;
+
+    P = (Graph_workspace_pool_t *)calloc(1, sizeof(Graph_workspace_pool_t));
+    if (P == NULL) {
+      LOG_ERR("Unable to allocate workspace pool");
+      return NULL;
+    }
+
+    P->capacity = capacity;
+    P->max_idle = (max_idle > 0) ? max_idle : 1;
+    P->idle     = (Graph_workspace_t **)calloc(P->max_idle,
+                                               sizeof(Graph_workspace_t *));
+    if (P->idle == NULL) {
+      LOG_ERR("Unable to allocate workspace pool of %d",P->max_idle);
+      free(P);
+      return NULL;
+    }
+
+    pthread_mutex_init(&P->lock, NULL);
+
+    return P;
+}
+
+/*
+ * Function:
+ * Graph_workspace_pool_acquire
+ *
+ * In this function we hand out an idle workspace
+ * (or create new one). Safe to call from any thread
+ */
+Graph_workspace_t *
+Graph_workspace_pool_acquire(Graph_workspace_pool_t *P) {
+
+    Graph_workspace_t   *W = NULL;
+
+    pthread_mutex_lock(&P->lock);
+    if (P->idle_count > 0) {
+      W = P->idle[--P->idle_count];
+    }
+    pthread_mutex_unlock(&P->lock);
+
+    if (W == NULL) {
+      W = Graph_workspace_create(P->capacity);
+    }
+
+    return W;
+}
+
+/*
+ * Function:
+ * Graph_workspace_pool_release
+ *
+ * In this function we return workspace to pool,
+ * it is destroyed if pool already has max_idle
+ */
+void
+Graph_workspace_pool_release(Graph_workspace_pool_t *P, Graph_workspace_t *W) {
+
+    if (W == NULL) {
+      return;
+    }
+
+    pthread_mutex_lock(&P->lock);
+    if (P->idle_count < P->max_idle) {
+      P->idle[P->idle_count++] = W;
+      W = NULL;
+    }
+    pthread_mutex_unlock(&P->lock);
+
+    Graph_workspace_destroy(W);
+
+    return;
+}
+
+/*
+ * Function:
+ * Graph_workspace_pool_destroy
+ *
+ * In this function we release pool along with
+ * idle workspaces. Workspaces still acquired
+ * must be released before
+ */
+void
+Graph_workspace_pool_destroy(Graph_workspace_pool_t *P) {
+
+    if (P == NULL) {
+      return;
+    }
+
+    while (P->idle_count > 0) {
+      Graph_workspace_destroy(P->idle[--P->idle_count]);
+    }
+
+    pthread_mutex_destroy(&P->lock);
+    free(P->idle);
+    free(P);
+
+    return;
+}
@@ -0,0 +1,2327 @@
+/*
+ * In this program we check API's of the library
+ * against plain single threaded Dijkstra (Graph_dijkstra
+ * / Graph_dijkstra_query) or a naive reference on
+ * random Graphs:
+ *      - heaps:    Graph_heap_* push / pop order of every
+ *                  variant and Graph_dijkstra with it against
+ *                  relaxing all edges till nothing changes
+ *      - csr:      rows, Graph_csr_has_edge and
+ *                  Graph_csr_get_dijsktra of Graph_freeze and
+ *                  Graph_csr_from_edges snapshots
+ *      - io:       Graph_write_edge_list read back by
+ *                  Graph_load_edge_list / Graph_csr_load_edge_list
+ *                  in both formats, odd lines of text files
+ *      - snapshot: Graph_save / Graph_csr_save reopened by
+ *                  Graph_open_mmap, corrupt files (byte order,
+ *                  offsets, targets, truncation, weights) rejected
+ *      - sorted:   Graph_has_edge with sorted adjacency while
+ *                  edges and vertices are added and removed,
+ *                  Graph_csr_has_edge of sorted snapshot,
+ *                  Graph_sorted_contains around scan cutoff
+ *      - edge_index: same with edge index (hash set kept or
+ *                  dropped by budget), bulk added edges towards
+ *                  vertices added later
+ *      - delta:    Graph_delta_stepping with given and
+ *                  automatic bucket width
+ *      - bfs:      Graph_bfs on unit weight Graphs, parents
+ *                  must lie on a shortest path
+ *      - batch:    Graph_multi_source_dijkstra rows
+ *      - paths:    Graph_shortest_path (bidirectional with
+ *                  reverse adjacency) and Graph_astar with zero,
+ *                  landmark and inconsistent heuristics, paths
+ *                  must be made of Graph edges
+ *      - components: Graph_connected_components and
+ *                  Graph_strongly_connected_components (both
+ *                  algorithms, Graph and CSR API's) against
+ *                  union-find and pairwise reachability
+ *      - mst:      Graph_mst total weight and edges with Prim,
+ *                  Kruskal and Boruvka against plain Kruskal,
+ *                  negative weights and disconnected Graphs
+ *      - dynamic:  Graph_sssp_distance / predecessor after
+ *                  random Graph_add_edge (also towards IDs
+ *                  added later), Graph_remove_edge,
+ *                  Graph_update_weight, Graph_add_vertex and
+ *                  Graph_remove_vertex calls
+ *      - ch:       Graph_ch_query / Graph_ch_distance of
+ *                  Contraction Hierarchy, also after
+ *                  Graph_ch_save and Graph_ch_load
+ *      - log:      Graph_set_log_handler, level and rate
+ *                  limit with messages of failing calls
+ *
+ * Graphs are directed and undirected, with dense or
+ * sparse vertex IDs, searched with 1 to 4 threads.
+ * Random numbers come from own generator, so a seed
+ * gives the same Graphs on every platform. Program
+ * prints one line per check and exits non zero if any
+ * result differs. Build it with sanitizers to catch
+ * memory errors and data races on the way:
+ *
+ * Compile:
+ *    gcc -g -fsanitize=address,undefined -Isrc tests/graph_check.c src/graph*.c -lpthread -o graph_check
+ *    gcc -g -fsanitize=thread -Isrc tests/graph_check.c src/graph*.c -lpthread -o graph_check
+ * Every third thread fails to start with:
+ *    gcc -g -fsanitize=address,undefined -DCHECK_THREAD_FAILURES -Wl,--wrap=pthread_create \
+ *        -Isrc tests/graph_check.c src/graph*.c -lpthread -o graph_check
+ * Run:
+ *    ./graph_check [-r seed] [-n rounds] [-c check,check,...]
+ *
+ * Author: Kaushik, Koneru
+ * Email:  konerukaushik@gmail.com
+ */
+
+#include <unistd.h>
+#include <errno.h>
+#include <stddef.h>
+#include <graph.h>
+
+/*
+ * Options of the run
+ */
+typedef struct check_options_ {
+  const char           *checks;
+  int                   rounds;      /* Random Graphs per check */
+  uint64_t              seed;
+} check_options_t;
+
+/*
+ * Random Graph being checked
+ */
+typedef struct check_graph_ {
+  Graph_t              *G;
+  vertex_number_t      *ids;         /* Vertex IDs present */
+  vertex_number_t       count;       /* Entries in ids */
+  vertex_number_t       capacity;    /* Capacity of ids */
+  vertex_number_t       next_id;     /* Next ID to hand out */
+  bool                  sparse;      /* IDs are spread out */
+  bool                  directed;
+} check_graph_t;
+
+/*
+ * Check selectable with -c
+ */
+typedef struct check_entry_ {
+  const char           *name;
+  void                (*run)(const check_options_t *, const char *);
+} check_entry_t;
+
+static uint64_t         check_state;
+static long             check_failures;
+
+#ifdef CHECK_THREAD_FAILURES
+/*
+ * Parallel API's must give same results with
+ * threads which could not be started
+ */
+int __real_pthread_create(pthread_t *, const pthread_attr_t *, void *(*)(void *), void *);
+
+int
+__wrap_pthread_create(pthread_t *thread, const pthread_attr_t *attr,
+                      void *(*routine)(void *), void *arg) {
+
+  static int            calls;
+
+  if (__atomic_fetch_add(&calls, 1, __ATOMIC_RELAXED) % 3 == 1) {
+    return EAGAIN;
+  }
+
+  return __real_pthread_create(thread, attr, routine, arg);
+}
+#endif
+
+/*
+ * splitmix64, same stream on every platform
+ */
+static uint64_t
+check_random(void) {
+
+  uint64_t              z;
+
+  z = (check_state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+  return z ^ (z >> 31);
+}
+
+static long
+check_below(long bound) {
+
+  return bound > 0 ? (long)(check_random() % (uint64_t)bound) : 0;
+}
+
+/*
+ * Report mismatch, only first few are printed
+ */
+static void
+check_fail(const char *check, const char *what, vertex_number_t source,
+           vertex_number_t vertex, long got, long expected) {
+
+  if (check_failures++ < 20) {
+    printf("FAIL %s: %s source %d vertex %d got %ld expected %ld\n",
+           check, what, source, vertex, got, expected);
+  }
+}
+
+/*
+ * Whether Graph has edge from S to D of given weight
+ */
+static bool
+check_has_edge(const Graph_t *G, vertex_number_t S, vertex_number_t D, long weight) {
+
+  Graph_vertices_t     *vertex;
+  Graph_edges_t        *edge;
+
+  vertex = Graph_get_vertex(G, S);
+  if (vertex == NULL) {
+    return FALSE;
+  }
+
+  for (edge = vertex->adjacency_list; edge != NULL; edge = edge->next) {
+    if (edge->target == D && edge->weight == weight) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/*
+ * Whether Graph has any edge from S to D, by
+ * scanning adjacency list of S
+ */
+static bool
+check_adjacent(const Graph_t *G, vertex_number_t S, vertex_number_t D) {
+
+  Graph_vertices_t     *vertex;
+  Graph_edges_t        *edge;
+
+  vertex = Graph_get_vertex(G, S);
+  if (vertex == NULL) {
+    return FALSE;
+  }
+
+  for (edge = vertex->adjacency_list; edge != NULL; edge = edge->next) {
+    if (edge->target == D) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/*
+ * ID handed out by check_new_id after skipping ahead
+ */
+static vertex_number_t
+check_future_id(const check_graph_t *C, vertex_number_t ahead) {
+
+  vertex_number_t       id = C->next_id + ahead;
+
+  return C->sparse ? id * 7919 + 100003 : id;
+}
+
+static vertex_number_t
+check_new_id(check_graph_t *C) {
+
+  vertex_number_t       id = check_future_id(C, 0);
+
+  C->next_id++;
+
+  return id;
+}
+
+static bool
+check_add_vertex(check_graph_t *C) {
+
+  vertex_number_t      *ids;
+  vertex_number_t       id = check_new_id(C);
+
+  if (C->count == C->capacity) {
+    ids = (vertex_number_t *)realloc(C->ids, 2 * C->capacity * sizeof(vertex_number_t));
+    if (ids == NULL) {
+      return FALSE;
+    }
+    C->ids      = ids;
+    C->capacity = 2 * C->capacity;
+  }
+
+  if (Graph_add_vertex(C->G, id) == NULL) {
+    return FALSE;
+  }
+  C->ids[C->count++] = id;
+
+  return TRUE;
+}
+
+static vertex_number_t
+check_any_vertex(const check_graph_t *C) {
+
+  return C->ids[check_below(C->count)];
+}
+
+/*
+ * Build Graph with given vertices and edges, weights
+ * in 0 .. max_weight (all 1 if max_weight is 0)
+ */
+static bool
+check_build(check_graph_t *C, vertex_number_t vertices, long edges,
+            long max_weight, bool directed, bool sparse, int threads) {
+
+  edge_weight_t         weight;
+  long                  iterator;
+
+  memset(C, 0, sizeof(check_graph_t));
+  C->sparse   = sparse;
+  C->directed = directed;
+  C->capacity = vertices + 1;
+  C->ids      = (vertex_number_t *)malloc(C->capacity * sizeof(vertex_number_t));
+  C->G        = Graph_init(0, directed);
+  if (C->ids == NULL || C->G == NULL) {
+    return FALSE;
+  }
+  Graph_set_num_threads(C->G, threads);
+
+  for (iterator = 0; iterator < vertices; iterator++) {
+    if (!check_add_vertex(C)) {
+      return FALSE;
+    }
+  }
+
+  for (iterator = 0; iterator < edges; iterator++) {
+    weight = max_weight > 0 ? (edge_weight_t)check_below(max_weight + 1) : 1;
+    Graph_add_edge(C->G, check_any_vertex(C), check_any_vertex(C), weight, directed);
+  }
+
+  return TRUE;
+}
+
+static void
+check_release(check_graph_t *C) {
+
+  Graph_destroy(C->G);
+  free(C->ids);
+}
+
+/*
+ * Graph_delta_stepping against Graph_dijkstra
+ */
+static void
+check_delta(check_graph_t *C, const long *expected, long *got,
+            vertex_number_t source) {
+
+  static const long     widths[] = { 0, 1, 7, 1000 };
+  vertex_number_t       row;
+  size_t                iterator;
+
+  for (iterator = 0; iterator < sizeof(widths) / sizeof(widths[0]); iterator++) {
+    if (!Graph_delta_stepping(C->G, source, widths[iterator], got)) {
+      check_fail("delta", "call failed", source, -1, 0, 1);
+      continue;
+    }
+    for (row = 0; row < C->G->total_vertices; row++) {
+      if (got[row] != expected[row]) {
+        check_fail("delta", "distance", source,
+                   C->G->index_table[row]->interface_number, got[row], expected[row]);
+      }
+    }
+  }
+}
+
+/*
+ * Graph_bfs against Graph_dijkstra of unit weight Graph
+ */
+static void
+check_bfs(check_graph_t *C, const long *expected, long *got,
+          vertex_number_t *parent, vertex_number_t source) {
+
+  Graph_vertices_t     *vertex;
+  vertex_number_t       row;
+
+  if (!Graph_bfs(C->G, source, got, parent)) {
+    check_fail("bfs", "call failed", source, -1, 0, 1);
+    return;
+  }
+
+  for (row = 0; row < C->G->total_vertices; row++) {
+    vertex = C->G->index_table[row];
+    if (got[row] != expected[row]) {
+      check_fail("bfs", "distance", source, vertex->interface_number,
+                 got[row], expected[row]);
+      continue;
+    }
+    if (got[row] == GRAPH_INFINITE_DISTANCE || vertex->interface_number == source) {
+      continue;
+    }
+    /* Parent is one hop closer and has an edge to vertex */
+    if (parent[row] == -1 || !check_has_edge(C->G, parent[row], vertex->interface_number, 1) ||
+        got[Graph_get_vertex(C->G, parent[row])->index] != got[row] - 1) {
+      check_fail("bfs", "parent", source, vertex->interface_number, parent[row], -1);
+    }
+  }
+}
+
+/*
+ * Graph_multi_source_dijkstra rows against Graph_dijkstra
+ */
+static void
+check_batch(check_graph_t *C, long *expected) {
+
+  vertex_number_t       sources[9];
+  vertex_number_t       columns = C->G->total_vertices;
+  vertex_number_t       row;
+  long                 *matrix;
+  int                   iterator;
+
+  matrix = (long *)malloc(sizeof(sources) / sizeof(sources[0]) * columns * sizeof(long));
+  if (matrix == NULL) {
+    check_fail("batch", "out of memory", -1, -1, 0, 1);
+    return;
+  }
+
+  for (iterator = 0; iterator < 9; iterator++) {
+    sources[iterator] = check_any_vertex(C);
+  }
+
+  if (!Graph_multi_source_dijkstra(C->G, sources, 9, matrix)) {
+    check_fail("batch", "call failed", -1, -1, 0, 1);
+  }
+
+  for (iterator = 0; iterator < 9; iterator++) {
+    Graph_dijkstra(C->G, sources[iterator], expected, NULL);
+    for (row = 0; row < columns; row++) {
+      if (matrix[iterator * (long)columns + row] != expected[row]) {
+        check_fail("batch", "distance", sources[iterator],
+                   C->G->index_table[row]->interface_number,
+                   matrix[iterator * (long)columns + row], expected[row]);
+      }
+    }
+  }
+
+  free(matrix);
+}
+
+/*
+ * Distances from source by relaxing all edges
+ * till nothing changes (no heap involved)
+ */
+static void
+check_distances_reference(const Graph_t *G, vertex_number_t source, long *distance) {
+
+  Graph_edges_t        *edge;
+  vertex_number_t       row;
+  vertex_number_t       other;
+  bool                  changed = TRUE;
+
+  for (row = 0; row < G->total_vertices; row++) {
+    distance[row] = GRAPH_INFINITE_DISTANCE;
+  }
+  distance[Graph_get_vertex(G, source)->index] = 0;
+
+  while (changed) {
+    changed = FALSE;
+    for (row = 0; row < G->total_vertices; row++) {
+      if (distance[row] == GRAPH_INFINITE_DISTANCE) {
+        continue;
+      }
+      for (edge = G->index_table[row]->adjacency_list; edge != NULL; edge = edge->next) {
+        other = Graph_get_vertex(G, edge->target)->index;
+        if (distance[row] + edge->weight < distance[other]) {
+          distance[other] = distance[row] + edge->weight;
+          changed         = TRUE;
+        }
+      }
+    }
+  }
+}
+
+/*
+ * Heap of given type against plain arrays, driven
+ * the way Dijkstra drives it: keys pushed or decreased
+ * are at most max_weight above last popped key and
+ * popped elements never come back
+ */
+static void
+check_heap_order(const char *check, const char *name, Graph_heap_type_t type,
+                 vertex_number_t capacity, long max_weight) {
+
+  Graph_heap_t         *H;
+  long                 *key;
+  char                 *state;       /* 0 new, 1 in heap, 2 popped */
+  vertex_number_t       element;
+  vertex_number_t       smallest;
+  long                  last = 0;
+  long                  pushed;
+  long                  failures = check_failures;
+  int                   operation;
+
+  H     = Graph_heap_create(capacity, type);
+  key   = (long *)malloc(capacity * sizeof(long));
+  state = (char *)calloc(capacity, sizeof(char));
+  if (H == NULL || key == NULL || state == NULL) {
+    check_fail(check, "out of memory", -1, -1, 0, 1);
+    goto destroy;
+  }
+  Graph_heap_set_type(H, type, max_weight);
+
+  for (operation = 0; operation <= capacity / 4; operation++) {
+    element = (vertex_number_t)check_below(capacity);
+    pushed  = check_below(max_weight + 1);
+    Graph_heap_push(H, element, pushed);
+    if (state[element] == 0 || pushed < key[element]) {
+      key[element] = pushed;
+    }
+    state[element] = 1;
+  }
+
+  for (;;) {
+    smallest = -1;
+    for (element = 0; element < capacity; element++) {
+      if (Graph_heap_contains(H, element) != (state[element] == 1)) {
+        check_fail(check, "contains", -1, element, Graph_heap_contains(H, element),
+                   state[element] == 1);
+      }
+      if (state[element] == 1 && (smallest == -1 || key[element] < key[smallest])) {
+        smallest = element;
+      }
+    }
+    if (Graph_heap_is_empty(H) != (smallest == -1)) {
+      check_fail(check, "is_empty", -1, -1, Graph_heap_is_empty(H), smallest == -1);
+      break;
+    }
+    if (smallest == -1) {
+      break;
+    }
+    if (Graph_heap_top_key(H) != key[smallest]) {
+      check_fail(check, "top key", -1, smallest, Graph_heap_top_key(H), key[smallest]);
+    }
+
+    element = Graph_heap_pop(H);
+    if (element < 0 || element >= capacity || state[element] != 1 ||
+        key[element] != key[smallest]) {
+      check_fail(check, "pop", -1, element,
+                 (element >= 0 && element < capacity) ? key[element] : -1, key[smallest]);
+      break;
+    }
+    state[element] = 2;
+    last           = key[element];
+
+    for (operation = (int)check_below(4); operation > 0; operation--) {
+      element = (vertex_number_t)check_below(capacity);
+      if (state[element] == 2) {
+        continue;
+      }
+      pushed = last + check_below(max_weight + 1);
+      Graph_heap_push(H, element, pushed);
+      if (state[element] == 0 || pushed < key[element]) {
+        key[element] = pushed;
+      }
+      state[element] = 1;
+    }
+  }
+
+destroy:
+  if (check_failures != failures) {
+    printf("     %s heap, capacity %d, max weight %ld\n", name, capacity, max_weight);
+  }
+  Graph_heap_destroy(H);
+  free(key);
+  free(state);
+}
+
+/*
+ * Heap variants directly and as frontier of
+ * Graph_dijkstra against check_distances_reference
+ */
+static void
+check_heaps(const check_options_t *O, const char *check) {
+
+  static const struct {
+    Graph_heap_type_t   type;
+    const char         *name;
+  } types[] = {
+    { GRAPH_HEAP_BINARY,     "binary"     },
+    { GRAPH_HEAP_QUATERNARY, "quaternary" },
+    { GRAPH_HEAP_PAIRING,    "pairing"    },
+    { GRAPH_HEAP_RADIX,      "radix"      },
+    { GRAPH_HEAP_DIAL,       "dial"       },
+    { GRAPH_HEAP_AUTO,       "auto"       },
+  };
+  check_graph_t         C;
+  long                 *expected;
+  long                 *got;
+  vertex_number_t       vertices;
+  vertex_number_t       source;
+  vertex_number_t       row;
+  long                  failures = check_failures;
+  long                  max_weight;
+  size_t                type;
+  int                   round;
+
+  for (round = 0; round < O->rounds; round++) {
+    /* Some rounds have weights too large for Dial, it falls back to Radix */
+    max_weight = (round % 3 == 2) ? 100000 : 50;
+    for (type = 0; type < sizeof(types) / sizeof(types[0]); type++) {
+      check_heap_order(check, types[type].name, types[type].type,
+                       (vertex_number_t)(1 + check_below(300)), max_weight);
+    }
+
+    vertices = (vertex_number_t)(20 + check_below(300));
+    if (!check_build(&C, vertices, vertices * (1 + check_below(6)), max_weight,
+                     check_below(2), check_below(2), 1)) {
+      check_fail(check, "build failed", -1, -1, 0, 1);
+      check_release(&C);
+      return;
+    }
+
+    expected = (long *)malloc(vertices * sizeof(long));
+    got      = (long *)malloc(vertices * sizeof(long));
+    if (expected == NULL || got == NULL) {
+      check_fail(check, "out of memory", -1, -1, 0, 1);
+    } else {
+      source = check_any_vertex(&C);
+      check_distances_reference(C.G, source, expected);
+      for (type = 0; type < sizeof(types) / sizeof(types[0]); type++) {
+        Graph_set_heap_type(C.G, types[type].type);
+        if (!Graph_dijkstra(C.G, source, got, NULL)) {
+          check_fail(check, types[type].name, source, -1, 0, 1);
+          continue;
+        }
+        for (row = 0; row < vertices; row++) {
+          if (got[row] != expected[row]) {
+            check_fail(check, types[type].name, source,
+                       C.G->index_table[row]->interface_number, got[row], expected[row]);
+          }
+        }
+      }
+    }
+
+    free(expected);
+    free(got);
+    check_release(&C);
+  }
+
+  printf("%s %s: %d Graphs\n", check_failures == failures ? "ok  " : "FAIL",
+         check, O->rounds);
+}
+
+/*
+ * Distances of CSR snapshot (by row) against
+ * reference of the Graph (by dense index)
+ */
+static void
+check_csr_distances(const char *check, const char *what, const Graph_csr_t *csr,
+                    const Graph_t *G, vertex_number_t source, const long *expected,
+                    long *got) {
+
+  vertex_number_t       id;
+  vertex_number_t       row;
+
+  if (!Graph_csr_get_dijsktra(csr, source, got)) {
+    check_fail(check, what, source, -1, 0, 1);
+    return;
+  }
+
+  for (row = 0; row < G->total_vertices; row++) {
+    id = G->index_table[row]->interface_number;
+    if (got[Graph_csr_get_row(csr, id)] != expected[row]) {
+      check_fail(check, what, source, id, got[Graph_csr_get_row(csr, id)], expected[row]);
+    }
+  }
+}
+
+/*
+ * CSR snapshots by Graph_freeze and Graph_csr_from_edges:
+ * rows, Graph_csr_has_edge and Graph_csr_get_dijsktra
+ * against the linked list Graph
+ */
+static void
+check_csr(const check_options_t *O, const char *check) {
+
+  check_graph_t         C;
+  Graph_t              *G;
+  Graph_csr_t          *csr;
+  vertex_number_t      *sources;
+  vertex_number_t      *targets;
+  edge_weight_t        *weights;
+  long                 *expected;
+  long                 *got;
+  vertex_number_t       vertices;
+  vertex_number_t       source;
+  vertex_number_t       target;
+  vertex_number_t       row;
+  edge_index_t          edges;
+  edge_index_t          edge;
+  long                  failures = check_failures;
+  bool                  directed;
+  int                   round;
+  int                   query;
+
+  for (round = 0; round < O->rounds; round++) {
+    vertices = (vertex_number_t)(20 + check_below(500));
+    if (!check_build(&C, vertices, vertices * (1 + check_below(6)), 50,
+                     check_below(2), check_below(2), 1)) {
+      check_fail(check, "build failed", -1, -1, 0, 1);
+      check_release(&C);
+      return;
+    }
+
+    expected = (long *)malloc(vertices * sizeof(long));
+    got      = (long *)malloc(vertices * sizeof(long));
+    csr      = Graph_freeze(C.G);
+    if (expected == NULL || got == NULL || csr == NULL) {
+      check_fail(check, "freeze failed", -1, -1, 0, 1);
+      goto next;
+    }
+
+    if (csr->total_vertices != vertices) {
+      check_fail(check, "rows", -1, -1, csr->total_vertices, vertices);
+      goto next;
+    }
+    for (row = 0; row < vertices; row++) {
+      if (Graph_csr_get_row(csr, csr->vertex_ids[row]) != row) {
+        check_fail(check, "row of vertex", -1, csr->vertex_ids[row],
+                   Graph_csr_get_row(csr, csr->vertex_ids[row]), row);
+      }
+    }
+    if (Graph_csr_get_row(csr, check_future_id(&C, 1)) != -1) {
+      check_fail(check, "row of missing vertex", -1, check_future_id(&C, 1),
+                 Graph_csr_get_row(csr, check_future_id(&C, 1)), -1);
+    }
+
+    for (query = 0; query < 4 * vertices; query++) {
+      source = check_any_vertex(&C);
+      target = (query % 8 == 7) ? check_future_id(&C, 1) : check_any_vertex(&C);
+      if (Graph_csr_has_edge(csr, source, target) != check_adjacent(C.G, source, target)) {
+        check_fail(check, "has_edge", source, target,
+                   Graph_csr_has_edge(csr, source, target),
+                   check_adjacent(C.G, source, target));
+      }
+    }
+
+    for (query = 0; query < 4; query++) {
+      source = check_any_vertex(&C);
+      check_distances_reference(C.G, source, expected);
+      check_csr_distances(check, "freeze distance", csr, C.G, source, expected, got);
+    }
+
+next:
+    Graph_csr_destroy(csr);
+    free(expected);
+    free(got);
+    check_release(&C);
+
+    /* Same edges once as arrays, once through Graph_add_edge */
+    vertices = (vertex_number_t)(1 + check_below(300));
+    edges    = vertices * check_below(6);
+    directed = check_below(2);
+    sources  = (vertex_number_t *)malloc((edges + 1) * sizeof(vertex_number_t));
+    targets  = (vertex_number_t *)malloc((edges + 1) * sizeof(vertex_number_t));
+    weights  = (edge_weight_t *)malloc((edges + 1) * sizeof(edge_weight_t));
+    expected = (long *)malloc(vertices * sizeof(long));
+    got      = (long *)malloc(vertices * sizeof(long));
+    G        = Graph_init(0, directed);
+    csr      = NULL;
+    if (sources == NULL || targets == NULL || weights == NULL || expected == NULL ||
+        got == NULL || G == NULL || Graph_add_vertices(G, vertices) == NULL) {
+      check_fail(check, "out of memory", -1, -1, 0, 1);
+      goto release;
+    }
+
+    /* Some edges name vertices past the end, they are dropped */
+    for (edge = 0; edge < edges; edge++) {
+      sources[edge] = (vertex_number_t)check_below(vertices + (edge % 16 == 15));
+      targets[edge] = (vertex_number_t)check_below(vertices + (edge % 16 == 14));
+      weights[edge] = (edge_weight_t)check_below(51);
+      if (sources[edge] < vertices && targets[edge] < vertices) {
+        Graph_add_edge(G, sources[edge], targets[edge], weights[edge], directed);
+      }
+    }
+    csr = Graph_csr_from_edges(vertices, sources, targets, weights, edges, directed);
+    if (csr == NULL) {
+      check_fail(check, "from_edges failed", -1, -1, 0, 1);
+      goto release;
+    }
+
+    for (query = 0; query < 4 * vertices; query++) {
+      source = (vertex_number_t)check_below(vertices);
+      target = (vertex_number_t)check_below(vertices);
+      if (Graph_csr_has_edge(csr, source, target) != check_adjacent(G, source, target)) {
+        check_fail(check, "from_edges has_edge", source, target,
+                   Graph_csr_has_edge(csr, source, target), check_adjacent(G, source, target));
+      }
+    }
+    source = (vertex_number_t)check_below(vertices);
+    check_distances_reference(G, source, expected);
+    check_csr_distances(check, "from_edges distance", csr, G, source, expected, got);
+
+release:
+    Graph_csr_destroy(csr);
+    Graph_destroy(G);
+    free(sources);
+    free(targets);
+    free(weights);
+    free(expected);
+    free(got);
+  }
+
+  printf("%s %s: %d Graphs\n", check_failures == failures ? "ok  " : "FAIL",
+         check, O->rounds);
+}
+
+/*
+ * Whether got holds the same directed edges as
+ * expected, counted with multiplicity
+ */
+static void
+check_same_edges(const char *check, const char *what, const Graph_t *expected,
+                 const Graph_t *got, const Graph_csr_t *csr) {
+
+  Graph_vertices_t     *vertex;
+  Graph_edges_t        *edge;
+  long                  total = (got != NULL) ? got->total_edges : csr->total_edges;
+
+  if (total != expected->total_edges) {
+    check_fail(check, what, -1, -1, total, expected->total_edges);
+    return;
+  }
+
+  for (vertex = expected->vertices_list; vertex != NULL; vertex = vertex->next) {
+    for (edge = vertex->adjacency_list; edge != NULL; edge = edge->next) {
+      if (got != NULL ? !check_has_edge(got, vertex->interface_number, edge->target,
+                                        edge->weight)
+                      : !Graph_csr_has_edge(csr, vertex->interface_number, edge->target)) {
+        check_fail(check, what, vertex->interface_number, edge->target, 0, edge->weight);
+      }
+    }
+  }
+}
+
+/*
+ * Graph_write_edge_list in both formats read back by
+ * Graph_load_edge_list and Graph_csr_load_edge_list,
+ * and a hand written text file with odd lines
+ */
+static void
+check_io(const check_options_t *O, const char *check) {
+
+  static const char     text[] =
+    "# comment\n"
+    "% comment\n"
+    "\n"
+    "  1 2 5\n"
+    "2,3,-2147483648\r\n"
+    "3\t1\n"
+    "4 x 1\n"
+    "-7 2147483647 2147483647\n"
+    "5 6 2147483648\n"
+    "6 5";
+  static const Graph_file_format_t formats[] = {
+    GRAPH_FORMAT_TEXT, GRAPH_FORMAT_BINARY
+  };
+  check_graph_t         C;
+  Graph_t              *G;
+  Graph_csr_t          *csr;
+  FILE                 *file;
+  char                  path[] = "/tmp/graph_check_io_XXXXXX";
+  long                  failures = check_failures;
+  vertex_number_t       vertices;
+  size_t                format;
+  int                   descriptor;
+  int                   round;
+
+  descriptor = mkstemp(path);
+  if (descriptor < 0) {
+    check_fail(check, "temporary file", -1, -1, 0, 1);
+    return;
+  }
+  close(descriptor);
+
+  for (round = 0; round < O->rounds; round++) {
+    vertices = (vertex_number_t)(1 + check_below(500));
+    if (!check_build(&C, vertices, vertices * check_below(6), 1000,
+                     check_below(2), check_below(2), 1)) {
+      check_fail(check, "build failed", -1, -1, 0, 1);
+      check_release(&C);
+      break;
+    }
+
+    /* Undirected edges are written as two directed ones */
+    for (format = 0; format < sizeof(formats) / sizeof(formats[0]); format++) {
+      if (!Graph_write_edge_list(C.G, path, formats[format])) {
+        check_fail(check, "write failed", -1, -1, formats[format], -1);
+        continue;
+      }
+
+      G = Graph_load_edge_list(path, round % 2 ? GRAPH_FORMAT_AUTO : formats[format], TRUE);
+      if (G == NULL) {
+        check_fail(check, "load failed", -1, -1, formats[format], -1);
+      } else {
+        check_same_edges(check, "load", C.G, G, NULL);
+      }
+      Graph_destroy(G);
+
+      csr = Graph_csr_load_edge_list(path, formats[format], TRUE);
+      if (csr == NULL) {
+        check_fail(check, "csr load failed", -1, -1, formats[format], -1);
+      } else {
+        check_same_edges(check, "csr load", C.G, NULL, csr);
+      }
+      Graph_csr_destroy(csr);
+    }
+
+    check_release(&C);
+  }
+
+  /* Malformed and out of range lines are skipped, INT_MIN is kept */
+  file = fopen(path, "wb");
+  if (file == NULL || fwrite(text, sizeof(text) - 1, 1, file) != 1) {
+    check_fail(check, "write failed", -1, -1, 0, 1);
+  }
+  if (file != NULL) {
+    fclose(file);
+  }
+  G = Graph_load_edge_list(path, GRAPH_FORMAT_AUTO, TRUE);
+  if (G == NULL || G->total_edges != 5 ||
+      !check_has_edge(G, 1, 2, 5) || !check_has_edge(G, 2, 3, INT_MIN) ||
+      !check_has_edge(G, 3, 1, 1) || !check_has_edge(G, -7, INT_MAX, INT_MAX) ||
+      !check_has_edge(G, 6, 5, 1)) {
+    check_fail(check, "text lines", -1, -1, G != NULL ? G->total_edges : -1, 5);
+  }
+  Graph_destroy(G);
+
+  unlink(path);
+
+  printf("%s %s: %d Graphs\n", check_failures == failures ? "ok  " : "FAIL",
+         check, O->rounds);
+}
+
+/*
+ * Overwrite size bytes of file at offset
+ */
+static bool
+check_patch(const char *path, long offset, const void *data, size_t size) {
+
+  FILE                 *file;
+  bool                  result;
+
+  file = fopen(path, "r+b");
+  if (file == NULL) {
+    return FALSE;
+  }
+  result = fseek(file, offset, SEEK_SET) == 0 && fwrite(data, size, 1, file) == 1;
+
+  return fclose(file) == 0 && result;
+}
+
+/*
+ * Graph_save / Graph_csr_save reopened by Graph_open_mmap
+ * against the Graph, and corrupt copies which open or
+ * Graph_csr_verify must reject
+ */
+static void
+check_snapshot(const check_options_t *O, const char *check) {
+
+  Graph_snapshot_header_t  header;
+  check_graph_t         C;
+  Graph_csr_t          *csr;
+  Graph_csr_t          *frozen;
+  FILE                 *file;
+  long                 *expected;
+  long                 *got;
+  char                  path[] = "/tmp/graph_check_snapshot_XXXXXX";
+  long                  failures = check_failures;
+  long                  offset;
+  vertex_number_t       vertices;
+  vertex_number_t       source;
+  vertex_number_t       target;
+  edge_index_t          edges;
+  edge_weight_t         weight;
+  int                   descriptor;
+  int                   round;
+  int                   query;
+  int                   damage;
+  bool                  saved;
+
+  descriptor = mkstemp(path);
+  if (descriptor < 0) {
+    check_fail(check, "temporary file", -1, -1, 0, 1);
+    return;
+  }
+  close(descriptor);
+
+  for (round = 0; round < O->rounds; round++) {
+    vertices = (vertex_number_t)(1 + check_below(500));
+    if (!check_build(&C, vertices, vertices * check_below(6), 50,
+                     check_below(2), check_below(2), 1)) {
+      check_fail(check, "build failed", -1, -1, 0, 1);
+      check_release(&C);
+      break;
+    }
+    if (round % 4 == 3) {
+      Graph_set_sorted_adjacency(C.G, TRUE);
+    }
+
+    /* Every other snapshot goes through Graph_csr_save */
+    frozen   = (round % 2) ? Graph_freeze(C.G) : NULL;
+    saved    = (round % 2) ? Graph_csr_save(frozen, path) : Graph_save(C.G, path);
+    csr      = saved ? Graph_open_mmap(path) : NULL;
+    expected = (long *)malloc(vertices * sizeof(long));
+    got      = (long *)malloc(vertices * sizeof(long));
+    if (csr == NULL || expected == NULL || got == NULL) {
+      check_fail(check, "save or open failed", -1, -1, saved, 1);
+      goto next;
+    }
+
+    if (!Graph_csr_verify(csr)) {
+      check_fail(check, "verify", -1, -1, 0, 1);
+    }
+    if (csr->total_vertices != vertices || csr->total_edges != C.G->total_edges) {
+      check_fail(check, "size", -1, -1, csr->total_edges, C.G->total_edges);
+    }
+    for (query = 0; query < 4 * vertices; query++) {
+      source = check_any_vertex(&C);
+      target = check_any_vertex(&C);
+      if (Graph_csr_has_edge(csr, source, target) != check_adjacent(C.G, source, target)) {
+        check_fail(check, "has_edge", source, target,
+                   Graph_csr_has_edge(csr, source, target),
+                   check_adjacent(C.G, source, target));
+      }
+    }
+    source = check_any_vertex(&C);
+    check_distances_reference(C.G, source, expected);
+    check_csr_distances(check, "distance", csr, C.G, source, expected, got);
+
+    memcpy(&header, csr->mapping, sizeof(header));
+    edges = csr->total_edges;
+    Graph_csr_destroy(csr);
+    csr = NULL;
+
+    /* Damage a copy, open must fail except for weights which only verify sees */
+    damage = round % 5;
+    switch (damage) {
+      case 0:
+        header.endian = 0x04030201u;
+        saved = check_patch(path, offsetof(Graph_snapshot_header_t, endian),
+                            &header.endian, sizeof(header.endian));
+        break;
+      case 1:
+        /* Last offset no longer matches edge count */
+        edges++;
+        saved = check_patch(path, (long)header.section[0] +
+                            vertices * (long)sizeof(edge_index_t), &edges, sizeof(edges));
+        break;
+      case 2:
+        /* Target out of range, needs an edge */
+        saved = edges > 0 &&
+                check_patch(path, (long)header.section[1] +
+                            check_below(edges) * (long)sizeof(vertex_number_t),
+                            &vertices, sizeof(vertices));
+        break;
+      case 3:
+        offset = (long)header.file_size - 1 - check_below(64);
+        saved  = truncate(path, offset) == 0;
+        break;
+      default:
+        weight = -12345;
+        saved  = edges > 0 &&
+                 check_patch(path, (long)header.section[2], &weight, sizeof(weight));
+        break;
+    }
+    if (!saved) {
+      goto next;
+    }
+
+    csr = Graph_open_mmap(path);
+    if (damage < 4 && csr != NULL) {
+      check_fail(check, "corrupt snapshot opened", -1, -1, damage, -1);
+    }
+    if (damage == 4 && (csr == NULL || Graph_csr_verify(csr))) {
+      check_fail(check, "corrupt weight verified", -1, -1, csr != NULL, 0);
+    }
+
+next:
+    Graph_csr_destroy(csr);
+    Graph_csr_destroy(frozen);
+    free(expected);
+    free(got);
+    check_release(&C);
+  }
+
+  /* File which is not a snapshot at all */
+  file = fopen(path, "wb");
+  if (file != NULL) {
+    fputs("not a snapshot, long enough to hold a header of some hundred bytes"
+          "..................................................................", file);
+    fclose(file);
+    csr = Graph_open_mmap(path);
+    if (csr != NULL) {
+      check_fail(check, "text file opened", -1, -1, 1, 0);
+    }
+    Graph_csr_destroy(csr);
+  }
+
+  unlink(path);
+
+  printf("%s %s: %d Graphs\n", check_failures == failures ? "ok  " : "FAIL",
+         check, O->rounds);
+}
+
+/*
+ * Parallel searches on random Graphs of growing size
+ */
+static void
+check_parallel(const check_options_t *O, const char *check) {
+
+  check_graph_t         C;
+  vertex_number_t      *parent;
+  long                 *expected;
+  long                 *got;
+  vertex_number_t       vertices;
+  vertex_number_t       source;
+  long                  failures = check_failures;
+  int                   round;
+  int                   query;
+  bool                  unit = (strcmp(check, "bfs") == 0);
+
+  for (round = 0; round < O->rounds; round++) {
+    vertices = (vertex_number_t)(50 + check_below(round % 3 == 2 ? 5000 : 500));
+    if (!check_build(&C, vertices, vertices * (1 + check_below(8)), unit ? 0 : 50,
+                     check_below(2), check_below(2), 1 + round % 4)) {
+      check_fail(check, "build failed", -1, -1, 0, 1);
+      check_release(&C);
+      return;
+    }
+
+    expected = (long *)malloc(vertices * sizeof(long));
+    got      = (long *)malloc(vertices * sizeof(long));
+    parent   = (vertex_number_t *)malloc(vertices * sizeof(vertex_number_t));
+    if (expected == NULL || got == NULL || parent == NULL) {
+      check_fail(check, "out of memory", -1, -1, 0, 1);
+    } else if (strcmp(check, "batch") == 0) {
+      check_batch(&C, expected);
+    } else {
+      for (query = 0; query < 4; query++) {
+        source = check_any_vertex(&C);
+        Graph_dijkstra(C.G, source, expected, NULL);
+        if (unit) {
+          check_bfs(&C, expected, got, parent, source);
+        } else {
+          check_delta(&C, expected, got, source);
+        }
+      }
+    }
+
+    free(expected);
+    free(got);
+    free(parent);
+    check_release(&C);
+  }
+
+  printf("%s %s: %d Graphs\n", check_failures == failures ? "ok  " : "FAIL",
+         check, O->rounds);
+}
+
+/*
+ * Heuristic context: distances from a landmark, so
+ * d(L,T) - d(L,v) never overestimates d(v,T). Scaled
+ * down by a per vertex factor when inconsistent
+ * heuristic is wanted (still admissible)
+ */
+typedef struct check_landmark_ {
+  const Graph_t        *G;
+  long                 *distance;
+  bool                  inconsistent;
+} check_landmark_t;
+
+static long
+check_zero_heuristic(vertex_number_t vertex, vertex_number_t target, void *context) {
+
+  (void)vertex;
+  (void)target;
+  (void)context;
+
+  return 0;
+}
+
+static long
+check_landmark_heuristic(vertex_number_t vertex, vertex_number_t target, void *context) {
+
+  check_landmark_t     *L = (check_landmark_t *)context;
+  long                  from = L->distance[Graph_get_vertex(L->G, vertex)->index];
+  long                  to   = L->distance[Graph_get_vertex(L->G, target)->index];
+
+  if (from == GRAPH_INFINITE_DISTANCE || to == GRAPH_INFINITE_DISTANCE || to <= from) {
+    return 0;
+  }
+  if (L->inconsistent) {
+    return (to - from) * (long)(((uint32_t)vertex * 2654435761u) >> 30) / 3;
+  }
+
+  return to - from;
+}
+
+/*
+ * Path returned by a point to point query must run
+ * from Source to Target over edges of the Graph and
+ * weigh (lightest parallel edges) what was reported
+ */
+static void
+check_path(const char *check, const char *what, const Graph_t *G,
+           vertex_number_t S, vertex_number_t T, long expected, long distance,
+           const vertex_number_t *path, vertex_number_t count) {
+
+  Graph_edges_t        *edge;
+  long                  weight;
+  long                  total = 0;
+  vertex_number_t       iterator;
+
+  if (distance != expected) {
+    check_fail(check, what, S, T, distance, expected);
+    return;
+  }
+  if ((expected == GRAPH_INFINITE_DISTANCE) != (count == 0)) {
+    check_fail(check, what, S, T, count, expected == GRAPH_INFINITE_DISTANCE ? 0 : 1);
+    return;
+  }
+  if (count == 0) {
+    return;
+  }
+  if (path[0] != S || path[count - 1] != T) {
+    check_fail(check, what, S, T, path[count - 1], T);
+    return;
+  }
+
+  for (iterator = 0; iterator + 1 < count; iterator++) {
+    weight = GRAPH_INFINITE_DISTANCE;
+    for (edge = Graph_get_vertex(G, path[iterator])->adjacency_list; edge != NULL;
+         edge = edge->next) {
+      if (edge->target == path[iterator + 1] && edge->weight < weight) {
+        weight = edge->weight;
+      }
+    }
+    if (weight == GRAPH_INFINITE_DISTANCE) {
+      check_fail(check, what, path[iterator], path[iterator + 1], 0, 1);
+      return;
+    }
+    total += weight;
+  }
+  if (total != expected) {
+    check_fail(check, what, S, T, total, expected);
+  }
+}
+
+/*
+ * Graph_shortest_path / Graph_shortest_path_query
+ * (bidirectional if Graph has reverse adjacency) and
+ * Graph_astar / Graph_astar_query with zero, landmark
+ * and inconsistent landmark heuristics against relaxing
+ * all edges. Half way edges are added and removed, so
+ * reverse adjacency is checked after changes too
+ */
+static void
+check_paths(const check_options_t *O, const char *check) {
+
+  check_graph_t         C;
+  check_landmark_t      L;
+  Graph_workspace_t    *W;
+  Graph_workspace_t    *Wr;
+  Graph_vertices_t     *vertex;
+  vertex_number_t      *path;
+  vertex_number_t       count;
+  vertex_number_t       S;
+  vertex_number_t       T;
+  long                 *expected;
+  long                  distance;
+  long                  failures = check_failures;
+  int                   round;
+  int                   query;
+  int                   change;
+  int                   queries = 20;
+
+  for (round = 0; round < O->rounds; round++) {
+    if (!check_build(&C, 2 + check_below(300), check_below(1200), round % 3 ? 9 : 0,
+                     check_below(2), check_below(2), 1)) {
+      check_fail(check, "build failed", -1, -1, 0, 1);
+      check_release(&C);
+      return;
+    }
+    if (round % 2 == 1 && !Graph_enable_reverse_adjacency(C.G, TRUE)) {
+      check_fail(check, "reverse failed", -1, -1, 0, 1);
+    }
+
+    W           = Graph_workspace_create(C.G->total_vertices);
+    Wr          = Graph_workspace_create(C.G->total_vertices);
+    path        = (vertex_number_t *)malloc(C.G->total_vertices * sizeof(vertex_number_t));
+    expected    = (long *)malloc(C.G->total_vertices * sizeof(long));
+    L.G         = C.G;
+    L.distance  = (long *)malloc(C.G->total_vertices * sizeof(long));
+    if (W == NULL || Wr == NULL || path == NULL || expected == NULL || L.distance == NULL) {
+      check_fail(check, "allocation failed", -1, -1, 0, 1);
+      queries = 0;
+    }
+
+    for (query = 0; query < queries; query++) {
+      /* Edges come and go half way */
+      for (change = 0; query == queries / 2 && change < 200; change++) {
+        S      = check_any_vertex(&C);
+        vertex = Graph_get_vertex(C.G, S);
+        if (change % 2 == 0 && vertex->adjacency_list != NULL) {
+          Graph_remove_edge(C.G, S, vertex->adjacency_list->target, C.directed);
+        } else {
+          Graph_add_edge(C.G, S, check_any_vertex(&C),
+                         round % 3 ? (edge_weight_t)check_below(10) : 1, C.directed);
+        }
+      }
+
+      S = check_any_vertex(&C);
+      T = (query % 7 == 0) ? S : check_any_vertex(&C);
+      check_distances_reference(C.G, S, expected);
+      check_distances_reference(C.G, check_any_vertex(&C), L.distance);
+
+      count = Graph_shortest_path(C.G, S, T, &distance, path);
+      check_path(check, "shortest_path", C.G, S, T,
+                 expected[Graph_get_vertex(C.G, T)->index], distance, path, count);
+
+      count = Graph_shortest_path_query(C.G, W, Wr, S, T, &distance, path);
+      check_path(check, "shortest_path_query", C.G, S, T,
+                 expected[Graph_get_vertex(C.G, T)->index], distance, path, count);
+
+      count = Graph_astar(C.G, S, T, check_zero_heuristic, NULL, &distance, path, NULL);
+      check_path(check, "astar", C.G, S, T,
+                 expected[Graph_get_vertex(C.G, T)->index], distance, path, count);
+
+      L.inconsistent = query % 2 == 1;
+      count = Graph_astar_query(C.G, W, S, T, check_landmark_heuristic, &L,
+                                &distance, path, NULL);
+      check_path(check, L.inconsistent ? "astar inconsistent" : "astar landmark", C.G,
+                 S, T, expected[Graph_get_vertex(C.G, T)->index], distance, path, count);
+    }
+
+    Graph_workspace_destroy(W);
+    Graph_workspace_destroy(Wr);
+    free(path);
+    free(expected);
+    free(L.distance);
+    check_release(&C);
+  }
+
+  printf("%s %s: %d Graphs, %d queries each\n",
+         check_failures == failures ? "ok  " : "FAIL", check, O->rounds, queries);
+}
+
+/*
+ * Registered trees against Graph_dijkstra_query
+ */
+static void
+check_trees(check_graph_t *C, Graph_sssp_t **trees, const vertex_number_t *sources,
+            int no_of_trees, Graph_workspace_t *W, int step) {
+
+  Graph_vertices_t     *vertex;
+  vertex_number_t       predecessor;
+  vertex_number_t       row;
+  long                  distance;
+  long                  expected;
+  int                   iterator;
+  bool                  present;
+
+  for (iterator = 0; iterator < no_of_trees; iterator++) {
+    present = Graph_get_vertex(C->G, sources[iterator]) != NULL &&
+              Graph_dijkstra_query(C->G, W, sources[iterator]);
+
+    for (row = 0; row < C->G->total_vertices; row++) {
+      vertex   = C->G->index_table[row];
+      expected = present ? W->min_distance[row] : GRAPH_INFINITE_DISTANCE;
+      if (present &&
+          (expected == GRAPH_INFINITE_DISTANCE || vertex->interface_number == sources[iterator]) &&
+          Graph_workspace_get_predecessor(C->G, W, vertex->interface_number) != -1) {
+        check_fail("dynamic", "workspace predecessor", sources[iterator],
+                   vertex->interface_number,
+                   Graph_workspace_get_predecessor(C->G, W, vertex->interface_number), -1);
+      }
+
+      distance = Graph_sssp_distance(trees[iterator], vertex->interface_number);
+      if (distance != expected) {
+        check_fail("dynamic", "distance", sources[iterator], vertex->interface_number,
+                   distance, expected);
+        printf("     after step %d\n", step);
+        continue;
+      }
+
+      /* Edge from predecessor must make up the distance */
+      predecessor = Graph_sssp_predecessor(trees[iterator], vertex->interface_number);
+      if (distance == GRAPH_INFINITE_DISTANCE || vertex->interface_number == sources[iterator]) {
+        if (predecessor != -1) {
+          check_fail("dynamic", "predecessor", sources[iterator], vertex->interface_number,
+                     predecessor, -1);
+        }
+        continue;
+      }
+      if (predecessor == -1 ||
+          !check_has_edge(C->G, predecessor, vertex->interface_number,
+                          distance - Graph_sssp_distance(trees[iterator], predecessor))) {
+        check_fail("dynamic", "predecessor", sources[iterator], vertex->interface_number,
+                   predecessor, -1);
+      }
+    }
+  }
+}
+
+/*
+ * Random changes of a Graph with registered trees
+ */
+static void
+check_dynamic(const check_options_t *O, const char *check) {
+
+  check_graph_t         C;
+  Graph_sssp_t         *trees[3];
+  vertex_number_t       sources[3];
+  Graph_workspace_t    *W;
+  Graph_vertices_t     *vertex;
+  Graph_edges_t        *edge;
+  vertex_number_t       S;
+  vertex_number_t       D;
+  vertex_number_t       victim;
+  long                  failures = check_failures;
+  long                  skip;
+  int                   round;
+  int                   step;
+  int                   iterator;
+  int                   operation;
+  int                   steps = 400;
+
+  for (round = 0; round < O->rounds; round++) {
+    if (!check_build(&C, 40 + check_below(60), 150 + check_below(150), 9,
+                     check_below(2), check_below(2), 1)) {
+      check_fail("dynamic", "build failed", -1, -1, 0, 1);
+      check_release(&C);
+      return;
+    }
+
+    /* Every step adds at most one vertex */
+    W = Graph_workspace_create(C.G->total_vertices + steps);
+    for (iterator = 0; iterator < 3; iterator++) {
+      sources[iterator] = C.ids[iterator];
+      trees[iterator]   = Graph_sssp_register(C.G, sources[iterator]);
+      if (trees[iterator] == NULL) {
+        check_fail("dynamic", "register failed", sources[iterator], -1, 0, 1);
+      }
+    }
+    if (W == NULL || trees[0] == NULL || trees[1] == NULL || trees[2] == NULL) {
+      Graph_workspace_destroy(W);
+      check_release(&C);
+      return;
+    }
+
+    for (step = 0; step < steps; step++) {
+      operation = (int)check_below(100);
+      S = check_any_vertex(&C);
+      D = check_any_vertex(&C);
+      if (C.count < 8) {
+        operation = 90;
+      }
+
+      /* Existing edge of S for removal and weight change */
+      vertex = Graph_get_vertex(C.G, S);
+      edge   = vertex->adjacency_list;
+      for (skip = check_below(vertex->degree); edge != NULL && skip > 0; skip--) {
+        edge = edge->next;
+      }
+
+      if (operation < 5) {
+        /* Vertex gets its incoming edge once it is added */
+        Graph_add_edge(C.G, S, check_future_id(&C, (vertex_number_t)check_below(3)),
+                       (edge_weight_t)check_below(10), TRUE);
+      } else if (operation < 35) {
+        Graph_add_edge(C.G, S, D, (edge_weight_t)check_below(10), C.directed);
+      } else if (operation < 55) {
+        if (edge != NULL) {
+          Graph_remove_edge(C.G, S, edge->target, C.directed);
+        }
+      } else if (operation < 85) {
+        if (edge != NULL) {
+          Graph_update_weight(C.G, S, edge->target, (edge_weight_t)check_below(10),
+                              C.directed);
+        }
+      } else if (operation < 90) {
+        /* Sources are removed too, now and then */
+        victim = (vertex_number_t)check_below(C.count);
+        Graph_remove_vertex(C.G, C.ids[victim]);
+        C.ids[victim] = C.ids[--C.count];
+      } else {
+        check_add_vertex(&C);
+      }
+
+      check_trees(&C, trees, sources, 3, W, step);
+    }
+
+    Graph_sssp_unregister(trees[1]);
+    Graph_workspace_destroy(W);
+    check_release(&C);
+  }
+
+  printf("%s %s: %d Graphs, %d changes each\n",
+         check_failures == failures ? "ok  " : "FAIL", check, O->rounds, steps);
+}
+
+/*
+ * Graph_has_edge of Graph with sorted adjacency or
+ * edge index (budgets which keep or drop its hash set)
+ * against scan of adjacency lists, while edges and
+ * vertices come and go. Incoming edges, pending ones
+ * of bulk added edges included, must match edges
+ */
+static void
+check_membership(const check_options_t *O, const char *check) {
+
+  check_graph_t         C;
+  Graph_csr_t          *csr;
+  Graph_vertices_t     *vertex;
+  Graph_edges_t        *edge;
+  Graph_edges_t        *reverse;
+  vertex_number_t       sources[16];
+  vertex_number_t       targets[16];
+  vertex_number_t       S;
+  vertex_number_t       D;
+  vertex_number_t       victim;
+  long                  failures = check_failures;
+  long                  skip;
+  long                  incoming;
+  long                  linked;
+  edge_index_t          added;
+  edge_index_t          expected;
+  int                   round;
+  int                   step;
+  int                   query;
+  int                   operation;
+  int                   steps = 300;
+  vertex_number_t       list[4 * GRAPH_SORTED_SCAN_MAX];
+  edge_index_t          length;
+  edge_index_t          position;
+  bool                  indexed = strcmp(check, "edge_index") == 0;
+  bool                  member;
+  bool                  sorted;
+  bool                  reversed;
+  size_t                budgets[] = { 0, 1024, 64 * 1024 };
+
+  /* Lengths either side of switch from halving to scan */
+  for (length = 0; !indexed && length < 4 * GRAPH_SORTED_SCAN_MAX; length++) {
+    for (position = 0; position < length; position++) {
+      list[position] = (vertex_number_t)(3 * position) - GRAPH_SORTED_SCAN_MAX;
+    }
+    for (D = -GRAPH_SORTED_SCAN_MAX - 2; D < 3 * (vertex_number_t)length; D++) {
+      member = D >= -GRAPH_SORTED_SCAN_MAX && (D + GRAPH_SORTED_SCAN_MAX) % 3 == 0 &&
+               D < 3 * (vertex_number_t)length - GRAPH_SORTED_SCAN_MAX;
+      if (Graph_sorted_contains(list, length, D) != member) {
+        check_fail(check, "sorted_contains", (vertex_number_t)length, D,
+                   Graph_sorted_contains(list, length, D), member);
+      }
+    }
+  }
+
+  for (round = 0; round < O->rounds; round++) {
+    if (!check_build(&C, 20 + check_below(200), check_below(1500), 9,
+                     check_below(2), check_below(2), 1)) {
+      check_fail(check, "build failed", -1, -1, 0, 1);
+      check_release(&C);
+      return;
+    }
+    sorted   = !indexed || round % 4 >= 2;
+    reversed = (round / 3) % 2 == 1;
+    if (reversed && !Graph_enable_reverse_adjacency(C.G, TRUE)) {
+      check_fail(check, "reverse failed", -1, -1, 0, 1);
+    }
+
+    for (step = 0; step < steps; step++) {
+      /* Switched on before any change or half way through */
+      if (step == (round % 2) * steps / 2) {
+        if (sorted && !Graph_set_sorted_adjacency(C.G, TRUE)) {
+          check_fail(check, "sorted failed", -1, -1, 0, 1);
+        }
+        if (indexed && !Graph_enable_edge_index(C.G, budgets[round % 3])) {
+          check_fail(check, "index failed", -1, -1, 0, 1);
+        }
+      }
+      /* Index dropped for a while, then built with another budget */
+      if (indexed && step == 3 * steps / 4) {
+        Graph_disable_edge_index(C.G);
+      } else if (indexed && step == 3 * steps / 4 + 10 &&
+                 !Graph_enable_edge_index(C.G, budgets[(round + 1) % 3])) {
+        check_fail(check, "index failed", -1, -1, 0, 1);
+      }
+
+      operation = (int)check_below(100);
+      S = check_any_vertex(&C);
+      D = check_any_vertex(&C);
+      if (C.count < 8) {
+        operation = 95;
+      }
+
+      vertex = Graph_get_vertex(C.G, S);
+      edge   = vertex->adjacency_list;
+      for (skip = check_below(vertex->degree); edge != NULL && skip > 0; skip--) {
+        edge = edge->next;
+      }
+
+      if (operation < 5) {
+        Graph_add_edge(C.G, S, check_future_id(&C, (vertex_number_t)check_below(3)),
+                       1, TRUE);
+      } else if (operation < 40) {
+        Graph_add_edge(C.G, S, D, 1, C.directed);
+      } else if (operation < 50) {
+        /* Unknown Sources are skipped, unknown Destinations kept */
+        length   = 1 + check_below(16);
+        expected = length;
+        for (position = 0; position < length; position++) {
+          sources[position] = check_any_vertex(&C);
+          targets[position] = check_any_vertex(&C);
+          if (check_below(8) == 0) {
+            targets[position] = check_future_id(&C, (vertex_number_t)check_below(3));
+          }
+          if (check_below(16) == 0) {
+            sources[position] = check_future_id(&C, 5);
+            expected--;
+          }
+        }
+        added = Graph_add_edges_bulk(C.G, sources, targets, NULL, length, C.directed);
+        if (added != expected) {
+          check_fail(check, "bulk added", -1, -1, added, expected);
+        }
+      } else if (operation < 80) {
+        if (edge != NULL) {
+          Graph_remove_edge(C.G, S, edge->target, C.directed);
+        }
+      } else if (operation < 85) {
+        victim = (vertex_number_t)check_below(C.count);
+        Graph_remove_vertex(C.G, C.ids[victim]);
+        C.ids[victim] = C.ids[--C.count];
+      } else if (operation < 90) {
+        Graph_compact(C.G);
+      } else {
+        check_add_vertex(&C);
+      }
+
+      /* Existing edges and random pairs, some with missing IDs */
+      for (query = 0; query < 20; query++) {
+        S = check_any_vertex(&C);
+        vertex = Graph_get_vertex(C.G, S);
+        if (query % 2 == 0 && vertex->adjacency_list != NULL) {
+          D = vertex->adjacency_list->target;
+        } else {
+          D = (query % 5 == 4) ? check_future_id(&C, (vertex_number_t)check_below(3))
+                               : check_any_vertex(&C);
+        }
+        if (Graph_has_edge(C.G, S, D) != check_adjacent(C.G, S, D)) {
+          check_fail(check, "has_edge", S, D, Graph_has_edge(C.G, S, D),
+                     check_adjacent(C.G, S, D));
+          printf("     after step %d\n", step);
+        }
+      }
+    }
+
+    /* Every incoming edge has its edge, pending ones are not listed */
+    for (incoming = 0, linked = 0, query = 0; reversed && query < C.count; query++) {
+      vertex = Graph_get_vertex(C.G, C.ids[query]);
+      for (edge = vertex->adjacency_list; edge != NULL; edge = edge->next) {
+        linked += Graph_get_vertex(C.G, edge->target) != NULL;
+      }
+      for (reverse = vertex->reverse_list; reverse != NULL; reverse = reverse->next) {
+        incoming++;
+        if (!check_adjacent(C.G, reverse->target, vertex->interface_number)) {
+          check_fail(check, "reverse edge", reverse->target, vertex->interface_number,
+                     0, 1);
+        }
+      }
+    }
+    if (incoming != linked) {
+      check_fail(check, "incoming edges", -1, -1, incoming, linked);
+    }
+
+    /* Frozen rows are sorted too */
+    csr = Graph_freeze(C.G);
+    if (csr == NULL || csr->is_sorted != sorted) {
+      check_fail(check, "freeze", -1, -1, csr != NULL, 1);
+    } else {
+      for (query = 0; query < 200; query++) {
+        S = check_any_vertex(&C);
+        D = check_any_vertex(&C);
+        if (Graph_csr_has_edge(csr, S, D) != check_adjacent(C.G, S, D)) {
+          check_fail(check, "csr has_edge", S, D, Graph_csr_has_edge(csr, S, D),
+                     check_adjacent(C.G, S, D));
+        }
+      }
+    }
+    Graph_csr_destroy(csr);
+    check_release(&C);
+  }
+
+  printf("%s %s: %d Graphs, %d changes each\n",
+         check_failures == failures ? "ok  " : "FAIL", check, O->rounds, steps);
+}
+
+/*
+ * Number representatives in order of first row,
+ * as the library numbers components
+ */
+static vertex_number_t
+check_number(vertex_number_t *label, vertex_number_t *scratch, vertex_number_t rows) {
+
+  vertex_number_t       count = 0;
+  vertex_number_t       row;
+
+  for (row = 0; row < rows; row++) {
+    scratch[row] = -1;
+  }
+  for (row = 0; row < rows; row++) {
+    if (scratch[label[row]] == -1) {
+      scratch[label[row]] = count++;
+    }
+    label[row] = scratch[label[row]];
+  }
+
+  return count;
+}
+
+static vertex_number_t
+check_find(vertex_number_t *parent, vertex_number_t row) {
+
+  while (parent[row] != row) {
+    row = parent[row];
+  }
+
+  return row;
+}
+
+/*
+ * Weakly connected components by union-find,
+ * strongly connected ones by pairwise reachability
+ */
+static vertex_number_t
+check_components_reference(const Graph_t *G, bool strong, vertex_number_t *label,
+                           vertex_number_t *scratch) {
+
+  Graph_edges_t        *edge;
+  vertex_number_t       rows = G->total_vertices;
+  vertex_number_t       row;
+  vertex_number_t       other;
+  vertex_number_t       head;
+  vertex_number_t       tail;
+  char                 *reach;
+
+  if (!strong) {
+    for (row = 0; row < rows; row++) {
+      label[row] = row;
+    }
+    for (row = 0; row < rows; row++) {
+      for (edge = G->index_table[row]->adjacency_list; edge != NULL; edge = edge->next) {
+        other = Graph_get_vertex(G, edge->target)->index;
+        label[check_find(label, row)] = check_find(label, other);
+      }
+    }
+    for (row = 0; row < rows; row++) {
+      label[row] = check_find(label, row);
+    }
+    return check_number(label, scratch, rows);
+  }
+
+  /* reach[row * rows + other] is set if row reaches other */
+  reach = (char *)calloc((size_t)rows * rows, 1);
+  if (reach == NULL) {
+    return -1;
+  }
+  for (row = 0; row < rows; row++) {
+    reach[(long)row * rows + row] = 1;
+    scratch[0] = row;
+    for (head = 0, tail = 1; head < tail; head++) {
+      for (edge = G->index_table[scratch[head]]->adjacency_list; edge != NULL;
+           edge = edge->next) {
+        other = Graph_get_vertex(G, edge->target)->index;
+        if (!reach[(long)row * rows + other]) {
+          reach[(long)row * rows + other] = 1;
+          scratch[tail++] = other;
+        }
+      }
+    }
+  }
+
+  for (row = 0; row < rows; row++) {
+    for (other = 0; !(reach[(long)row * rows + other] && reach[(long)other * rows + row]);
+         other++) {
+    }
+    label[row] = other;
+  }
+  free(reach);
+
+  return check_number(label, scratch, rows);
+}
+
+static void
+check_labels(const char *check, const char *what, const Graph_t *G,
+             const vertex_number_t *got, vertex_number_t got_count,
+             const vertex_number_t *expected, vertex_number_t expected_count) {
+
+  vertex_number_t       row;
+
+  if (got_count != expected_count) {
+    check_fail(check, what, -1, -1, got_count, expected_count);
+    return;
+  }
+
+  for (row = 0; row < G->total_vertices; row++) {
+    if (got[row] != expected[row]) {
+      check_fail(check, what, -1, G->index_table[row]->interface_number,
+                 got[row], expected[row]);
+    }
+  }
+}
+
+/*
+ * Connected and strongly connected components of
+ * Graph and its CSR snapshot against reference
+ */
+static void
+check_components(const check_options_t *O, const char *check) {
+
+  static const Graph_scc_algorithm_t algorithms[] = {
+    GRAPH_SCC_TARJAN, GRAPH_SCC_FORWARD_BACKWARD
+  };
+  check_graph_t         C;
+  Graph_csr_t          *csr;
+  Graph_csr_t          *transposed;
+  vertex_number_t      *expected;
+  vertex_number_t      *got;
+  vertex_number_t      *scratch;
+  vertex_number_t       vertices;
+  vertex_number_t       expected_count;
+  long                  failures = check_failures;
+  size_t                algorithm;
+  int                   round;
+
+  for (round = 0; round < O->rounds; round++) {
+    /* Sparse edges give many small components */
+    vertices = (vertex_number_t)(20 + check_below(400));
+    if (!check_build(&C, vertices, vertices * (1 + check_below(30)) / 10, 5,
+                     check_below(2), check_below(2), 1 + round % 4)) {
+      check_fail(check, "build failed", -1, -1, 0, 1);
+      check_release(&C);
+      return;
+    }
+
+    expected   = (vertex_number_t *)malloc(vertices * sizeof(vertex_number_t));
+    got        = (vertex_number_t *)malloc(vertices * sizeof(vertex_number_t));
+    scratch    = (vertex_number_t *)malloc(vertices * sizeof(vertex_number_t));
+    csr        = Graph_freeze(C.G);
+    transposed = Graph_csr_transpose(csr);
+    if (expected == NULL || got == NULL || scratch == NULL || csr == NULL ||
+        transposed == NULL) {
+      check_fail(check, "out of memory", -1, -1, 0, 1);
+    } else {
+      expected_count = check_components_reference(C.G, FALSE, expected, scratch);
+      check_labels(check, "connected", C.G, got,
+                   Graph_connected_components(C.G, got), expected, expected_count);
+      check_labels(check, "csr connected", C.G, got,
+                   Graph_csr_connected_components(csr, got), expected, expected_count);
+
+      expected_count = check_components_reference(C.G, TRUE, expected, scratch);
+      for (algorithm = 0; algorithm < sizeof(algorithms) / sizeof(algorithms[0]);
+           algorithm++) {
+        check_labels(check, "strong", C.G, got,
+                     Graph_strongly_connected_components(C.G, algorithms[algorithm], got),
+                     expected, expected_count);
+        check_labels(check, "csr strong", C.G, got,
+                     Graph_csr_strongly_connected_components(csr, transposed,
+                                                             algorithms[algorithm], got),
+                     expected, expected_count);
+      }
+    }
+
+    Graph_csr_destroy(transposed);
+    Graph_csr_destroy(csr);
+    free(expected);
+    free(got);
+    free(scratch);
+    check_release(&C);
+  }
+
+  printf("%s %s: %d Graphs\n", check_failures == failures ? "ok  " : "FAIL",
+         check, O->rounds);
+}
+
+/*
+ * Edge of reference Kruskal, by dense row
+ */
+typedef struct check_mst_edge_ {
+  long                  weight;
+  vertex_number_t       a;
+  vertex_number_t       b;
+} check_mst_edge_t;
+
+static int
+check_mst_compare(const void *x, const void *y) {
+
+  const check_mst_edge_t *A = (const check_mst_edge_t *)x;
+  const check_mst_edge_t *B = (const check_mst_edge_t *)y;
+
+  return (A->weight > B->weight) - (A->weight < B->weight);
+}
+
+/*
+ * Weight and edges of minimum spanning forest by
+ * plain Kruskal: sorted edges joined with union-find,
+ * direction ignored
+ */
+static long
+check_mst_reference(const Graph_t *G, vertex_number_t *parent, edge_index_t *no_of_edges) {
+
+  check_mst_edge_t     *edges;
+  Graph_edges_t        *edge;
+  edge_index_t          count = 0;
+  edge_index_t          iterator;
+  vertex_number_t       row;
+  vertex_number_t       a;
+  vertex_number_t       b;
+  long                  total = 0;
+
+  *no_of_edges = 0;
+  edges = (check_mst_edge_t *)malloc((G->total_edges + 1) * sizeof(check_mst_edge_t));
+  if (edges == NULL) {
+    return 0;
+  }
+
+  for (row = 0; row < G->total_vertices; row++) {
+    parent[row] = row;
+    for (edge = G->index_table[row]->adjacency_list; edge != NULL; edge = edge->next) {
+      edges[count].weight = edge->weight;
+      edges[count].a      = row;
+      edges[count].b      = Graph_get_vertex(G, edge->target)->index;
+      count++;
+    }
+  }
+  qsort(edges, count, sizeof(check_mst_edge_t), check_mst_compare);
+
+  for (iterator = 0; iterator < count; iterator++) {
+    a = check_find(parent, edges[iterator].a);
+    b = check_find(parent, edges[iterator].b);
+    if (a != b) {
+      parent[a] = b;
+      total    += edges[iterator].weight;
+      (*no_of_edges)++;
+    }
+  }
+
+  free(edges);
+
+  return total;
+}
+
+/*
+ * Graph_mst with every algorithm against reference
+ * Kruskal: total weight, no of edges, and result must
+ * be a forest of Graph edges. Weights include negative
+ * and extreme ones, Graphs are disconnected at times and
+ * large enough now and then for parallel sort of edges
+ */
+static void
+check_mst(const check_options_t *O, const char *check) {
+
+  static const struct {
+    const char             *name;
+    Graph_mst_algorithm_t   algorithm;
+  } algorithms[] = {
+    { "prim",    GRAPH_MST_PRIM    },
+    { "kruskal", GRAPH_MST_KRUSKAL },
+    { "boruvka", GRAPH_MST_BORUVKA },
+  };
+  check_graph_t         C;
+  Graph_mst_t          *M;
+  vertex_number_t      *parent;
+  vertex_number_t       vertices;
+  vertex_number_t       a;
+  vertex_number_t       b;
+  edge_index_t          expected_edges;
+  edge_index_t          iterator;
+  long                  expected;
+  long                  total;
+  long                  edges;
+  long                  failures = check_failures;
+  size_t                algorithm;
+  int                   round;
+  int                   extra;
+  edge_weight_t         weight;
+
+  for (round = 0; round < O->rounds; round++) {
+    vertices = 1 + check_below(300);
+    edges    = check_below(3 * vertices);
+    if (round % 10 == 9) {
+      vertices = 2000;
+      edges    = 40000;
+    }
+    if (!check_build(&C, vertices, edges, round % 4 ? 1000 : 0, check_below(2),
+                     check_below(2), 1 + round % 4)) {
+      check_fail(check, "build failed", -1, -1, 0, 1);
+      check_release(&C);
+      return;
+    }
+    for (extra = 0; round % 2 == 1 && extra < 20; extra++) {
+      weight = (edge_weight_t)(-1 - check_below(1000));
+      if (extra == 0) {
+        weight = INT_MIN;
+      } else if (extra == 1) {
+        weight = INT_MAX;
+      }
+      Graph_add_edge(C.G, check_any_vertex(&C), check_any_vertex(&C), weight, C.directed);
+    }
+
+    parent = (vertex_number_t *)malloc(C.G->total_vertices * sizeof(vertex_number_t));
+    if (parent == NULL) {
+      check_fail(check, "allocation failed", -1, -1, 0, 1);
+      check_release(&C);
+      return;
+    }
+    expected = check_mst_reference(C.G, parent, &expected_edges);
+
+    for (algorithm = 0; algorithm < sizeof(algorithms) / sizeof(algorithms[0]); algorithm++) {
+      M = Graph_mst(C.G, algorithms[algorithm].algorithm);
+      if (M == NULL) {
+        check_fail(check, algorithms[algorithm].name, -1, -1, 0, 1);
+        continue;
+      }
+      if (M->total_weight != expected || M->no_of_edges != expected_edges) {
+        check_fail(check, algorithms[algorithm].name, -1, -1, M->total_weight, expected);
+      }
+
+      /* Edges of the Graph, no cycle */
+      for (a = 0; a < C.G->total_vertices; a++) {
+        parent[a] = a;
+      }
+      for (total = 0, iterator = 0; iterator < M->no_of_edges; iterator++) {
+        total += M->weight[iterator];
+        if (!check_has_edge(C.G, M->source[iterator], M->destination[iterator],
+                            M->weight[iterator]) &&
+            !check_has_edge(C.G, M->destination[iterator], M->source[iterator],
+                            M->weight[iterator])) {
+          check_fail(check, algorithms[algorithm].name, M->source[iterator],
+                     M->destination[iterator], M->weight[iterator], -1);
+          break;
+        }
+        a = check_find(parent, Graph_get_vertex(C.G, M->source[iterator])->index);
+        b = check_find(parent, Graph_get_vertex(C.G, M->destination[iterator])->index);
+        if (a == b) {
+          check_fail(check, algorithms[algorithm].name, M->source[iterator],
+                     M->destination[iterator], 1, 0);
+          break;
+        }
+        parent[a] = b;
+      }
+      if (total != M->total_weight) {
+        check_fail(check, algorithms[algorithm].name, -1, -1, total, M->total_weight);
+      }
+      Graph_mst_destroy(M);
+    }
+
+    free(parent);
+    check_release(&C);
+  }
+
+  printf("%s %s: %d Graphs\n",
+         check_failures == failures ? "ok  " : "FAIL", check, O->rounds);
+}
+
+/*
+ * Contraction Hierarchy of random Graph against
+ * Graph_dijkstra, every other one after a round trip
+ * through Graph_ch_save / Graph_ch_load
+ */
+static void
+check_ch(const check_options_t *O, const char *check) {
+
+  check_graph_t         C;
+  Graph_ch_t           *H;
+  Graph_ch_t           *loaded;
+  Graph_workspace_t    *W;
+  Graph_workspace_t    *Wr;
+  long                 *expected;
+  vertex_number_t       vertices;
+  vertex_number_t       source;
+  vertex_number_t       target;
+  vertex_number_t       row;
+  long                  failures = check_failures;
+  long                  got;
+  char                  path[] = "/tmp/graph_check_ch_XXXXXX";
+  int                   descriptor;
+  int                   round;
+  int                   query;
+
+  for (round = 0; round < O->rounds; round++) {
+    /* Random Graphs have no hierarchy, keep them small */
+    vertices = (vertex_number_t)(20 + check_below(round % 3 == 2 ? 800 : 200));
+    if (!check_build(&C, vertices, vertices * (1 + check_below(3)), 50,
+                     check_below(2), check_below(2), 1 + round % 4)) {
+      check_fail(check, "build failed", -1, -1, 0, 1);
+      check_release(&C);
+      return;
+    }
+
+    H = Graph_ch_build(C.G);
+    if (H != NULL && round % 2 == 1) {
+      strcpy(path, "/tmp/graph_check_ch_XXXXXX");
+      descriptor = mkstemp(path);
+      loaded     = NULL;
+      if (descriptor >= 0) {
+        close(descriptor);
+        if (Graph_ch_save(H, path)) {
+          loaded = Graph_ch_load(path);
+        }
+        unlink(path);
+      }
+      Graph_ch_destroy(H);
+      H = loaded;
+    }
+
+    expected = (long *)malloc(vertices * sizeof(long));
+    W        = Graph_workspace_create(vertices);
+    Wr       = Graph_workspace_create(vertices);
+    if (H == NULL) {
+      check_fail(check, "build or reload failed", -1, -1, 0, 1);
+    } else if (expected == NULL || W == NULL || Wr == NULL) {
+      check_fail(check, "out of memory", -1, -1, 0, 1);
+    } else {
+      for (query = 0; query < 4; query++) {
+        source = check_any_vertex(&C);
+        Graph_dijkstra(C.G, source, expected, NULL);
+        for (row = 0; row < C.G->total_vertices; row++) {
+          target = C.G->index_table[row]->interface_number;
+          got    = Graph_ch_query(H, W, Wr, source, target);
+          if (got != expected[row]) {
+            check_fail(check, "query", source, target, got, expected[row]);
+          }
+        }
+        target = check_any_vertex(&C);
+        row    = Graph_get_vertex(C.G, target)->index;
+        got    = Graph_ch_distance(H, source, target);
+        if (got != expected[row]) {
+          check_fail(check, "distance", source, target, got, expected[row]);
+        }
+      }
+    }
+
+    Graph_workspace_destroy(W);
+    Graph_workspace_destroy(Wr);
+    Graph_ch_destroy(H);
+    free(expected);
+    check_release(&C);
+  }
+
+  printf("%s %s: %d Graphs\n", check_failures == failures ? "ok  " : "FAIL",
+         check, O->rounds);
+}
+
+/*
+ * Messages seen by check_log_handler
+ */
+typedef struct check_log_ {
+  long                  messages;
+  long                  errors;
+  unsigned long         suppressed;   /* Sum of suppressed summaries */
+  size_t                longest;
+  bool                  well_formed;
+  char                  last[GRAPH_LOG_MESSAGE_MAX];
+} check_log_t;
+
+static void
+check_log_handler(Graph_log_level_t level, const char *file, int line,
+                  const char *message, void *context) {
+
+  check_log_t          *L = (check_log_t *)context;
+  unsigned long         dropped;
+
+  if (sscanf(message, "%lu messages suppressed", &dropped) == 1) {
+    L->suppressed += dropped;
+    return;
+  }
+
+  L->messages++;
+  L->errors += level == GRAPH_LOG_ERR;
+  if (strlen(message) > L->longest) {
+    L->longest = strlen(message);
+  }
+  if (file == NULL || line <= 0 || strchr(message, '\n') != NULL) {
+    L->well_formed = FALSE;
+  }
+  snprintf(L->last, sizeof(L->last), "%s", message);
+}
+
+/*
+ * Graph_set_log_handler / level / rate limit: messages
+ * of failing calls reach handler below selected level
+ * only, long ones are truncated, messages over the rate
+ * limit are dropped and summarized once next second
+ * starts. Library is left silent as main set it
+ */
+static void
+check_log(const check_options_t *O, const char *check) {
+
+  check_log_t           L;
+  Graph_t              *G;
+  char                  expected[64];
+  char                  filler[2 * GRAPH_LOG_MESSAGE_MAX];
+  long                  failures = check_failures;
+  long                  burst = 50;
+  long                  iterator;
+  unsigned int          limit = 5;
+
+  (void)O;
+  memset(&L, 0, sizeof(L));
+  L.well_formed = TRUE;
+
+  G = Graph_init(0, TRUE);
+  if (G == NULL) {
+    check_fail(check, "init failed", -1, -1, 0, 1);
+    return;
+  }
+
+  Graph_set_log_handler(check_log_handler, &L);
+  Graph_set_log_rate_limit(0);
+
+  /* Silent, then errors only, then everything */
+  Graph_add_edge(G, 12345, 1, 1, TRUE);
+  if (L.messages != 0) {
+    check_fail(check, "level none", -1, -1, L.messages, 0);
+  }
+
+  Graph_set_log_level(GRAPH_LOG_ERR);
+  Graph_add_edge(G, 12345, 1, 1, TRUE);
+  snprintf(expected, sizeof(expected), "Unable to find vertex: %d", 12345);
+  if (L.errors != 1 || strcmp(L.last, expected) != 0) {
+    check_fail(check, "failing call", -1, -1, L.errors, 1);
+  }
+  LOG_INFO("Note %d", 1);
+  if (L.messages != 1) {
+    check_fail(check, "level err", -1, -1, L.messages, 1);
+  }
+
+  Graph_set_log_level(GRAPH_LOG_INFO);
+  LOG_INFO("Note %d", 2);
+  if (L.messages != 2 || strcmp(L.last, "Note 2") != 0) {
+    check_fail(check, "level info", -1, -1, L.messages, 2);
+  }
+
+  memset(filler, 'x', sizeof(filler) - 1);
+  filler[sizeof(filler) - 1] = '\0';
+  LOG_ERR("%s", filler);
+  if (L.longest != GRAPH_LOG_MESSAGE_MAX - 1) {
+    check_fail(check, "truncation", -1, -1, (long)L.longest, GRAPH_LOG_MESSAGE_MAX - 1);
+  }
+
+  /*
+   * Burst over the limit: every message is either
+   * delivered or counted in a summary, summary of
+   * the last window comes with first message after it
+   */
+  L.messages = 0;
+  Graph_set_log_rate_limit(limit);
+  for (iterator = 0; iterator < burst; iterator++) {
+    LOG_ERR("Burst %ld", iterator);
+  }
+  if (L.messages < limit || L.messages > 2 * limit) {
+    check_fail(check, "rate limit", -1, -1, L.messages, limit);
+  }
+  sleep(1);
+  LOG_ERR("After burst");
+  if (L.messages - 1 + (long)L.suppressed != burst) {
+    check_fail(check, "suppressed", -1, -1, L.messages - 1 + (long)L.suppressed, burst);
+  }
+  if (!L.well_formed) {
+    check_fail(check, "message format", -1, -1, 0, 1);
+  }
+
+  Graph_set_log_level(GRAPH_LOG_NONE);
+  Graph_set_log_rate_limit(GRAPH_LOG_RATE_LIMIT);
+  Graph_set_log_handler(NULL, NULL);
+  Graph_destroy(G);
+
+  printf("%s %s: burst of %ld messages, limit %u\n",
+         check_failures == failures ? "ok  " : "FAIL", check, burst, limit);
+}
+
+static bool
+check_selected(const check_options_t *O, const char *check) {
+
+  const char           *found;
+  size_t                length = strlen(check);
+
+  for (found = strstr(O->checks, check); found != NULL; found = strstr(found + 1, check)) {
+    if ((found == O->checks || found[-1] == ',') &&
+        (found[length] == '\0' || found[length] == ',')) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/*
+ * Checks in order they run
+ */
+static const check_entry_t check_table[] = {
+  { "heaps",      check_heaps      },
+  { "csr",        check_csr        },
+  { "io",         check_io         },
+  { "snapshot",   check_snapshot   },
+  { "sorted",     check_membership },
+  { "edge_index", check_membership },
+  { "delta",      check_parallel   },
+  { "bfs",        check_parallel   },
+  { "batch",      check_parallel   },
+  { "paths",      check_paths      },
+  { "components", check_components },
+  { "mst",        check_mst        },
+  { "dynamic",    check_dynamic    },
+  { "ch",         check_ch         },
+  { "log",        check_log        },
+};
+
+#define CHECK_COUNT (sizeof(check_table) / sizeof(check_table[0]))
+
+int main(int argc, char **argv) {
+
+  check_options_t       O;
+  size_t                iterator;
+  int                   option;
+
+  O.checks = NULL;
+  O.rounds = 20;
+  O.seed   = 1;
+
+  while ((option = getopt(argc, argv, "r:n:c:")) != -1) {
+    switch (option) {
+      case 'r': O.seed   = strtoull(optarg, NULL, 10); break;
+      case 'n': O.rounds = atoi(optarg); break;
+      case 'c': O.checks = optarg; break;
+      default:
+        fprintf(stderr, "Usage: %s [-r seed] [-n rounds] [-c check,check,...]\nChecks:",
+                argv[0]);
+        for (iterator = 0; iterator < CHECK_COUNT; iterator++) {
+          fprintf(stderr, " %s", check_table[iterator].name);
+        }
+        fprintf(stderr, "\n");
+        return 2;
+    }
+  }
+
+  check_state = O.seed;
+  Graph_set_log_level(GRAPH_LOG_NONE);
+
+  for (iterator = 0; iterator < CHECK_COUNT; iterator++) {
+    if (O.checks == NULL || check_selected(&O, check_table[iterator].name)) {
+      check_table[iterator].run(&O, check_table[iterator].name);
+    }
+  }
+
+  if (check_failures > 0) {
+    printf("%ld mismatches (seed %llu)\n", check_failures, (unsigned long long)O.seed);
+    return 1;
+  }
+
+  return 0;
+}